@@ -6,6 +6,7 @@
 #include <iostream>
 #include <memory>
 #include <chrono>
+#include <fstream>
 
 int main() {
   ConfigLogger::ConfigTestStart();
@@ -213,6 +214,63 @@ int main() {
       std::cout << "  " << (hasConfig ? "✅" : "❌") << " " << file << std::endl;
     }
 
+    // === TEST BINARY CONFIG CACHE ===
+    std::cout << "\n=== TESTING BINARY CONFIG CACHE ===" << std::endl;
+
+    // First load compiles the .bin if needed, the second must come from it
+    configManager.ClearCache();
+    configManager.LoadConfig("motion_config_positions.json");
+    configManager.ClearCache();
+    configManager.LoadConfig("motion_config_positions.json");
+
+    std::ifstream positionsFile("config/motion_config_positions.json");
+    nlohmann::json parsedPositions = nlohmann::json::parse(positionsFile);
+
+    if (configManager.GetConfig("motion_config_positions.json") == parsedPositions) {
+      std::cout << "✅ Decoded cache matches the JSON source" << std::endl;
+    }
+    else {
+      std::cout << "❌ Decoded cache differs from the JSON source" << std::endl;
+    }
+
+    int positionCount = 0;
+    int positionMismatches = 0;
+    for (const auto& [device, positions] : parsedPositions.items()) {
+      for (const auto& [name, value] : positions.items()) {
+        ConfigCache::PositionRecord record;
+        auto lookup = configManager.FindCachedPosition("motion_config_positions.json", device, name, record);
+        positionCount++;
+        if (lookup != ConfigCache::Lookup::Found ||
+          record.x != value.value("x", 0.0) || record.y != value.value("y", 0.0) ||
+          record.z != value.value("z", 0.0) || record.u != value.value("u", 0.0) ||
+          record.v != value.value("v", 0.0) || record.w != value.value("w", 0.0)) {
+          positionMismatches++;
+        }
+      }
+    }
+    std::cout << (positionMismatches == 0 ? "✅ " : "❌ ") << positionCount - positionMismatches << "/"
+      << positionCount << " positions match in the cached table" << std::endl;
+
+    auto parseStart = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < 100; i++) {
+      std::ifstream file("config/motion_config_graph.json");
+      nlohmann::json graph = nlohmann::json::parse(file);
+    }
+    auto parseEnd = std::chrono::high_resolution_clock::now();
+
+    for (int i = 0; i < 100; i++) {
+      configManager.ClearCache();
+      configManager.LoadConfig("motion_config_graph.json");
+      configManager.GetConfig("motion_config_graph.json");
+    }
+    auto cacheEnd = std::chrono::high_resolution_clock::now();
+
+    std::cout << "⏱️ Graph JSON parse: "
+      << std::chrono::duration_cast<std::chrono::microseconds>(parseEnd - parseStart).count() / 100.0
+      << " us, binary cache load + decode: "
+      << std::chrono::duration_cast<std::chrono::microseconds>(cacheEnd - parseEnd).count() / 100.0
+      << " us" << std::endl;
+
     // === PERFORMANCE TEST ===
     std::cout << "\n=== PERFORMANCE TEST ===" << std::endl;
 
@@ -0,0 +1,872 @@
+// TestSoak.cpp
+// Soak / load test: many simulated PI and ACS controllers driven through the standardized managers
+//
+// Links testing/SimulatedPIGCS2.cpp and testing/SimulatedACSC.cpp instead of the vendor
+// libraries, so no hardware is touched. Worker threads run randomized move, status and
+// scan operations for hours; every report interval prints (and appends to a CSV)
+// throughput, latency percentiles, thread count, memory and time lost outside
+// controller calls. Built with PROJECT4_PROFILE_LOCKS it also reports lock waits
+// per interval, the LockProfiler table at the end and a Chrome trace next to the CSV.
+//
+// Devices are spread over --stations stations of a MotionCell, polled by --io-threads
+// shared I/O threads (-1: a thread per controller). --scaling N instead runs 1..N
+// stations for --step-seconds each and reports how throughput scales; the device
+// and worker counts are then per station.
+//
+// Every run first checks the CouplingModel kernels: AVX2 against scalar results,
+// and a fit of a known synthetic peak. --kernels runs only that check.
+//
+// Usage: TestSoak [--hexapods 16] [--gantries 2] [--workers 8] [--hours 1]
+//                 [--report-seconds 10] [--latency-us 500] [--jitter-us 200]
+//                 [--stations 1] [--io-threads 0] [--scaling N] [--step-seconds 20]
+//                 [--csv soak.csv] [--seed 1] [--kernels] [--verbose]
+#include "devices/motions/MotionCell.h"
+#include "devices/motions/CouplingModel.h"
+#include "devices/motions/PIControllerManagerStandardized.h"
+#include "devices/motions/ACSControllerManagerStandardized.h"
+#include "devices/motions/PIController.h"
+#include "devices/motions/ACSController.h"
+#include "core/ConfigManager.h"
+#include "core/ConfigRegistry.h"
+#include "core/HealthWatchdog.h"
+#include "core/TelemetrySegment.h"
+#include "testing/SimulatedHardware.h"
+#include "utils/AllocationTracker.h"
+#include "utils/IOExecutor.h"
+#include "utils/LoggerAdapter.h"
+#include "utils/ProfiledMutex.h"
+#include "utils/ThreadPolicy.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#include <tlhelp32.h>
+#endif
+
+namespace {
+
+// === OPTIONS ===
+
+struct SoakOptions {
+  int hexapods = 16;
+  int gantries = 2;
+  int workers = 8;
+  double hours = 1.0;
+  int reportSeconds = 10;
+  int latencyUs = 500;
+  int jitterUs = 200;
+  int stations = 1;
+  int ioThreads = 0;      // MotionCell::Settings::ioThreads
+  int scaling = 0;        // > 0: scaling benchmark over 1..scaling stations
+  int stepSeconds = 20;
+  std::string csvPath = "soak_results.csv";
+  unsigned int seed = 1;
+  bool kernelsOnly = false; // Numeric kernel check only, no simulated hardware
+  bool verbose = false;   // Keep the controllers' own console logging
+};
+
+bool ParseArguments(int argc, char* argv[], SoakOptions& options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    try {
+      if (arg == "--hexapods" && hasValue) options.hexapods = std::stoi(argv[++i]);
+      else if (arg == "--gantries" && hasValue) options.gantries = std::stoi(argv[++i]);
+      else if (arg == "--workers" && hasValue) options.workers = std::stoi(argv[++i]);
+      else if (arg == "--hours" && hasValue) options.hours = std::stod(argv[++i]);
+      else if (arg == "--report-seconds" && hasValue) options.reportSeconds = std::stoi(argv[++i]);
+      else if (arg == "--latency-us" && hasValue) options.latencyUs = std::stoi(argv[++i]);
+      else if (arg == "--jitter-us" && hasValue) options.jitterUs = std::stoi(argv[++i]);
+      else if (arg == "--stations" && hasValue) options.stations = std::stoi(argv[++i]);
+      else if (arg == "--io-threads" && hasValue) options.ioThreads = std::stoi(argv[++i]);
+      else if (arg == "--scaling" && hasValue) options.scaling = std::stoi(argv[++i]);
+      else if (arg == "--step-seconds" && hasValue) options.stepSeconds = std::stoi(argv[++i]);
+      else if (arg == "--csv" && hasValue) options.csvPath = argv[++i];
+      else if (arg == "--seed" && hasValue) options.seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+      else if (arg == "--kernels") options.kernelsOnly = true;
+      else if (arg == "--verbose") options.verbose = true;
+      else {
+        std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+        return false;
+      }
+    }
+    catch (const std::exception&) {
+      std::cerr << "Invalid value for " << arg << std::endl;
+      return false;
+    }
+  }
+  return options.hexapods + options.gantries > 0 && options.workers > 0 && options.reportSeconds > 0 &&
+    options.stations > 0 && options.scaling >= 0 && options.stepSeconds > 0;
+}
+
+// === OPERATIONS AND SAMPLES ===
+
+enum Operation {
+  PIMove,
+  PIStatus,
+  PIScan,
+  ACSMove,
+  ACSStatus,
+  ACSScan,
+  OperationCount
+};
+
+const char* const kOperationNames[OperationCount] = {
+  "pi.move", "pi.status", "pi.scan", "acs.move", "acs.status", "acs.scan"
+};
+
+struct Sample {
+  float latencyMs;
+  float appMs;      // Outside the caller's own controller calls: lock waits, queueing, CPU (scans: motion too)
+  bool ok;
+};
+
+// One per worker - the reporter swaps the buffers out, so workers never share a lock
+class SampleLog {
+public:
+  void Add(Operation operation, const Sample& sample) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_samples[operation].push_back(sample);
+  }
+
+  void DrainInto(std::vector<Sample> (&out)[OperationCount]) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int i = 0; i < OperationCount; i++) {
+      out[i].insert(out[i].end(), m_samples[i].begin(), m_samples[i].end());
+      m_samples[i].clear();
+    }
+  }
+
+private:
+  std::mutex m_mutex;
+  std::vector<Sample> m_samples[OperationCount];
+};
+
+std::atomic<bool> g_stopRequested{ false };
+
+void OnSignal(int) {
+  g_stopRequested = true;
+}
+
+template <typename Body>
+void Measure(SampleLog& log, Operation operation, Body&& body) {
+  const double vendorBefore = SimulatedHardware::ThreadVendorSeconds();
+  const auto start = std::chrono::steady_clock::now();
+  const bool ok = body();
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  const double vendor = SimulatedHardware::ThreadVendorSeconds() - vendorBefore;
+  log.Add(operation, { static_cast<float>(seconds * 1000.0),
+    static_cast<float>(std::max(0.0, seconds - vendor) * 1000.0), ok });
+}
+
+// === WORKLOAD ===
+
+// Moves and scans need the device's motion lease, as on a real station where one
+// sequence owns a stage at a time; a worker that loses the race queries status instead
+template <typename Controller>
+struct StationDevice {
+  Controller* controller;
+  std::unique_ptr<std::mutex> motion;
+};
+
+struct Station {
+  std::vector<StationDevice<PIController>> hexapods;
+  std::vector<StationDevice<ACSController>> gantries;
+};
+
+void RunPIOperation(const StationDevice<PIController>& device, std::mt19937& rng, SampleLog& log) {
+  PIController& hexapod = *device.controller;
+  std::uniform_real_distribution<double> offset(-0.5, 0.5);
+  int choice = std::uniform_int_distribution<int>(0, 99)(rng);
+  const std::string axis = std::string(1, "XYZ"[std::uniform_int_distribution<int>(0, 2)(rng)]);
+
+  std::unique_lock<std::mutex> lease(*device.motion, std::defer_lock);
+  if ((choice < 40 || choice >= 90) && !lease.try_lock()) {
+    choice = 50;
+  }
+
+  if (choice < 40) {
+    const double target = offset(rng);
+    Measure(log, PIMove, [&]() { return hexapod.MoveToPosition(axis, target, false); });
+    hexapod.WaitForMotionCompletion(axis, 10.0);
+  }
+  else if (choice < 90) {
+    Measure(log, PIStatus, [&]() {
+      std::map<std::string, double> positions;
+      const bool ok = hexapod.GetPositions(positions);
+      hexapod.IsMoving(axis);
+      return ok;
+    });
+  }
+  else {
+    // 3 x 3 step scan reading the coupling signal at each point
+    const double x0 = offset(rng);
+    const double y0 = offset(rng);
+    Measure(log, PIScan, [&]() {
+      bool ok = true;
+      for (int row = 0; row < 3 && ok; row++) {
+        for (int column = 0; column < 3 && ok; column++) {
+          double voltage = 0.0;
+          ok = hexapod.MoveToPositionMultiAxis({ "X", "Y" }, { x0 + 0.01 * column, y0 + 0.01 * row }, true) &&
+            hexapod.GetAnalogVoltage(1, voltage);
+        }
+      }
+      return ok;
+    });
+  }
+}
+
+void RunACSOperation(const StationDevice<ACSController>& device, std::mt19937& rng, SampleLog& log) {
+  ACSController& gantry = *device.controller;
+  std::uniform_real_distribution<double> offset(-5.0, 5.0);
+  int choice = std::uniform_int_distribution<int>(0, 99)(rng);
+  const std::string axis = std::string(1, "XYZ"[std::uniform_int_distribution<int>(0, 2)(rng)]);
+
+  std::unique_lock<std::mutex> lease(*device.motion, std::defer_lock);
+  if ((choice < 40 || choice >= 90) && !lease.try_lock()) {
+    choice = 50;
+  }
+
+  if (choice < 40) {
+    const double target = offset(rng);
+    Measure(log, ACSMove, [&]() { return gantry.MoveToPosition(axis, target, false); });
+    gantry.WaitForMotionCompletion(axis, 10.0);
+  }
+  else if (choice < 90) {
+    Measure(log, ACSStatus, [&]() {
+      std::map<std::string, double> positions;
+      const bool ok = gantry.GetPositions(positions);
+      gantry.IsMoving(axis);
+      return ok;
+    });
+  }
+  else {
+    const double x0 = offset(rng);
+    const double y0 = offset(rng);
+    Measure(log, ACSScan, [&]() {
+      bool ok = true;
+      for (int row = 0; row < 3 && ok; row++) {
+        for (int column = 0; column < 3 && ok; column++) {
+          ok = gantry.MoveToPositionMultiAxis({ "X", "Y" }, { x0 + 0.1 * column, y0 + 0.1 * row }, true);
+        }
+      }
+      return ok;
+    });
+  }
+}
+
+void WorkerThreadFunc(const Station& station, unsigned int seed, SampleLog& log, const std::atomic<bool>& stop) {
+  std::mt19937 rng(seed);
+  const size_t deviceCount = station.hexapods.size() + station.gantries.size();
+  if (deviceCount == 0) {
+    return;
+  }
+  std::uniform_int_distribution<size_t> pick(0, deviceCount - 1);
+
+  while (!stop && !g_stopRequested) {
+    const size_t device = pick(rng);
+    if (device < station.hexapods.size()) {
+      RunPIOperation(station.hexapods[device], rng, log);
+    }
+    else {
+      RunACSOperation(station.gantries[device - station.hexapods.size()], rng, log);
+    }
+  }
+}
+
+// === PROCESS METRICS ===
+
+struct ProcessMetrics {
+  int threads = 0;
+  double residentMB = 0.0;
+};
+
+ProcessMetrics ReadProcessMetrics() {
+  ProcessMetrics metrics;
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    metrics.residentMB = counters.WorkingSetSize / (1024.0 * 1024.0);
+  }
+  HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+  if (snapshot != INVALID_HANDLE_VALUE) {
+    THREADENTRY32 entry;
+    entry.dwSize = sizeof(entry);
+    const DWORD processId = GetCurrentProcessId();
+    for (BOOL more = Thread32First(snapshot, &entry); more; more = Thread32Next(snapshot, &entry)) {
+      if (entry.th32OwnerProcessID == processId) metrics.threads++;
+    }
+    CloseHandle(snapshot);
+  }
+#else
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("Threads:", 0) == 0) metrics.threads = std::stoi(line.substr(8));
+    if (line.rfind("VmRSS:", 0) == 0) metrics.residentMB = std::stod(line.substr(6)) / 1024.0;
+  }
+#endif
+  return metrics;
+}
+
+// === REPORTING ===
+
+struct OperationStats {
+  size_t count = 0;
+  size_t failures = 0;
+  double p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+  double appP99 = 0.0;
+};
+
+double Percentile(std::vector<float>& sorted, double q) {
+  if (sorted.empty()) return 0.0;
+  return sorted[std::min(sorted.size() - 1, static_cast<size_t>(q * sorted.size()))];
+}
+
+OperationStats Summarize(const std::vector<Sample>& samples) {
+  OperationStats stats;
+  std::vector<float> latencies;
+  std::vector<float> app;
+  latencies.reserve(samples.size());
+  app.reserve(samples.size());
+  for (const auto& sample : samples) {
+    latencies.push_back(sample.latencyMs);
+    app.push_back(sample.appMs);
+    if (!sample.ok) stats.failures++;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  std::sort(app.begin(), app.end());
+  stats.count = samples.size();
+  stats.p50 = Percentile(latencies, 0.50);
+  stats.p95 = Percentile(latencies, 0.95);
+  stats.p99 = Percentile(latencies, 0.99);
+  stats.max = latencies.empty() ? 0.0 : latencies.back();
+  stats.appP99 = Percentile(app, 0.99);
+  return stats;
+}
+
+// Discards the controllers' console logging unless --verbose
+class NullBuffer : public std::streambuf {
+protected:
+  int overflow(int c) override { return traits_type::not_eof(c); }
+};
+
+class ConsoleRedirect {
+public:
+  explicit ConsoleRedirect(bool verbose) : m_console(std::cout.rdbuf()), m_verbose(verbose) {}
+  ~ConsoleRedirect() { Restore(); }
+
+  void Quiet() {
+    if (!m_verbose) std::cout.rdbuf(&m_null);
+  }
+  void Restore() { std::cout.rdbuf(m_console); }
+
+private:
+  std::streambuf* m_console;
+  NullBuffer m_null;
+  bool m_verbose;
+};
+
+// Devices go round-robin to "station-1".."station-N"; a single station stays unnamed
+nlohmann::json BuildDeviceConfig(int hexapods, int gantries, int stations) {
+  nlohmann::json devices = nlohmann::json::object();
+  char name[32];
+  for (int i = 0; i < hexapods; i++) {
+    std::snprintf(name, sizeof(name), "sim-hex-%02d", i + 1);
+    devices[name] = { { "Id", i }, { "IpAddress", "10.99.0." + std::to_string(10 + i) }, { "IsEnabled", true },
+      { "Name", name }, { "Port", 50000 }, { "installAxes", "X Y Z U V W" }, { "typeController", "PI" } };
+    if (stations > 1) devices[name]["Station"] = "station-" + std::to_string(i % stations + 1);
+  }
+  for (int i = 0; i < gantries; i++) {
+    std::snprintf(name, sizeof(name), "sim-gantry-%02d", i + 1);
+    devices[name] = { { "Id", 100 + i }, { "IpAddress", "10.99.1." + std::to_string(10 + i) }, { "IsEnabled", true },
+      { "Name", name }, { "Port", 701 }, { "installAxes", "X Y Z" }, { "typeController", "ACS" } };
+    if (stations > 1) devices[name]["Station"] = "station-" + std::to_string(i % stations + 1);
+  }
+  return { { "MotionDevices", devices } };
+}
+
+// === NUMERIC KERNELS ===
+
+// The AVX2 and scalar CouplingModel paths must agree, and the LM fit must find a
+// known peak - checked before the soak so a kernel regression fails fast
+bool CheckCouplingKernels(unsigned int seed, std::ostream& report) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> offset(-0.02, 0.02);
+  bool ok = true;
+
+  // Parity: counts around the 4-wide vector step exercise the scalar tail
+  double worstEvaluate = 0.0;
+  for (auto shape : { CouplingModel::Shape::Gaussian, CouplingModel::Shape::Lorentzian }) {
+    for (int dims = 1; dims <= CouplingModel::kMaxDims; dims++) {
+      for (size_t count : { 1, 3, 4, 5, 7, 64, 1001 }) {
+        CouplingModel::Model model;
+        model.shape = shape;
+        model.dims = dims;
+        model.peak = 0.8;
+        model.background = 0.05;
+        std::vector<std::vector<double>> axes(dims, std::vector<double>(count));
+        const double* coords[CouplingModel::kMaxDims] = {};
+        for (int d = 0; d < dims; d++) {
+          model.center[d] = offset(rng) * 0.1;
+          for (auto& value : axes[d]) value = offset(rng);
+          coords[d] = axes[d].data();
+        }
+
+        std::vector<double> batch(count), scalar(count);
+        CouplingModel::EvaluateBatch(model, coords, count, batch.data());
+        CouplingModel::EvaluateBatchScalar(model, coords, count, scalar.data());
+        for (size_t i = 0; i < count; i++) {
+          worstEvaluate = std::max(worstEvaluate, std::abs(batch[i] - scalar[i]) / model.peak);
+        }
+      }
+    }
+  }
+
+  CouplingModel::SampledMap map(-0.01, -0.01, 0.0005, 0.0005, 41, 37);
+  map.Fill(CouplingModel::Model());
+  const size_t mapCount = 1003;   // Some points outside the grid to exercise the clamp
+  std::vector<double> x(mapCount), y(mapCount), batch(mapCount);
+  for (size_t i = 0; i < mapCount; i++) {
+    x[i] = offset(rng);
+    y[i] = offset(rng);
+  }
+  map.SampleBatch(x.data(), y.data(), mapCount, batch.data());
+  double worstSample = 0.0;
+  for (size_t i = 0; i < mapCount; i++) {
+    worstSample = std::max(worstSample, std::abs(batch[i] - map.Sample(x[i], y[i])));
+  }
+
+  constexpr double kParityTolerance = 1e-12;   // Vector exp is good to ~1e-14 relative
+  report << "🧮 Coupling kernels (" << CouplingModel::KernelName() << "): EvaluateBatch max deviation "
+    << worstEvaluate << ", SampleBatch " << worstSample << std::endl;
+  if (!CouplingModel::HasAVX2()) {
+    report << "   No AVX2 on this CPU - only the scalar path ran" << std::endl;
+  }
+  if (worstEvaluate > kParityTolerance || worstSample > kParityTolerance) {
+    report << "❌ Vector and scalar kernels disagree" << std::endl;
+    ok = false;
+  }
+
+  // Fit: 15 x 15 grid over a known Gaussian with 0.2 % noise
+  CouplingModel::Model truth;
+  truth.peak = 0.8;
+  truth.background = 0.05;
+  truth.center[0] = 0.0012;
+  truth.center[1] = -0.0007;
+  truth.width[0] = 0.004;
+  truth.width[1] = 0.005;
+
+  std::normal_distribution<double> noise(0.0, 0.002 * truth.peak);
+  std::vector<double> gx, gy, values;
+  for (int iy = 0; iy < 15; iy++) {
+    for (int ix = 0; ix < 15; ix++) {
+      gx.push_back(-0.007 + 0.001 * ix);
+      gy.push_back(-0.007 + 0.001 * iy);
+    }
+  }
+  const double* grid[2] = { gx.data(), gy.data() };
+  values.resize(gx.size());
+  CouplingModel::EvaluateBatch(truth, grid, gx.size(), values.data());
+  for (auto& value : values) value += noise(rng);
+
+  const CouplingModel::Model guess = CouplingModel::InitialGuess(truth.shape, 2, grid, values.data(), values.size());
+  const CouplingModel::FitResult fit = CouplingModel::FitPeak(guess, grid, values.data(), values.size());
+  double worstCenter = 0.0;
+  double worstWidth = 0.0;
+  for (int d = 0; d < 2; d++) {
+    worstCenter = std::max(worstCenter, std::abs(fit.model.center[d] - truth.center[d]));
+    worstWidth = std::max(worstWidth, std::abs(fit.model.width[d] / truth.width[d] - 1.0));
+  }
+  report << "🎯 Peak fit: " << (fit.converged ? "converged" : "NOT converged") << " in " << fit.iterations
+    << " iterations, centre error " << worstCenter * 1e6 << " nm (sigma " << fit.centerSigma[0] * 1e6
+    << " nm), width error " << worstWidth * 100.0 << " %" << std::endl;
+  if (!fit.converged || worstCenter > 2e-5 || worstWidth > 0.02) {
+    report << "❌ Fit missed the synthetic peak" << std::endl;
+    ok = false;
+  }
+  return ok;
+}
+
+// === CELL AND WORKERS ===
+
+struct Cell {
+  std::unique_ptr<MotionCell> motion;
+  std::vector<std::unique_ptr<Station>> stations;   // Workers keep references
+  size_t hexapods = 0;
+  size_t gantries = 0;
+  double connectSeconds = 0.0;
+  int telemetryRejected = 0;   // Devices that connected without a telemetry slot
+  int watchdogRejected = 0;    // Devices that connected without a watchdog channel
+};
+
+Cell OpenCell(ConfigManager& configManager, const SoakOptions& options, int stations, int hexapods, int gantries) {
+  configManager.SetConfig(ConfigRegistry::Files::MOTION_DEVICES, BuildDeviceConfig(hexapods, gantries, stations));   // Never saved
+
+  Cell cell;
+  MotionCell::Settings settings;
+  settings.ioThreads = options.ioThreads;
+  cell.motion = std::make_unique<MotionCell>(configManager, settings);
+
+  const int rejectedBefore = TelemetrySegment::Instance().GetRejectedMotionSlots();
+  const int unwatchedBefore = HealthWatchdog::Instance().GetRejectedRegistrations();
+  const auto connectStart = std::chrono::steady_clock::now();
+  cell.motion->Initialize();
+  cell.motion->ConnectAll();
+  cell.connectSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - connectStart).count();
+  cell.telemetryRejected = TelemetrySegment::Instance().GetRejectedMotionSlots() - rejectedBefore;
+  cell.watchdogRejected = HealthWatchdog::Instance().GetRejectedRegistrations() - unwatchedBefore;
+
+  for (const auto& name : cell.motion->GetStationNames()) {
+    auto station = std::make_unique<Station>();
+    PIControllerManagerStandardized* piManager = cell.motion->PI(name);
+    for (const auto& device : piManager->GetConnectedDeviceNames()) {
+      if (PIController* hexapod = piManager->GetDevice(device)) {
+        station->hexapods.push_back({ hexapod, std::make_unique<std::mutex>() });
+      }
+    }
+    ACSControllerManagerStandardized* acsManager = cell.motion->ACS(name);
+    for (const auto& device : acsManager->GetDeviceNames()) {
+      ACSController* gantry = acsManager->GetDevice(device);
+      if (gantry && gantry->IsConnected()) {
+        station->gantries.push_back({ gantry, std::make_unique<std::mutex>() });
+      }
+    }
+    cell.hexapods += station->hexapods.size();
+    cell.gantries += station->gantries.size();
+    cell.stations.push_back(std::move(station));
+  }
+  return cell;
+}
+
+// Worker i drives station i % stations
+class WorkerPool {
+public:
+  ~WorkerPool() { Join(); }
+
+  void Start(const Cell& cell, int count, unsigned int seed) {
+    for (int i = 0; i < count; i++) {
+      m_logs.push_back(std::make_unique<SampleLog>());
+      const Station& station = *cell.stations[i % cell.stations.size()];
+      m_threads.emplace_back(WorkerThreadFunc, std::cref(station), seed * 1000u + i,
+        std::ref(*m_logs.back()), std::cref(m_stop));
+    }
+  }
+
+  void DrainInto(std::vector<Sample> (&out)[OperationCount]) {
+    for (auto& log : m_logs) {
+      log->DrainInto(out);
+    }
+  }
+
+  void Join() {
+    m_stop = true;
+    for (auto& thread : m_threads) {
+      thread.join();
+    }
+    m_threads.clear();
+  }
+
+private:
+  std::vector<std::unique_ptr<SampleLog>> m_logs;
+  std::vector<std::thread> m_threads;
+  std::atomic<bool> m_stop{ false };
+};
+
+void SleepUnlessStopped(std::chrono::steady_clock::time_point until) {
+  while (!g_stopRequested && std::chrono::steady_clock::now() < until) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
+// === SOAK ===
+
+int RunSoak(const SoakOptions& options, ConfigManager& configManager, std::ostream& report, ConsoleRedirect& console) {
+  Cell cell = OpenCell(configManager, options, options.stations, options.hexapods, options.gantries);
+
+  console.Restore();
+  report << "🔌 Connected " << cell.hexapods << "/" << options.hexapods << " hexapods, "
+    << cell.gantries << "/" << options.gantries << " gantries on " << cell.stations.size() << " stations in "
+    << std::fixed << std::setprecision(2) << cell.connectSeconds << " s" << std::endl;
+  if (cell.hexapods == 0 && cell.gantries == 0) {
+    report << "❌ Nothing connected - aborting" << std::endl;
+    return 1;
+  }
+  if (cell.telemetryRejected > 0) {
+    report << "❌ " << cell.telemetryRejected << " devices got no telemetry slot (" << Telemetry::kMaxMotionSlots
+      << " available) - aborting" << std::endl;
+    return 1;
+  }
+  if (cell.watchdogRejected > 0) {
+    report << "❌ " << cell.watchdogRejected << " devices got no watchdog channel (" << HealthWatchdog::MAX_CHANNELS
+      << " available) - aborting" << std::endl;
+    return 1;
+  }
+  console.Quiet();
+
+  std::ofstream csv(options.csvPath);
+  csv << std::fixed << "elapsed_s,operation,count,failures,ops_per_s,p50_ms,p95_ms,p99_ms,max_ms,app_p99_ms,"
+    << "threads,rss_mb,vendor_calls_per_s,wire_wait_ms,heap_allocs_per_s,lock_wait_ms" << std::endl;
+
+  // === RUN ===
+  WorkerPool workers;
+  workers.Start(cell, options.workers, options.seed);
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(options.hours * 3600.0));
+  const ProcessMetrics baseline = ReadProcessMetrics();
+  SimulatedHardware::Stats lastSim = SimulatedHardware::Instance().GetStats();
+  uint64_t lastAllocations = AllocationTracker::GetTotalCounters().allocations;
+  double lastLockWait = LockProfiler::GetTotals().waitSeconds;
+  auto lastReport = start;
+
+  size_t totals[OperationCount] = { 0 };
+  size_t totalFailures[OperationCount] = { 0 };
+  double worstP99[OperationCount] = { 0.0 };
+  int peakThreads = baseline.threads;
+  ProcessMetrics metrics = baseline;
+
+  while (!g_stopRequested && std::chrono::steady_clock::now() < end) {
+    SleepUnlessStopped(std::min(lastReport + std::chrono::seconds(options.reportSeconds), end));
+
+    const auto now = std::chrono::steady_clock::now();
+    const double interval = std::chrono::duration<double>(now - lastReport).count();
+    const double elapsed = std::chrono::duration<double>(now - start).count();
+    lastReport = now;
+
+    std::vector<Sample> samples[OperationCount];
+    workers.DrainInto(samples);
+
+    metrics = ReadProcessMetrics();
+    peakThreads = std::max(peakThreads, metrics.threads);
+    const SimulatedHardware::Stats sim = SimulatedHardware::Instance().GetStats();
+    const double callsPerSecond = (sim.calls - lastSim.calls) / interval;
+    const double wireWaitMs = (sim.wireWaitSeconds - lastSim.wireWaitSeconds) * 1000.0;
+    lastSim = sim;
+    const uint64_t allocations = AllocationTracker::GetTotalCounters().allocations;
+    const double allocationsPerSecond = (allocations - lastAllocations) / interval;
+    lastAllocations = allocations;
+    const double lockWait = LockProfiler::GetTotals().waitSeconds;
+    const double lockWaitMs = (lockWait - lastLockWait) * 1000.0;
+    lastLockWait = lockWait;
+
+    report << "\n⏱️  " << std::setprecision(0) << elapsed << " s | threads " << metrics.threads
+      << " | RSS " << std::setprecision(1) << metrics.residentMB << " MB (" << std::showpos
+      << metrics.residentMB - baseline.residentMB << std::noshowpos << ") | controller calls "
+      << std::setprecision(0) << callsPerSecond << "/s | wire wait " << std::setprecision(1) << wireWaitMs << " ms";
+    if (LockProfiler::IsEnabled()) {
+      report << " | lock wait " << lockWaitMs << " ms";
+    }
+    report << std::endl;
+    report << "  operation     ops/s    p50 ms   p95 ms   p99 ms   max ms  app p99  fail" << std::endl;
+
+    for (int i = 0; i < OperationCount; i++) {
+      const OperationStats stats = Summarize(samples[i]);
+      totals[i] += stats.count;
+      totalFailures[i] += stats.failures;
+      worstP99[i] = std::max(worstP99[i], stats.p99);
+      if (stats.count == 0) continue;
+
+      report << "  " << std::left << std::setw(11) << kOperationNames[i] << std::right << std::setprecision(1)
+        << std::setw(8) << stats.count / interval << std::setprecision(2)
+        << std::setw(9) << stats.p50 << std::setw(9) << stats.p95 << std::setw(9) << stats.p99
+        << std::setw(9) << stats.max << std::setw(9) << stats.appP99 << std::setw(6) << stats.failures << std::endl;
+
+      csv << std::setprecision(1) << elapsed << "," << kOperationNames[i] << "," << stats.count << ","
+        << stats.failures << "," << std::setprecision(2) << stats.count / interval << ","
+        << std::setprecision(3) << stats.p50 << "," << stats.p95 << "," << stats.p99 << "," << stats.max << ","
+        << stats.appP99 << "," << metrics.threads << "," << std::setprecision(1) << metrics.residentMB << ","
+        << std::setprecision(0) << callsPerSecond << "," << std::setprecision(1) << wireWaitMs << ","
+        << std::setprecision(0) << allocationsPerSecond << "," << std::setprecision(1) << lockWaitMs << std::endl;
+    }
+  }
+
+  // === SHUTDOWN ===
+  workers.Join();
+  const double hours = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 3600.0;
+
+  cell.stations.clear();
+  cell.motion.reset();
+  HealthWatchdog::Instance().Stop();
+  console.Restore();
+
+  report << "\n=== Soak Summary (" << std::setprecision(2) << hours << " h) ===" << std::endl;
+  bool failed = false;
+  for (int i = 0; i < OperationCount; i++) {
+    if (totals[i] == 0) continue;
+    report << "  " << std::left << std::setw(11) << kOperationNames[i] << std::right << std::setw(10) << totals[i]
+      << " ops, " << totalFailures[i] << " failed, worst interval p99 " << worstP99[i] << " ms" << std::endl;
+    failed |= totalFailures[i] > 0;
+  }
+  report << "  Threads: " << baseline.threads << " at start, peak " << peakThreads << std::endl;
+  report << "  RSS: " << std::setprecision(1) << baseline.residentMB << " -> " << metrics.residentMB << " MB ("
+    << std::showpos << (hours > 0.0 ? (metrics.residentMB - baseline.residentMB) / hours : 0.0) << std::noshowpos
+    << " MB/h)" << std::endl;
+  report << "  Results: " << options.csvPath << std::endl;
+  if (LockProfiler::IsEnabled()) {
+    const std::string tracePath = options.csvPath + ".locks.json";
+    report << std::endl;
+    LockProfiler::Report(report);
+    if (LockProfiler::ExportTrace(tracePath)) {
+      report << "  Lock trace: " << tracePath << std::endl;
+    }
+  }
+  report << (failed ? "⚠️  Some operations failed" : "✅ No failed operations") << std::endl;
+  return failed ? 2 : 0;
+}
+
+// === SCALING BENCHMARK ===
+
+// Same per-station load on 1..N stations in one process. With no shared
+// bottleneck, throughput grows linearly: efficiency = ops(N) / (N * ops(1)).
+int RunScaling(const SoakOptions& options, ConfigManager& configManager, std::ostream& report, ConsoleRedirect& console) {
+  report << "📈 Scaling 1.." << options.scaling << " stations, " << options.stepSeconds << " s each - per station "
+    << options.hexapods << " hexapods, " << options.gantries << " gantries, " << options.workers << " workers" << std::endl;
+  report << "  stations  devices  threads      ops/s  per station  efficiency  pi.move p99  start delay  fail" << std::endl;
+
+  std::ofstream csv(options.csvPath);
+  csv << std::fixed << "stations,hexapods,gantries,workers,threads,ops_per_s,ops_per_s_per_station,efficiency,"
+    << "pi_move_p99_ms,acs_move_p99_ms,io_start_delay_ms,failures" << std::endl;
+
+  double singleStation = 0.0;
+  bool failed = false;
+  for (int stations = 1; stations <= options.scaling && !g_stopRequested; stations++) {
+    console.Quiet();
+    Cell cell = OpenCell(configManager, options, stations, options.hexapods * stations, options.gantries * stations);
+
+    WorkerPool workers;
+    workers.Start(cell, options.workers * stations, options.seed + stations);
+
+    // Warm-up, so first moves and settle polling are not counted
+    std::vector<Sample> warmup[OperationCount];
+    SleepUnlessStopped(std::chrono::steady_clock::now() + std::chrono::seconds(1));
+    workers.DrainInto(warmup);
+
+    const auto start = std::chrono::steady_clock::now();
+    SleepUnlessStopped(start + std::chrono::seconds(options.stepSeconds));
+    std::vector<Sample> samples[OperationCount];
+    workers.DrainInto(samples);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const ProcessMetrics metrics = ReadProcessMetrics();
+    const double startDelayMs = cell.motion->GetExecutor() ? cell.motion->GetExecutor()->GetStats().maxLatenessMs : 0.0;
+
+    workers.Join();
+    cell.stations.clear();
+    cell.motion.reset();
+    console.Restore();
+
+    size_t operations = 0;
+    size_t failures = 0;
+    for (int i = 0; i < OperationCount; i++) {
+      operations += samples[i].size();
+      for (const auto& sample : samples[i]) {
+        if (!sample.ok) failures++;
+      }
+    }
+    failed |= failures > 0;
+    if (cell.telemetryRejected > 0) {
+      report << "❌ " << cell.telemetryRejected << " devices got no telemetry slot (" << Telemetry::kMaxMotionSlots
+        << " available)" << std::endl;
+      failed = true;
+    }
+    if (cell.watchdogRejected > 0) {
+      report << "❌ " << cell.watchdogRejected << " devices got no watchdog channel (" << HealthWatchdog::MAX_CHANNELS
+        << " available)" << std::endl;
+      failed = true;
+    }
+
+    const double opsPerSecond = operations / seconds;
+    if (stations == 1) singleStation = opsPerSecond;
+    const double efficiency = singleStation > 0.0 ? opsPerSecond / (stations * singleStation) : 0.0;
+    const double piMoveP99 = Summarize(samples[PIMove]).p99;
+    const double acsMoveP99 = Summarize(samples[ACSMove]).p99;
+
+    report << std::fixed << std::setw(10) << stations << std::setw(9) << cell.hexapods + cell.gantries
+      << std::setw(9) << metrics.threads << std::setprecision(1) << std::setw(11) << opsPerSecond
+      << std::setw(13) << opsPerSecond / stations << std::setw(11) << efficiency * 100.0 << "%"
+      << std::setprecision(2) << std::setw(10) << piMoveP99 << " ms" << std::setw(10) << startDelayMs << " ms"
+      << std::setw(6) << failures << std::endl;
+
+    csv << stations << "," << cell.hexapods << "," << cell.gantries << "," << options.workers * stations << ","
+      << metrics.threads << "," << std::setprecision(2) << opsPerSecond << "," << opsPerSecond / stations << ","
+      << std::setprecision(3) << efficiency << "," << piMoveP99 << "," << acsMoveP99 << "," << startDelayMs << ","
+      << failures << std::endl;
+  }
+
+  HealthWatchdog::Instance().Stop();
+  report << "  Results: " << options.csvPath << std::endl;
+  report << (failed ? "⚠️  Some operations failed" : "✅ No failed operations") << std::endl;
+  return failed ? 2 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  SoakOptions options;
+  if (!ParseArguments(argc, argv, options)) {
+    std::cerr << "Usage: TestSoak [--hexapods N] [--gantries N] [--workers N] [--hours H] [--report-seconds S]"
+      << " [--latency-us U] [--jitter-us U] [--stations N] [--io-threads N] [--scaling N] [--step-seconds S]"
+      << " [--csv path] [--seed N] [--kernels] [--verbose]" << std::endl;
+    return 1;
+  }
+
+  // Reports always reach the console; controller logging only with --verbose
+  std::ostream report(std::cout.rdbuf());
+  ConsoleRedirect console(options.verbose);
+
+  report << "=== Soak Test - Simulated Hardware ===" << std::endl;
+  if (!CheckCouplingKernels(options.seed, report)) {
+    return 1;
+  }
+  if (options.kernelsOnly) {
+    return 0;
+  }
+  if (options.scaling == 0) {
+    report << "🧪 " << options.hexapods << " hexapods, " << options.gantries << " gantries, "
+      << options.workers << " workers, " << options.hours << " h, link latency "
+      << options.latencyUs << " us (+" << options.jitterUs << " us jitter)" << std::endl;
+  }
+  report << "🧵 Controller polling: " << (options.ioThreads < 0 ? "a thread per controller"
+    : options.ioThreads == 0 ? "shared I/O threads, one per station" : std::to_string(options.ioThreads) + " shared I/O threads")
+    << std::endl;
+
+  std::signal(SIGINT, OnSignal);
+
+  SimulatedHardware::Settings settings;
+  settings.callLatency = std::chrono::microseconds(options.latencyUs);
+  settings.callJitter = std::chrono::microseconds(options.jitterUs);
+  SimulatedHardware::Instance().SetSettings(settings);
+
+  // === SETUP - same order as the application ===
+  console.Quiet();
+
+  auto loggerAdapter = std::make_unique<LoggerAdapter>();
+  auto& configManager = ConfigManager::Instance();
+  configManager.SetLogger(loggerAdapter.get());
+  configManager.SetConfigDirectory("config");
+  ThreadPolicy::LoadFromFile("config/thread_policy.json");
+  TelemetrySegment::Instance().Open();
+  HealthWatchdog::Instance().Start();
+
+  return options.scaling > 0
+    ? RunScaling(options, configManager, report, console)
+    : RunSoak(options, configManager, report, console);
+}
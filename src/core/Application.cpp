@@ -9,9 +9,16 @@
 #include "../core/ServiceLocator.h"  // Use ServiceLocator instead of UniversalServices
 #include "../devices/motions/PIControllerManagerStandardized.h"
 #include "../devices/motions/ACSControllerManagerStandardized.h"
+#include "../devices/motions/HomingOrchestrator.h"
 #include "../core/ConfigManager.h"     // For ConfigManager
 #include "../core/ConfigRegistry.h"
+#include "../core/TelemetrySegment.h"
+#include "../core/HealthWatchdog.h"
 #include "../utils/LoggerAdapter.h"
+#include "../utils/AllocationTracker.h"
+#include "../utils/ProfiledMutex.h"
+#include "../utils/ThreadPolicy.h"
+#include "../ui/JogInput.h"
 #include <GL/gl.h>
 #include <thread>
 
@@ -37,6 +44,7 @@ bool Application::Initialize() {
 void Application::Run() {
   running = true;
   Logger::Info(L"Starting main application loop");
+  ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::UI, "UI");
 
   // **STEP 1**: Render home page first
   RenderInitialHomePage();
@@ -44,11 +52,20 @@ void Application::Run() {
   // **STEP 2**: AFTER home page is shown, initialize services (ConfigManager + Motion managers)
   InitializeServices();
 
+  // Watch the render loop too - alarm only, there is nothing safe to restart from here
+  HealthWatchdog::ChannelOptions uiOptions;
+  uiOptions.deadline = std::chrono::milliseconds(500);
+  m_uiWatchdogId = HealthWatchdog::Instance().Register("UI:RenderLoop", uiOptions);
+
   // **STEP 3**: Main loop
   while (running && !ShouldClose()) {
+    HealthWatchdog::Instance().Heartbeat(m_uiWatchdogId);
     ProcessEvents();
     Render();
 
+    // Jog buttons were collected while rendering - send this frame's jog velocities
+    JogInput::Instance().Update();
+
     // Small delay to prevent excessive CPU usage
     SDL_Delay(16); // ~60 FPS
   }
@@ -89,6 +106,9 @@ void Application::InitializeServices() {
     ServiceLocator::Get().RegisterConfigManager(&configManager);
     Logger::Success(L"✅ ConfigManager registered as service");
 
+    // Thread classes must be configured before any device thread starts
+    ThreadPolicy::LoadFromFile("config/thread_policy.json");
+
     // Load configurations through the service
     ConfigLogger::ConfigTestStart();
     if (ConfigRegistry::LoadMotionConfigs()) {
@@ -98,6 +118,18 @@ void Application::InitializeServices() {
       ConfigLogger::ConfigError("Motion configurations", "Failed to load some configs");
     }
 
+    // Open the telemetry segment before any controller connects so every
+    // comm thread gets a slot for external analysis tools
+    if (TelemetrySegment::Instance().Open()) {
+      Logger::Success(L"✅ Telemetry segment published");
+    }
+    else {
+      Logger::Warning(L"⚠️ Telemetry segment unavailable - external tools will not see live data");
+    }
+
+    // Start deadline monitoring before any comm thread exists
+    HealthWatchdog::Instance().Start();
+
     // ========================================================================
     // STEP 2: Create Motion Managers (they get ConfigManager via ServiceLocator)
     // ========================================================================
@@ -142,11 +174,25 @@ void Application::InitializeServices() {
       // Continue without ACS manager
     }
 
+    // Machine homing runs the phased plan over whichever managers exist
+    if (m_piManager || m_acsManager) {
+      m_homing = std::make_unique<HomingOrchestrator>(m_acsManager.get(), m_piManager.get());
+      if (m_homing->LoadPlan(ConfigManager::Instance().GetConfig(ConfigRegistry::Files::HOMING))) {
+        ServiceLocator::Get().RegisterHoming(m_homing.get());
+        Logger::Success(L"✅ Homing plan loaded and registered");
+      }
+      else {
+        Logger::Warning(L"⚠️ Homing plan invalid - machine homing unavailable");
+        m_homing.reset();
+      }
+    }
+
     // ========================================================================
     // STEP 3: Print Service Status
     // ========================================================================
     Logger::Info(L"📊 Service Registration Complete:");
     ServiceLocator::Get().PrintStatus();
+    ThreadPolicy::PrintReport(std::cout);
 
     // ========================================================================
     // STEP 4: Initialize All Services
@@ -165,6 +211,7 @@ void Application::InitializeServices() {
     // ========================================================================
     if (ServiceLocator::Get().HasPI() || ServiceLocator::Get().HasACS()) {
       std::thread hardwareThread([this]() {
+        ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::Background, "Motion connect");
         Logger::Info(L"🔗 Connecting to motion hardware in background...");
 
         bool connected = ServiceLocator::Get().ConnectAllMotion();
@@ -300,6 +347,12 @@ void Application::ProcessEvents() {
 void Application::HandleWindowEvent(const SDL_WindowEvent& windowEvent) {
   Uint32 windowID = windowEvent.windowID;
 
+  // Losing focus stops any jog in progress
+  SDL_Event jogEvent;
+  jogEvent.type = SDL_WINDOWEVENT;
+  jogEvent.window = windowEvent;
+  JogInput::Instance().HandleEvent(jogEvent);
+
   if (window1 && windowID == window1->GetWindowID()) {
     window1->MakeContextCurrent();
     ImGui::SetCurrentContext(imgui_context1);
@@ -342,6 +395,9 @@ void Application::HandleGlobalEvent(const SDL_Event& event) {
     ImGui_ImplSDL2_ProcessEvent(&event);
   }
 
+  // Gamepad hot-plug
+  JogInput::Instance().HandleEvent(event);
+
   if (event.type == SDL_QUIT) {
     running = false;
   }
@@ -395,6 +451,9 @@ void Application::Cleanup() {
   // ========================================================================
   if (ServiceLocator::Get().HasPI() || ServiceLocator::Get().HasACS()) {
     Logger::Info(L"🛑 Stopping and disconnecting motion services...");
+    JogInput::Instance().StopAll();
+    ServiceLocator::Get().RegisterHoming(nullptr);
+    m_homing.reset();   // Aborts a running plan while the devices are still connected
 
     // Use ServiceLocator batch operations for clean shutdown
     ServiceLocator::Get().DisconnectAllMotion();
@@ -420,6 +479,14 @@ void Application::Cleanup() {
     Logger::Success(L"Motion services cleaned up safely");
   }
 
+  // Controllers have unregistered their channels - stop monitoring
+  HealthWatchdog::Instance().Unregister(m_uiWatchdogId);
+  m_uiWatchdogId = -1;
+  HealthWatchdog::Instance().Stop();
+
+  // Controllers have released their slots - unpublish the segment
+  TelemetrySegment::Instance().Close();
+
   // ========================================================================
   // CLEANUP IMGUI CONTEXTS
   // ========================================================================
@@ -454,5 +521,19 @@ void Application::Cleanup() {
   uiRenderer2.reset();
 
   SDL_Quit();
+
+  // Only populated in PROJECT4_TRACK_ALLOCATIONS builds
+  if (AllocationTracker::IsEnabled()) {
+    AllocationTracker::Report(std::cout);
+  }
+
+  // Only populated in PROJECT4_PROFILE_LOCKS builds
+  if (LockProfiler::IsEnabled()) {
+    LockProfiler::Report(std::cout);
+    if (LockProfiler::ExportTrace("lock_trace.json")) {
+      std::cout << "LockProfiler: Trace written to lock_trace.json" << std::endl;
+    }
+  }
+
   Logger::Success(L"Application cleanup complete");
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 // Forward declarations for managers - NO direct dependencies!
 class PIControllerManagerStandardized;
 class ACSControllerManagerStandardized;
+class HomingOrchestrator;
 // ConfigManager is accessed via ServiceLocator, no forward declaration needed
 
 /**
@@ -70,6 +71,7 @@ private:
   // STATE
   // ========================================================================
   std::atomic<bool> running;
+  int m_uiWatchdogId = -1;  // Render loop heartbeat channel
 
   // ========================================================================
   // CORE SYSTEMS
@@ -101,6 +103,9 @@ private:
   std::unique_ptr<PIControllerManagerStandardized> m_piManager;
   std::unique_ptr<ACSControllerManagerStandardized> m_acsManager;
 
+  // Machine homing across both managers - destroyed before them
+  std::unique_ptr<HomingOrchestrator> m_homing;
+
   // NOTE: ConfigManager is NOT stored here - it's a singleton accessed via ServiceLocator
   // NOTE: All access to services goes through ServiceLocator::Get().Service()
 
@@ -0,0 +1,377 @@
+// ConfigCache.cpp - Compiled binary form of the JSON configuration files
+#include "ConfigCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(ConfigCache::Header) == 56, "Cache header layout changed");
+static_assert(sizeof(ConfigCache::PositionRecord) == 128, "Position record layout changed");
+
+namespace {
+  uint64_t AlignUp(uint64_t value) {
+    return (value + 7) & ~static_cast<uint64_t>(7);
+  }
+
+  int CompareRecord(const ConfigCache::PositionRecord& record, const char* device, const char* name) {
+    int result = std::strncmp(record.device, device, ConfigCache::kMaxDeviceName);
+    return result != 0 ? result : std::strncmp(record.name, name, ConfigCache::kMaxPositionName);
+  }
+}
+
+// ============================================================================
+// MAPPED FILE
+// ============================================================================
+
+class ConfigCache::MappedFile {
+public:
+  ~MappedFile() { Close(); }
+
+  bool Open(const std::string& path) {
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+      nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+      return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+      Close();
+      return false;
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr) {
+      Close();
+      return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    m_fd = ::open(path.c_str(), O_RDONLY);
+    if (m_fd < 0) {
+      return false;
+    }
+
+    struct stat info;
+    if (fstat(m_fd, &info) != 0 || info.st_size == 0) {
+      Close();
+      return false;
+    }
+    m_size = static_cast<size_t>(info.st_size);
+
+    void* view = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    m_data = view == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(view);
+#endif
+    if (m_data == nullptr) {
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void Close() {
+#ifdef _WIN32
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+#else
+    if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+  }
+
+  const uint8_t* Data() const { return m_data; }
+  size_t Size() const { return m_size; }
+
+  const Header& GetHeader() const { return *reinterpret_cast<const Header*>(m_data); }
+
+  const PositionRecord* Positions() const {
+    return reinterpret_cast<const PositionRecord*>(m_data + GetHeader().positionOffset);
+  }
+
+private:
+#ifdef _WIN32
+  HANDLE m_file = INVALID_HANDLE_VALUE;
+  HANDLE m_mapping = nullptr;
+#else
+  int m_fd = -1;
+#endif
+  const uint8_t* m_data = nullptr;
+  size_t m_size = 0;
+};
+
+// ============================================================================
+// OPEN / COMPILE
+// ============================================================================
+
+ConfigCache::ConfigCache() = default;
+
+ConfigCache::~ConfigCache() {
+  ReleaseAll();
+}
+
+bool ConfigCache::Open(const std::string& key, const std::string& jsonPath,
+  nlohmann::json& parsed, bool& parsedNow) {
+  parsedNow = false;
+
+  std::string source;
+  if (!ReadSource(jsonPath, source)) {
+    return false;
+  }
+
+  const uint64_t hash = HashBytes(source.data(), source.size());
+  const std::string cachePath = CachePathFor(jsonPath);
+
+  // The old view must be gone before the file can be replaced on Windows
+  Release(key);
+  if (MapCacheFile(key, cachePath, hash, source.size())) {
+    return true;
+  }
+
+  // Missing or stale - parse once and rebuild
+  parsed = nlohmann::json::parse(source);
+  parsedNow = true;
+
+  if (WriteCacheFile(cachePath, parsed, hash, source.size()) &&
+    MapCacheFile(key, cachePath, hash, source.size())) {
+    std::cout << "ConfigCache: Compiled " << cachePath << std::endl;
+  }
+  else {
+    std::cout << "ConfigCache: Could not write " << cachePath << " - using JSON only" << std::endl;
+  }
+  return true;
+}
+
+bool ConfigCache::Compile(const std::string& key, const std::string& jsonPath, const nlohmann::json& document) {
+  std::string source;
+  if (!ReadSource(jsonPath, source)) {
+    return false;
+  }
+
+  const uint64_t hash = HashBytes(source.data(), source.size());
+  const std::string cachePath = CachePathFor(jsonPath);
+
+  Release(key);
+  return WriteCacheFile(cachePath, document, hash, source.size()) &&
+    MapCacheFile(key, cachePath, hash, source.size());
+}
+
+bool ConfigCache::MapCacheFile(const std::string& key, const std::string& cachePath,
+  uint64_t sourceHash, uint64_t sourceSize) {
+  auto file = std::make_unique<MappedFile>();
+  if (!file->Open(cachePath)) {
+    return false;
+  }
+
+  if (file->Size() < sizeof(Header)) {
+    return false;
+  }
+
+  const Header& header = file->GetHeader();
+  const uint64_t positionBytes = static_cast<uint64_t>(header.positionCount) * sizeof(PositionRecord);
+  if (header.magic != kMagic || header.version != kLayoutVersion ||
+    header.sourceHash != sourceHash || header.sourceSize != sourceSize ||
+    header.documentOffset + header.documentSize > file->Size() ||
+    header.positionOffset + positionBytes > file->Size()) {
+    return false;
+  }
+
+  m_files[key] = std::move(file);
+  return true;
+}
+
+bool ConfigCache::WriteCacheFile(const std::string& cachePath, const nlohmann::json& document,
+  uint64_t sourceHash, uint64_t sourceSize) {
+  try {
+    std::vector<uint8_t> encoded = nlohmann::json::to_msgpack(document);
+
+    std::vector<PositionRecord> positions;
+    if (!BuildPositionTable(document, positions)) {
+      positions.clear();
+    }
+
+    Header header = {};
+    header.magic = kMagic;
+    header.version = kLayoutVersion;
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+    header.documentOffset = AlignUp(sizeof(Header));
+    header.documentSize = encoded.size();
+    header.positionOffset = AlignUp(header.documentOffset + header.documentSize);
+    header.positionCount = static_cast<uint32_t>(positions.size());
+
+    std::vector<uint8_t> image(header.positionOffset + positions.size() * sizeof(PositionRecord), 0);
+    std::memcpy(image.data(), &header, sizeof(header));
+    std::memcpy(image.data() + header.documentOffset, encoded.data(), encoded.size());
+    if (!positions.empty()) {
+      std::memcpy(image.data() + header.positionOffset, positions.data(), positions.size() * sizeof(PositionRecord));
+    }
+
+    // Write beside the target and swap in, so a reader never sees half a file
+    const std::string tempPath = cachePath + ".tmp";
+    {
+      std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+      if (!out.is_open()) {
+        return false;
+      }
+      out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+      if (!out.good()) {
+        return false;
+      }
+    }
+
+    std::filesystem::rename(tempPath, cachePath);
+    return true;
+  }
+  catch (const std::exception& e) {
+    std::cout << "ConfigCache: Failed to write " << cachePath << ": " << e.what() << std::endl;
+    return false;
+  }
+}
+
+// Only documents shaped {device: {position: {x, y, z[, u, v, w]}}} get a table
+bool ConfigCache::BuildPositionTable(const nlohmann::json& document, std::vector<PositionRecord>& records) {
+  if (!document.is_object() || document.empty()) {
+    return false;
+  }
+
+  for (const auto& [device, positions] : document.items()) {
+    if (!positions.is_object() || device.size() >= kMaxDeviceName) {
+      return false;
+    }
+
+    for (const auto& [name, value] : positions.items()) {
+      if (!value.is_object() || name.size() >= kMaxPositionName ||
+        !value.contains("x") || !value["x"].is_number() ||
+        !value.contains("y") || !value["y"].is_number() ||
+        !value.contains("z") || !value["z"].is_number()) {
+        return false;
+      }
+
+      PositionRecord record = {};
+      std::memcpy(record.device, device.data(), device.size());
+      std::memcpy(record.name, name.data(), name.size());
+      record.x = value["x"].get<double>();
+      record.y = value["y"].get<double>();
+      record.z = value["z"].get<double>();
+      record.u = value.value("u", 0.0);
+      record.v = value.value("v", 0.0);
+      record.w = value.value("w", 0.0);
+      records.push_back(record);
+    }
+  }
+
+  std::sort(records.begin(), records.end(), [](const PositionRecord& a, const PositionRecord& b) {
+    return CompareRecord(a, b.device, b.name) < 0;
+  });
+  return !records.empty();
+}
+
+// ============================================================================
+// ACCESS
+// ============================================================================
+
+bool ConfigCache::IsOpen(const std::string& key) const {
+  return m_files.find(key) != m_files.end();
+}
+
+void ConfigCache::Release(const std::string& key) {
+  m_files.erase(key);
+}
+
+void ConfigCache::ReleaseAll() {
+  m_files.clear();
+}
+
+bool ConfigCache::Decode(const std::string& key, nlohmann::json& out) const {
+  auto it = m_files.find(key);
+  if (it == m_files.end()) {
+    return false;
+  }
+
+  try {
+    const MappedFile& file = *it->second;
+    const uint8_t* begin = file.Data() + file.GetHeader().documentOffset;
+    out = nlohmann::json::from_msgpack(begin, begin + file.GetHeader().documentSize);
+    return true;
+  }
+  catch (const std::exception& e) {
+    std::cout << "ConfigCache: Failed to decode " << key << ": " << e.what() << std::endl;
+    return false;
+  }
+}
+
+ConfigCache::Lookup ConfigCache::FindPosition(const std::string& key, const std::string& device,
+  const std::string& name, PositionRecord& out) const {
+  auto it = m_files.find(key);
+  if (it == m_files.end() || it->second->GetHeader().positionCount == 0) {
+    return Lookup::NoTable;
+  }
+
+  // Names that do not fit a record cannot be in the table
+  if (device.size() >= kMaxDeviceName || name.size() >= kMaxPositionName) {
+    return Lookup::NotFound;
+  }
+
+  const PositionRecord* first = it->second->Positions();
+  const PositionRecord* last = first + it->second->GetHeader().positionCount;
+  const PositionRecord* found = std::lower_bound(first, last, 0,
+    [&](const PositionRecord& record, int) { return CompareRecord(record, device.c_str(), name.c_str()) < 0; });
+
+  if (found == last || CompareRecord(*found, device.c_str(), name.c_str()) != 0) {
+    return Lookup::NotFound;
+  }
+
+  out = *found;
+  return Lookup::Found;
+}
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+uint64_t ConfigCache::HashBytes(const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string ConfigCache::CachePathFor(const std::string& jsonPath) {
+  return std::filesystem::path(jsonPath).replace_extension(".bin").string();
+}
+
+bool ConfigCache::ReadSource(const std::string& jsonPath, std::string& bytes) {
+  std::ifstream file(jsonPath, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  file.seekg(0, std::ios::end);
+  bytes.resize(static_cast<size_t>(file.tellg()));
+  file.seekg(0, std::ios::beg);
+  file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  return file.good() || file.eof();
+}
@@ -0,0 +1,97 @@
+// ConfigCache.h - Compiled binary form of the JSON configuration files
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "nlohmann/json.hpp"
+
+/**
+ * ConfigCache - Binary cache next to every JSON config (foo.json -> foo.bin)
+ *
+ * The JSON file stays the editable source of truth. On load its bytes are
+ * hashed (FNV-1a 64); when the .bin carries the same hash it is memory-mapped
+ * and used directly, otherwise the JSON is parsed once and the .bin rewritten.
+ *
+ * File layout (little-endian, 8-byte aligned sections):
+ *   Header          - magic, layout version, source hash/size, section offsets
+ *   Document        - MessagePack encoding of the whole JSON document
+ *   PositionRecord  - flat table sorted by (device, name), only present for
+ *                     position-shaped documents ({device: {name: {x,y,z,...}}})
+ *
+ * Position lookups binary-search the mapped table and never decode the
+ * document. Everything else is decoded from MessagePack on first use, which
+ * skips text tokenizing and number parsing but still builds the full DOM -
+ * about the cost of a text parse. Only positions are parse-free.
+ */
+class ConfigCache {
+public:
+  static constexpr uint32_t kMagic = 0x46433450;   // "P4CF"
+  static constexpr uint32_t kLayoutVersion = 1;
+  static constexpr size_t kMaxDeviceName = 32;
+  static constexpr size_t kMaxPositionName = 48;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+    uint64_t documentOffset;
+    uint64_t documentSize;
+    uint64_t positionOffset;
+    uint32_t positionCount;
+    uint32_t reserved;
+  };
+
+  struct PositionRecord {
+    char device[kMaxDeviceName];
+    char name[kMaxPositionName];
+    double x, y, z, u, v, w;
+  };
+
+  enum class Lookup {
+    Found,
+    NotFound,   // Table is authoritative - the position does not exist
+    NoTable     // File not cached or not position-shaped - use the JSON
+  };
+
+  ConfigCache();
+  ~ConfigCache();
+  ConfigCache(const ConfigCache&) = delete;
+  ConfigCache& operator=(const ConfigCache&) = delete;
+
+  // Make sure a current .bin exists for jsonPath and map it. The JSON is
+  // parsed only when the cache is missing or stale; it is then handed back
+  // through parsed (parsedNow = true) so the caller does not parse it again.
+  // Returns false only when the JSON file cannot be read.
+  bool Open(const std::string& key, const std::string& jsonPath, nlohmann::json& parsed, bool& parsedNow);
+
+  // Recompile after the JSON was written by us (no re-parse needed)
+  bool Compile(const std::string& key, const std::string& jsonPath, const nlohmann::json& document);
+
+  bool IsOpen(const std::string& key) const;
+  void Release(const std::string& key);
+  void ReleaseAll();
+
+  // Decode the full document from the mapped MessagePack section
+  bool Decode(const std::string& key, nlohmann::json& out) const;
+
+  Lookup FindPosition(const std::string& key, const std::string& device,
+    const std::string& name, PositionRecord& out) const;
+
+  static uint64_t HashBytes(const void* data, size_t size);
+  static std::string CachePathFor(const std::string& jsonPath);
+
+private:
+  class MappedFile;
+
+  static bool ReadSource(const std::string& jsonPath, std::string& bytes);
+  static bool WriteCacheFile(const std::string& cachePath, const nlohmann::json& document,
+    uint64_t sourceHash, uint64_t sourceSize);
+  static bool BuildPositionTable(const nlohmann::json& document, std::vector<PositionRecord>& records);
+  bool MapCacheFile(const std::string& key, const std::string& cachePath, uint64_t sourceHash, uint64_t sourceSize);
+
+  std::unordered_map<std::string, std::unique_ptr<MappedFile>> m_files;
+};
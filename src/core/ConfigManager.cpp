@@ -16,19 +16,33 @@ bool ConfigManager::LoadConfig(const std::string& filename) {
       return false;
     }
 
-    std::ifstream file(fullPath);
-    if (!file.is_open()) {
-      LogError("Failed to open config file: " + fullPath);
-      return false;
-    }
-
     nlohmann::json config;
-    file >> config;
-
-    // Cache the loaded config
-    m_configCache[filename] = config;
+    bool parsedNow = true;
+    if (UsesBinaryCache(filename)) {
+      if (!m_binaryCache.Open(filename, fullPath, config, parsedNow)) {
+        LogError("Failed to open config file: " + fullPath);
+        return false;
+      }
+    }
+    else {
+      std::ifstream file(fullPath);
+      if (!file.is_open()) {
+        LogError("Failed to open config file: " + fullPath);
+        return false;
+      }
+      file >> config;
+    }
 
-    LogInfo("Loaded config: " + filename);
+    if (parsedNow) {
+      // Cache was stale - keep the document we just parsed
+      m_configCache[filename] = config;
+      LogInfo("Loaded config: " + filename);
+    }
+    else {
+      // Decoded from the binary cache on first GetConfig
+      m_configCache.erase(filename);
+      LogInfo("Loaded config: " + filename + " (binary cache)");
+    }
     return true;
 
   }
@@ -42,6 +56,9 @@ bool ConfigManager::LoadConfig(const std::string& filename) {
 bool ConfigManager::SaveConfig(const std::string& filename) {
   auto it = m_configCache.find(filename);
   if (it == m_configCache.end()) {
+    if (m_binaryCache.IsOpen(filename)) {
+      return SaveConfig(filename, GetConfig(filename));
+    }
     LogError("Config not found in cache: " + filename);
     return false;
   }
@@ -65,9 +82,13 @@ bool ConfigManager::SaveConfig(const std::string& filename, const nlohmann::json
 
     // Pretty print with 2-space indentation
     file << data.dump(2);
+    file.close();
 
     // Update cache
     m_configCache[filename] = data;
+    if (UsesBinaryCache(filename) && !m_binaryCache.Compile(filename, fullPath, data)) {
+      LogWarning("Binary cache not updated for: " + filename);
+    }
 
     LogInfo("Saved config: " + filename);
     return true;
@@ -86,6 +107,12 @@ nlohmann::json ConfigManager::GetConfig(const std::string& filename) {
     return it->second;
   }
 
+  // Loaded from the binary cache but not decoded yet
+  nlohmann::json decoded;
+  if (m_binaryCache.Decode(filename, decoded)) {
+    return m_configCache[filename] = std::move(decoded);
+  }
+
   // Try to load if not in cache
   if (LoadConfig(filename)) {
     return m_configCache[filename];
@@ -99,17 +126,20 @@ nlohmann::json ConfigManager::GetConfig(const std::string& filename) {
 // Set configuration data
 void ConfigManager::SetConfig(const std::string& filename, const nlohmann::json& data) {
   m_configCache[filename] = data;
+  // The mapped position table no longer matches until the config is saved
+  m_binaryCache.Release(filename);
   LogInfo("Config updated in cache: " + filename);
 }
 
 // Check if config exists in cache
 bool ConfigManager::HasConfig(const std::string& filename) const {
-  return m_configCache.find(filename) != m_configCache.end();
+  return m_configCache.find(filename) != m_configCache.end() || m_binaryCache.IsOpen(filename);
 }
 
 // Clear all cached configurations
 void ConfigManager::ClearCache() {
   m_configCache.clear();
+  m_binaryCache.ReleaseAll();
   LogInfo("Configuration cache cleared");
 }
 
@@ -118,6 +148,12 @@ void ConfigManager::SetLogger(ILogger* logger) {
   m_logger = logger;
 }
 
+// Look up a position without decoding the document
+ConfigCache::Lookup ConfigManager::FindCachedPosition(const std::string& filename, const std::string& device,
+  const std::string& positionName, ConfigCache::PositionRecord& out) const {
+  return m_binaryCache.FindPosition(filename, device, positionName, out);
+}
+
 // Load all configuration files from directory
 std::vector<std::string> ConfigManager::LoadAllConfigs() {
   std::vector<std::string> loadedFiles;
@@ -201,6 +237,11 @@ std::string ConfigManager::GetConfigDirectory() const {
   return m_configDirectory;
 }
 
+// Backups and other non-.json files are not worth a cache file
+bool ConfigManager::UsesBinaryCache(const std::string& filename) {
+  return std::filesystem::path(filename).extension() == ".json";
+}
+
 // Get full file path
 std::string ConfigManager::GetFullPath(const std::string& filename) const {
   return (std::filesystem::path(m_configDirectory) / filename).string();
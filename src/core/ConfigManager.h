@@ -7,6 +7,7 @@
 #include <fstream>
 #include <iostream>
 #include "nlohmann/json.hpp"
+#include "ConfigCache.h"
 
 // Forward declare logger interface - keep it simple
 class ILogger;
@@ -17,6 +18,12 @@ class ILogger;
  * Simple, unified access to all JSON configuration files.
  * Handles loading, saving, and caching of configurations.
  *
+ * Each JSON file is compiled to a binary cache beside it (see ConfigCache).
+ * LoadConfig only maps that cache when it is current; the document is decoded
+ * on the first GetConfig. Only named-position lookups (FindCachedPosition)
+ * read the cache without decoding - every other accessor goes through
+ * GetConfig and pays one full decode per file plus a DOM copy per call.
+ *
  * Usage:
  *   auto& config = ConfigManager::Instance();
  *   config.LoadConfig("camera_config.json");
@@ -41,6 +48,10 @@ public:
   void ClearCache();
   void SetLogger(ILogger* logger);
 
+  // Position lookup from the binary table, no decode (NoTable = use GetConfig)
+  ConfigCache::Lookup FindCachedPosition(const std::string& filename, const std::string& device,
+    const std::string& positionName, ConfigCache::PositionRecord& out) const;
+
   // Bulk operations
   std::vector<std::string> LoadAllConfigs();
   void SaveAllConfigs();
@@ -60,11 +71,13 @@ private:
 
   // Internal data
   std::unordered_map<std::string, nlohmann::json> m_configCache;
+  ConfigCache m_binaryCache;   // Configs loaded but not yet decoded live only here
   std::string m_configDirectory = "config";
   ILogger* m_logger = nullptr;
 
   // Helper methods
   std::string GetFullPath(const std::string& filename) const;
+  static bool UsesBinaryCache(const std::string& filename);
   void LogInfo(const std::string& message) const;
   void LogError(const std::string& message) const;
   void LogWarning(const std::string& message) const;
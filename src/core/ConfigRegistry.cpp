@@ -1,4 +1,5 @@
 #include "ConfigRegistry.h"
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
@@ -15,7 +16,9 @@ void ConfigRegistry::InitializeKnownFiles() {
       Files::CAMERA_CONFIG,
       Files::CAMERA_EXPOSURE,
       Files::CAMERA_OFFSET,
+      Files::COORDINATE_SYSTEMS,
       Files::DATA_SERVER,
+      Files::HOMING,
       Files::IO_CONFIG,
       Files::MOTION_DEVICES,
       Files::MOTION_GRAPH,
@@ -83,6 +86,7 @@ bool ConfigRegistry::LoadMotionConfigs() {
   success &= configManager.LoadConfig(Files::MOTION_GRAPH);
   success &= configManager.LoadConfig(Files::MOTION_POSITIONS);
   success &= configManager.LoadConfig(Files::TRANSFORMATION_MATRIX);
+  success &= configManager.LoadConfig(Files::HOMING);
 
   return success;
 }
@@ -277,6 +281,7 @@ std::vector<Config::Motion::DeviceInfo> Config::Motion::GetAllDevices() {
       info.isEnabled = ConfigHelper::GetValue<bool>(device, "IsEnabled", false);
       info.installAxes = ConfigHelper::GetValue<std::string>(device, "installAxes", "");
       info.typeController = ConfigHelper::GetValue<std::string>(device, "typeController", "");
+      info.station = ConfigHelper::GetValue<std::string>(device, "Station", "");
 
       devices.push_back(info);
     }
@@ -295,10 +300,35 @@ Config::Motion::DeviceInfo Config::Motion::GetDevice(const std::string& name) {
   return DeviceInfo{}; // Return empty if not found
 }
 
+std::vector<std::string> Config::Motion::GetStationNames() {
+  std::vector<std::string> stations;
+  for (const auto& device : GetAllDevices()) {
+    if (!device.station.empty() &&
+      std::find(stations.begin(), stations.end(), device.station) == stations.end()) {
+      stations.push_back(device.station);
+    }
+  }
+  std::sort(stations.begin(), stations.end());
+  return stations;
+}
+
 Config::Motion::Position Config::Motion::GetPosition(const std::string& device, const std::string& positionName) {
-  auto config = ConfigRegistry::GetMotionPositions();
   Position pos = { 0, 0, 0, 0, 0, 0 };
 
+  // Fast path: the binary cache's position table, no JSON involved
+  ConfigCache::PositionRecord record;
+  switch (ConfigManager::Instance().FindCachedPosition(ConfigRegistry::Files::MOTION_POSITIONS,
+    device, positionName, record)) {
+  case ConfigCache::Lookup::Found:
+    return { record.x, record.y, record.z, record.u, record.v, record.w };
+  case ConfigCache::Lookup::NotFound:
+    return pos;
+  case ConfigCache::Lookup::NoTable:
+    break;
+  }
+
+  auto config = ConfigRegistry::GetMotionPositions();
+
   if (config.contains(device) && config[device].contains(positionName)) {
     auto posData = config[device][positionName];
     pos.x = ConfigHelper::GetValue<double>(posData, "x", 0.0);
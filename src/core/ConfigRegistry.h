@@ -19,7 +19,9 @@ public:
     static constexpr const char* CAMERA_CONFIG = "camera_config.json";
     static constexpr const char* CAMERA_EXPOSURE = "camera_exposure_config.json";
     static constexpr const char* CAMERA_OFFSET = "camera_to_object_offset.json";
+    static constexpr const char* COORDINATE_SYSTEMS = "coordinate_systems.json";
     static constexpr const char* DATA_SERVER = "DataServerConfig.json";
+    static constexpr const char* HOMING = "homing.json";
     static constexpr const char* IO_CONFIG = "IOConfig.json";
     static constexpr const char* MOTION_DEVICES = "motion_config_devices.json";
     static constexpr const char* MOTION_GRAPH = "motion_config_graph.json";
@@ -102,6 +104,7 @@ namespace Config {
       bool isEnabled;
       std::string installAxes;
       std::string typeController;
+      std::string station;        // Empty when the cell has a single station
     };
 
     struct Position {
@@ -110,6 +113,9 @@ namespace Config {
 
     std::vector<DeviceInfo> GetAllDevices();
     DeviceInfo GetDevice(const std::string& name);
+    std::vector<std::string> GetStationNames();  // Sorted, without the empty station
+    // Only accessor served from the binary position table without decoding;
+    // the others decode their document once and copy it on every call
     Position GetPosition(const std::string& device, const std::string& positionName);
     bool SetPosition(const std::string& device, const std::string& positionName, const Position& pos);
   }
@@ -0,0 +1,306 @@
+// HealthWatchdog.cpp - Deadline monitoring for comm threads and the UI loop
+#include "HealthWatchdog.h"
+#include "../utils/ThreadPolicy.h"
+
+#include <iostream>
+#include <sstream>
+
+namespace {
+  const char* RecoveryName(HealthWatchdog::Recovery recovery) {
+    switch (recovery) {
+    case HealthWatchdog::Recovery::Reconnect: return "Reconnect";
+    case HealthWatchdog::Recovery::SafeStop: return "SafeStop";
+    default: return "None";
+    }
+  }
+}
+
+HealthWatchdog& HealthWatchdog::Instance() {
+  static HealthWatchdog instance;
+  return instance;
+}
+
+HealthWatchdog::~HealthWatchdog() {
+  Stop();
+}
+
+int64_t HealthWatchdog::NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// MONITOR THREAD
+// ============================================================================
+
+void HealthWatchdog::Start(std::chrono::milliseconds pollInterval) {
+  if (m_running.exchange(true)) {
+    return;
+  }
+
+  m_pollInterval = pollInterval;
+  m_monitorThread = std::thread(&HealthWatchdog::MonitorThreadFunc, this);
+  std::cout << "HealthWatchdog: Started (poll " << pollInterval.count() << " ms)" << std::endl;
+}
+
+void HealthWatchdog::Stop() {
+  if (!m_running.exchange(false)) {
+    return;
+  }
+
+  m_condVar.notify_all();
+  if (m_monitorThread.joinable()) {
+    m_monitorThread.join();
+  }
+
+  // Let any in-flight recovery finish before the watchdog goes away
+  std::vector<std::future<void>> pending;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& channel : m_channels) {
+      if (channel.recoveryTask.valid()) {
+        pending.push_back(std::move(channel.recoveryTask));
+      }
+    }
+  }
+  for (auto& task : pending) {
+    task.wait();
+  }
+
+  std::cout << "HealthWatchdog: Stopped" << std::endl;
+}
+
+void HealthWatchdog::MonitorThreadFunc() {
+  // Stall detection must not be delayed by UI or disk activity
+  ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::MotionIO, "Watchdog");
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  while (m_running.load()) {
+    const int64_t now = NowNs();
+    for (int i = 0; i < MAX_CHANNELS; i++) {
+      Channel& channel = m_channels[i];
+      if (channel.active.load() && channel.monitored.load()) {
+        CheckChannel(i, channel, now);
+      }
+    }
+
+    m_condVar.wait_for(lock, m_pollInterval, [this]() { return !m_running.load(); });
+  }
+}
+
+// Called with m_mutex held
+void HealthWatchdog::CheckChannel(int id, Channel& channel, int64_t nowNs) {
+  const int64_t deadlineNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    channel.options.deadline).count();
+  const int64_t ageNs = nowNs - channel.lastBeatNs.load(std::memory_order_relaxed);
+  const double ageMs = ageNs / 1.0e6;
+
+  if (ageNs <= deadlineNs) {
+    if (channel.stale.exchange(false)) {
+      channel.recoveryTriggered = false;
+      if (channel.options.onStaleChanged) {
+        channel.options.onStaleChanged(false);
+      }
+      RaiseAlarm(channel.name, "Heartbeat resumed", true);
+    }
+    return;
+  }
+
+  if (!channel.stale.exchange(true)) {
+    channel.staleCount++;
+    if (channel.options.onStaleChanged) {
+      channel.options.onStaleChanged(true);
+    }
+
+    std::ostringstream msg;
+    msg << "Missed deadline - last heartbeat " << static_cast<int>(ageMs) << " ms ago (deadline "
+      << channel.options.deadline.count() << " ms)";
+    RaiseAlarm(channel.name, msg.str(), false);
+  }
+
+  // Escalate once per stall, and never while a previous recovery is still running
+  const bool escalate = channel.options.recovery != Recovery::None &&
+    channel.options.onRecover &&
+    !channel.recoveryTriggered &&
+    ageNs > deadlineNs * channel.options.recoveryAfterMisses;
+  const bool busy = channel.recoveryTask.valid() &&
+    channel.recoveryTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+
+  if (escalate && !busy) {
+    channel.recoveryTriggered = true;
+    channel.recoveryCount++;
+
+    RaiseAlarm(channel.name, std::string("Starting recovery: ") + RecoveryName(channel.options.recovery), false);
+
+    // Recovery may block in vendor calls - never run it on the monitor thread
+    auto action = channel.options.onRecover;
+    std::string name = channel.name;
+    channel.recoveryTask = std::async(std::launch::async, [this, action, name, id]() {
+      ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::Background, "Recovery " + name);
+      bool ok = false;
+      try {
+        ok = action();
+      }
+      catch (const std::exception& e) {
+        std::cout << "HealthWatchdog: Recovery for " << name << " threw: " << e.what() << std::endl;
+      }
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      RaiseAlarm(name, ok ? "Recovery completed" : "Recovery failed", false);
+
+      // Allow another attempt if the channel is still stale after a failed recovery
+      if (!ok && m_channels[id].active.load()) {
+        m_channels[id].recoveryTriggered = false;
+      }
+    });
+  }
+}
+
+// Called with m_mutex held
+void HealthWatchdog::RaiseAlarm(const std::string& channel, const std::string& message, bool cleared) {
+  Alarm alarm;
+  alarm.channel = channel;
+  alarm.message = message;
+  alarm.time = std::chrono::system_clock::now();
+  alarm.cleared = cleared;
+
+  std::cout << "HealthWatchdog: [" << (cleared ? "CLEARED" : "ALARM") << "] "
+    << channel << " - " << message << std::endl;
+
+  m_alarms.push_back(alarm);
+  while (m_alarms.size() > MAX_ALARM_HISTORY) {
+    m_alarms.pop_front();
+  }
+
+  if (m_alarmCallback) {
+    m_alarmCallback(alarm);
+  }
+}
+
+// ============================================================================
+// CHANNEL REGISTRATION
+// ============================================================================
+
+int HealthWatchdog::Register(const std::string& name, const ChannelOptions& options) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  for (int i = 0; i < MAX_CHANNELS; i++) {
+    Channel& channel = m_channels[i];
+    if (channel.active.load() || channel.recoveryTask.valid()) {
+      continue;
+    }
+
+    channel.name = name;
+    channel.options = options;
+    channel.recoveryTriggered = false;
+    channel.staleCount = 0;
+    channel.recoveryCount = 0;
+    channel.stale.store(false);
+    channel.lastBeatNs.store(NowNs());
+    channel.monitored.store(true);
+    channel.active.store(true);
+
+    std::cout << "HealthWatchdog: Registered " << name << " (deadline " << options.deadline.count()
+      << " ms, recovery " << RecoveryName(options.recovery) << ")" << std::endl;
+    return i;
+  }
+
+  // An unregistered comm thread is never checked - make that loud
+  m_rejectedRegistrations++;
+  RaiseAlarm(name, "Not monitored - all " + std::to_string(MAX_CHANNELS) + " watchdog channels in use", false);
+  return -1;
+}
+
+void HealthWatchdog::Unregister(int id) {
+  if (id < 0 || id >= MAX_CHANNELS) {
+    return;
+  }
+
+  std::future<void> pending;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Channel& channel = m_channels[id];
+    channel.active.store(false);
+    channel.monitored.store(false);
+    channel.options = ChannelOptions();
+    pending = std::move(channel.recoveryTask);
+  }
+
+  // The recovery callback may reference the owner - wait before it is destroyed
+  if (pending.valid()) {
+    pending.wait();
+  }
+}
+
+void HealthWatchdog::SetMonitored(int id, bool monitored) {
+  if (id < 0 || id >= MAX_CHANNELS) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Channel& channel = m_channels[id];
+  channel.lastBeatNs.store(NowNs());
+  channel.monitored.store(monitored);
+
+  // An intentionally paused channel is not stale
+  if (!monitored && channel.stale.exchange(false)) {
+    channel.recoveryTriggered = false;
+    if (channel.options.onStaleChanged) {
+      channel.options.onStaleChanged(false);
+    }
+  }
+}
+
+void HealthWatchdog::Heartbeat(int id) {
+  if (id < 0 || id >= MAX_CHANNELS) {
+    return;
+  }
+  m_channels[id].lastBeatNs.store(NowNs(), std::memory_order_relaxed);
+}
+
+// ============================================================================
+// STATUS
+// ============================================================================
+
+bool HealthWatchdog::IsStale(int id) const {
+  if (id < 0 || id >= MAX_CHANNELS) {
+    return false;
+  }
+  return m_channels[id].stale.load();
+}
+
+std::vector<HealthWatchdog::ChannelStatus> HealthWatchdog::GetChannelStatus() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<ChannelStatus> result;
+  const int64_t now = NowNs();
+
+  for (const auto& channel : m_channels) {
+    if (!channel.active.load()) {
+      continue;
+    }
+
+    ChannelStatus status;
+    status.name = channel.name;
+    status.monitored = channel.monitored.load();
+    status.stale = channel.stale.load();
+    status.ageMs = (now - channel.lastBeatNs.load()) / 1.0e6;
+    status.deadlineMs = static_cast<double>(channel.options.deadline.count());
+    status.staleCount = channel.staleCount;
+    status.recoveryCount = channel.recoveryCount;
+    status.recovery = channel.options.recovery;
+    result.push_back(status);
+  }
+
+  return result;
+}
+
+std::vector<HealthWatchdog::Alarm> HealthWatchdog::GetRecentAlarms() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return std::vector<Alarm>(m_alarms.begin(), m_alarms.end());
+}
+
+void HealthWatchdog::SetAlarmCallback(std::function<void(const Alarm&)> callback) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_alarmCallback = std::move(callback);
+}
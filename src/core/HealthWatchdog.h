@@ -0,0 +1,142 @@
+// HealthWatchdog.h - Deadline monitoring for comm threads and the UI loop
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TelemetryLayout.h"
+
+/**
+ * HealthWatchdog - Detects stalled threads before their data is trusted
+ *
+ * Every long-running loop (controller comm threads, the render loop) registers
+ * a channel with an expected deadline and calls Heartbeat() once per cycle.
+ * A single monitor thread checks the age of every heartbeat:
+ *
+ *   - age > deadline                 -> channel marked stale, alarm raised,
+ *                                       onStaleChanged(true) invoked
+ *   - age > deadline * recoveryAfter -> recovery action runs on a worker thread
+ *                                       (Reconnect / SafeStop), at most once per stall
+ *   - heartbeat resumes              -> stale cleared, alarm cleared
+ *
+ * Heartbeat() is a single atomic store so it is safe to call from hot loops.
+ *
+ * Usage:
+ *   HealthWatchdog::ChannelOptions options;
+ *   options.deadline = std::chrono::milliseconds(1000);
+ *   options.recovery = HealthWatchdog::Recovery::Reconnect;
+ *   options.onRecover = [this]() { return Reconnect(); };
+ *   int id = HealthWatchdog::Instance().Register("PI:hex-left", options);
+ *   ...
+ *   HealthWatchdog::Instance().Heartbeat(id);   // every loop iteration
+ */
+class HealthWatchdog {
+public:
+  enum class Recovery {
+    None,       // Alarm only
+    Reconnect,  // Drop and re-open the device connection
+    SafeStop    // Stop all motion on the device
+  };
+
+  struct ChannelOptions {
+    std::chrono::milliseconds deadline{ 1000 };
+    Recovery recovery = Recovery::None;
+    int recoveryAfterMisses = 3;                   // Escalate once age exceeds N deadlines
+    std::function<void(bool stale)> onStaleChanged; // Called from the monitor thread - keep it cheap
+    std::function<bool()> onRecover;                // Called from a worker thread
+  };
+
+  struct ChannelStatus {
+    std::string name;
+    bool monitored = false;
+    bool stale = false;
+    double ageMs = 0.0;
+    double deadlineMs = 0.0;
+    int staleCount = 0;
+    int recoveryCount = 0;
+    Recovery recovery = Recovery::None;
+  };
+
+  struct Alarm {
+    std::string channel;
+    std::string message;
+    std::chrono::system_clock::time_point time;
+    bool cleared = false;
+  };
+
+  static HealthWatchdog& Instance();
+
+  // Monitor thread lifetime
+  void Start(std::chrono::milliseconds pollInterval = std::chrono::milliseconds(50));
+  void Stop();
+  bool IsRunning() const { return m_running.load(); }
+
+  // Channel registration
+  int Register(const std::string& name, const ChannelOptions& options);
+  void Unregister(int id);
+  void SetMonitored(int id, bool monitored);  // Pause while a device is intentionally offline
+  void Heartbeat(int id);
+
+  // Status
+  bool IsStale(int id) const;
+  std::vector<ChannelStatus> GetChannelStatus() const;
+  std::vector<Alarm> GetRecentAlarms() const;
+  void SetAlarmCallback(std::function<void(const Alarm&)> callback);
+
+  // Registrations refused because every channel was taken (since process start)
+  int GetRejectedRegistrations() const { return m_rejectedRegistrations.load(); }
+
+  // One channel per device comm thread (as many as telemetry slots) plus the
+  // non-device loops: UI render loop, IO pollers
+  static constexpr int NON_DEVICE_CHANNELS = 8;
+  static constexpr int MAX_CHANNELS = Telemetry::kMaxMotionSlots + NON_DEVICE_CHANNELS;
+
+private:
+  HealthWatchdog() = default;
+  ~HealthWatchdog();
+  HealthWatchdog(const HealthWatchdog&) = delete;
+  HealthWatchdog& operator=(const HealthWatchdog&) = delete;
+
+  struct Channel {
+    // Hot fields - touched by Heartbeat() without locks
+    std::atomic<bool> active{ false };
+    std::atomic<bool> monitored{ false };
+    std::atomic<bool> stale{ false };
+    std::atomic<int64_t> lastBeatNs{ 0 };
+
+    // Cold fields - guarded by m_mutex
+    std::string name;
+    ChannelOptions options;
+    bool recoveryTriggered = false;
+    int staleCount = 0;
+    int recoveryCount = 0;
+    std::future<void> recoveryTask;
+  };
+
+  void MonitorThreadFunc();
+  void CheckChannel(int id, Channel& channel, int64_t nowNs);
+  void RaiseAlarm(const std::string& channel, const std::string& message, bool cleared);
+  static int64_t NowNs();
+
+  std::array<Channel, MAX_CHANNELS> m_channels;
+  mutable std::mutex m_mutex;
+  std::atomic<int> m_rejectedRegistrations{ 0 };
+
+  std::thread m_monitorThread;
+  std::condition_variable m_condVar;
+  std::atomic<bool> m_running{ false };
+  std::chrono::milliseconds m_pollInterval{ 50 };
+
+  std::deque<Alarm> m_alarms;
+  std::function<void(const Alarm&)> m_alarmCallback;
+  static constexpr size_t MAX_ALARM_HISTORY = 100;
+};
@@ -104,4 +104,6 @@ EziIOManager* ServiceLocator::ioManager = nullptr;
 CLD101xManager* ServiceLocator::cldManager = nullptr;
 Keithley2400Manager* ServiceLocator::smuManager = nullptr;
 PneumaticManager* ServiceLocator::pneumaticManager = nullptr;
-MachineOperations* ServiceLocator::machineOperations = nullptr;
\ No newline at end of file
+MachineOperations* ServiceLocator::machineOperations = nullptr;
+HomingOrchestrator* ServiceLocator::homingOrchestrator = nullptr;
+std::map<std::string, ServiceLocator::StationScope> ServiceLocator::stations;
\ No newline at end of file
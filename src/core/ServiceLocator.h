@@ -5,6 +5,9 @@
 // ServiceLocator.h - Complete version with all original services + ConfigManager
 #pragma once
 #include <iostream>
+#include <map>
+#include <string>
+#include <vector>
 
 // Forward declarations - ZERO dependencies!
 class PIControllerManagerStandardized;
@@ -16,6 +19,7 @@ class CLD101xManager;
 class Keithley2400Manager;
 class PneumaticManager;
 class MachineOperations;
+class HomingOrchestrator;
 
 /**
  * ServiceLocator - Complete Zero Dependencies Service Registry
@@ -87,6 +91,11 @@ public:
     if (service) std::cout << "✅ Machine Operations Service registered" << std::endl;
   }
 
+  void RegisterHoming(HomingOrchestrator* service) {
+    homingOrchestrator = service;
+    if (service) std::cout << "✅ Homing Service registered" << std::endl;
+  }
+
   // ========================================================================
   // SERVICE ACCESS (used everywhere, zero parameters needed!)
   // ========================================================================
@@ -120,6 +129,7 @@ public:
   Keithley2400Manager* SMU() const { return smuManager; }
   PneumaticManager* Pneumatic() const { return pneumaticManager; }
   MachineOperations* MachineOps() const { return machineOperations; }
+  HomingOrchestrator* Homing() const { return homingOrchestrator; }
 
   // ========================================================================
   // AVAILABILITY CHECKS (for conditional logic)
@@ -134,6 +144,50 @@ public:
   bool HasSMU() const { return smuManager != nullptr; }
   bool HasPneumatic() const { return pneumaticManager != nullptr; }
   bool HasMachineOps() const { return machineOperations != nullptr; }
+  bool HasHoming() const { return homingOrchestrator != nullptr; }
+
+  // ========================================================================
+  // STATION SCOPES (multi-station cell, see devices/motions/MotionCell.h)
+  // ========================================================================
+
+  // Motion managers of one station. PI()/ACS() above stay the default scope
+  // for single-station code; station-aware code asks for its own scope.
+  struct StationScope {
+    std::string name;
+    PIControllerManagerStandardized* piManager = nullptr;
+    ACSControllerManagerStandardized* acsManager = nullptr;
+
+    PIControllerManagerStandardized* PI() const { return piManager; }
+    ACSControllerManagerStandardized* ACS() const { return acsManager; }
+    bool HasPI() const { return piManager != nullptr; }
+    bool HasACS() const { return acsManager != nullptr; }
+  };
+
+  // Register during startup only - lookups do not lock
+  void RegisterStation(const std::string& name, PIControllerManagerStandardized* pi,
+    ACSControllerManagerStandardized* acs) {
+    stations[name] = StationScope{ name, pi, acs };
+    std::cout << "✅ Station " << name << " registered" << std::endl;
+  }
+
+  const StationScope* Station(const std::string& name) const {
+    auto it = stations.find(name);
+    if (it == stations.end()) {
+      std::cout << "❌ Station " << name << " not available" << std::endl;
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  bool HasStation(const std::string& name) const { return stations.count(name) > 0; }
+
+  std::vector<std::string> GetStationNames() const {
+    std::vector<std::string> names;
+    for (const auto& [name, scope] : stations) {
+      names.push_back(name);
+    }
+    return names;
+  }
 
   // ========================================================================
   // UTILITY METHODS
@@ -150,6 +204,8 @@ public:
     smuManager = nullptr;
     pneumaticManager = nullptr;
     machineOperations = nullptr;
+    homingOrchestrator = nullptr;
+    stations.clear();
     std::cout << "🔄 All services cleared" << std::endl;
   }
 
@@ -165,6 +221,7 @@ public:
     if (HasSMU()) count++;
     if (HasPneumatic()) count++;
     if (HasMachineOps()) count++;
+    if (HasHoming()) count++;
     return count;
   }
 
@@ -180,13 +237,19 @@ public:
     std::cout << "SMU: " << (HasSMU() ? "REGISTERED" : "NOT REGISTERED") << std::endl;
     std::cout << "Pneumatic: " << (HasPneumatic() ? "REGISTERED" : "NOT REGISTERED") << std::endl;
     std::cout << "Machine Ops: " << (HasMachineOps() ? "REGISTERED" : "NOT REGISTERED") << std::endl;
+    std::cout << "Homing: " << (HasHoming() ? "REGISTERED" : "NOT REGISTERED") << std::endl;
     std::cout << "Total Services: " << GetAvailableServiceCount() << std::endl;
+    for (const auto& [name, scope] : stations) {
+      std::cout << "Station " << name << ": PI " << (scope.HasPI() ? "REGISTERED" : "NOT REGISTERED")
+        << ", ACS " << (scope.HasACS() ? "REGISTERED" : "NOT REGISTERED") << std::endl;
+    }
   }
 
   // ========================================================================
   // BATCH OPERATIONS (convenience methods) - DECLARATIONS ONLY
   // ========================================================================
 
+  // Default scope only - station managers belong to their MotionCell
   // Initialize all available motion controllers
   bool InitializeAllMotion();
 
@@ -210,6 +273,8 @@ private:
   static Keithley2400Manager* smuManager;
   static PneumaticManager* pneumaticManager;
   static MachineOperations* machineOperations;
+  static HomingOrchestrator* homingOrchestrator;
+  static std::map<std::string, StationScope> stations;
 };
 
 // ========================================================================
@@ -223,6 +288,7 @@ private:
 // auto pi = Services.PI();
 // auto camera = Services.Camera();
 // if (Services.HasACS()) { auto acs = Services.ACS(); }
+// if (auto station = Services.Station("station-2")) { auto pi = station->PI(); }
 
 // ========================================================================
 // SAFER SERVICE ACCESS WITH AUTOMATIC NULL CHECKS
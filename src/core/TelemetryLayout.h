@@ -0,0 +1,207 @@
+// TelemetryLayout.h - Fixed binary layout of the shared-memory telemetry segment
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Telemetry Segment Layout (version 3)
+ *
+ * The segment is a single flat block shared with external readers
+ * (Python, LabVIEW, ...). All fields are little-endian, naturally aligned,
+ * and located at the offsets published in SegmentHeader, so readers never
+ * need to hard-code structure sizes.
+ *
+ *   [SegmentHeader]                          offset 0
+ *   [MotionSlot x motionSlotCount]           offset header.motionSlotOffset
+ *   [IOSlot     x ioSlotCount]               offset header.ioSlotOffset
+ *   [TraceSlot]                              offset header.traceSlotOffset
+ *
+ * Version 2 raised the motion slot count from 8 to 64 so a full station
+ * (16 hexapods + 2 gantries) and multi-station cells fit. Version 3 added
+ * the trace slot. Readers must take slot counts and sizes from the header,
+ * never from this file.
+ *
+ * Segment names:
+ *   Windows : "Local\\Project4Telemetry"   (named file mapping)
+ *   POSIX   : "/project4_telemetry"         (shm_open, /dev/shm/project4_telemetry)
+ *
+ * Snapshot protocol (seqlock, one writer per slot):
+ *   1. s1 = slot.sequence        (retry if odd - write in progress)
+ *   2. copy slot.snapshot
+ *   3. s2 = slot.sequence        (retry if s1 != s2)
+ *
+ * Ring protocol (single writer, any number of readers):
+ *   - slot.ringHead counts samples ever written; the newest sample is at
+ *     index (ringHead - 1) % kRingCapacity.
+ *   - Each sample carries its own sampleIndex. The reader reads sampleIndex,
+ *     copies the sample, then re-reads sampleIndex; both reads must equal the
+ *     index it expected, otherwise the writer lapped the reader and the
+ *     sample must be discarded.
+ *
+ * Trace protocol (whole-trace seqlock):
+ *   - The trace slot holds the last controller-side recording (e.g. a
+ *     servo-rate gantry trace), written in one go. The live motion rings
+ *     never receive recorded samples - they stay in poll order.
+ *   - Same seqlock as the snapshots: read sequence (retry if odd), copy
+ *     header fields and values[c][0..sampleCount), re-read sequence.
+ *     traceIndex changes with every published trace.
+ *   - Sample i of a trace was taken at startTimestampNs + i * periodMs.
+ *
+ * Timestamps are steady-clock nanoseconds. The header records the steady and
+ * Unix time at segment creation so readers can convert to wall-clock time.
+ */
+namespace Telemetry {
+
+  constexpr uint32_t kMagic = 0x544D3450;       // "P4MT" in memory order
+  constexpr uint32_t kLayoutVersion = 3;
+
+  constexpr int kMaxMotionSlots = 64;           // 18 devices per station, several stations per process
+  constexpr int kMaxIOSlots = 8;
+  constexpr int kMaxAxes = 6;
+  constexpr int kMaxAnalogChannels = 8;
+  constexpr int kNameLength = 32;
+  constexpr int kAxisNameLength = 4;
+  constexpr int kRingCapacity = 1024;           // Power of two
+  constexpr int kMaxTraceChannels = 16;
+  constexpr int kTraceCapacity = 100000;        // Samples per trace channel
+
+  // Slot flags (MotionSnapshot::flags / IOSnapshot::flags)
+  constexpr uint32_t kFlagConnected = 1u << 0;
+  constexpr uint32_t kFlagStale = 1u << 1;       // Publisher missed its deadline
+
+  static_assert((kRingCapacity & (kRingCapacity - 1)) == 0, "Ring capacity must be a power of two");
+  static_assert(std::atomic<uint32_t>::is_always_lock_free, "Seqlock requires lock-free 32-bit atomics");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring head requires lock-free 64-bit atomics");
+
+  // ==========================================================================
+  // HEADER
+  // ==========================================================================
+  struct SegmentHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t totalSize;
+
+    uint32_t motionSlotCount;
+    uint32_t motionSlotSize;
+    uint32_t motionSlotOffset;
+    uint32_t ioSlotCount;
+    uint32_t ioSlotSize;
+    uint32_t ioSlotOffset;
+
+    uint32_t ringCapacity;
+    uint32_t motionSampleSize;
+    uint32_t ioSampleSize;
+    uint32_t publisherPid;
+
+    uint64_t steadyAtCreateNs;
+    uint64_t unixAtCreateNs;
+
+    uint32_t traceSlotSize;
+    uint32_t traceSlotOffset;
+    uint32_t traceChannelCount;
+    uint32_t traceCapacity;
+  };
+
+  // ==========================================================================
+  // MOTION
+  // ==========================================================================
+  struct MotionSnapshot {
+    uint64_t timestampNs;
+    uint64_t frameCounter;
+    double positions[kMaxAxes];
+    double analog[kMaxAnalogChannels];          // analog[i] = controller channel i+1
+    uint32_t movingMask;                        // Bit i = axis i moving
+    uint32_t servoMask;                         // Bit i = axis i servo on
+    uint32_t analogMask;                        // Bit i = analog[i] valid
+    uint32_t flags;
+  };
+
+  struct MotionSample {
+    uint64_t sampleIndex;
+    uint64_t timestampNs;
+    double positions[kMaxAxes];
+    double analog[kMaxAnalogChannels];
+  };
+
+  struct alignas(64) MotionSlot {
+    std::atomic<uint32_t> sequence;
+    uint32_t inUse;
+    uint32_t axisCount;
+    uint32_t reserved;
+    char deviceName[kNameLength];
+    char controllerType[8];                      // "PI" / "ACS"
+    char axisNames[kMaxAxes][kAxisNameLength];
+    MotionSnapshot snapshot;
+
+    alignas(64) std::atomic<uint64_t> ringHead;
+    MotionSample ring[kRingCapacity];
+  };
+
+  // ==========================================================================
+  // IO
+  // ==========================================================================
+  struct IOSnapshot {
+    uint64_t timestampNs;
+    uint64_t inputs;                             // Bit i = input pin i
+    uint64_t outputs;                            // Bit i = output pin i
+    uint32_t flags;
+    uint32_t reserved;
+  };
+
+  struct IOSample {
+    uint64_t sampleIndex;
+    uint64_t timestampNs;
+    uint64_t inputs;
+    uint64_t outputs;
+  };
+
+  struct alignas(64) IOSlot {
+    std::atomic<uint32_t> sequence;
+    uint32_t inUse;
+    uint32_t inputCount;
+    uint32_t outputCount;
+    char deviceName[kNameLength];
+    IOSnapshot snapshot;
+
+    alignas(64) std::atomic<uint64_t> ringHead;
+    IOSample ring[kRingCapacity];
+  };
+
+  // ==========================================================================
+  // TRACE
+  // ==========================================================================
+  struct alignas(64) TraceSlot {
+    std::atomic<uint32_t> sequence;
+    uint32_t channelCount;
+    uint32_t sampleCount;
+    uint32_t reserved;
+    uint64_t traceIndex;                         // Traces published since the segment was created
+    uint64_t startTimestampNs;
+    double periodMs;
+    char deviceName[kNameLength];
+    char channelNames[kMaxTraceChannels][kNameLength];   // e.g. "PE(0)"
+
+    alignas(64) double values[kMaxTraceChannels][kTraceCapacity];
+  };
+
+  // ==========================================================================
+  // WHOLE SEGMENT
+  // ==========================================================================
+  struct alignas(64) Segment {
+    SegmentHeader header;
+    MotionSlot motion[kMaxMotionSlots];
+    IOSlot io[kMaxIOSlots];
+    TraceSlot trace;
+  };
+
+  // Offsets are part of the published contract - a layout change must bump kLayoutVersion
+  static_assert(sizeof(SegmentHeader) == 88, "SegmentHeader layout changed");
+  static_assert(sizeof(MotionSnapshot) == 144, "MotionSnapshot layout changed");
+  static_assert(sizeof(MotionSample) == 128, "MotionSample layout changed");
+  static_assert(sizeof(IOSnapshot) == 32, "IOSnapshot layout changed");
+  static_assert(sizeof(IOSample) == 32, "IOSample layout changed");
+
+} // namespace Telemetry
@@ -0,0 +1,416 @@
+// TelemetrySegment.cpp - Shared-memory telemetry publisher
+#include "TelemetrySegment.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace Telemetry;
+
+namespace {
+  // Copy a string into a fixed, always-terminated char field
+  template <size_t N>
+  void CopyName(char (&dest)[N], const std::string& src) {
+    std::memset(dest, 0, N);
+    std::memcpy(dest, src.c_str(), std::min(src.size(), N - 1));
+  }
+
+  // Seqlock write section: odd sequence while the snapshot is being updated
+  template <typename Slot, typename Fn>
+  void SeqlockWrite(Slot& slot, Fn&& write) {
+    uint32_t seq = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    write(slot.snapshot);
+    slot.sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  // Ring append: invalidate the sample index, write, then publish the index and head
+  template <typename Slot, typename Fill>
+  void RingAppend(Slot& slot, Fill&& fill) {
+    uint64_t head = slot.ringHead.load(std::memory_order_relaxed);
+    auto& sample = slot.ring[head & (kRingCapacity - 1)];
+
+    std::atomic_ref<uint64_t> index(sample.sampleIndex);
+    index.store(UINT64_MAX, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    fill(sample);
+    index.store(head, std::memory_order_release);
+
+    slot.ringHead.store(head + 1, std::memory_order_release);
+  }
+}
+
+TelemetrySegment& TelemetrySegment::Instance() {
+  static TelemetrySegment instance;
+  return instance;
+}
+
+TelemetrySegment::~TelemetrySegment() {
+  Close();
+}
+
+std::string TelemetrySegment::DefaultName() {
+#ifdef _WIN32
+  return "Local\\Project4Telemetry";
+#else
+  return "/project4_telemetry";
+#endif
+}
+
+uint64_t TelemetrySegment::NowNs() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ============================================================================
+// SEGMENT LIFETIME
+// ============================================================================
+
+bool TelemetrySegment::Open(const std::string& name) {
+  std::lock_guard<std::mutex> lock(m_slotMutex);
+
+  if (m_segment) {
+    return true;
+  }
+
+  const size_t size = sizeof(Segment);
+  void* view = nullptr;
+
+#ifdef _WIN32
+  HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+    0, static_cast<DWORD>(size), name.c_str());
+  if (mapping == NULL) {
+    std::cout << "TelemetrySegment: CreateFileMapping failed for " << name
+      << ". Error: " << GetLastError() << std::endl;
+    return false;
+  }
+
+  view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+  if (view == NULL) {
+    std::cout << "TelemetrySegment: MapViewOfFile failed. Error: " << GetLastError() << std::endl;
+    CloseHandle(mapping);
+    return false;
+  }
+  m_mappingHandle = mapping;
+#else
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    std::cout << "TelemetrySegment: shm_open failed for " << name << std::endl;
+    return false;
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    std::cout << "TelemetrySegment: ftruncate failed for " << name << std::endl;
+    close(fd);
+    return false;
+  }
+
+  view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (view == MAP_FAILED) {
+    std::cout << "TelemetrySegment: mmap failed for " << name << std::endl;
+    close(fd);
+    return false;
+  }
+  m_shmFd = fd;
+#endif
+
+  // A previous run may have left data behind - always start from a clean layout
+  std::memset(view, 0, size);
+  m_segment = new (view) Segment();
+  m_name = name;
+  InitializeHeader();
+
+  std::cout << "TelemetrySegment: Published " << size << " bytes at " << name
+    << " (layout v" << kLayoutVersion << ")" << std::endl;
+  return true;
+}
+
+void TelemetrySegment::InitializeHeader() {
+  SegmentHeader& header = m_segment->header;
+
+  header.version = kLayoutVersion;
+  header.headerSize = sizeof(SegmentHeader);
+  header.totalSize = static_cast<uint32_t>(sizeof(Segment));
+
+  header.motionSlotCount = kMaxMotionSlots;
+  header.motionSlotSize = sizeof(MotionSlot);
+  header.motionSlotOffset = static_cast<uint32_t>(offsetof(Segment, motion));
+  header.ioSlotCount = kMaxIOSlots;
+  header.ioSlotSize = sizeof(IOSlot);
+  header.ioSlotOffset = static_cast<uint32_t>(offsetof(Segment, io));
+
+  header.ringCapacity = kRingCapacity;
+  header.motionSampleSize = sizeof(MotionSample);
+  header.ioSampleSize = sizeof(IOSample);
+
+  header.traceSlotSize = sizeof(TraceSlot);
+  header.traceSlotOffset = static_cast<uint32_t>(offsetof(Segment, trace));
+  header.traceChannelCount = kMaxTraceChannels;
+  header.traceCapacity = kTraceCapacity;
+#ifdef _WIN32
+  header.publisherPid = static_cast<uint32_t>(GetCurrentProcessId());
+#else
+  header.publisherPid = static_cast<uint32_t>(getpid());
+#endif
+
+  header.steadyAtCreateNs = NowNs();
+  header.unixAtCreateNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count());
+
+  // Magic goes in last so readers never see a half-initialized header
+  std::atomic_thread_fence(std::memory_order_release);
+  std::atomic_ref<uint32_t>(header.magic).store(kMagic, std::memory_order_release);
+}
+
+void TelemetrySegment::Close() {
+  std::lock_guard<std::mutex> lock(m_slotMutex);
+
+  if (!m_segment) {
+    return;
+  }
+
+  // Tell readers the publisher is gone before unmapping
+  std::atomic_ref<uint32_t>(m_segment->header.magic).store(0, std::memory_order_release);
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_segment);
+  CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+  m_mappingHandle = nullptr;
+#else
+  munmap(m_segment, sizeof(Segment));
+  close(m_shmFd);
+  shm_unlink(m_name.c_str());
+  m_shmFd = -1;
+#endif
+
+  m_segment = nullptr;
+  std::cout << "TelemetrySegment: Closed " << m_name << std::endl;
+}
+
+// ============================================================================
+// MOTION SLOTS
+// ============================================================================
+
+int TelemetrySegment::AcquireMotionSlot(const std::string& deviceName, const std::string& controllerType,
+  const std::vector<std::string>& axes) {
+  std::lock_guard<std::mutex> lock(m_slotMutex);
+
+  if (!m_segment) {
+    return -1;
+  }
+
+  for (int i = 0; i < kMaxMotionSlots; i++) {
+    MotionSlot& slot = m_segment->motion[i];
+    if (slot.inUse) {
+      continue;
+    }
+
+    WriterLock writer(m_motionWriters[i]);
+    SeqlockWrite(slot, [&](MotionSnapshot& snapshot) {
+      std::memset(&snapshot, 0, sizeof(snapshot));
+      CopyName(slot.deviceName, deviceName);
+      CopyName(slot.controllerType, controllerType);
+      slot.axisCount = static_cast<uint32_t>(std::min<size_t>(axes.size(), kMaxAxes));
+      for (uint32_t a = 0; a < kMaxAxes; a++) {
+        CopyName(slot.axisNames[a], a < slot.axisCount ? axes[a] : std::string());
+      }
+      slot.inUse = 1;
+    });
+
+    std::cout << "TelemetrySegment: Slot " << i << " assigned to " << deviceName << std::endl;
+    return i;
+  }
+
+  m_rejectedMotionSlots++;
+  std::cout << "TelemetrySegment: No free motion slot for " << deviceName
+    << " (" << kMaxMotionSlots << " slots in use)" << std::endl;
+  return -1;
+}
+
+void TelemetrySegment::ReleaseMotionSlot(int slot) {
+  std::lock_guard<std::mutex> lock(m_slotMutex);
+
+  if (!m_segment || slot < 0 || slot >= kMaxMotionSlots) {
+    return;
+  }
+
+  WriterLock writer(m_motionWriters[slot]);
+  SeqlockWrite(m_segment->motion[slot], [&](MotionSnapshot& snapshot) {
+    snapshot.flags &= ~kFlagConnected;
+    m_segment->motion[slot].inUse = 0;
+  });
+}
+
+void TelemetrySegment::PublishMotion(int slot, const MotionSnapshot& snapshot) {
+  if (!m_segment || slot < 0 || slot >= kMaxMotionSlots) {
+    return;
+  }
+
+  MotionSlot& target = m_segment->motion[slot];
+  WriterLock writer(m_motionWriters[slot]);
+
+  // A fresh publish always clears the stale flag - the publisher is alive again
+  SeqlockWrite(target, [&](MotionSnapshot& dest) {
+    dest = snapshot;
+    dest.flags &= ~kFlagStale;
+  });
+
+  RingAppend(target, [&](MotionSample& sample) {
+    sample.timestampNs = snapshot.timestampNs;
+    std::memcpy(sample.positions, snapshot.positions, sizeof(sample.positions));
+    std::memcpy(sample.analog, snapshot.analog, sizeof(sample.analog));
+  });
+}
+
+void TelemetrySegment::UpdateMotionFlags(int slot, uint32_t setFlags, uint32_t clearFlags) {
+  if (!m_segment || slot < 0 || slot >= kMaxMotionSlots) {
+    return;
+  }
+
+  WriterLock writer(m_motionWriters[slot]);
+  SeqlockWrite(m_segment->motion[slot], [&](MotionSnapshot& snapshot) {
+    snapshot.flags = (snapshot.flags | setFlags) & ~clearFlags;
+  });
+}
+
+// ============================================================================
+// IO SLOTS
+// ============================================================================
+
+int TelemetrySegment::AcquireIOSlot(const std::string& deviceName, int inputCount, int outputCount) {
+  std::lock_guard<std::mutex> lock(m_slotMutex);
+
+  if (!m_segment) {
+    return -1;
+  }
+
+  for (int i = 0; i < kMaxIOSlots; i++) {
+    IOSlot& slot = m_segment->io[i];
+    if (slot.inUse) {
+      continue;
+    }
+
+    WriterLock writer(m_ioWriters[i]);
+    SeqlockWrite(slot, [&](IOSnapshot& snapshot) {
+      std::memset(&snapshot, 0, sizeof(snapshot));
+      CopyName(slot.deviceName, deviceName);
+      slot.inputCount = static_cast<uint32_t>(std::clamp(inputCount, 0, 64));
+      slot.outputCount = static_cast<uint32_t>(std::clamp(outputCount, 0, 64));
+      slot.inUse = 1;
+    });
+
+    std::cout << "TelemetrySegment: IO slot " << i << " assigned to " << deviceName << std::endl;
+    return i;
+  }
+
+  std::cout << "TelemetrySegment: No free IO slot for " << deviceName << std::endl;
+  return -1;
+}
+
+void TelemetrySegment::ReleaseIOSlot(int slot) {
+  std::lock_guard<std::mutex> lock(m_slotMutex);
+
+  if (!m_segment || slot < 0 || slot >= kMaxIOSlots) {
+    return;
+  }
+
+  WriterLock writer(m_ioWriters[slot]);
+  SeqlockWrite(m_segment->io[slot], [&](IOSnapshot& snapshot) {
+    snapshot.flags &= ~kFlagConnected;
+    m_segment->io[slot].inUse = 0;
+  });
+}
+
+void TelemetrySegment::PublishIO(int slot, uint64_t inputs, uint64_t outputs, uint32_t flags) {
+  if (!m_segment || slot < 0 || slot >= kMaxIOSlots) {
+    return;
+  }
+
+  IOSlot& target = m_segment->io[slot];
+  const uint64_t now = NowNs();
+  WriterLock writer(m_ioWriters[slot]);
+
+  SeqlockWrite(target, [&](IOSnapshot& dest) {
+    dest.timestampNs = now;
+    dest.inputs = inputs;
+    dest.outputs = outputs;
+    dest.flags = flags & ~kFlagStale;
+  });
+
+  RingAppend(target, [&](IOSample& sample) {
+    sample.timestampNs = now;
+    sample.inputs = inputs;
+    sample.outputs = outputs;
+  });
+}
+
+void TelemetrySegment::UpdateIOFlags(int slot, uint32_t setFlags, uint32_t clearFlags) {
+  if (!m_segment || slot < 0 || slot >= kMaxIOSlots) {
+    return;
+  }
+
+  WriterLock writer(m_ioWriters[slot]);
+  SeqlockWrite(m_segment->io[slot], [&](IOSnapshot& snapshot) {
+    snapshot.flags = (snapshot.flags | setFlags) & ~clearFlags;
+  });
+}
+
+// ============================================================================
+// TRACE SLOT
+// ============================================================================
+
+bool TelemetrySegment::PublishTrace(const std::string& deviceName, const std::vector<std::string>& channelNames,
+  const std::vector<std::vector<double>>& values, double periodMs, uint64_t startTimestampNs) {
+  if (!m_segment) {
+    return false;
+  }
+
+  const size_t samples = values.empty() ? 0 : values.front().size();
+  if (values.size() != channelNames.size() || values.size() > static_cast<size_t>(kMaxTraceChannels) ||
+    samples > static_cast<size_t>(kTraceCapacity)) {
+    std::cout << "TelemetrySegment: Trace from " << deviceName << " does not fit (" << values.size()
+      << " channels, " << samples << " samples)" << std::endl;
+    return false;
+  }
+  for (const auto& channel : values) {
+    if (channel.size() != samples) {
+      std::cout << "TelemetrySegment: Trace from " << deviceName << " has ragged channels" << std::endl;
+      return false;
+    }
+  }
+
+  TraceSlot& slot = m_segment->trace;
+  WriterLock writer(m_traceWriter);
+
+  // Same seqlock as the snapshots, held across the whole trace
+  uint32_t seq = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.channelCount = static_cast<uint32_t>(values.size());
+  slot.sampleCount = static_cast<uint32_t>(samples);
+  slot.traceIndex++;
+  slot.startTimestampNs = startTimestampNs;
+  slot.periodMs = periodMs;
+  CopyName(slot.deviceName, deviceName);
+  for (int c = 0; c < kMaxTraceChannels; c++) {
+    CopyName(slot.channelNames[c], c < static_cast<int>(values.size()) ? channelNames[c] : std::string());
+    if (c < static_cast<int>(values.size()) && samples > 0) {
+      std::memcpy(slot.values[c], values[c].data(), samples * sizeof(double));
+    }
+  }
+
+  slot.sequence.store(seq + 2, std::memory_order_release);
+  return true;
+}
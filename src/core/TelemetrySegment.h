@@ -0,0 +1,93 @@
+// TelemetrySegment.h - Publisher side of the shared-memory telemetry segment
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "TelemetryLayout.h"
+
+/**
+ * TelemetrySegment - Publishes controller/IO snapshots for external tools
+ *
+ * Owns the shared-memory mapping described in TelemetryLayout.h. Each
+ * publisher (controller comm thread, IO poller) acquires a slot once and then
+ * publishes without locks or syscalls; external readers consume the slots
+ * with the seqlock/ring protocol documented in the layout header.
+ *
+ * If the segment is not open (unit tests, mapping failure) every call is a
+ * cheap no-op, so publishers never need to check.
+ *
+ * Usage:
+ *   auto& telemetry = TelemetrySegment::Instance();
+ *   telemetry.Open();
+ *   int slot = telemetry.AcquireMotionSlot("hex-left", "PI", axes);
+ *   telemetry.PublishMotion(slot, snapshot);
+ */
+class TelemetrySegment {
+public:
+  static TelemetrySegment& Instance();
+
+  // Segment lifetime
+  bool Open(const std::string& name = DefaultName());
+  void Close();
+  bool IsOpen() const { return m_segment != nullptr; }
+
+  // Motion slots
+  int AcquireMotionSlot(const std::string& deviceName, const std::string& controllerType,
+    const std::vector<std::string>& axes);
+  void ReleaseMotionSlot(int slot);
+  void PublishMotion(int slot, const Telemetry::MotionSnapshot& snapshot);
+  void UpdateMotionFlags(int slot, uint32_t setFlags, uint32_t clearFlags);
+  // Acquisitions refused because every motion slot was taken (since process start)
+  int GetRejectedMotionSlots() const { return m_rejectedMotionSlots.load(); }
+
+  // IO slots
+  int AcquireIOSlot(const std::string& deviceName, int inputCount, int outputCount);
+  void ReleaseIOSlot(int slot);
+  void PublishIO(int slot, uint64_t inputs, uint64_t outputs, uint32_t flags);
+  void UpdateIOFlags(int slot, uint32_t setFlags, uint32_t clearFlags);
+
+  // Trace slot - replaces the last published trace; the live rings are not touched
+  bool PublishTrace(const std::string& deviceName, const std::vector<std::string>& channelNames,
+    const std::vector<std::vector<double>>& values, double periodMs, uint64_t startTimestampNs);
+
+  // Steady-clock timestamp used for all published samples
+  static uint64_t NowNs();
+  static std::string DefaultName();
+
+private:
+  TelemetrySegment() = default;
+  ~TelemetrySegment();
+  TelemetrySegment(const TelemetrySegment&) = delete;
+  TelemetrySegment& operator=(const TelemetrySegment&) = delete;
+
+  void InitializeHeader();
+
+  // Slots have a single publisher, but flag updates may come from the
+  // watchdog thread - this process-local spin lock keeps the seqlock single-writer
+  class WriterLock {
+  public:
+    explicit WriterLock(std::atomic_flag& flag) : m_flag(flag) {
+      while (m_flag.test_and_set(std::memory_order_acquire)) {}
+    }
+    ~WriterLock() { m_flag.clear(std::memory_order_release); }
+  private:
+    std::atomic_flag& m_flag;
+  };
+
+  Telemetry::Segment* m_segment = nullptr;
+  std::string m_name;
+  std::mutex m_slotMutex;  // Guards slot acquire/release only
+  std::atomic_flag m_motionWriters[Telemetry::kMaxMotionSlots];
+  std::atomic_flag m_ioWriters[Telemetry::kMaxIOSlots];
+  std::atomic_flag m_traceWriter;
+  std::atomic<int> m_rejectedMotionSlots{ 0 };
+
+#ifdef _WIN32
+  void* m_mappingHandle = nullptr;
+#else
+  int m_shmFd = -1;
+#endif
+};
@@ -0,0 +1,132 @@
+// ACSAsyncTransport.cpp
+#include "ACSAsyncTransport.h"
+
+#include <cstring>
+#include <iostream>
+
+ACSAsyncTransport::ACSAsyncTransport()
+  : m_handle(ACSC_INVALID) {
+}
+
+ACSAsyncTransport::~ACSAsyncTransport() {
+  if (m_count > 0) {
+    Drain();
+  }
+}
+
+void ACSAsyncTransport::Begin(HANDLE handle) {
+  if (m_count > 0 && handle != m_handle) {
+    Drain();
+  }
+  m_handle = handle;
+}
+
+// === REQUESTS ===
+
+bool ACSAsyncTransport::GetFPosition(int axis, double* position, bool* ok) {
+  Slot* slot = Acquire(Kind::Real, position, ok, axis, "FPOS");
+  if (!acsc_GetFPosition(m_handle, axis, position, &slot->wait)) {
+    return Reject(slot);
+  }
+  return true;
+}
+
+bool ACSAsyncTransport::GetMotorState(int axis, int* state, bool* ok) {
+  Slot* slot = Acquire(Kind::Integer, state, ok, axis, "MST");
+  if (!acsc_GetMotorState(m_handle, axis, state, &slot->wait)) {
+    return Reject(slot);
+  }
+  return true;
+}
+
+bool ACSAsyncTransport::ToPoint(int flags, int axis, double point, const char* label) {
+  Slot* slot = Acquire(Kind::Command, nullptr, nullptr, axis, label);
+  if (!acsc_ToPoint(m_handle, flags, axis, point, &slot->wait)) {
+    return Reject(slot);
+  }
+  return true;
+}
+
+bool ACSAsyncTransport::Halt(int axis, const char* label) {
+  Slot* slot = Acquire(Kind::Command, nullptr, nullptr, axis, label);
+  if (!acsc_Halt(m_handle, axis, &slot->wait)) {
+    return Reject(slot);
+  }
+  return true;
+}
+
+// === COMPLETION ===
+
+int ACSAsyncTransport::Drain() {
+  int failures = 0;
+
+  for (int i = 0; i < m_count; i++) {
+    Slot& slot = m_slots[i];
+    int received = 0;
+    const bool completed = acsc_WaitForAsyncCall(m_handle, slot.result, &received, &slot.wait,
+      static_cast<int>(m_timeout.count())) != 0;
+
+    if (!completed) {
+      // Timed out or failed - make sure the library no longer writes into the caller's buffer
+      acsc_CancelOperation(m_handle, &slot.wait);
+      failures++;
+      if (slot.kind == Kind::Command) {
+        std::cout << "ACSAsyncTransport: ERROR - " << slot.label << " on axis " << slot.axis
+          << " failed. Error code: " << acsc_GetLastError() << std::endl;
+      }
+    }
+
+    if (slot.ok) {
+      *slot.ok = completed;
+    }
+  }
+
+  if (m_count > 0) {
+    m_stats.lastDrainMs = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - m_firstIssue).count();
+  }
+  m_stats.completed += m_count - failures;
+  m_stats.failed += failures;
+  m_count = 0;
+  return failures;
+}
+
+// === HELPERS ===
+
+ACSAsyncTransport::Slot* ACSAsyncTransport::Acquire(Kind kind, void* result, bool* ok, int axis, const char* label) {
+  // Window full - complete what is in flight before reusing slots
+  if (m_count == MAX_IN_FLIGHT) {
+    Drain();
+  }
+
+  if (m_count == 0) {
+    m_firstIssue = std::chrono::steady_clock::now();
+  }
+
+  Slot& slot = m_slots[m_count++];
+  std::memset(&slot.wait, 0, sizeof(slot.wait));
+  slot.kind = kind;
+  slot.result = result;
+  slot.ok = ok;
+  slot.axis = axis;
+  slot.label = label;
+
+  if (ok) {
+    *ok = false;
+  }
+  if (m_count > m_stats.maxDepth) {
+    m_stats.maxDepth = m_count;
+  }
+  return &slot;
+}
+
+// The request never left - drop its slot (always the last one)
+bool ACSAsyncTransport::Reject(Slot* slot) {
+  if (slot->kind == Kind::Command) {
+    std::cout << "ACSAsyncTransport: ERROR - Could not issue " << slot->label << " on axis " << slot->axis
+      << ". Error code: " << acsc_GetLastError() << std::endl;
+  }
+  m_count--;
+  m_stats.failed++;
+  return false;
+}
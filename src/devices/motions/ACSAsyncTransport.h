@@ -0,0 +1,82 @@
+// ACSAsyncTransport.h - Pipelined asynchronous ACSC calls on one controller connection
+#pragma once
+#include <Windows.h>
+#include <chrono>
+#include <cstdint>
+
+#include "ACSC.h"
+
+/**
+ * ACSAsyncTransport - Keeps several ACSC requests in flight and completes them together
+ *
+ * Every acsc_* call made with a NULL wait block is a full round trip. Issued
+ * with an ACSC_WAITBLOCK the call returns as soon as the request is sent, so
+ * the FPOS/MST reads and motion commands of one poll cycle go out back to
+ * back and Drain() collects all replies - the cycle costs one round trip
+ * instead of one per call.
+ *
+ * The transport is owned by a single thread (the ACSController comm thread):
+ * issue requests, then Drain() before reading any result. Result pointers
+ * must stay valid until Drain() returns. Slots are fixed, so issuing and
+ * draining never allocate; when all slots are busy the oldest requests are
+ * drained first.
+ */
+class ACSAsyncTransport {
+public:
+  struct Stats {
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    int maxDepth = 0;                    // Most requests in flight at once
+    double lastDrainMs = 0.0;            // Issue of the first request -> last reply
+  };
+
+  ACSAsyncTransport();
+  ~ACSAsyncTransport();
+
+  // Connection used by the following requests; nothing may be in flight
+  void Begin(HANDLE handle);
+
+  // Status reads - *ok is set when the reply arrives
+  bool GetFPosition(int axis, double* position, bool* ok);
+  bool GetMotorState(int axis, int* state, bool* ok);
+
+  // Commands - failures are reported by Drain() with the label
+  bool ToPoint(int flags, int axis, double point, const char* label);
+  bool Halt(int axis, const char* label);
+
+  // Complete every request in flight, in issue order. Returns the number that failed.
+  int Drain();
+
+  int InFlight() const { return m_count; }
+  const Stats& GetStats() const { return m_stats; }
+
+  void SetTimeout(std::chrono::milliseconds timeout) { m_timeout = timeout; }
+
+  static constexpr int MAX_IN_FLIGHT = 16;
+
+private:
+  enum class Kind {
+    Real,
+    Integer,
+    Command
+  };
+
+  struct Slot {
+    ACSC_WAITBLOCK wait;
+    Kind kind = Kind::Command;
+    void* result = nullptr;      // Caller's buffer for reads
+    bool* ok = nullptr;
+    int axis = -1;
+    const char* label = "";
+  };
+
+  Slot* Acquire(Kind kind, void* result, bool* ok, int axis, const char* label);
+  bool Reject(Slot* slot);
+
+  HANDLE m_handle;
+  Slot m_slots[MAX_IN_FLIGHT];
+  int m_count = 0;
+  std::chrono::steady_clock::time_point m_firstIssue;
+  std::chrono::milliseconds m_timeout{ 1000 };
+  Stats m_stats;
+};
@@ -0,0 +1,395 @@
+// ACSBufferProgramManager.cpp
+#include "ACSBufferProgramManager.h"
+#include "ACSController.h"
+#include "../../core/ConfigCache.h"
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+  // Forwards to the ACSC library on the controller's connection
+  class ACSCBackend : public ACSBufferProgramManager::Backend {
+  public:
+    explicit ACSCBackend(ACSController& controller) : m_controller(controller) {}
+
+    bool LoadBuffer(int buffer, const std::string& text) override {
+      std::string program = text;
+      return acsc_LoadBuffer(m_controller.GetHandle(), buffer, program.data(),
+        static_cast<int>(program.size()), ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool UploadBuffer(int buffer, int count, std::string& text) override {
+      std::vector<char> data(static_cast<size_t>(count) + 1, '\0');
+      int received = 0;
+      if (!acsc_UploadBuffer(m_controller.GetHandle(), buffer, 0, data.data(), count, &received, ACSC_SYNCHRONOUS)) {
+        return false;
+      }
+      text.assign(data.data(), std::clamp(received, 0, count));
+      return true;
+    }
+
+    bool CompileBuffer(int buffer) override {
+      return acsc_CompileBuffer(m_controller.GetHandle(), buffer, ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool GetProgramState(int buffer, int& state) override {
+      return acsc_GetProgramState(m_controller.GetHandle(), buffer, &state, ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool GetProgramError(int buffer, int& error) override {
+      return acsc_GetProgramError(m_controller.GetHandle(), buffer, &error, ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool DeclareArray(const std::string& name, int size) override {
+      std::string declaration = name + "(" + std::to_string(size) + ")";
+      return acsc_DeclareVariable(m_controller.GetHandle(), ACSC_REAL_TYPE, declaration.data(), ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool WriteArray(const std::string& name, const std::vector<double>& values) override {
+      std::string variable = name;
+      std::vector<double> data = values;
+      return acsc_WriteReal(m_controller.GetHandle(), ACSC_NONE, variable.data(), 0, static_cast<int>(data.size()) - 1,
+        ACSC_NONE, ACSC_NONE, data.data(), ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool RunBuffer(int buffer, const std::string& label) override {
+      std::string labelText = label;
+      return acsc_RunBuffer(m_controller.GetHandle(), buffer, label.empty() ? nullptr : labelText.data(),
+        ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool StopBuffer(int buffer) override {
+      return acsc_StopBuffer(m_controller.GetHandle(), buffer, ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool WaitProgramEnd(int buffer, int timeoutMs) override {
+      return acsc_WaitProgramEnd(m_controller.GetHandle(), buffer, timeoutMs) != 0;
+    }
+
+    int GetLastError() override { return acsc_GetLastError(); }
+
+  private:
+    ACSController& m_controller;
+  };
+
+  constexpr const char* kHashPrefix = "! P4HASH ";
+  constexpr int kStampLength = 9 + 16 + 1;   // Prefix, 16 hex digits, newline
+
+  std::string HashStamp(uint64_t hash) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%s%016llx\n", kHashPrefix, static_cast<unsigned long long>(hash));
+    return text;
+  }
+}
+
+ACSBufferProgramManager::ACSBufferProgramManager(ACSController& controller)
+  : m_backend(std::make_unique<ACSCBackend>(controller)) {
+}
+
+ACSBufferProgramManager::ACSBufferProgramManager(std::unique_ptr<Backend> backend)
+  : m_backend(std::move(backend)) {
+}
+
+// === PROGRAM LIBRARY ===
+
+bool ACSBufferProgramManager::LoadManifest(const std::string& directory) {
+  const std::string path = directory + "/programs.json";
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    std::cout << "ACSBufferProgramManager: ERROR - Cannot open " << path << std::endl;
+    return false;
+  }
+
+  nlohmann::json manifest;
+  try {
+    file >> manifest;
+  }
+  catch (const std::exception& e) {
+    std::cout << "ACSBufferProgramManager: ERROR - Parsing " << path << ": " << e.what() << std::endl;
+    return false;
+  }
+
+  m_directory = directory;
+  bool allValid = true;
+  for (const auto& entry : manifest.value("Programs", nlohmann::json::array())) {
+    Program program;
+    program.name = entry.value("Name", "");
+    program.buffer = entry.value("Buffer", -1);
+    program.source = entry.value("Source", "");
+    for (const auto& parameter : entry.value("Parameters", nlohmann::json::array())) {
+      program.parameters.push_back({ parameter.value("Name", ""), parameter.value("Default", 0.0) });
+    }
+    allValid &= AddProgram(program);
+  }
+
+  std::cout << "ACSBufferProgramManager: " << m_programs.size() << " programs in " << path << std::endl;
+  return allValid;
+}
+
+bool ACSBufferProgramManager::AddProgram(const Program& program) {
+  if (program.name.empty() || program.source.empty() || program.buffer < 0 || program.buffer > MAX_BUFFER) {
+    std::cout << "ACSBufferProgramManager: ERROR - Invalid program '" << program.name << "' (buffer "
+      << program.buffer << ", source '" << program.source << "')" << std::endl;
+    return false;
+  }
+  if (program.parameters.size() > static_cast<size_t>(MAX_PARAMETERS)) {
+    std::cout << "ACSBufferProgramManager: ERROR - Program '" << program.name << "' has more than "
+      << MAX_PARAMETERS << " parameters" << std::endl;
+    return false;
+  }
+
+  for (const auto& [name, existing] : m_programs) {
+    if (name != program.name && existing.buffer == program.buffer) {
+      std::cout << "ACSBufferProgramManager: ERROR - Buffer " << program.buffer << " already used by '"
+        << name << "'" << std::endl;
+      return false;
+    }
+  }
+
+  m_programs[program.name] = program;
+  m_loadedHashes.erase(program.buffer);
+  return true;
+}
+
+const ACSBufferProgramManager::Program* ACSBufferProgramManager::FindProgram(const std::string& name) const {
+  auto it = m_programs.find(name);
+  return it != m_programs.end() ? &it->second : nullptr;
+}
+
+std::vector<std::string> ACSBufferProgramManager::GetProgramNames() const {
+  std::vector<std::string> names;
+  for (const auto& [name, program] : m_programs) {
+    names.push_back(name);
+  }
+  return names;
+}
+
+// === UPLOAD ===
+
+bool ACSBufferProgramManager::Upload(const std::string& name, bool force) {
+  const Program* program = nullptr;
+  if (!CheckProgram(name, program)) {
+    return false;
+  }
+
+  std::string source;
+  if (!ReadSource(*program, source)) {
+    return false;
+  }
+  const uint64_t hash = HashSource(source);
+  const std::string stamp = HashStamp(hash);
+
+  if (!force) {
+    auto known = m_loadedHashes.find(program->buffer);
+    if (known != m_loadedHashes.end() && known->second == hash) {
+      return true;
+    }
+
+    // The stamp on the controller survives host restarts - skip the compile if it matches
+    std::string head;
+    int state = 0;
+    if (m_backend->UploadBuffer(program->buffer, kStampLength, head) && head == stamp &&
+      m_backend->GetProgramState(program->buffer, state) && (state & ACSC_PST_COMPILED)) {
+      m_loadedHashes[program->buffer] = hash;
+      std::cout << "ACSBufferProgramManager: '" << name << "' unchanged in buffer " << program->buffer << std::endl;
+      return true;
+    }
+  }
+
+  int state = 0;
+  if (m_backend->GetProgramState(program->buffer, state) && (state & ACSC_PST_RUN)) {
+    std::cout << "ACSBufferProgramManager: ERROR - Cannot load '" << name << "' - buffer "
+      << program->buffer << " is running" << std::endl;
+    return false;
+  }
+
+  // Arguments must exist before the program referencing them compiles
+  const std::string array = ArgumentArrayName(program->buffer);
+  if (!program->parameters.empty() && m_declared.count(array) == 0) {
+    if (!m_backend->DeclareArray(array, static_cast<int>(program->parameters.size()))) {
+      // Already declared by an earlier session is fine; the compile will tell otherwise
+      std::cout << "ACSBufferProgramManager: WARNING - Could not declare " << array << ". Error code: "
+        << m_backend->GetLastError() << std::endl;
+    }
+    m_declared.insert(array);
+  }
+
+  m_loadedHashes.erase(program->buffer);
+  if (!m_backend->LoadBuffer(program->buffer, stamp + source)) {
+    LogError("Loading '" + name + "' into buffer " + std::to_string(program->buffer));
+    return false;
+  }
+  if (!m_backend->CompileBuffer(program->buffer)) {
+    LogProgramError(*program);
+    return false;
+  }
+
+  m_loadedHashes[program->buffer] = hash;
+  std::cout << "ACSBufferProgramManager: Loaded and compiled '" << name << "' in buffer " << program->buffer
+    << " (" << source.size() << " bytes)" << std::endl;
+  return true;
+}
+
+bool ACSBufferProgramManager::UploadAll(bool force) {
+  bool allLoaded = true;
+  for (const auto& [name, program] : m_programs) {
+    allLoaded &= Upload(name, force);
+  }
+  return allLoaded;
+}
+
+// === EXECUTION ===
+
+bool ACSBufferProgramManager::Run(const std::string& name, const Parameters& parameters, const std::string& label) {
+  const Program* program = nullptr;
+  if (!CheckProgram(name, program) || !Upload(name)) {
+    return false;
+  }
+
+  for (const auto& [parameter, value] : parameters) {
+    const bool known = std::any_of(program->parameters.begin(), program->parameters.end(),
+      [&](const Parameter& p) { return p.name == parameter; });
+    if (!known) {
+      std::cout << "ACSBufferProgramManager: ERROR - '" << name << "' has no parameter '" << parameter << "'" << std::endl;
+      return false;
+    }
+  }
+
+  int state = 0;
+  if (m_backend->GetProgramState(program->buffer, state) && (state & ACSC_PST_RUN)) {
+    std::cout << "ACSBufferProgramManager: ERROR - '" << name << "' is already running" << std::endl;
+    return false;
+  }
+
+  // All arguments in one write
+  if (!program->parameters.empty()) {
+    std::vector<double> values;
+    values.reserve(program->parameters.size());
+    for (const auto& parameter : program->parameters) {
+      auto given = parameters.find(parameter.name);
+      values.push_back(given != parameters.end() ? given->second : parameter.defaultValue);
+    }
+    if (!m_backend->WriteArray(ArgumentArrayName(program->buffer), values)) {
+      LogError("Writing arguments of '" + name + "'");
+      return false;
+    }
+  }
+
+  if (!m_backend->RunBuffer(program->buffer, label)) {
+    LogError("Starting '" + name + "'");
+    return false;
+  }
+
+  std::cout << "ACSBufferProgramManager: Started '" << name << "' in buffer " << program->buffer
+    << (label.empty() ? "" : " at " + label) << std::endl;
+  return true;
+}
+
+bool ACSBufferProgramManager::Wait(const std::string& name, std::chrono::milliseconds timeout) {
+  const Program* program = nullptr;
+  if (!CheckProgram(name, program)) {
+    return false;
+  }
+
+  if (!m_backend->WaitProgramEnd(program->buffer, static_cast<int>(timeout.count()))) {
+    LogError("Waiting for '" + name + "'");
+    return false;
+  }
+
+  int error = 0;
+  if (m_backend->GetProgramError(program->buffer, error) && error != 0) {
+    LogProgramError(*program);
+    return false;
+  }
+  return true;
+}
+
+bool ACSBufferProgramManager::RunAndWait(const std::string& name, const Parameters& parameters,
+  std::chrono::milliseconds timeout, const std::string& label) {
+  if (!Run(name, parameters, label)) {
+    return false;
+  }
+  if (!Wait(name, timeout)) {
+    Stop(name);
+    return false;
+  }
+  return true;
+}
+
+bool ACSBufferProgramManager::Stop(const std::string& name) {
+  const Program* program = nullptr;
+  if (!CheckProgram(name, program)) {
+    return false;
+  }
+  if (!m_backend->StopBuffer(program->buffer)) {
+    LogError("Stopping '" + name + "'");
+    return false;
+  }
+  return true;
+}
+
+bool ACSBufferProgramManager::IsRunning(const std::string& name) {
+  const Program* program = FindProgram(name);
+  int state = 0;
+  return program && m_backend->GetProgramState(program->buffer, state) && (state & ACSC_PST_RUN);
+}
+
+void ACSBufferProgramManager::Invalidate() {
+  m_loadedHashes.clear();
+  m_declared.clear();
+}
+
+// === HELPERS ===
+
+uint64_t ACSBufferProgramManager::HashSource(const std::string& text) {
+  return ConfigCache::HashBytes(text.data(), text.size());
+}
+
+std::string ACSBufferProgramManager::ArgumentArrayName(int buffer) {
+  return "P4ARG" + std::to_string(buffer);
+}
+
+// Source with LF line endings, so the hash does not depend on how the file was checked out
+bool ACSBufferProgramManager::ReadSource(const Program& program, std::string& text) const {
+  const std::string path = m_directory + "/" + program.source;
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    std::cout << "ACSBufferProgramManager: ERROR - Cannot open " << path << std::endl;
+    return false;
+  }
+
+  std::ostringstream content;
+  content << file.rdbuf();
+  text = content.str();
+  text.erase(std::remove(text.begin(), text.end(), '\r'), text.end());
+  if (!text.empty() && text.back() != '\n') {
+    text += '\n';
+  }
+  return true;
+}
+
+bool ACSBufferProgramManager::CheckProgram(const std::string& name, const Program*& program) {
+  program = FindProgram(name);
+  if (!program) {
+    std::cout << "ACSBufferProgramManager: ERROR - Unknown program '" << name << "'" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void ACSBufferProgramManager::LogError(const std::string& action) {
+  std::cout << "ACSBufferProgramManager: ERROR - " << action << " failed. Error code: "
+    << m_backend->GetLastError() << std::endl;
+}
+
+// Compile and runtime errors are reported per buffer, not through acsc_GetLastError
+void ACSBufferProgramManager::LogProgramError(const Program& program) {
+  int error = 0;
+  m_backend->GetProgramError(program.buffer, error);
+  std::cout << "ACSBufferProgramManager: ERROR - '" << program.name << "' in buffer " << program.buffer
+    << " reported program error " << error << " (library error " << m_backend->GetLastError() << ")" << std::endl;
+}
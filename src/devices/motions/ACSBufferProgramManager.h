@@ -0,0 +1,111 @@
+// ACSBufferProgramManager.h - ACSPL+ buffer programs kept in the repo and run with parameters
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+class ACSController;
+
+/**
+ * ACSBufferProgramManager - Uploads, compiles and runs ACSPL+ programs
+ *
+ * Programs live in acspl/ (relative to the working directory, like config/) and
+ * are listed in acspl/programs.json:
+ *   { "Programs": [ { "Name": "DispenseDots", "Buffer": 5,
+ *                     "Source": "dispense_dots.prg",
+ *                     "Parameters": [ { "Name": "Count", "Default": 1 }, { "Name": "Pitch" }, ... ] } ] }
+ *
+ * Upload: the source is stamped with a "! P4HASH <hash>" first line. If
+ * the buffer already carries that stamp and is compiled, nothing is sent;
+ * otherwise it is loaded with acsc_LoadBuffer and compiled once.
+ *
+ * Parameters: each program gets a global REAL array P4ARG<buffer>(n), one
+ * element per listed parameter in order. Run() writes the whole array
+ * with a single acsc_WriteReal before starting the buffer, so the program
+ * reads e.g. P4ARG5(0) for Count. Parameters not passed take their default.
+ *
+ * Usage:
+ *   ACSBufferProgramManager programs(controller);
+ *   programs.LoadManifest();
+ *   programs.Upload("DispenseDots");
+ *   programs.RunAndWait("DispenseDots", { { "Count", 12 }, { "Pitch", 1.5 } }, std::chrono::seconds(20));
+ */
+class ACSBufferProgramManager {
+public:
+  struct Parameter {
+    std::string name;
+    double defaultValue = 0.0;
+  };
+
+  struct Program {
+    std::string name;
+    int buffer = -1;
+    std::string source;                  // File name inside the program directory
+    std::vector<Parameter> parameters;   // Index in P4ARG<buffer> = position in this list
+  };
+
+  using Parameters = std::map<std::string, double>;
+
+  // Controller calls used by the manager - same shape as the ACSC functions
+  class Backend {
+  public:
+    virtual ~Backend() = default;
+    virtual bool LoadBuffer(int buffer, const std::string& text) = 0;
+    virtual bool UploadBuffer(int buffer, int count, std::string& text) = 0;
+    virtual bool CompileBuffer(int buffer) = 0;
+    virtual bool GetProgramState(int buffer, int& state) = 0;
+    virtual bool GetProgramError(int buffer, int& error) = 0;
+    virtual bool DeclareArray(const std::string& name, int size) = 0;
+    virtual bool WriteArray(const std::string& name, const std::vector<double>& values) = 0;
+    virtual bool RunBuffer(int buffer, const std::string& label) = 0;
+    virtual bool StopBuffer(int buffer) = 0;
+    virtual bool WaitProgramEnd(int buffer, int timeoutMs) = 0;
+    virtual int GetLastError() = 0;
+  };
+
+  explicit ACSBufferProgramManager(ACSController& controller);   // Real controller via ACSC
+  explicit ACSBufferProgramManager(std::unique_ptr<Backend> backend);
+
+  // Program library
+  bool LoadManifest(const std::string& directory = "acspl");
+  bool AddProgram(const Program& program);
+  const Program* FindProgram(const std::string& name) const;
+  std::vector<std::string> GetProgramNames() const;
+
+  // Upload and compile when the source changed (force = always reload)
+  bool Upload(const std::string& name, bool force = false);
+  bool UploadAll(bool force = false);
+
+  // Execution
+  bool Run(const std::string& name, const Parameters& parameters = {}, const std::string& label = "");
+  bool Wait(const std::string& name, std::chrono::milliseconds timeout);
+  bool RunAndWait(const std::string& name, const Parameters& parameters, std::chrono::milliseconds timeout,
+    const std::string& label = "");
+  bool Stop(const std::string& name);
+  bool IsRunning(const std::string& name);
+
+  // Forget what is known about the controller (after a reconnect or controller reboot)
+  void Invalidate();
+
+  static uint64_t HashSource(const std::string& text);
+  static std::string ArgumentArrayName(int buffer);
+
+  static constexpr int MAX_BUFFER = 63;
+  static constexpr int MAX_PARAMETERS = 64;
+
+private:
+  bool ReadSource(const Program& program, std::string& text) const;
+  bool CheckProgram(const std::string& name, const Program*& program);
+  void LogError(const std::string& action);
+  void LogProgramError(const Program& program);
+
+  std::unique_ptr<Backend> m_backend;
+  std::string m_directory = "acspl";
+  std::map<std::string, Program> m_programs;
+  std::map<int, uint64_t> m_loadedHashes;   // Buffer -> hash verified this session
+  std::set<std::string> m_declared;         // Argument arrays declared this session
+};
@@ -1,15 +1,25 @@
 ﻿// acs_controller.cpp
 #include "ACSController.h"
+#include "../../core/TelemetrySegment.h"
+#include "../../utils/AllocationTracker.h"
+#include "../../utils/IOExecutor.h"
+#include "../../utils/ThreadPolicy.h"
 
 #include <iostream>
 #include <chrono>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 #include <iomanip>  // For std::setprecision
 
+static_assert(ControllerTraits::ACSGantryXYZ::kAxisIndices[0] == ACSC_AXIS_X &&
+  ControllerTraits::ACSGantryXYZ::kAxisIndices[1] == ACSC_AXIS_Y &&
+  ControllerTraits::ACSGantryXYZ::kAxisIndices[2] == ACSC_AXIS_Z, "Gantry traits out of step with ACSC axis indices");
+
 // Constructor - initialize with correct axis identifiers
-ACSController::ACSController()
-  : m_controllerId(ACSC_INVALID),
+ACSController::ACSController(IOExecutor* executor)
+  : m_executor(executor),
+  m_controllerId(ACSC_INVALID),
   m_port(ACSC_SOCKET_STREAM_PORT) {
 
   // Initialize atomic variables
@@ -21,6 +31,7 @@ ACSController::ACSController()
 
   // Initialize available axes with string identifiers (consistent with PI controller)
   m_availableAxes = { "X", "Y", "Z" };
+  ApplyAxisLayout();
 
   // Start communication thread
   StartCommunicationThread();
@@ -29,6 +40,9 @@ ACSController::ACSController()
 ACSController::~ACSController() {
   std::cout << "ACSController: Shutting down controller" << std::endl;
 
+  // Unregister first - waits for any recovery that is still using this controller
+  HealthWatchdog::Instance().Unregister(m_watchdogId.exchange(-1));
+
   // Stop communication thread
   StopCommunicationThread();
 
@@ -36,25 +50,68 @@ ACSController::~ACSController() {
   if (m_isConnected) {
     Disconnect();
   }
+
+  // Last resort: a thread still blocked in a vendor call must finish before we go away
+  if (m_communicationThread.joinable()) {
+    std::cout << "ACSController: Waiting for blocked communication thread" << std::endl;
+    m_communicationThread.join();
+  }
+  if (m_executor && m_threadRunning) {
+    std::cout << "ACSController: Waiting for blocked communication task" << std::endl;
+    m_executor->Cancel(m_executorTask, IOExecutor::kWaitForever);
+  }
 }
 
 void ACSController::StartCommunicationThread() {
   if (!m_threadRunning) {
     m_threadRunning.store(true);
     m_terminateThread.store(false);
+    m_threadExited.store(false);
+    m_lastStatusUpdate = std::chrono::steady_clock::now();
+    m_lastPositionUpdate = m_lastStatusUpdate;
+
+    if (m_executor) {
+      m_executorTask = m_executor->Schedule(CommThreadName(), [this]() { return CommunicationTick(); });
+      std::cout << "ACSController: Communication task scheduled on " << m_executor->GetName() << std::endl;
+      return;
+    }
+
     m_communicationThread = std::thread(&ACSController::CommunicationThreadFunc, this);
     std::cout << "ACSController: Communication thread started" << std::endl;
   }
 }
 
-void ACSController::StopCommunicationThread() {
+bool ACSController::StopCommunicationThread(std::chrono::milliseconds timeout) {
   if (m_threadRunning) {
     {
-      std::lock_guard<std::mutex> lock(m_mutex);
+      ProfiledLockGuard lock(m_mutex);
       m_terminateThread.store(true);
     }
     m_condVar.notify_all();
 
+    if (m_executor) {
+      // Returns once no tick is in flight; a tick blocked in a vendor call keeps it running
+      if (!m_executor->Cancel(m_executorTask, timeout)) {
+        std::cout << "ACSController: Communication task did not finish within " << timeout.count()
+          << " ms - still blocked in a controller call" << std::endl;
+        return false;
+      }
+      m_threadExited.store(true);
+      m_threadRunning.store(false);
+      std::cout << "ACSController: Communication task cancelled" << std::endl;
+      return true;
+    }
+
+    // A hung vendor call would block join() forever - wait with a deadline first
+    {
+      ProfiledUniqueLock lock(m_mutex);
+      if (!m_condVar.wait_for(lock, timeout, [this]() { return m_threadExited.load(); })) {
+        std::cout << "ACSController: Communication thread did not exit within " << timeout.count()
+          << " ms - still blocked in a controller call" << std::endl;
+        return false;
+      }
+    }
+
     if (m_communicationThread.joinable()) {
       m_communicationThread.join();
     }
@@ -62,143 +119,368 @@ void ACSController::StopCommunicationThread() {
     m_threadRunning.store(false);
     std::cout << "ACSController: Communication thread stopped" << std::endl;
   }
+  return true;
+}
+
+std::string ACSController::CommThreadName() const {
+  return m_deviceName.empty() ? "ACS comm" : "ACS comm " + m_deviceName;
 }
 
 void ACSController::CommunicationThreadFunc() {
+  ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::MotionIO, CommThreadName());
+
+  while (!m_terminateThread) {
+    auto sleepTime = CommunicationTick();
+
+    // Wait for next update or termination
+    ProfiledUniqueLock lock(m_mutex);
+    if (sleepTime.count() > 0) {
+      m_condVar.wait_for(lock, sleepTime, [this]() {
+        return m_terminateThread.load() || (m_commandPending.load() && m_isConnected.load());
+      });
+    }
+    else {
+      // No sleep needed if we're already behind schedule, but yield to let other threads run
+      lock.unlock();
+      std::this_thread::yield();
+    }
+  }
+
+  // Tell StopCommunicationThread we are done
+  {
+    ProfiledLockGuard lock(m_mutex);
+    m_threadExited.store(true);
+  }
+  m_condVar.notify_all();
+}
+
+std::chrono::milliseconds ACSController::CommunicationTick() {
   // Set update interval to 200ms (5 Hz)
   const auto updateInterval = std::chrono::milliseconds(200);
 
-  // Frame counter for less frequent updates
-  int frameCounter = 0;
+  if (m_terminateThread) {
+    return IOExecutor::kStop;
+  }
 
-  // Initialization of last update timestamps
-  m_lastStatusUpdate = std::chrono::steady_clock::now();
-  m_lastPositionUpdate = m_lastStatusUpdate;
+  auto cycleStartTime = std::chrono::steady_clock::now();
+  HealthWatchdog::Instance().Heartbeat(m_watchdogId.load());
 
-  while (!m_terminateThread) {
-    auto cycleStartTime = std::chrono::steady_clock::now();
+  // Only update if connected
+  if (m_isConnected) {
+    AllocationTracker::Scope allocScope("ACSController::CommTick");
+    m_frameCounter++;
 
-    // Process any pending motor commands first for responsiveness
-    {
-      std::lock_guard<std::mutex> lock(m_commandMutex);
-      for (auto& cmd : m_commandQueue) {
-        if (!cmd.executed) {
-          // Execute the command
-          MoveRelative(cmd.axis, cmd.distance, false);
-          cmd.executed = true;
-        }
-      }
+    // Queued moves and status reads go out as one pipelined batch.
+    // Motor state (moving and servo flags) every 3rd frame, ~1.67Hz.
+    PollStatus(m_frameCounter % 3 == 0);
+
+    PublishTelemetry();
+  }
+
+  // Calculate how long to sleep to maintain consistent update rate
+  auto cycleEndTime = std::chrono::steady_clock::now();
+  auto cycleDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
+    cycleEndTime - cycleStartTime);
+  // Faster polling while jogging, so the jog deadman is checked in time
+  auto sleepTime = (IsJogging() ? kJogPollInterval : updateInterval) - cycleDuration;
+  return std::max(sleepTime, std::chrono::milliseconds(0));
+}
+
+// ============================================================================
+// HEALTH MONITORING
+// ============================================================================
+
+void ACSController::RegisterWatchdog() {
+  HealthWatchdog::ChannelOptions options;
+  options.deadline = m_watchdogDeadline;
+  options.recovery = m_watchdogRecovery;
+  options.onStaleChanged = [this](bool stale) {
+    m_dataStale.store(stale);
+    TelemetrySegment::Instance().UpdateMotionFlags(m_telemetrySlot.load(),
+      stale ? Telemetry::kFlagStale : 0, stale ? 0 : Telemetry::kFlagStale);
+  };
+  if (m_watchdogRecovery == HealthWatchdog::Recovery::Reconnect) {
+    options.onRecover = [this]() { return Reconnect(); };
+  }
+  else if (m_watchdogRecovery == HealthWatchdog::Recovery::SafeStop) {
+    options.onRecover = [this]() { return StopAllAxes(); };
+  }
+
+  std::string name = "ACS:" + (m_deviceName.empty() ? m_ipAddress : m_deviceName);
+  m_watchdogId.store(HealthWatchdog::Instance().Register(name, options));
+}
+
+void ACSController::SetWatchdogPolicy(std::chrono::milliseconds deadline, HealthWatchdog::Recovery recovery) {
+  m_watchdogDeadline = deadline;
+  m_watchdogRecovery = recovery;
+
+  // Re-register so the new policy takes effect immediately
+  if (m_watchdogId.load() >= 0) {
+    HealthWatchdog::Instance().Unregister(m_watchdogId.exchange(-1));
+    RegisterWatchdog();
+    HealthWatchdog::Instance().SetMonitored(m_watchdogId.load(), m_isConnected.load());
+  }
+}
+
+bool ACSController::Reconnect() {
+  const std::string ipAddress = m_ipAddress;
+  const int port = m_port;
+
+  std::cout << "ACSController: Reconnecting to " << ipAddress << ":" << port << std::endl;
+
+  // Stop the poller first so nothing touches the handle while it is replaced
+  bool threadStopped = StopCommunicationThread();
+  Disconnect();
 
-      // Remove executed commands
-      m_commandQueue.erase(
-        std::remove_if(m_commandQueue.begin(), m_commandQueue.end(),
-          [](const MotorCommand& cmd) { return cmd.executed; }),
-        m_commandQueue.end());
+  // Closing the handle unblocks a hung vendor call
+  if (!threadStopped && !StopCommunicationThread()) {
+    std::cout << "ACSController: Reconnect aborted - communication thread still blocked" << std::endl;
+    return false;
+  }
+
+  if (!Connect(ipAddress, port)) {
+    return false;
+  }
+
+  StartCommunicationThread();
+  return true;
+}
+
+// Copy the cached status into this controller's telemetry slot
+void ACSController::PublishTelemetry() {
+  if (m_telemetrySlot < 0) {
+    return;
+  }
+
+  Telemetry::MotionSnapshot snapshot{};
+  snapshot.timestampNs = TelemetrySegment::NowNs();
+  snapshot.frameCounter = ++m_telemetryFrame;
+  snapshot.flags = Telemetry::kFlagConnected;
+
+  {
+    ProfiledLockGuard lock(m_mutex);
+    const int axisCount = std::min<int>(static_cast<int>(m_availableAxes.size()), Telemetry::kMaxAxes);
+    for (int i = 0; i < axisCount; i++) {
+      const std::string& axis = m_availableAxes[i];
+      auto pos = m_axisPositions.find(axis);
+      if (pos != m_axisPositions.end()) snapshot.positions[i] = pos->second;
+      auto moving = m_axisMoving.find(axis);
+      if (moving != m_axisMoving.end() && moving->second) snapshot.movingMask |= (1u << i);
+      auto servo = m_axisServoEnabled.find(axis);
+      if (servo != m_axisServoEnabled.end() && servo->second) snapshot.servoMask |= (1u << i);
     }
+  }
 
-    // Only update if connected
-    if (m_isConnected) {
-      frameCounter++;
+  TelemetrySegment::Instance().PublishMotion(m_telemetrySlot, snapshot);
+}
 
-      // Always update positions
-      std::map<std::string, double> positions;
-      if (GetPositions(positions)) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_axisPositions = positions;
-        m_lastPositionUpdate = std::chrono::steady_clock::now();
-      }
+// Issue queued moves asynchronously - completed by the Drain() in PollStatus
+void ACSController::ProcessCommandQueue() {
+  ProfiledLockGuard lock(m_commandMutex);
+  m_commandPending.store(false);
 
-      // Update other status less frequently (every 3rd frame, ~1.67Hz)
-      if (frameCounter % 3 == 0) {
-        // Update axis motion status for X, Y, Z only
-        for (const auto& axis : { "X", "Y", "Z" }) {
-          bool moving = IsMoving(axis);
-          std::lock_guard<std::mutex> lock(m_mutex);
-          m_axisMoving[axis] = moving;
-        }
-
-        // Update servo status for X, Y, Z only
-        for (const auto& axis : { "X", "Y", "Z" }) {
-          bool enabled;
-          if (IsServoEnabled(axis, enabled)) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_axisServoEnabled[axis] = enabled;
-          }
-        }
-
-        m_lastStatusUpdate = std::chrono::steady_clock::now();
-      }
+  for (const auto& cmd : m_commandQueue) {
+    int axisIndex = GetAxisIndex(cmd.axis);
+    if (axisIndex >= 0) {
+      m_transport.ToPoint(cmd.relative ? ACSC_AMF_RELATIVE : 0, axisIndex, cmd.value,
+        cmd.relative ? "queued relative move" : "queued move");
     }
+  }
 
-    // Calculate how long to sleep to maintain consistent update rate
-    auto cycleEndTime = std::chrono::steady_clock::now();
-    auto cycleDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
-      cycleEndTime - cycleStartTime);
-    auto sleepTime = updateInterval - cycleDuration;
+  // clear() keeps the capacity - no allocation on the next tick
+  m_commandQueue.clear();
+}
 
-    // Wait for next update or termination
-    std::unique_lock<std::mutex> lock(m_mutex);
-    if (sleepTime.count() > 0) {
-      m_condVar.wait_for(lock, sleepTime, [this]() { return m_terminateThread.load(); });
+bool ACSController::QueueMove(const std::string& axis, double value, bool relative) {
+  if (!m_isConnected) {
+    std::cout << "ACSController: ERROR - Cannot queue move - not connected" << std::endl;
+    return false;
+  }
+  if (GetAxisIndex(axis) < 0) {
+    return false;
+  }
+
+  {
+    ProfiledLockGuard lock(m_commandMutex);
+    m_commandQueue.push_back({ axis, value, relative });
+  }
+  NoteCommand(axis, relative ? m_estimator.Query(EstimatorSlot(axis)).position + value : value);
+
+  // Wake the communication thread instead of waiting for the next poll
+  {
+    ProfiledLockGuard lock(m_mutex);
+    m_commandPending.store(true);
+  }
+  m_condVar.notify_all();
+  if (m_executor) {
+    m_executor->Wake(m_executorTask);
+  }
+  return true;
+}
+
+bool ACSController::Jog(const std::string& axis, double velocity) {
+  if (!m_isConnected) {
+    std::cout << "ACSController: ERROR - Cannot jog - not connected" << std::endl;
+    return false;
+  }
+
+  int axisIndex = GetAxisIndex(axis);
+  if (axisIndex < 0 || axisIndex >= kMaxPolledAxes) {
+    return false;
+  }
+
+  ProfiledLockGuard lock(m_commandMutex);
+  JogState& jog = m_jogs[axisIndex];
+
+  // Release: halt now rather than on the next poll
+  if (velocity == 0.0) {
+    if (!jog.active) {
+      return true;
     }
-    else {
-      // No sleep needed if we're already behind schedule, but yield to let other threads run
-      lock.unlock();
-      std::this_thread::yield();
+    jog.active = false;
+    m_activeJogs--;
+    if (!acsc_Halt(m_controllerId, axisIndex, NULL)) {
+      int error = acsc_GetLastError();
+      std::cout << "ACSController: ERROR - Failed to halt jog on axis " << axis << ". Error code: " << error << std::endl;
+      return false;
     }
+    return true;
   }
-}
 
-// Helper method to process the command queue
-void ACSController::ProcessCommandQueue() {
-  std::lock_guard<std::mutex> lock(m_commandMutex);
-  for (auto& cmd : m_commandQueue) {
-    if (!cmd.executed) {
-      // Execute the command
-      MoveRelative(cmd.axis, cmd.distance, false);
-      cmd.executed = true;
+  jog.refreshed = std::chrono::steady_clock::now();
+
+  // Only re-send on a start, a reversal or a speed change of more than 2%
+  const bool changed = !jog.active || (velocity > 0.0) != (jog.velocity > 0.0) ||
+    std::abs(velocity - jog.velocity) > 0.02 * std::abs(jog.velocity);
+  if (!changed) {
+    return true;
+  }
+
+  // The sign of the velocity gives the direction
+  if (!acsc_Jog(m_controllerId, ACSC_AMF_VELOCITY, axisIndex, velocity, NULL)) {
+    int error = acsc_GetLastError();
+    std::cout << "ACSController: ERROR - Failed to jog axis " << axis << ". Error code: " << error << std::endl;
+    return false;
+  }
+
+  if (!jog.active) {
+    jog.active = true;
+    m_activeJogs++;
+    // Velocity mode has no target - only the samples describe the axis
+    if (EstimatorSlot(axis) >= 0) {
+      m_estimator.ClearCommand(EstimatorSlot(axis));
     }
   }
+  jog.velocity = velocity;
+  return true;
+}
 
-  // Remove executed commands
-  m_commandQueue.erase(
-    std::remove_if(m_commandQueue.begin(), m_commandQueue.end(),
-      [](const MotorCommand& cmd) { return cmd.executed; }),
-    m_commandQueue.end());
+bool ACSController::StopJog() {
+  bool success = true;
+  for (int axisIndex = 0; axisIndex < kMaxPolledAxes; axisIndex++) {
+    bool active = false;
+    {
+      ProfiledLockGuard lock(m_commandMutex);
+      active = m_jogs[axisIndex].active;
+    }
+    if (active && m_isConnected && !acsc_Halt(m_controllerId, axisIndex, NULL)) {
+      int error = acsc_GetLastError();
+      std::cout << "ACSController: ERROR - Failed to halt jog on axis " << axisIndex << ". Error code: " << error << std::endl;
+      success = false;
+    }
+  }
+  ClearJog(-1);
+  return success;
 }
 
-// Helper method to update positions using batch query
-void ACSController::UpdatePositions() {
-  if (!m_isConnected) return;
+// Communication thread: halt jogs whose input stopped refreshing (UI hang, lost focus)
+void ACSController::CheckJogDeadman() {
+  if (!IsJogging()) {
+    return;
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  ProfiledLockGuard lock(m_commandMutex);
+  for (int axisIndex = 0; axisIndex < kMaxPolledAxes; axisIndex++) {
+    JogState& jog = m_jogs[axisIndex];
+    if (jog.active && now - jog.refreshed > kJogDeadman) {
+      jog.active = false;
+      m_activeJogs--;
+      m_transport.Halt(axisIndex, "jog deadman halt");
+      std::cout << "ACSController: WARNING - Jog on axis " << axisIndex << " not refreshed - halting" << std::endl;
+    }
+  }
+}
 
-  std::map<std::string, double> positions;
-  if (GetPositions(positions)) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_axisPositions = positions;
-    m_lastPositionUpdate = std::chrono::steady_clock::now();
+void ACSController::ClearJog(int axisIndex) {
+  ProfiledLockGuard lock(m_commandMutex);
+  for (int i = 0; i < kMaxPolledAxes; i++) {
+    if ((axisIndex < 0 || axisIndex == i) && m_jogs[i].active) {
+      m_jogs[i].active = false;
+      m_activeJogs--;
+    }
   }
 }
 
-// Helper method to update motor status (moving, servo state)
-void ACSController::UpdateMotorStatus() {
+// One poll cycle: queued commands, FPOS and (optionally) MST for all axes are
+// issued back to back and completed together - one round trip instead of one per call
+void ACSController::PollStatus(bool includeMotorState) {
   if (!m_isConnected) return;
 
+  const int axisCount = m_polledAxisCount;
+  const auto issued = std::chrono::steady_clock::now();
+
+  m_transport.Begin(m_controllerId);
+  ProcessCommandQueue();
+  CheckJogDeadman();
+
+  for (int i = 0; i < axisCount; i++) {
+    m_positionOk[i] = false;
+    m_stateOk[i] = false;
+    const int axisIndex = m_polledAxisIndex[i];
+    if (axisIndex < 0) {
+      continue;
+    }
+    m_transport.GetFPosition(axisIndex, &m_polledPositions[i], &m_positionOk[i]);
+    if (includeMotorState) {
+      m_transport.GetMotorState(axisIndex, &m_polledStates[i], &m_stateOk[i]);
+    }
+  }
+
+  m_transport.Drain();
+
   auto now = std::chrono::steady_clock::now();
+  bool allPositions = true;
 
-  // Use batch queries if possible, otherwise query each axis
-  for (const auto& axis : m_availableAxes) {
-    int axisIndex = GetAxisIndex(axis);
-    if (axisIndex >= 0) {
-      int state = 0;
-      if (acsc_GetMotorState(m_controllerId, axisIndex, &state, NULL)) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_axisMoving[axis] = (state & ACSC_MST_MOVE) != 0;
-        m_axisServoEnabled[axis] = (state & ACSC_MST_ENABLE) != 0;
-      }
+  // The batch is answered in order - midway is the best guess of when FPOS was sampled
+  const auto positionTime = issued + (now - issued) / 2;
+  for (int i = 0; i < axisCount; i++) {
+    if (m_positionOk[i]) {
+      m_estimator.AddSample(i, positionTime, m_polledPositions[i]);
+    }
+  }
+
+  ProfiledLockGuard lock(m_mutex);
+  for (int i = 0; i < axisCount; i++) {
+    const std::string& axis = m_availableAxes[i];
+    if (m_positionOk[i]) {
+      m_axisPositions[axis] = m_polledPositions[i];
+    }
+    else {
+      allPositions = false;
+    }
+    if (m_stateOk[i]) {
+      m_axisMoving[axis] = (m_polledStates[i] & ACSC_MST_MOVE) != 0;
+      m_axisServoEnabled[axis] = (m_polledStates[i] & ACSC_MST_ENABLE) != 0;
     }
   }
 
-  m_lastStatusUpdate = now;
+  if (allPositions) {
+    m_lastPositionUpdate = now;
+  }
+  if (includeMotorState) {
+    m_lastStatusUpdate = now;
+  }
 }
 
 // Helper to convert string axis identifiers to ACS axis indices
@@ -211,6 +493,30 @@ int ACSController::GetAxisIndex(const std::string& axis) {
   return -1;
 }
 
+int ACSController::EstimatorSlot(const std::string& axis) const {
+  for (int i = 0; i < m_polledAxisCount; i++) {
+    if (m_availableAxes[i] == axis) return i;
+  }
+  return -1;
+}
+
+void ACSController::NoteCommand(const std::string& axis, double target) {
+  const int slot = EstimatorSlot(axis);
+  if (slot >= 0) {
+    m_estimator.SetCommand(slot, std::chrono::steady_clock::now(), target);
+  }
+}
+
+bool ACSController::GetEstimatedPosition(const std::string& axis, AxisStateEstimator::Estimate& estimate,
+  std::chrono::steady_clock::time_point time) const {
+  const int slot = EstimatorSlot(axis);
+  if (slot < 0) {
+    return false;
+  }
+  estimate = m_estimator.Query(slot, time);
+  return estimate.valid;
+}
+
 bool ACSController::Connect(const std::string& ipAddress, int port) {
   // Check if already connected
   if (m_isConnected) {
@@ -239,6 +545,7 @@ bool ACSController::Connect(const std::string& ipAddress, int port) {
   }
 
   m_isConnected.store(true);
+  m_estimator.Reset();
   std::cout << "ACSController: Successfully connected to " << ipAddress << std::endl;
 
   // Enable all configured axes
@@ -258,7 +565,7 @@ bool ACSController::Connect(const std::string& ipAddress, int port) {
   // Initialize position cache immediately
   std::map<std::string, double> initialPositions;
   if (GetPositions(initialPositions)) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    ProfiledLockGuard lock(m_mutex);
     m_axisPositions = initialPositions;
     m_lastPositionUpdate = std::chrono::steady_clock::now();
 
@@ -276,6 +583,16 @@ bool ACSController::Connect(const std::string& ipAddress, int port) {
     std::cout << "ACSController: WARNING - Failed to initialize position cache after connection" << std::endl;
   }
 
+  // Publish snapshots for external analysis tools
+  m_telemetrySlot = TelemetrySegment::Instance().AcquireMotionSlot(
+    m_deviceName.empty() ? m_ipAddress : m_deviceName, "ACS", m_availableAxes);
+
+  // Start deadline monitoring of the communication thread
+  if (m_watchdogId.load() < 0) {
+    RegisterWatchdog();
+  }
+  HealthWatchdog::Instance().SetMonitored(m_watchdogId.load(), true);
+
   return true;
 }
 
@@ -289,6 +606,9 @@ bool ACSController::Disconnect() {
 
   std::cout << "ACSController: Disconnecting from controller" << std::endl;
 
+  // Intentional disconnect - not a stall
+  HealthWatchdog::Instance().SetMonitored(m_watchdogId.load(), false);
+
   bool success = true;
 
   // Ensure all axes are stopped before disconnecting
@@ -304,6 +624,8 @@ bool ACSController::Disconnect() {
     success = false;
   }
 
+  TelemetrySegment::Instance().ReleaseMotionSlot(m_telemetrySlot.exchange(-1));
+
   // Always update connection state regardless of close result
   m_isConnected.store(false);
   m_controllerId = ACSC_INVALID;
@@ -345,6 +667,7 @@ bool ACSController::MoveToPosition(const std::string& axis, double position, boo
   if (!StartMotion(axis)) {
     return false;
   }
+  NoteCommand(axis, position);
 
   // If blocking mode, wait for motion to complete
   if (blocking) {
@@ -380,6 +703,7 @@ bool ACSController::MoveRelative(const std::string& axis, double distance, bool
   double distances[1] = { distance };
 
   // Command the relative move
+  const double start = m_estimator.Query(EstimatorSlot(axis)).position;
   if (!acsc_ToPointM(m_controllerId, ACSC_AMF_WAIT | ACSC_AMF_RELATIVE, axes, distances, NULL)) {
     int error = acsc_GetLastError();
     std::cout << "ACSController: ERROR - Failed to move axis relatively. Error code: " << error << std::endl;
@@ -390,6 +714,7 @@ bool ACSController::MoveRelative(const std::string& axis, double distance, bool
   if (!StartMotion(axis)) {
     return false;
   }
+  NoteCommand(axis, start + distance);
 
   // If blocking mode, wait for motion to complete
   if (blocking) {
@@ -411,6 +736,9 @@ bool ACSController::HomeAxis(const std::string& axis) {
   }
 
   std::cout << "ACSController: Homing axis " << axis << std::endl;
+  if (EstimatorSlot(axis) >= 0) {
+    m_estimator.ClearCommand(EstimatorSlot(axis));
+  }
 
   // Option 1: Use a direct FaultClear + Home sequence
   if (!acsc_FaultClear(m_controllerId, axisIndex, NULL)) {
@@ -435,6 +763,10 @@ bool ACSController::StopAxis(const std::string& axis) {
   }
 
   std::cout << "ACSController: Stopping axis " << axis << std::endl;
+  ClearJog(axisIndex);
+  if (EstimatorSlot(axis) >= 0) {
+    m_estimator.ClearCommand(EstimatorSlot(axis));
+  }
 
   // Command the stop
   if (!acsc_Halt(m_controllerId, axisIndex, NULL)) {
@@ -453,6 +785,8 @@ bool ACSController::StopAllAxes() {
   }
 
   std::cout << "ACSController: Stopping all axes" << std::endl;
+  ClearJog(-1);
+  m_estimator.ClearCommand(-1);
 
   // Command the stop for all axes
   if (!acsc_KillAll(m_controllerId, NULL)) {
@@ -476,7 +810,7 @@ bool ACSController::IsMoving(const std::string& axis) {
 
   if (elapsed < m_statusUpdateInterval) {
     // Use cached value if it exists and is recent
-    std::lock_guard<std::mutex> lock(m_mutex);
+    ProfiledLockGuard lock(m_mutex);
     auto it = m_axisMoving.find(axis);
     if (it != m_axisMoving.end()) {
       return it->second;
@@ -500,7 +834,7 @@ bool ACSController::IsMoving(const std::string& axis) {
 
   // Update the cache
   {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    ProfiledLockGuard lock(m_mutex);
     m_axisMoving[axis] = isMoving;
     m_lastStatusUpdate = now;
   }
@@ -513,6 +847,11 @@ bool ACSController::GetPosition(const std::string& axis, double& position) {
     return false;
   }
 
+  // A stalled comm thread means the link is hung - do not queue another read behind it
+  if (m_dataStale.load()) {
+    return false;
+  }
+
   int axisIndex = GetAxisIndex(axis);
   if (axisIndex < 0) {
     return false;
@@ -534,37 +873,72 @@ bool ACSController::GetPositions(std::map<std::string, double>& positions) {
   if (!m_isConnected || m_availableAxes.empty()) {
     return false;
   }
+  return (this->*m_getPositions)(positions);
+}
 
-  // Since we now have only X, Y, Z axes, we can optimize this for exactly 3 axes
-  // Create arrays for the axes we know we have
-  int axisIndices[3] = {
-      GetAxisIndex("X"), GetAxisIndex("Y"), GetAxisIndex("Z")
-  };
-  double posArray[3] = { 0.0 };
+// Known layout: axis indices are compile-time constants, no name lookups
+template <typename Traits>
+bool ACSController::GetPositionsFixed(std::map<std::string, double>& positions) {
+  double posArray[Traits::kAxisCount] = { 0.0 };
+  bool success = true;
+  for (int i = 0; i < Traits::kAxisCount; i++) {
+    if (!acsc_GetFPosition(m_controllerId, Traits::kAxisIndices[i], &posArray[i], NULL)) {
+      success = false;
+    }
+  }
+
+  if (success) {
+    // m_availableAxes matches Traits::kAxes for this model
+    for (int i = 0; i < Traits::kAxisCount; i++) {
+      positions[m_availableAxes[i]] = posArray[i];
+    }
+  }
+  return success;
+}
 
-  // Query positions individually for each axis
-  // This could be optimized with a batch call if the ACS API supports it
+// Any other configured axis set
+bool ACSController::GetPositionsGeneric(std::map<std::string, double>& positions) {
+  double posArray[kMaxPolledAxes] = { 0.0 };
   bool success = true;
-  for (int i = 0; i < 3; i++) {
-    if (axisIndices[i] >= 0) {
-      if (!acsc_GetFPosition(m_controllerId, axisIndices[i], &posArray[i], NULL)) {
-        success = false;
-      }
+  for (int i = 0; i < m_polledAxisCount; i++) {
+    if (m_polledAxisIndex[i] >= 0 &&
+      !acsc_GetFPosition(m_controllerId, m_polledAxisIndex[i], &posArray[i], NULL)) {
+      success = false;
     }
   }
 
   if (success) {
-    // Fill the map with results
-    for (int i = 0; i < 3; i++) {
-      if (axisIndices[i] >= 0) {
+    for (int i = 0; i < m_polledAxisCount; i++) {
+      if (m_polledAxisIndex[i] >= 0) {
         positions[m_availableAxes[i]] = posArray[i];
       }
     }
   }
-
   return success;
 }
 
+void ACSController::ApplyAxisLayout() {
+  // Only single-letter axes can match a model ("XYZ" unsplit stays generic)
+  std::string installed;
+  bool singleLetters = true;
+  for (const auto& axis : m_availableAxes) {
+    installed += axis;
+    singleLetters &= (axis.size() == 1);
+  }
+
+  m_model = singleLetters ? ControllerTraits::Resolve("ACS", installed) : ControllerTraits::Model::Generic;
+  m_getPositions = &ACSController::GetPositionsGeneric;
+  ControllerTraits::Dispatch(m_model, [this](auto traits) {
+    using Traits = typename decltype(traits)::Type;
+    m_getPositions = &ACSController::GetPositionsFixed<Traits>;
+  });
+
+  m_polledAxisCount = std::min<int>(static_cast<int>(m_availableAxes.size()), kMaxPolledAxes);
+  for (int i = 0; i < m_polledAxisCount; i++) {
+    m_polledAxisIndex[i] = GetAxisIndex(m_availableAxes[i]);
+  }
+}
+
 bool ACSController::EnableServo(const std::string& axis, bool enable) {
   if (!m_isConnected) {
     std::cout << "ACSController: ERROR - Cannot change servo state - not connected" << std::endl;
@@ -637,6 +1011,7 @@ bool ACSController::SetVelocity(const std::string& axis, double velocity) {
     return false;
   }
 
+  m_estimator.SetMaxVelocity(EstimatorSlot(axis), velocity);
   return true;
 }
 
@@ -655,6 +1030,7 @@ bool ACSController::GetVelocity(const std::string& axis, double& velocity) {
     return false;
   }
 
+  m_estimator.SetMaxVelocity(EstimatorSlot(axis), velocity);
   return true;
 }
 
@@ -753,6 +1129,8 @@ bool ACSController::ConfigureFromDevice(const MotionDevice& device) {
     std::cout << "ACSController: Configured with default gantry axes (X Y Z)" << std::endl;
   }
 
+  ApplyAxisLayout();
+  std::cout << "ACSController: Controller model " << ControllerTraits::ModelName(m_model) << std::endl;
   return true;
 }
 
@@ -839,6 +1217,9 @@ bool ACSController::MoveToPositionMultiAxis(const std::vector<std::string>& axes
     std::cout << "ACSController: ERROR - Failed to start motion. Error code: " << error << std::endl;
     return false;
   }
+  for (size_t i = 0; i < axes.size(); i++) {
+    NoteCommand(axes[i], positions[i]);
+  }
 
   // If blocking mode, wait for motion to complete on all axes
   if (blocking) {
@@ -855,7 +1236,87 @@ bool ACSController::MoveToPositionMultiAxis(const std::vector<std::string>& axes
   return true;
 }
 
+// -1 terminated axis list for the *M calls; rejects unknown axes rather
+// than letting a -1 cut the list short
+bool ACSController::BuildAxisArray(const std::vector<std::string>& axes, int* axisArray, std::string& reason) {
+  if (axes.empty() || axes.size() > static_cast<size_t>(kMaxArmedAxes) || axes.size() > m_availableAxes.size()) {
+    reason = "invalid axis count " + std::to_string(axes.size());
+    return false;
+  }
+  for (size_t i = 0; i < axes.size(); i++) {
+    axisArray[i] = GetAxisIndex(axes[i]);
+    if (axisArray[i] < 0) {
+      reason = "unknown axis " + axes[i];
+      return false;
+    }
+  }
+  axisArray[axes.size()] = -1;
+  return true;
+}
+
+bool ACSController::ArmMove(const std::vector<std::string>& axes, const std::vector<double>& positions,
+  std::string& reason) {
+  if (!m_isConnected) {
+    reason = "not connected";
+    return false;
+  }
+  if (axes.size() != positions.size()) {
+    reason = "invalid axes/positions";
+    return false;
+  }
+
+  int axisArray[kMaxArmedAxes + 1];
+  double points[kMaxArmedAxes];
+  if (!BuildAxisArray(axes, axisArray, reason)) {
+    return false;
+  }
+  for (size_t i = 0; i < axes.size(); i++) {
+    bool enabled = false;
+    if (!IsServoEnabled(axes[i], enabled) || !enabled) {
+      reason = "axis " + axes[i] + " disabled";
+      return false;
+    }
+    points[i] = positions[i];
+  }
+
+  if (!acsc_ToPointM(m_controllerId, ACSC_AMF_WAIT, axisArray, points, NULL)) {
+    reason = "ToPointM rejected, error " + std::to_string(acsc_GetLastError());
+    return false;
+  }
+  return true;
+}
+
+bool ACSController::StartArmedMove(const std::vector<std::string>& axes) {
+  if (!m_isConnected) {
+    return false;
+  }
+  int axisArray[kMaxArmedAxes + 1];
+  std::string reason;
+  if (!BuildAxisArray(axes, axisArray, reason)) {
+    std::cout << "ACSController: ERROR - Cannot start armed move - " << reason << std::endl;
+    return false;
+  }
+
+  if (!acsc_GoM(m_controllerId, axisArray, NULL)) {
+    std::cout << "ACSController: ERROR - Failed to start armed move. Error code: " << acsc_GetLastError() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ACSController::CancelArmedMove(const std::vector<std::string>& axes) {
+  if (!m_isConnected) {
+    return false;
+  }
+  int axisArray[kMaxArmedAxes + 1];
+  std::string reason;
+  if (!BuildAxisArray(axes, axisArray, reason)) {
+    std::cout << "ACSController: ERROR - Cannot cancel armed move - " << reason << std::endl;
+    return false;
+  }
 
+  return acsc_HaltM(m_controllerId, axisArray, NULL) != 0;
+}
 
 bool ACSController::RunBuffer(int bufferNumber, const std::string& labelName) {
   if (!m_isConnected) {
@@ -954,6 +1415,29 @@ bool ACSController::StopAllBuffers() {
   return true;
 }
 
+bool ACSController::WaitForBufferCompletion(int bufferNumber, int timeoutMs) {
+  if (!m_isConnected) {
+    std::cout << "ACSController: ERROR - Cannot wait for buffer - not connected" << std::endl;
+    return false;
+  }
+
+  if (!acsc_WaitProgramEnd(m_controllerId, bufferNumber, timeoutMs)) {
+    int error = acsc_GetLastError();
+    std::cout << "ACSController: ERROR - Buffer " << bufferNumber << " did not finish within "
+      << timeoutMs << " ms. Error code: " << error << std::endl;
+    return false;
+  }
+
+  // A program that stopped on an error also "ends"
+  int programError = 0;
+  if (acsc_GetProgramError(m_controllerId, bufferNumber, &programError, NULL) && programError != 0) {
+    std::cout << "ACSController: ERROR - Buffer " << bufferNumber << " ended with program error "
+      << programError << std::endl;
+    return false;
+  }
+  return true;
+}
+
 
 
 
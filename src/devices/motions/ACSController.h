@@ -9,13 +9,23 @@
 #include <vector>
 #include <map>
 #include <iostream>  // Replace logger with standard output
+#include "AxisStateEstimator.h"
+#include "ControllerTraits.h"
 #include "MotionTypes.h"  // Make sure this is included
+#include "../../core/HealthWatchdog.h"
+#include "../../utils/ProfiledMutex.h"
+#include "ACSAsyncTransport.h"
 
 // Include ACS controller library
 #include "ACSC.h"
+
+class IOExecutor;
+
 class ACSController {
 public:
-  ACSController();
+  // With an executor the status polling runs as a task on its shared workers
+  // instead of on a thread of its own (see utils/IOExecutor.h)
+  explicit ACSController(IOExecutor* executor = nullptr);
   ~ACSController();
 
   // Connection methods
@@ -35,6 +45,12 @@ public:
   bool GetPosition(const std::string& axis, double& position);
   bool GetPositions(std::map<std::string, double>& positions);
 
+  // Position between polls from the estimator - for displays and collision
+  // prediction; the cached GetPosition only changes once per poll
+  bool GetEstimatedPosition(const std::string& axis, AxisStateEstimator::Estimate& estimate,
+    std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now()) const;
+  AxisStateEstimator& GetEstimator() { return m_estimator; }
+
   // Servo control
   bool EnableServo(const std::string& axis, bool enable);
   bool IsServoEnabled(const std::string& axis, bool& enabled);
@@ -58,12 +74,33 @@ public:
 
   // Add this method to expose available axes
   const std::vector<std::string>& GetAvailableAxes() const { return m_availableAxes; }
+  // Model matched to the configured axes (see ControllerTraits.h)
+  ControllerTraits::Model GetModel() const { return m_model; }
+
+  // Fire-and-forget move, issued by the communication thread in the same
+  // pipelined batch as the status reads (see ACSAsyncTransport.h)
+  bool QueueMove(const std::string& axis, double value, bool relative);
+
+  // Continuous jog in velocity mode (acsc_Jog). Call every UI frame while the
+  // input is held - speed changes are re-sent, 0 halts at once. An axis not
+  // refreshed within kJogDeadman is halted by the communication thread.
+  bool Jog(const std::string& axis, double velocity);
+  bool StopJog();
+  bool IsJogging() const { return m_activeJogs.load() > 0; }
 
   // Multi-axis movement
   bool MoveToPositionMultiAxis(const std::vector<std::string>& axes,
     const std::vector<double>& positions,
     bool blocking = true);
 
+  // Two-phase start for MotionTransaction: ArmMove sends the targets held
+  // back (ACSC_AMF_WAIT), StartArmedMove releases them with a single GoM and
+  // CancelArmedMove drops targets that were never started
+  bool ArmMove(const std::vector<std::string>& axes, const std::vector<double>& positions,
+    std::string& reason);
+  bool StartArmedMove(const std::vector<std::string>& axes);
+  bool CancelArmedMove(const std::vector<std::string>& axes);
+
   // Copy current position as JSON
   bool CopyPositionToClipboard();
 
@@ -71,36 +108,64 @@ public:
   bool RunBuffer(int bufferNumber, const std::string& labelName = "");
   bool StopBuffer(int bufferNumber);
   bool StopAllBuffers();
+  bool WaitForBufferCompletion(int bufferNumber, int timeoutMs);   // Fails on timeout or program error
 
   // NEW: Manufacturer information methods using ACSC API
   bool GetFirmwareVersion(std::string& firmwareVersion);
   bool GetSerialNumber(std::string& serialNumber);
   bool GetDeviceIdentification(std::string& manufacturerInfo);
 	int GetControllerId() const { return (int)m_controllerId; }
+  HANDLE GetHandle() const { return m_controllerId; }
+  int GetTelemetrySlot() const { return m_telemetrySlot.load(); }
+
+  // Health monitoring (see core/HealthWatchdog.h)
+  bool IsDataStale() const { return m_dataStale.load(); }
+  bool Reconnect();
+  void SetWatchdogPolicy(std::chrono::milliseconds deadline, HealthWatchdog::Recovery recovery);
 
 private:
   // Communication thread methods
   void StartCommunicationThread();
-  void StopCommunicationThread();
+  // Returns false if the thread is still blocked in a controller call after the timeout
+  bool StopCommunicationThread(std::chrono::milliseconds timeout = std::chrono::milliseconds(2000));
   void CommunicationThreadFunc();
+  // Per-device name for the thread report and executor tasks
+  std::string CommThreadName() const;
+  // One poll cycle; returns the delay until the next one
+  std::chrono::milliseconds CommunicationTick();
   void ProcessCommandQueue();
-  void UpdatePositions();
-  void UpdateMotorStatus();
+  void PollStatus(bool includeMotorState);
   bool StartMotion(const std::string& axis);
 
+  // Shared-memory telemetry (see core/TelemetrySegment.h)
+  void PublishTelemetry();
+  std::atomic<int> m_telemetrySlot{ -1 };
+  uint64_t m_telemetryFrame = 0;
+
+  // Watchdog channel for the communication thread
+  void RegisterWatchdog();
+  std::atomic<int> m_watchdogId{ -1 };
+  std::atomic<bool> m_dataStale{ false };
+  std::atomic<bool> m_threadExited{ true };
+  std::chrono::milliseconds m_watchdogDeadline{ 1500 };
+  HealthWatchdog::Recovery m_watchdogRecovery = HealthWatchdog::Recovery::Reconnect;
+
   // Command queue structure
   struct MotorCommand {
     std::string axis;
-    double distance;
-    bool executed;
+    double value;      // Target position, or distance when relative
+    bool relative;
   };
 
   std::string m_windowTitle = "ACS Controller"; // Default title
 
   // Thread-related members
   std::thread m_communicationThread;
-  std::mutex m_mutex;
-  std::condition_variable m_condVar;
+  IOExecutor* m_executor = nullptr;
+  uint64_t m_executorTask = 0;
+  int m_frameCounter = 0;
+  ProfiledMutex m_mutex{ "ACSController::m_mutex" };
+  std::condition_variable_any m_condVar;
   std::atomic<bool> m_threadRunning{ false };
   std::atomic<bool> m_terminateThread{ false };
   std::atomic<bool> m_isConnected{ false };
@@ -108,7 +173,33 @@ private:
 
   // Command queue
   std::vector<MotorCommand> m_commandQueue;
-  std::mutex m_commandMutex;
+  ProfiledMutex m_commandMutex{ "ACSController::m_commandMutex" };
+  std::atomic<bool> m_commandPending{ false };
+
+  // Pipelined controller I/O - used by the communication thread only
+  ACSAsyncTransport m_transport;
+  static constexpr int kMaxPolledAxes = 8;
+
+  // Axis lists of the two-phase start (ArmMove / StartArmedMove / CancelArmedMove)
+  static constexpr int kMaxArmedAxes = 8;
+  bool BuildAxisArray(const std::vector<std::string>& axes, int* axisArray, std::string& reason);
+  double m_polledPositions[kMaxPolledAxes] = { 0.0 };
+  int m_polledStates[kMaxPolledAxes] = { 0 };
+  bool m_positionOk[kMaxPolledAxes] = { false };
+  bool m_stateOk[kMaxPolledAxes] = { false };
+
+  // Jog state per ACS axis index, guarded by m_commandMutex
+  struct JogState {
+    bool active = false;
+    double velocity = 0.0;
+    std::chrono::steady_clock::time_point refreshed;
+  };
+  void CheckJogDeadman();
+  void ClearJog(int axisIndex);   // -1 = all axes
+  JogState m_jogs[kMaxPolledAxes];
+  std::atomic<int> m_activeJogs{ 0 };
+  static constexpr std::chrono::milliseconds kJogDeadman{ 300 };
+  static constexpr std::chrono::milliseconds kJogPollInterval{ 50 };
 
   // Controller handle
   HANDLE m_controllerId;  // Handle for the ACS controller
@@ -122,6 +213,11 @@ private:
   std::map<std::string, double> m_axisPositions;
   std::map<std::string, bool> m_axisMoving;
   std::map<std::string, bool> m_axisServoEnabled;
+  AxisStateEstimator m_estimator;   // Slots in m_availableAxes order, fed by every poll
+
+  // Estimator slot of an axis name, -1 if not polled
+  int EstimatorSlot(const std::string& axis) const;
+  void NoteCommand(const std::string& axis, double target);
 
   // UI state
   bool m_showWindow = false;
@@ -130,6 +226,18 @@ private:
   // Convert between string axis names and ACS axis indices
   int GetAxisIndex(const std::string& axis);
 
+  // Axis layout, resolved whenever m_availableAxes changes: the model picks
+  // the GetPositions variant, the polled indices spare the comm thread the
+  // axis-name lookups
+  void ApplyAxisLayout();
+  template <typename Traits>
+  bool GetPositionsFixed(std::map<std::string, double>& positions);
+  bool GetPositionsGeneric(std::map<std::string, double>& positions);
+  ControllerTraits::Model m_model = ControllerTraits::Model::Generic;
+  bool (ACSController::*m_getPositions)(std::map<std::string, double>&) = &ACSController::GetPositionsGeneric;
+  int m_polledAxisIndex[kMaxPolledAxes] = { 0 };
+  int m_polledAxisCount = 0;
+
   // Debug flag
   bool m_enableDebug = false;  // Enable debug logging
 
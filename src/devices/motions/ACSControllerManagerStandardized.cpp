@@ -6,8 +6,9 @@
 #include "core/ConfigRegistry.h"
 #include <iostream>
 
-ACSControllerManagerStandardized::ACSControllerManagerStandardized(ConfigManager& configManager)
-  : DeviceManagerBase("ACS_Controller_Manager"), m_configManager(configManager) {
+ACSControllerManagerStandardized::ACSControllerManagerStandardized(ConfigManager& configManager,
+  const std::string& station)
+  : DeviceManagerBase("ACS_Controller_Manager"), m_configManager(configManager), m_station(station) {
   LoadDevicesFromConfig();
 }
 
@@ -29,8 +30,8 @@ bool ACSControllerManagerStandardized::Initialize() {
       std::cout << "Creating ACS controller: " << config.name
         << " @ " << config.ipAddress << ":" << config.port << std::endl;
 
-      // Create controller instance (constructor takes no parameters)
-      auto controller = std::make_unique<ACSController>();
+      // Create controller instance (polls on the shared executor when one is set)
+      auto controller = std::make_unique<ACSController>(m_executor);
 
       // Configure the controller with device info if needed
       // (Note: ConfigureFromDevice would need MotionDevice struct)
@@ -201,6 +202,10 @@ void ACSControllerManagerStandardized::LoadDevicesFromConfig() {
     // Filter for ACS controller devices
     for (const auto& device : devices) {
       if (device.typeController == "ACS" && device.isEnabled) {
+        if (!m_station.empty() && device.station != m_station) {
+          continue;
+        }
+
         DeviceConfig config;
         config.name = device.name;
         config.ipAddress = device.ipAddress;
@@ -217,7 +222,8 @@ void ACSControllerManagerStandardized::LoadDevicesFromConfig() {
     }
 
     std::cout << "ACSControllerManager: Loaded " << m_deviceConfigs.size()
-      << " ACS devices from configuration" << std::endl;
+      << " ACS devices from configuration"
+      << (m_station.empty() ? "" : " for station " + m_station) << std::endl;
 
   }
   catch (const std::exception& e) {
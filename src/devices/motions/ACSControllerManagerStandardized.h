@@ -14,6 +14,9 @@
 /**
  * ACS Controller Manager - Now fully compliant with IDeviceManagerInterface
  * KISS design - simple and focused on essential operations
+ *
+ * Constructed with a station name it only manages that station's gantries
+ * (see MotionCell.h); the device table is filled once by Initialize().
  */
 class ACSControllerManagerStandardized : public DeviceManagerBase<ACSController> {
 private:
@@ -32,8 +35,12 @@ private:
   };
   std::vector<DeviceConfig> m_deviceConfigs;
 
+  // Station filter ("" = every ACS device) and shared poller for new controllers
+  std::string m_station;
+  IOExecutor* m_executor = nullptr;
+
 public:
-  explicit ACSControllerManagerStandardized(ConfigManager& configManager);
+  explicit ACSControllerManagerStandardized(ConfigManager& configManager, const std::string& station = "");
   ~ACSControllerManagerStandardized() override = default;
 
   // === CORE LIFECYCLE ===
@@ -58,6 +65,11 @@ public:
   // === DEVICE IDENTIFICATION ===
   bool GetDeviceIdentification(const std::string& deviceName, std::string& manufacturerInfo) override;
 
+  // === STATION ===
+  const std::string& GetStation() const { return m_station; }
+  // Set before Initialize() - controllers then poll on the executor
+  void SetIOExecutor(IOExecutor* executor) { m_executor = executor; }
+
   // === ADDITIONAL UTILITY ===
   void PrintDeviceStatus() const;
 
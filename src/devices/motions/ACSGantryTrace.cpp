@@ -0,0 +1,312 @@
+// ACSGantryTrace.cpp
+#include "ACSGantryTrace.h"
+#include "ACSController.h"
+#include "../../core/TelemetrySegment.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+  // Forwards to the ACSC library on the controller's connection
+  class ACSCBackend : public ACSGantryTrace::Backend {
+  public:
+    explicit ACSCBackend(ACSController& controller) : m_controller(controller) {}
+
+    bool DeclareMatrix(const std::string& name, int rows, int columns) override {
+      std::string declaration = name + "(" + std::to_string(rows) + ")(" + std::to_string(columns) + ")";
+      return acsc_DeclareVariable(m_controller.GetHandle(), ACSC_REAL_TYPE, declaration.data(), ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool StartCollection(int flags, int axis, const std::string& array, int samples,
+      double periodMs, const std::string& variables) override {
+      std::string arrayName = array;
+      std::string vars = variables;
+      return acsc_DataCollectionExt(m_controller.GetHandle(), flags, axis, arrayName.data(), samples,
+        periodMs, vars.data(), ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool WaitCollectionEnd(int axis, int timeoutMs) override {
+      return acsc_WaitCollectEndExt(m_controller.GetHandle(), timeoutMs, axis) != 0;
+    }
+
+    bool StopCollection() override {
+      return acsc_StopCollect(m_controller.GetHandle(), ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool ReadMatrix(const std::string& name, int rows, int columns, double* values) override {
+      std::string variable = name;
+      return acsc_ReadReal(m_controller.GetHandle(), ACSC_NONE, variable.data(),
+        0, rows - 1, 0, columns - 1, values, ACSC_SYNCHRONOUS) != 0;
+    }
+
+    int GetLastError() override { return acsc_GetLastError(); }
+
+  private:
+    ACSController& m_controller;
+  };
+}
+
+int ACSGantryTrace::Trace::Find(Signal signal, int axis) const {
+  for (size_t i = 0; i < channels.size(); i++) {
+    if (channels[i].signal == signal && channels[i].axis == axis) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+ACSGantryTrace::ACSGantryTrace(ACSController& controller)
+  : m_backend(std::make_unique<ACSCBackend>(controller)) {
+}
+
+ACSGantryTrace::ACSGantryTrace(std::unique_ptr<Backend> backend)
+  : m_backend(std::move(backend)) {
+}
+
+ACSGantryTrace::~ACSGantryTrace() {
+  if (m_armed && !m_completed) {
+    Stop();
+  }
+}
+
+// === COLLECTION CONTROL ===
+
+bool ACSGantryTrace::Arm(const Config& config) {
+  const int rows = static_cast<int>(config.channels.size());
+  if (rows == 0 || rows > MAX_CHANNELS || config.samples < 2 || config.samples > MAX_SAMPLES ||
+    config.periodMs <= 0.0) {
+    std::cout << "ACSGantryTrace: ERROR - Invalid collection config (" << rows << " channels, "
+      << config.samples << " samples, " << config.periodMs << " ms)" << std::endl;
+    return false;
+  }
+
+  // Matrices cannot be resized on the controller - one per shape, declared once
+  const std::string array = MatrixName(rows, config.samples);
+  if (m_declared.count(array) == 0) {
+    if (!m_backend->DeclareMatrix(array, rows, config.samples)) {
+      // Already declared by an earlier session is fine; collection will tell otherwise
+      std::cout << "ACSGantryTrace: WARNING - Could not declare " << array << ". Error code: "
+        << m_backend->GetLastError() << std::endl;
+    }
+    m_declared.insert(array);
+  }
+
+  // DC variable list: one entry per row, separated by CR
+  std::string variables;
+  for (const auto& channel : config.channels) {
+    if (!variables.empty()) variables += "\r";
+    variables += std::string(SignalName(channel.signal)) + "(" + std::to_string(channel.axis) + ")";
+  }
+
+  const bool synchronous = config.syncAxis >= 0;
+  const int flags = synchronous ? ACSC_DCF_SYNC : ACSC_DCF_TEMPORAL;
+  if (!m_backend->StartCollection(flags, synchronous ? config.syncAxis : ACSC_NONE, array,
+    config.samples, config.periodMs, variables)) {
+    LogError("Starting data collection");
+    return false;
+  }
+
+  m_config = config;
+  m_array = array;
+  m_armed = true;
+  m_completed = false;
+
+  std::cout << "ACSGantryTrace: Armed " << rows << " channels x " << config.samples << " samples at "
+    << config.periodMs << " ms" << (synchronous ? " (starts with next motion)" : "") << std::endl;
+  return true;
+}
+
+bool ACSGantryTrace::WaitForCompletion(std::chrono::milliseconds timeout) {
+  if (!m_armed) {
+    std::cout << "ACSGantryTrace: ERROR - No collection armed" << std::endl;
+    return false;
+  }
+  if (m_completed) {
+    return true;
+  }
+
+  const int axis = m_config.syncAxis >= 0 ? m_config.syncAxis : ACSC_NONE;
+  if (!m_backend->WaitCollectionEnd(axis, static_cast<int>(timeout.count()))) {
+    LogError("Waiting for data collection");
+    return false;
+  }
+
+  m_completed = true;
+  m_completedAt = std::chrono::steady_clock::now();
+  return true;
+}
+
+bool ACSGantryTrace::Stop() {
+  if (!m_backend->StopCollection()) {
+    LogError("Stopping data collection");
+    return false;
+  }
+  m_armed = false;
+  return true;
+}
+
+// One ReadReal for the whole matrix
+bool ACSGantryTrace::Read(Trace& trace) {
+  if (!m_armed || !m_completed) {
+    std::cout << "ACSGantryTrace: ERROR - No completed collection to read" << std::endl;
+    return false;
+  }
+
+  const int rows = static_cast<int>(m_config.channels.size());
+  const int columns = m_config.samples;
+  std::vector<double> matrix(static_cast<size_t>(rows) * columns, 0.0);
+  if (!m_backend->ReadMatrix(m_array, rows, columns, matrix.data())) {
+    LogError("Reading " + m_array);
+    return false;
+  }
+
+  trace.channels = m_config.channels;
+  trace.periodMs = m_config.periodMs;
+  trace.values.assign(rows, std::vector<double>());
+  for (int r = 0; r < rows; r++) {
+    trace.values[r].assign(matrix.begin() + static_cast<size_t>(r) * columns,
+      matrix.begin() + static_cast<size_t>(r + 1) * columns);
+  }
+
+  // The controller does not timestamp the matrix - back-date from the completion
+  const auto duration = std::chrono::duration<double, std::milli>(m_config.periodMs * (columns - 1));
+  const auto start = m_completedAt - std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration);
+  trace.startTimestampNs = static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count());
+  return true;
+}
+
+bool ACSGantryTrace::Capture(const Config& config, const std::function<bool()>& motion, Trace& trace,
+  std::chrono::milliseconds timeout) {
+  if (!Arm(config)) {
+    return false;
+  }
+
+  if (motion && !motion()) {
+    std::cout << "ACSGantryTrace: ERROR - Motion failed - discarding collection" << std::endl;
+    Stop();
+    return false;
+  }
+
+  if (!WaitForCompletion(timeout)) {
+    Stop();
+    return false;
+  }
+  if (!Read(trace)) {
+    return false;
+  }
+
+  // Export problems do not invalidate the capture
+  if (!config.publishAs.empty()) {
+    PublishToTelemetry(trace, config.publishAs);
+  }
+  return true;
+}
+
+// === ANALYSIS AND EXPORT ===
+
+ACSGantryTrace::ChannelStats ACSGantryTrace::ComputeStats(const Trace& trace, Signal signal, int axis) {
+  ChannelStats stats;
+  const int index = trace.Find(signal, axis);
+  if (index < 0 || trace.values[index].empty()) {
+    return stats;
+  }
+
+  const auto& values = trace.values[index];
+  stats.valid = true;
+  stats.min = values.front();
+  stats.max = values.front();
+  double sumSquares = 0.0;
+  size_t maxAbsIndex = 0;
+
+  for (size_t i = 0; i < values.size(); i++) {
+    const double v = values[i];
+    stats.min = std::min(stats.min, v);
+    stats.max = std::max(stats.max, v);
+    sumSquares += v * v;
+    if (std::abs(v) > stats.maxAbs) {
+      stats.maxAbs = std::abs(v);
+      maxAbsIndex = i;
+    }
+  }
+
+  stats.rms = std::sqrt(sumSquares / values.size());
+  stats.maxAbsTimeMs = maxAbsIndex * trace.periodMs;
+  return stats;
+}
+
+bool ACSGantryTrace::SaveCsv(const Trace& trace, const std::string& path) {
+  try {
+    const std::filesystem::path filePath(path);
+    if (filePath.has_parent_path()) {
+      std::filesystem::create_directories(filePath.parent_path());
+    }
+  }
+  catch (const std::exception& e) {
+    std::cout << "ACSGantryTrace: ERROR - " << e.what() << std::endl;
+    return false;
+  }
+
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    std::cout << "ACSGantryTrace: ERROR - Cannot write " << path << std::endl;
+    return false;
+  }
+
+  file << "time_ms";
+  for (const auto& channel : trace.channels) {
+    file << "," << SignalName(channel.signal) << "(" << channel.axis << ")";
+  }
+  file << "\n";
+
+  file.precision(10);
+  for (size_t i = 0; i < trace.SampleCount(); i++) {
+    file << i * trace.periodMs;
+    for (const auto& values : trace.values) {
+      file << "," << values[i];
+    }
+    file << "\n";
+  }
+
+  std::cout << "ACSGantryTrace: Saved " << trace.SampleCount() << " samples to " << path << std::endl;
+  return true;
+}
+
+static_assert(ACSGantryTrace::MAX_CHANNELS <= Telemetry::kMaxTraceChannels &&
+  ACSGantryTrace::MAX_SAMPLES <= Telemetry::kTraceCapacity, "Every valid trace must fit the telemetry trace slot");
+
+// The whole trace goes to the segment's trace slot - the live FPOS ring keeps its poll order
+bool ACSGantryTrace::PublishToTelemetry(const Trace& trace, const std::string& deviceName) {
+  std::vector<std::string> names;
+  names.reserve(trace.channels.size());
+  for (const auto& channel : trace.channels) {
+    names.push_back(std::string(SignalName(channel.signal)) + "(" + std::to_string(channel.axis) + ")");
+  }
+  return TelemetrySegment::Instance().PublishTrace(deviceName, names, trace.values, trace.periodMs,
+    trace.startTimestampNs);
+}
+
+const char* ACSGantryTrace::SignalName(Signal signal) {
+  switch (signal) {
+  case Signal::FPOS: return "FPOS";
+  case Signal::RPOS: return "RPOS";
+  case Signal::PE: return "PE";
+  case Signal::FVEL: return "FVEL";
+  case Signal::RVEL: return "RVEL";
+  }
+  return "FPOS";
+}
+
+// === HELPERS ===
+
+std::string ACSGantryTrace::MatrixName(int rows, int columns) {
+  return "P4TRC" + std::to_string(rows) + "X" + std::to_string(columns);
+}
+
+void ACSGantryTrace::LogError(const std::string& action) {
+  std::cout << "ACSGantryTrace: ERROR - " << action << " failed. Error code: " << m_backend->GetLastError() << std::endl;
+}
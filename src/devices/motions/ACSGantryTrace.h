@@ -0,0 +1,128 @@
+// ACSGantryTrace.h - Servo-rate gantry traces through ACS controller-side data collection
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+class ACSController;
+
+/**
+ * ACSGantryTrace - Records controller variables at servo rate around a move
+ *
+ * The host polls FPOS at 5 Hz; following error on a dispense path needs
+ * every servo cycle. Arm() starts data collection (DC) on the controller
+ * for the selected FPOS/RPOS/PE/FVEL/RVEL channels into a global matrix,
+ * synchronised to the next motion of an axis. Read() fetches the whole
+ * matrix with one acsc_ReadReal call. No host polling while it runs.
+ *
+ * All controller traffic goes through a Backend: the ACSC backend talks to
+ * the controller, ACSSimulatedGantryTrace (ACSSimulatedGantryTrace.h)
+ * emulates collection over a simulated gantry.
+ *
+ * Usage:
+ *   ACSGantryTrace trace(controller);
+ *   ACSGantryTrace::Config config;
+ *   config.channels = { { Signal::FPOS, 0 }, { Signal::PE, 0 } };
+ *   ACSGantryTrace::Trace result;
+ *   trace.Capture(config, [&]() { return controller.MoveToPosition("X", 10.0, false); }, result);
+ *   auto pe = ACSGantryTrace::ComputeStats(result, Signal::PE, 0);
+ *
+ * With Config::publishAs set, Capture also hands the trace to the
+ * telemetry segment's trace slot for external analysis tools.
+ */
+class ACSGantryTrace {
+public:
+  enum class Signal {
+    FPOS,   // Feedback position
+    RPOS,   // Reference position
+    PE,     // Position (following) error
+    FVEL,   // Feedback velocity
+    RVEL    // Reference velocity
+  };
+
+  struct Channel {
+    Signal signal = Signal::FPOS;
+    int axis = 0;                // ACS axis index
+  };
+
+  struct Config {
+    std::vector<Channel> channels;
+    int samples = 2000;
+    double periodMs = 1.0;       // Sampling period; the servo cycle is the lower limit
+    int syncAxis = 0;            // Start with the next motion of this axis, -1 = start immediately
+    std::string publishAs;       // Capture exports the trace to telemetry under this name, empty = no export
+  };
+
+  struct Trace {
+    std::vector<Channel> channels;
+    std::vector<std::vector<double>> values;   // values[channel][sample]
+    double periodMs = 0.0;
+    uint64_t startTimestampNs = 0;             // Host steady clock, estimated from the end of collection
+
+    size_t SampleCount() const { return values.empty() ? 0 : values.front().size(); }
+    int Find(Signal signal, int axis) const;   // Channel index or -1
+  };
+
+  struct ChannelStats {
+    bool valid = false;
+    double min = 0.0;
+    double max = 0.0;
+    double maxAbs = 0.0;
+    double rms = 0.0;
+    double maxAbsTimeMs = 0.0;   // Time of maxAbs from the start of the trace
+  };
+
+  // Controller calls used by the trace - same shape as the ACSC functions
+  class Backend {
+  public:
+    virtual ~Backend() = default;
+    virtual bool DeclareMatrix(const std::string& name, int rows, int columns) = 0;
+    virtual bool StartCollection(int flags, int axis, const std::string& array, int samples,
+      double periodMs, const std::string& variables) = 0;
+    virtual bool WaitCollectionEnd(int axis, int timeoutMs) = 0;
+    virtual bool StopCollection() = 0;
+    virtual bool ReadMatrix(const std::string& name, int rows, int columns, double* values) = 0;
+    virtual int GetLastError() = 0;
+  };
+
+  explicit ACSGantryTrace(ACSController& controller);   // Real controller via ACSC
+  explicit ACSGantryTrace(std::unique_ptr<Backend> backend);
+  ~ACSGantryTrace();
+
+  // Collection control
+  bool Arm(const Config& config);
+  bool WaitForCompletion(std::chrono::milliseconds timeout);
+  bool Stop();
+  bool Read(Trace& trace);
+
+  // Arm, run the motion, wait for the collection and read it back
+  bool Capture(const Config& config, const std::function<bool()>& motion, Trace& trace,
+    std::chrono::milliseconds timeout = std::chrono::seconds(30));
+
+  // Analysis and export
+  static ChannelStats ComputeStats(const Trace& trace, Signal signal, int axis);
+  static bool SaveCsv(const Trace& trace, const std::string& path);
+  static bool PublishToTelemetry(const Trace& trace, const std::string& deviceName);   // Trace slot, not the live ring
+
+  static const char* SignalName(Signal signal);
+  static constexpr int MAX_CHANNELS = 16;
+  static constexpr int MAX_SAMPLES = 100000;
+
+  Backend& GetBackend() { return *m_backend; }
+
+private:
+  static std::string MatrixName(int rows, int columns);
+  void LogError(const std::string& action);
+
+  std::unique_ptr<Backend> m_backend;
+  std::set<std::string> m_declared;   // Controller matrices declared by this instance
+  Config m_config;
+  std::string m_array;
+  bool m_armed = false;
+  bool m_completed = false;
+  std::chrono::steady_clock::time_point m_completedAt;
+};
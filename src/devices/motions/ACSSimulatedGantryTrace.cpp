@@ -0,0 +1,302 @@
+// ACSSimulatedGantryTrace.cpp
+#include "ACSSimulatedGantryTrace.h"
+#include "ACSC.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace {
+  // Error codes reported through GetLastError()
+  constexpr int kErrorUndeclaredVariable = 1002;
+  constexpr int kErrorInvalidVariable = 1003;
+  constexpr int kErrorDimensionMismatch = 1004;
+  constexpr int kErrorNoCollection = 1005;
+  constexpr int kErrorTimeout = 1006;
+
+  constexpr double kPi = 3.14159265358979323846;
+}
+
+ACSSimulatedGantryTrace::ACSSimulatedGantryTrace() {
+  const auto now = Clock::now();
+  for (auto& profile : m_profiles) {
+    profile.start = now;
+  }
+  std::cout << "ACSSimulatedGantryTrace: Simulated data collection ready" << std::endl;
+}
+
+// === SIMULATED GANTRY ===
+
+void ACSSimulatedGantryTrace::SetAxisModel(int axis, const AxisModel& model) {
+  if (axis >= 0 && axis < AXIS_COUNT) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_models[axis] = model;
+  }
+}
+
+bool ACSSimulatedGantryTrace::Move(int axis, double target) {
+  if (axis < 0 || axis >= AXIS_COUNT) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto now = Clock::now();
+  Profile& profile = m_profiles[axis];
+  profile.from = Evaluate(axis, now).rpos;
+  profile.to = target;
+  profile.start = now;
+
+  // DC/s: collection starts with the motion
+  if (m_collection.active && !m_collection.started && m_collection.syncAxis == axis) {
+    m_collection.started = true;
+    m_collection.start = now;
+  }
+  return true;
+}
+
+double ACSSimulatedGantryTrace::GetPosition(int axis) {
+  if (axis < 0 || axis >= AXIS_COUNT) {
+    return 0.0;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const Sample sample = Evaluate(axis, Clock::now());
+  return sample.rpos - sample.pe;
+}
+
+// Called with m_mutex held: trapezoidal reference plus following-error model
+ACSSimulatedGantryTrace::Sample ACSSimulatedGantryTrace::Evaluate(int axis, Clock::time_point time) {
+  const AxisModel& model = m_models[axis];
+  const Profile& profile = m_profiles[axis];
+
+  const double distance = std::abs(profile.to - profile.from);
+  const double direction = profile.to >= profile.from ? 1.0 : -1.0;
+  const double a = model.acceleration;
+
+  double accelTime = model.velocity / a;
+  double cruiseTime = 0.0;
+  double peakVelocity = model.velocity;
+  if (distance < a * accelTime * accelTime) {
+    accelTime = std::sqrt(distance / a);
+    peakVelocity = a * accelTime;
+  }
+  else {
+    cruiseTime = (distance - a * accelTime * accelTime) / model.velocity;
+  }
+  const double total = 2.0 * accelTime + cruiseTime;
+
+  const double t = std::chrono::duration<double>(time - profile.start).count();
+  double s = 0.0;
+  double v = 0.0;
+  double acc = 0.0;
+  double ring = 0.0;
+
+  if (t <= 0.0) {
+    s = 0.0;
+  }
+  else if (t < accelTime) {
+    s = 0.5 * a * t * t;
+    v = a * t;
+    acc = a;
+  }
+  else if (t < accelTime + cruiseTime) {
+    s = 0.5 * a * accelTime * accelTime + peakVelocity * (t - accelTime);
+    v = peakVelocity;
+  }
+  else if (t < total) {
+    const double remaining = total - t;
+    s = distance - 0.5 * a * remaining * remaining;
+    v = a * remaining;
+    acc = -a;
+  }
+  else {
+    s = distance;
+    if (distance > 0.0) {
+      const double after = t - total;
+      ring = -model.accelerationLag * a * std::exp(-after / model.ringDecay) * std::cos(2.0 * kPi * model.ringFrequency * after);
+    }
+  }
+
+  Sample sample;
+  sample.rpos = profile.from + direction * s;
+  sample.rvel = direction * v;
+  sample.pe = direction * (model.velocityLag * v + model.accelerationLag * acc + ring);
+  if (model.noise > 0.0) {
+    std::normal_distribution<double> noise(0.0, model.noise);
+    sample.pe += noise(m_random);
+  }
+  return sample;
+}
+
+// === BACKEND ===
+
+bool ACSSimulatedGantryTrace::DeclareMatrix(const std::string& name, int rows, int columns) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_declared[name] = { rows, columns };
+  m_matrices[name].assign(static_cast<size_t>(rows) * columns, 0.0);
+  return true;
+}
+
+bool ACSSimulatedGantryTrace::StartCollection(int flags, int axis, const std::string& array, int samples,
+  double periodMs, const std::string& variables) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto declared = m_declared.find(array);
+  if (declared == m_declared.end()) {
+    m_lastError = kErrorUndeclaredVariable;
+    return false;
+  }
+
+  Collection collection;
+  std::istringstream list(variables);
+  std::string entry;
+  while (std::getline(list, entry, '\r')) {
+    ACSGantryTrace::Signal signal;
+    int variableAxis = 0;
+    if (!ParseVariable(entry, signal, variableAxis)) {
+      m_lastError = kErrorInvalidVariable;
+      return false;
+    }
+    collection.variables.push_back({ signal, variableAxis });
+  }
+
+  if (static_cast<int>(collection.variables.size()) > declared->second.first || samples > declared->second.second) {
+    m_lastError = kErrorDimensionMismatch;
+    return false;
+  }
+
+  const bool synchronous = (flags & ACSC_DCF_SYNC) != 0;
+  if (synchronous && (axis < 0 || axis >= AXIS_COUNT)) {
+    m_lastError = kErrorInvalidVariable;
+    return false;
+  }
+
+  collection.active = true;
+  collection.started = !synchronous;
+  collection.syncAxis = synchronous ? axis : -1;
+  collection.array = array;
+  collection.samples = samples;
+  collection.periodMs = periodMs;
+  collection.start = Clock::now();
+  m_collection = collection;
+  return true;
+}
+
+bool ACSSimulatedGantryTrace::WaitCollectionEnd(int /*axis*/, int timeoutMs) {
+  const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_collection.active) {
+        m_lastError = kErrorNoCollection;
+        return false;
+      }
+
+      if (m_collection.started) {
+        const auto end = m_collection.start + std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double, std::milli>(m_collection.periodMs * m_collection.samples));
+        if (Clock::now() >= end) {
+          Fill(m_collection);
+          m_collection.active = false;
+          return true;
+        }
+      }
+    }
+
+    if (Clock::now() >= deadline) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_lastError = kErrorTimeout;
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+bool ACSSimulatedGantryTrace::StopCollection() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_collection.active = false;
+  return true;
+}
+
+bool ACSSimulatedGantryTrace::ReadMatrix(const std::string& name, int rows, int columns, double* values) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto declared = m_declared.find(name);
+  if (declared == m_declared.end()) {
+    m_lastError = kErrorUndeclaredVariable;
+    return false;
+  }
+  if (rows > declared->second.first || columns > declared->second.second) {
+    m_lastError = kErrorDimensionMismatch;
+    return false;
+  }
+
+  const auto& matrix = m_matrices[name];
+  const int stride = declared->second.second;
+  for (int r = 0; r < rows; r++) {
+    std::memcpy(values + static_cast<size_t>(r) * columns, matrix.data() + static_cast<size_t>(r) * stride,
+      sizeof(double) * columns);
+  }
+  return true;
+}
+
+int ACSSimulatedGantryTrace::GetLastError() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const int error = m_lastError;
+  m_lastError = 0;
+  return error;
+}
+
+// === HELPERS ===
+
+// Called with m_mutex held: sample every variable at the collection period
+void ACSSimulatedGantryTrace::Fill(const Collection& collection) {
+  auto& matrix = m_matrices[collection.array];
+  const int stride = m_declared[collection.array].second;
+
+  for (int i = 0; i < collection.samples; i++) {
+    const auto time = collection.start + std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double, std::milli>(collection.periodMs * i));
+
+    for (size_t r = 0; r < collection.variables.size(); r++) {
+      const auto [signal, axis] = collection.variables[r];
+      const Sample sample = Evaluate(axis, time);
+      double value = 0.0;
+      switch (signal) {
+      case ACSGantryTrace::Signal::FPOS: value = sample.rpos - sample.pe; break;
+      case ACSGantryTrace::Signal::RPOS: value = sample.rpos; break;
+      case ACSGantryTrace::Signal::PE: value = sample.pe; break;
+      case ACSGantryTrace::Signal::FVEL: value = sample.rvel; break;
+      case ACSGantryTrace::Signal::RVEL: value = sample.rvel; break;
+      }
+      matrix[r * stride + i] = value;
+    }
+  }
+}
+
+// "FPOS(0)" -> FPOS, 0
+bool ACSSimulatedGantryTrace::ParseVariable(const std::string& text, ACSGantryTrace::Signal& signal, int& axis) {
+  const size_t open = text.find('(');
+  const size_t close = text.find(')', open);
+  if (open == std::string::npos || close == std::string::npos) {
+    return false;
+  }
+
+  const std::string name = text.substr(0, open);
+  static const ACSGantryTrace::Signal kSignals[] = {
+    ACSGantryTrace::Signal::FPOS, ACSGantryTrace::Signal::RPOS, ACSGantryTrace::Signal::PE,
+    ACSGantryTrace::Signal::FVEL, ACSGantryTrace::Signal::RVEL
+  };
+
+  for (auto candidate : kSignals) {
+    if (name == ACSGantryTrace::SignalName(candidate)) {
+      signal = candidate;
+      axis = std::atoi(text.substr(open + 1, close - open - 1).c_str());
+      return axis >= 0 && axis < AXIS_COUNT;
+    }
+  }
+  return false;
+}
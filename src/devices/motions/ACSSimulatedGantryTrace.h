@@ -0,0 +1,90 @@
+// ACSSimulatedGantryTrace.h - Data-collection emulation for running without a gantry
+#pragma once
+
+#include "ACSGantryTrace.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * ACSSimulatedGantryTrace - ACSGantryTrace backend over a simulated gantry
+ *
+ * Emulates what the trace relies on: matrices are declared once, collection
+ * starts immediately or with the next Move() of the sync axis, takes
+ * samples * period of wall time, and the matrix is read back row per
+ * channel.
+ *
+ * Each axis follows a trapezoidal profile. The following error is a
+ * velocity/acceleration lag plus a decaying oscillation after the move and
+ * measurement noise - enough to exercise dispense-path checks.
+ */
+class ACSSimulatedGantryTrace : public ACSGantryTrace::Backend {
+public:
+  struct AxisModel {
+    double velocity = 50.0;        // mm/s
+    double acceleration = 500.0;   // mm/s^2
+    double velocityLag = 2e-5;     // PE per mm/s
+    double accelerationLag = 4e-6; // PE per mm/s^2
+    double ringFrequency = 40.0;   // Hz, oscillation after the move
+    double ringDecay = 0.02;       // s, time constant of that oscillation
+    double noise = 2e-5;           // mm, standard deviation of PE noise
+  };
+
+  static constexpr int AXIS_COUNT = 8;
+
+  ACSSimulatedGantryTrace();
+
+  // Simulated gantry
+  void SetAxisModel(int axis, const AxisModel& model);
+  bool Move(int axis, double target);   // Starts the profile now; triggers a sync collection
+  double GetPosition(int axis);
+
+  // Backend
+  bool DeclareMatrix(const std::string& name, int rows, int columns) override;
+  bool StartCollection(int flags, int axis, const std::string& array, int samples,
+    double periodMs, const std::string& variables) override;
+  bool WaitCollectionEnd(int axis, int timeoutMs) override;
+  bool StopCollection() override;
+  bool ReadMatrix(const std::string& name, int rows, int columns, double* values) override;
+  int GetLastError() override;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Profile {
+    Clock::time_point start;
+    double from = 0.0;
+    double to = 0.0;
+  };
+
+  struct Sample {
+    double rpos, rvel, pe;
+  };
+
+  struct Collection {
+    bool active = false;
+    bool started = false;
+    int syncAxis = -1;
+    std::string array;
+    int samples = 0;
+    double periodMs = 1.0;
+    std::vector<std::pair<ACSGantryTrace::Signal, int>> variables;
+    Clock::time_point start;
+  };
+
+  Sample Evaluate(int axis, Clock::time_point time);
+  void Fill(const Collection& collection);
+  static bool ParseVariable(const std::string& text, ACSGantryTrace::Signal& signal, int& axis);
+
+  std::mutex m_mutex;
+  AxisModel m_models[AXIS_COUNT];
+  Profile m_profiles[AXIS_COUNT];
+  std::map<std::string, std::pair<int, int>> m_declared;   // name -> rows, columns
+  std::map<std::string, std::vector<double>> m_matrices;
+  Collection m_collection;
+  std::mt19937 m_random{ 4242 };
+  int m_lastError = 0;
+};
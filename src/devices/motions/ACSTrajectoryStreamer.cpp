@@ -0,0 +1,519 @@
+// ACSTrajectoryStreamer.cpp
+#include "ACSTrajectoryStreamer.h"
+#include "ACSController.h"
+#include "../../utils/ThreadPolicy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+  // Forwards to the ACSC library on the controller's connection
+  class ACSCBackend : public ACSTrajectoryStreamer::Backend {
+  public:
+    explicit ACSCBackend(ACSController& controller) : m_controller(controller) {}
+
+    bool SplineM(int flags, int* axes, double periodMs) override {
+      return acsc_SplineM(m_controller.GetHandle(), flags, axes, periodMs, ACSC_SYNCHRONOUS) != 0;
+    }
+
+    // Blocks inside the library while the controller's point queue is full
+    bool AddPVTPointM(int* axes, double* point, double* velocity, double intervalMs) override {
+      return acsc_AddPVTPointM(m_controller.GetHandle(), axes, point, velocity, intervalMs, ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool EndSequenceM(int* axes) override {
+      return acsc_EndSequenceM(m_controller.GetHandle(), axes, ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool GoM(int* axes) override {
+      return acsc_GoM(m_controller.GetHandle(), axes, ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool HaltM(int* axes) override {
+      return acsc_HaltM(m_controller.GetHandle(), axes, ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool GetFreePoints(int axis, int& free) override {
+      char variable[] = "GSFREE";
+      return acsc_ReadInteger(m_controller.GetHandle(), ACSC_NONE, variable, axis, axis,
+        ACSC_NONE, ACSC_NONE, &free, ACSC_SYNCHRONOUS) != 0;
+    }
+
+    bool IsMoving(int axis, bool& moving) override {
+      int state = 0;
+      if (!acsc_GetMotorState(m_controller.GetHandle(), axis, &state, ACSC_SYNCHRONOUS)) {
+        return false;
+      }
+      moving = (state & ACSC_MST_MOVE) != 0;
+      return true;
+    }
+
+    int GetLastError() override { return acsc_GetLastError(); }
+
+  private:
+    ACSController& m_controller;
+  };
+
+  // Profile times are seconds, the ACSC spline calls take milliseconds
+  constexpr double kMsPerSecond = 1000.0;
+
+  constexpr double kPi = 3.14159265358979323846;
+  constexpr double kEpsilon = 1e-9;
+
+  // One Line or Arc segment resolved for evaluation along the path
+  struct PathPiece {
+    bool arc = false;
+    double from[2] = { 0.0, 0.0 };
+    double to[2] = { 0.0, 0.0 };
+    double center[2] = { 0.0, 0.0 };
+    double radius = 0.0;
+    double startAngle = 0.0;
+    double sweep = 0.0;            // Signed, negative = clockwise
+    double length = 0.0;
+
+    void Evaluate(double s, double* position, double* tangent) const {
+      const double u = length > 0.0 ? std::clamp(s / length, 0.0, 1.0) : 0.0;
+      if (!arc) {
+        for (int i = 0; i < 2; i++) {
+          position[i] = from[i] + (to[i] - from[i]) * u;
+          tangent[i] = length > 0.0 ? (to[i] - from[i]) / length : 0.0;
+        }
+        return;
+      }
+      const double angle = startAngle + sweep * u;
+      const double direction = sweep >= 0.0 ? 1.0 : -1.0;
+      position[0] = center[0] + radius * std::cos(angle);
+      position[1] = center[1] + radius * std::sin(angle);
+      tangent[0] = -direction * std::sin(angle);
+      tangent[1] = direction * std::cos(angle);
+    }
+  };
+
+  // Pieces between two stops, fed with one trapezoidal profile
+  struct FeedRun {
+    std::vector<PathPiece> pieces;
+    double length = 0.0;
+    double dwellAfter = 0.0;
+
+    void Evaluate(double s, double* position, double* tangent) const {
+      for (size_t i = 0; i < pieces.size(); i++) {
+        if (s <= pieces[i].length || i + 1 == pieces.size()) {
+          pieces[i].Evaluate(s, position, tangent);
+          return;
+        }
+        s -= pieces[i].length;
+      }
+    }
+  };
+}
+
+// === PATH ===
+
+ACSTrajectoryStreamer::DispensePath& ACSTrajectoryStreamer::DispensePath::LineTo(double a, double b) {
+  Segment segment;
+  segment.type = Segment::Type::Line;
+  segment.end[0] = a;
+  segment.end[1] = b;
+  segments.push_back(segment);
+  return *this;
+}
+
+ACSTrajectoryStreamer::DispensePath& ACSTrajectoryStreamer::DispensePath::ArcTo(double a, double b,
+  double centerA, double centerB, bool clockwise) {
+  Segment segment;
+  segment.type = Segment::Type::Arc;
+  segment.end[0] = a;
+  segment.end[1] = b;
+  segment.center[0] = centerA;
+  segment.center[1] = centerB;
+  segment.clockwise = clockwise;
+  segments.push_back(segment);
+  return *this;
+}
+
+ACSTrajectoryStreamer::DispensePath& ACSTrajectoryStreamer::DispensePath::Dwell(double seconds) {
+  Segment segment;
+  segment.type = Segment::Type::Dwell;
+  segment.dwellSeconds = seconds;
+  segments.push_back(segment);
+  return *this;
+}
+
+// === PLANNING ===
+
+bool ACSTrajectoryStreamer::Plan(const DispensePath& path, const Profile& profile, std::vector<PVTPoint>& points) {
+  points.clear();
+  if (profile.velocity <= 0.0 || profile.acceleration <= 0.0 || profile.sampleTime <= 0.0) {
+    std::cout << "ACSTrajectoryStreamer: ERROR - Velocity, acceleration and sample time must be positive" << std::endl;
+    return false;
+  }
+
+  // Split the path into runs at dwells and sharp corners
+  const double cornerCos = std::cos(profile.cornerAngleDeg * kPi / 180.0);
+  std::vector<FeedRun> runs(1);
+  double current[2] = { path.start[0], path.start[1] };
+  double lastTangent[2] = { 0.0, 0.0 };
+
+  for (size_t i = 0; i < path.segments.size(); i++) {
+    const auto& segment = path.segments[i];
+
+    if (segment.type == DispensePath::Segment::Type::Dwell) {
+      if (segment.dwellSeconds < 0.0) {
+        std::cout << "ACSTrajectoryStreamer: ERROR - Segment " << i << ": negative dwell" << std::endl;
+        return false;
+      }
+      runs.back().dwellAfter += segment.dwellSeconds;
+      runs.emplace_back();
+      continue;
+    }
+
+    PathPiece piece;
+    piece.arc = segment.type == DispensePath::Segment::Type::Arc;
+    piece.from[0] = current[0];
+    piece.from[1] = current[1];
+    piece.to[0] = segment.end[0];
+    piece.to[1] = segment.end[1];
+
+    if (piece.arc) {
+      piece.center[0] = segment.center[0];
+      piece.center[1] = segment.center[1];
+      piece.radius = std::hypot(current[0] - segment.center[0], current[1] - segment.center[1]);
+      const double endRadius = std::hypot(segment.end[0] - segment.center[0], segment.end[1] - segment.center[1]);
+      if (piece.radius < kEpsilon || std::abs(endRadius - piece.radius) > 1e-3 * piece.radius + 1e-6) {
+        std::cout << "ACSTrajectoryStreamer: ERROR - Segment " << i << ": arc end is not on the circle (radius "
+          << piece.radius << " vs " << endRadius << ")" << std::endl;
+        return false;
+      }
+
+      piece.startAngle = std::atan2(current[1] - segment.center[1], current[0] - segment.center[0]);
+      double sweep = std::atan2(segment.end[1] - segment.center[1], segment.end[0] - segment.center[0]) - piece.startAngle;
+      if (segment.clockwise) {
+        while (sweep >= -kEpsilon) sweep -= 2.0 * kPi;   // (-2pi, 0), end == start: full circle
+      }
+      else {
+        while (sweep <= kEpsilon) sweep += 2.0 * kPi;    // (0, 2pi]
+      }
+      piece.sweep = sweep;
+      piece.length = piece.radius * std::abs(sweep);
+    }
+    else {
+      piece.length = std::hypot(segment.end[0] - current[0], segment.end[1] - current[1]);
+    }
+
+    current[0] = segment.end[0];
+    current[1] = segment.end[1];
+    if (piece.length < kEpsilon) {
+      continue;
+    }
+
+    double position[2];
+    double startTangent[2];
+    double endTangent[2];
+    piece.Evaluate(0.0, position, startTangent);
+    piece.Evaluate(piece.length, position, endTangent);
+
+    FeedRun& run = runs.back();
+    if (!run.pieces.empty() &&
+      startTangent[0] * lastTangent[0] + startTangent[1] * lastTangent[1] < cornerCos) {
+      runs.emplace_back();
+    }
+    runs.back().pieces.push_back(piece);
+    runs.back().length += piece.length;
+    lastTangent[0] = endTangent[0];
+    lastTangent[1] = endTangent[1];
+  }
+
+  // Trapezoidal feed per run, sampled at (about) sampleTime
+  double last[2] = { path.start[0], path.start[1] };
+  for (const auto& run : runs) {
+    if (run.length > 0.0) {
+      const double a = profile.acceleration;
+      double accelTime = profile.velocity / a;
+      double cruiseTime = 0.0;
+      double peak = profile.velocity;
+      if (run.length < peak * accelTime) {
+        accelTime = std::sqrt(run.length / a);
+        peak = a * accelTime;
+      }
+      else {
+        cruiseTime = (run.length - peak * accelTime) / peak;
+      }
+      const double total = 2.0 * accelTime + cruiseTime;
+
+      const int steps = std::max(1, static_cast<int>(std::ceil(total / profile.sampleTime - kEpsilon)));
+      const double interval = total / steps;
+      for (int k = 1; k <= steps; k++) {
+        const double t = k == steps ? total : k * interval;
+        double s = 0.0;
+        double v = 0.0;
+        if (t < accelTime) {
+          s = 0.5 * a * t * t;
+          v = a * t;
+        }
+        else if (t < accelTime + cruiseTime) {
+          s = 0.5 * a * accelTime * accelTime + peak * (t - accelTime);
+          v = peak;
+        }
+        else {
+          const double remaining = std::max(0.0, total - t);
+          s = run.length - 0.5 * a * remaining * remaining;
+          v = a * remaining;
+        }
+
+        PVTPoint point;
+        double tangent[2];
+        run.Evaluate(std::clamp(s, 0.0, run.length), point.position, tangent);
+        point.velocity[0] = v * tangent[0];
+        point.velocity[1] = v * tangent[1];
+        point.interval = interval;
+        points.push_back(point);
+      }
+      last[0] = points.back().position[0];
+      last[1] = points.back().position[1];
+    }
+
+    // Dwell: hold position, one point per sample time
+    if (run.dwellAfter > 0.0) {
+      const int steps = std::max(1, static_cast<int>(std::ceil(run.dwellAfter / profile.sampleTime - kEpsilon)));
+      const double interval = run.dwellAfter / steps;
+      for (int k = 0; k < steps; k++) {
+        points.push_back({ { last[0], last[1] }, { 0.0, 0.0 }, interval });
+      }
+    }
+  }
+
+  if (points.empty()) {
+    std::cout << "ACSTrajectoryStreamer: ERROR - Path has no motion" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// === STREAMING ===
+
+ACSTrajectoryStreamer::ACSTrajectoryStreamer(ACSController& controller)
+  : m_backend(std::make_unique<ACSCBackend>(controller)) {
+}
+
+ACSTrajectoryStreamer::ACSTrajectoryStreamer(std::unique_ptr<Backend> backend)
+  : m_backend(std::move(backend)) {
+}
+
+ACSTrajectoryStreamer::~ACSTrajectoryStreamer() {
+  if (m_running) {
+    Stop();
+  }
+  else if (m_feeder.joinable()) {
+    m_feeder.join();
+  }
+}
+
+bool ACSTrajectoryStreamer::Run(const DispensePath& path, const Profile& profile, int axisA, int axisB) {
+  std::vector<PVTPoint> points;
+  if (!Plan(path, profile, points)) {
+    return false;
+  }
+  return Start(axisA, axisB, std::move(points));
+}
+
+bool ACSTrajectoryStreamer::Start(int axisA, int axisB, std::vector<PVTPoint> points) {
+  if (m_running) {
+    std::cout << "ACSTrajectoryStreamer: ERROR - A trajectory is already streaming" << std::endl;
+    return false;
+  }
+  if (points.empty() || axisA < 0 || axisB < 0 || axisA == axisB || m_queueDepth < 1) {
+    std::cout << "ACSTrajectoryStreamer: ERROR - Invalid trajectory (" << points.size() << " points, axes "
+      << axisA << "/" << axisB << ")" << std::endl;
+    return false;
+  }
+  if (m_feeder.joinable()) {
+    m_feeder.join();
+  }
+
+  m_axes[0] = axisA;
+  m_axes[1] = axisB;
+  m_axes[2] = -1;
+  m_points = std::move(points);
+  m_dueTimes.resize(m_points.size());
+  double time = 0.0;
+  for (size_t i = 0; i < m_points.size(); i++) {
+    time += m_points[i].interval;
+    m_dueTimes[i] = time;
+  }
+
+  m_abort = false;
+  m_failed = false;
+  m_sent = 0;
+  m_starvations = 0;
+
+  // Cubic PVT, each point with its own interval; held until GoM
+  if (!m_backend->SplineM(ACSC_AMF_CUBIC | ACSC_AMF_VARTIME | ACSC_AMF_WAIT, m_axes,
+    m_points.front().interval * kMsPerSecond)) {
+    return Fail("Starting spline motion");
+  }
+
+  // Prefill so the motion starts with a full lookahead
+  const size_t prefill = std::min(m_points.size(), static_cast<size_t>(m_queueDepth));
+  for (size_t i = 0; i < prefill; i++) {
+    if (!SendPoint(i)) {
+      m_backend->HaltM(m_axes);
+      return Fail("Adding PVT point");
+    }
+  }
+  if (m_sent == m_points.size() && !m_backend->EndSequenceM(m_axes)) {
+    m_backend->HaltM(m_axes);
+    return Fail("Ending point sequence");
+  }
+
+  if (!m_backend->GoM(m_axes)) {
+    m_backend->HaltM(m_axes);
+    return Fail("Starting motion");
+  }
+
+  m_running = true;
+  m_feeder = std::thread(&ACSTrajectoryStreamer::FeederThreadFunc, this);
+
+  std::cout << "ACSTrajectoryStreamer: Streaming " << m_points.size() << " points ("
+    << m_dueTimes.back() << " s) on axes " << axisA << "/" << axisB << std::endl;
+  return true;
+}
+
+bool ACSTrajectoryStreamer::SendPoint(size_t index) {
+  PVTPoint& point = m_points[index];
+  if (!m_backend->AddPVTPointM(m_axes, point.position, point.velocity, point.interval * kMsPerSecond)) {
+    return false;
+  }
+  m_sent++;
+  return true;
+}
+
+// Both axes report motion end - a failed read counts as still moving
+bool ACSTrajectoryStreamer::AxesStopped() {
+  for (int i = 0; i < 2; i++) {
+    bool moving = true;
+    if (!m_backend->IsMoving(m_axes[i], moving) || moving) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Tops up the controller queue as it reports free space, never more than
+// m_queueDepth points ahead; the host clock only paces when the free space
+// cannot be read
+void ACSTrajectoryStreamer::FeederThreadFunc() {
+  ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::MotionIO, "ACS trajectory feeder");
+
+  const auto goTime = std::chrono::steady_clock::now();
+  const size_t total = m_points.size();
+  const auto idle = std::chrono::duration<double>(std::clamp(m_points.front().interval / 2.0, 0.001, 0.010));
+  bool drained = false;
+
+  while (!m_abort) {
+    const size_t sent = m_sent;
+
+    if (sent < total) {
+      size_t allowed = 0;
+      int free = 0;
+      if (m_backend->GetFreePoints(m_axes[0], free)) {
+        const int queued = std::max(CONTROLLER_QUEUE_POINTS - free, 0);
+        if (queued == 0 && !drained) {
+          m_starvations++;   // The controller ran the queue dry before we refilled it
+        }
+        drained = queued == 0;
+        allowed = static_cast<size_t>(std::max(m_queueDepth - queued, 0));
+      }
+      else {
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - goTime).count();
+        const size_t consumed = std::upper_bound(m_dueTimes.begin(), m_dueTimes.end(), elapsed) - m_dueTimes.begin();
+        if (consumed >= sent) {
+          m_starvations++;
+        }
+        allowed = consumed + static_cast<size_t>(m_queueDepth) > sent
+          ? consumed + static_cast<size_t>(m_queueDepth) - sent : 0;
+      }
+
+      if (allowed > 0) {
+        const size_t end = std::min(total, sent + allowed);
+        bool ok = true;
+        for (size_t i = sent; i < end && ok; i++) {
+          ok = SendPoint(i);
+        }
+        if (!ok) {
+          Fail("Adding PVT point");
+          m_backend->HaltM(m_axes);
+          break;
+        }
+        if (m_sent == total && !m_backend->EndSequenceM(m_axes)) {
+          Fail("Ending point sequence");
+          m_backend->HaltM(m_axes);
+          break;
+        }
+        continue;
+      }
+    }
+    else if (AxesStopped()) {
+      break;
+    }
+
+    std::this_thread::sleep_for(idle);
+  }
+
+  if (m_starvations > 0) {
+    std::cout << "ACSTrajectoryStreamer: WARNING - Controller queue ran dry " << m_starvations
+      << " times - raise the queue depth or the sample time" << std::endl;
+  }
+  m_running = false;
+}
+
+bool ACSTrajectoryStreamer::Wait(std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (m_running) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      std::cout << "ACSTrajectoryStreamer: ERROR - Timeout waiting for trajectory" << std::endl;
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  if (m_feeder.joinable()) {
+    m_feeder.join();
+  }
+  return !m_failed;
+}
+
+bool ACSTrajectoryStreamer::Stop() {
+  m_abort = true;
+  if (m_feeder.joinable()) {
+    m_feeder.join();
+  }
+  m_running = false;
+
+  if (m_axes[0] < 0) {
+    return true;
+  }
+  if (!m_backend->HaltM(m_axes)) {
+    return Fail("Halting trajectory");
+  }
+  std::cout << "ACSTrajectoryStreamer: Trajectory halted after " << m_sent << " of " << m_points.size()
+    << " points" << std::endl;
+  return true;
+}
+
+ACSTrajectoryStreamer::Stats ACSTrajectoryStreamer::GetStats() const {
+  Stats stats;
+  stats.pointsTotal = m_points.size();
+  stats.pointsSent = m_sent;
+  stats.starvations = m_starvations;
+  stats.pathTime = m_dueTimes.empty() ? 0.0 : m_dueTimes.back();
+  stats.running = m_running;
+  stats.failed = m_failed;
+  return stats;
+}
+
+bool ACSTrajectoryStreamer::Fail(const char* action) {
+  m_failed = true;
+  std::cout << "ACSTrajectoryStreamer: ERROR - " << action << " failed. Error code: "
+    << m_backend->GetLastError() << std::endl;
+  return false;
+}
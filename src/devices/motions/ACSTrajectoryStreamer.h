@@ -0,0 +1,141 @@
+// ACSTrajectoryStreamer.h - Continuous gantry paths streamed as PVT spline points
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class ACSController;
+
+/**
+ * ACSTrajectoryStreamer - Dispense paths as one continuous PVT motion
+ *
+ * A DispensePath (lines, arcs and dwells in the plane of two gantry axes)
+ * is planned with a trapezoidal feed profile and sampled into PVT points:
+ * position plus velocity every sampleTime seconds. The controller
+ * interpolates cubically between them (acsc_SplineM with
+ * ACSC_AMF_CUBIC | ACSC_AMF_VARTIME), so the path is followed without the
+ * stops of point-to-point ToPointM moves.
+ *
+ * A background feeder keeps the controller's point queue filled: it
+ * prefills queueDepth points, starts the motion (GoM), then tops up as the
+ * controller reports free queue space (GSFREE) - never more than queueDepth
+ * ahead, and it reports starvation when it finds the queue drained. If the
+ * free space cannot be read it paces on the host clock instead. The run
+ * ends when both axes report motion end, not on the planned path time.
+ * Tangent breaks sharper than cornerAngleDeg and dwells bring the feed to
+ * a stop.
+ *
+ * Times are seconds throughout; the ACSC spline period and PVT interval
+ * are milliseconds, converted at the Backend boundary.
+ *
+ * Usage:
+ *   ACSTrajectoryStreamer::DispensePath path(10.0, 10.0);
+ *   path.LineTo(30.0, 10.0).ArcTo(30.0, 30.0, 30.0, 20.0, false).Dwell(0.2).LineTo(10.0, 30.0);
+ *   ACSTrajectoryStreamer streamer(controller);
+ *   streamer.Run(path, profile, ACSC_AXIS_X, ACSC_AXIS_Y);
+ *   streamer.Wait(std::chrono::seconds(30));
+ */
+class ACSTrajectoryStreamer {
+public:
+  struct DispensePath {
+    struct Segment {
+      enum class Type {
+        Line,
+        Arc,
+        Dwell
+      };
+      Type type = Type::Line;
+      double end[2] = { 0.0, 0.0 };
+      double center[2] = { 0.0, 0.0 };   // Arc only
+      bool clockwise = false;            // Arc only
+      double dwellSeconds = 0.0;         // Dwell only
+    };
+
+    DispensePath(double startA, double startB) : start{ startA, startB } {}
+
+    DispensePath& LineTo(double a, double b);
+    DispensePath& ArcTo(double a, double b, double centerA, double centerB, bool clockwise);  // end == start: full circle
+    DispensePath& Dwell(double seconds);
+
+    double start[2];
+    std::vector<Segment> segments;
+  };
+
+  struct Profile {
+    double velocity = 20.0;        // Path feed (mm/s)
+    double acceleration = 200.0;   // Path acceleration (mm/s^2)
+    double sampleTime = 0.010;     // Seconds between PVT points
+    double cornerAngleDeg = 10.0;  // Sharper tangent breaks stop the feed
+  };
+
+  struct PVTPoint {
+    double position[2];
+    double velocity[2];
+    double interval;               // Seconds since the previous point
+  };
+
+  struct Stats {
+    size_t pointsTotal = 0;
+    size_t pointsSent = 0;
+    size_t starvations = 0;        // Points sent after the controller should already have used them
+    double pathTime = 0.0;         // Seconds
+    bool running = false;
+    bool failed = false;
+  };
+
+  // Controller calls used by the streamer - same shape (and units) as the ACSC functions
+  class Backend {
+  public:
+    virtual ~Backend() = default;
+    virtual bool SplineM(int flags, int* axes, double periodMs) = 0;
+    virtual bool AddPVTPointM(int* axes, double* point, double* velocity, double intervalMs) = 0;
+    virtual bool EndSequenceM(int* axes) = 0;
+    virtual bool GoM(int* axes) = 0;
+    virtual bool HaltM(int* axes) = 0;
+    virtual bool GetFreePoints(int axis, int& free) = 0;     // Free space in the leading axis' point queue
+    virtual bool IsMoving(int axis, bool& moving) = 0;
+    virtual int GetLastError() = 0;
+  };
+
+  explicit ACSTrajectoryStreamer(ACSController& controller);   // Real controller via ACSC
+  explicit ACSTrajectoryStreamer(std::unique_ptr<Backend> backend);
+  ~ACSTrajectoryStreamer();
+
+  // Sample a path into PVT points (the first point follows path.start after one interval)
+  static bool Plan(const DispensePath& path, const Profile& profile, std::vector<PVTPoint>& points);
+
+  // Stream points on two axes; the gantry must already be at the first point's origin
+  bool Start(int axisA, int axisB, std::vector<PVTPoint> points);
+  bool Run(const DispensePath& path, const Profile& profile, int axisA, int axisB);
+  bool Wait(std::chrono::milliseconds timeout);
+  bool Stop();
+
+  bool IsRunning() const { return m_running.load(); }
+  Stats GetStats() const;
+
+  void SetQueueDepth(int points) { m_queueDepth = points; }
+
+  static constexpr int DEFAULT_QUEUE_DEPTH = 32;   // Controller queue holds 50 points
+  static constexpr int CONTROLLER_QUEUE_POINTS = 50;
+
+private:
+  void FeederThreadFunc();
+  bool SendPoint(size_t index);
+  bool AxesStopped();
+  bool Fail(const char* action);
+
+  std::unique_ptr<Backend> m_backend;
+  int m_axes[3] = { -1, -1, -1 };   // -1 terminated for the *M calls
+  std::vector<PVTPoint> m_points;
+  std::vector<double> m_dueTimes;   // Seconds after GoM when each point is consumed
+  int m_queueDepth = DEFAULT_QUEUE_DEPTH;
+
+  std::thread m_feeder;
+  std::atomic<bool> m_running{ false };
+  std::atomic<bool> m_abort{ false };
+  std::atomic<bool> m_failed{ false };
+  std::atomic<size_t> m_sent{ 0 };
+  std::atomic<size_t> m_starvations{ 0 };
+};
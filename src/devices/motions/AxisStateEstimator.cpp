@@ -0,0 +1,193 @@
+// AxisStateEstimator.cpp
+#include "AxisStateEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+void AxisStateEstimator::SetSettings(const Settings& settings) {
+  ProfiledLockGuard lock(m_mutex);
+  m_settings = settings;
+}
+
+void AxisStateEstimator::SetLimits(int axis, double maxVelocity, double maxAcceleration) {
+  if (!ValidAxis(axis)) return;
+  ProfiledLockGuard lock(m_mutex);
+  m_axes[axis].maxVelocity = std::max(maxVelocity, 0.0);
+  m_axes[axis].maxAcceleration = std::max(maxAcceleration, 0.0);
+}
+
+void AxisStateEstimator::SetMaxVelocity(int axis, double maxVelocity) {
+  if (!ValidAxis(axis)) return;
+  ProfiledLockGuard lock(m_mutex);
+  m_axes[axis].maxVelocity = std::max(maxVelocity, 0.0);
+}
+
+void AxisStateEstimator::AddSample(int axis, Clock::time_point time, double position) {
+  if (!ValidAxis(axis)) return;
+  ProfiledLockGuard lock(m_mutex);
+  AxisState& state = m_axes[axis];
+
+  // Samples must be in time order; a late duplicate replaces the newest
+  if (state.count > 0) {
+    Sample& newest = state.history[(state.head - 1 + kHistory) % kHistory];
+    if (time <= newest.time) {
+      if (time == newest.time) newest.position = position;
+      return;
+    }
+  }
+
+  // A sample at or past the commanded target ends the command - from here
+  // the samples alone describe the axis
+  if (state.commanded && state.count > 0 && time > state.commandTime) {
+    const double before = At(state, state.count - 1).position - state.target;
+    const double after = position - state.target;
+    if (before * after <= 0.0 || std::abs(after) <= m_settings.positionNoise) {
+      state.commanded = false;
+    }
+  }
+
+  state.history[state.head] = { time, position };
+  state.head = (state.head + 1) % kHistory;
+  state.count = std::min(state.count + 1, kHistory);
+}
+
+void AxisStateEstimator::SetCommand(int axis, Clock::time_point time, double target, double speed) {
+  if (!ValidAxis(axis)) return;
+  ProfiledLockGuard lock(m_mutex);
+  AxisState& state = m_axes[axis];
+  state.commanded = true;
+  state.commandTime = time;
+  state.target = target;
+  state.speed = speed;
+}
+
+void AxisStateEstimator::ClearCommand(int axis) {
+  ProfiledLockGuard lock(m_mutex);
+  for (int i = 0; i < kMaxAxes; i++) {
+    if (axis < 0 || axis == i) m_axes[i].commanded = false;
+  }
+}
+
+void AxisStateEstimator::Reset() {
+  ProfiledLockGuard lock(m_mutex);
+  for (auto& state : m_axes) {
+    state.count = 0;
+    state.head = 0;
+    state.commanded = false;
+  }
+}
+
+// === ESTIMATION ===
+
+// How far the axis may be from a straight-line prediction dt seconds out.
+// observed is the velocity of the last two samples: without limits it is
+// the only evidence of how fast the axis can go, even when the prediction
+// itself has stopped (at the target, or held while reversing)
+double AxisStateEstimator::Bound(const AxisState& state, double dt, double velocity, double observed) const {
+  double bound = std::max(std::abs(velocity), std::abs(observed)) * dt;
+  if (state.maxAcceleration > 0.0) {
+    bound = 0.5 * state.maxAcceleration * dt * dt;
+    if (state.maxVelocity > 0.0) {
+      bound = std::min(bound, (state.maxVelocity + std::abs(velocity)) * dt);
+    }
+  }
+  else if (state.maxVelocity > 0.0) {
+    bound = (state.maxVelocity + std::abs(velocity)) * dt;
+  }
+  return bound + m_settings.positionNoise;
+}
+
+AxisStateEstimator::Estimate AxisStateEstimator::Query(int axis, Clock::time_point time) const {
+  Estimate estimate;
+  if (!ValidAxis(axis)) return estimate;
+
+  ProfiledLockGuard lock(m_mutex);
+  const AxisState& state = m_axes[axis];
+  if (state.count == 0) return estimate;
+
+  auto seconds = [](Clock::duration duration) { return std::chrono::duration<double>(duration).count(); };
+  const Sample& newest = At(state, state.count - 1);
+  const Sample& oldest = At(state, 0);
+  estimate.valid = true;
+  estimate.age = seconds(time - newest.time);
+
+  // Inside the history: interpolate between the bracketing samples
+  if (time <= newest.time && time >= oldest.time && state.count >= 2) {
+    int i = state.count - 2;
+    while (i > 0 && At(state, i).time > time) i--;
+    const Sample& a = At(state, i);
+    const Sample& b = At(state, i + 1);
+    const double span = seconds(b.time - a.time);
+    const double dt1 = seconds(time - a.time);
+    const double dt2 = seconds(b.time - time);
+    estimate.velocity = (b.position - a.position) / span;
+    estimate.position = a.position + estimate.velocity * dt1;
+
+    // Deviation from the chord: a*dt1*dt2/2 with an acceleration limit
+    double bound = std::abs(estimate.velocity) * std::min(dt1, dt2);
+    if (state.maxAcceleration > 0.0) {
+      bound = 0.5 * state.maxAcceleration * dt1 * dt2;
+    }
+    else if (state.maxVelocity > 0.0) {
+      bound = (state.maxVelocity + std::abs(estimate.velocity)) * std::min(dt1, dt2);
+    }
+    estimate.uncertainty = bound + m_settings.positionNoise;
+    return estimate;
+  }
+
+  estimate.extrapolated = true;
+  if (time < oldest.time) {
+    // Older than the history - nothing better than the oldest sample
+    estimate.position = oldest.position;
+    estimate.uncertainty = Bound(state, seconds(oldest.time - time), 0.0, 0.0);
+    return estimate;
+  }
+
+  const double horizon = std::chrono::duration<double>(m_settings.maxExtrapolation).count();
+  const double dt = std::min(seconds(time - newest.time), horizon);
+
+  double velocity = 0.0;
+  if (state.count >= 2) {
+    // A move commanded between the two samples only ran for part of the interval
+    const Sample& previous = At(state, state.count - 2);
+    const Clock::time_point from = state.commanded && state.commandTime > previous.time && state.commandTime < newest.time
+      ? state.commandTime : previous.time;
+    velocity = (newest.position - previous.position) / seconds(newest.time - from);
+  }
+  if (state.maxVelocity > 0.0) {
+    velocity = std::clamp(velocity, -state.maxVelocity, state.maxVelocity);
+  }
+  const double observed = velocity;
+
+  double position = newest.position + velocity * dt;
+  double commandSpread = 0.0;
+  if (state.commanded) {
+    const double remaining = state.target - newest.position;
+    const double direction = remaining > 0.0 ? 1.0 : (remaining < 0.0 ? -1.0 : 0.0);
+    double speed = std::abs(velocity);
+    double elapsed = dt;
+    if (velocity * direction <= 0.0 && state.commandTime > newest.time) {
+      // Commanded after the last poll - assume it started at the command
+      speed = state.speed > 0.0 ? state.speed : state.maxVelocity;
+      elapsed = std::clamp(seconds(time - state.commandTime), 0.0, horizon);
+    }
+    else if (velocity * direction < 0.0) {
+      speed = 0.0;   // Still moving away, e.g. reversing - do not extrapolate either way
+    }
+    const double travel = std::min(speed * elapsed, std::abs(remaining));
+    position = newest.position + direction * travel;
+    velocity = travel < std::abs(remaining) ? direction * speed : 0.0;
+
+    // The axis is somewhere between the last sample and the target
+    commandSpread = std::max(travel, std::abs(remaining) - travel);
+  }
+
+  estimate.position = position;
+  estimate.velocity = velocity;
+  estimate.uncertainty = Bound(state, dt, velocity, observed);
+  if (state.maxVelocity <= 0.0 && state.maxAcceleration <= 0.0) {
+    // No limit to bound the speed - a commanded move can be anywhere along its path
+    estimate.uncertainty = std::max(estimate.uncertainty, commandSpread + m_settings.positionNoise);
+  }
+  return estimate;
+}
@@ -0,0 +1,102 @@
+// AxisStateEstimator.h - Axis positions between polls: interpolated, extrapolated, with an error bound
+#pragma once
+
+#include "../../utils/ProfiledMutex.h"
+#include <chrono>
+
+/**
+ * AxisStateEstimator - Short timestamped position history per axis
+ *
+ * The controllers' cached positions change only when the communication
+ * thread polls (50 ms PI, 200 ms ACS), so a display or planner reading them
+ * sees a staircase. The estimator keeps the last kHistory polled positions
+ * of each axis with their sample times and answers for any query time:
+ *
+ *   - between two samples: linear interpolation
+ *   - after the last sample: extrapolation at the velocity of the last two
+ *     samples, or - for a move commanded since - at the commanded speed,
+ *     never past the commanded target; at most maxExtrapolation ahead
+ *
+ * A command ends when a sample reaches (or passes) its target, or when the
+ * owner clears it: move settled, stopped, jog or homing took over.
+ *
+ * Each estimate carries an uncertainty bound from the axis limits: with a
+ * known acceleration limit the velocity cannot have changed by more than
+ * a*dt since the last sample, with only a velocity limit by more than
+ * vmax + |v|. Without limits the bound falls back to the observed velocity
+ * times the age, and for a commanded move to the span between the last
+ * sample and the target.
+ *
+ * Axes are slots 0..kMaxAxes-1 in the owner's polling order. AddSample and
+ * SetCommand take fixed-size storage only and may be called from the
+ * allocation-free communication tick. All methods are thread-safe.
+ */
+class AxisStateEstimator {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr int kMaxAxes = 8;
+  static constexpr int kHistory = 16;
+
+  struct Settings {
+    std::chrono::milliseconds maxExtrapolation{ 500 };   // Beyond this the estimate is held, not extrapolated
+    double positionNoise = 0.0;                           // Added to every bound (encoder / poll noise)
+  };
+
+  struct Estimate {
+    bool valid = false;           // At least one sample
+    bool extrapolated = false;    // Query time after the last sample (or before the first)
+    double position = 0.0;
+    double velocity = 0.0;        // Units per second
+    double uncertainty = 0.0;     // Bound on |position - true position|
+    double age = 0.0;             // Seconds from the last sample to the query time (negative: in the past)
+  };
+
+  AxisStateEstimator() = default;
+  explicit AxisStateEstimator(const Settings& settings) : m_settings(settings) {}
+
+  void SetSettings(const Settings& settings);
+
+  // 0 = unknown
+  void SetLimits(int axis, double maxVelocity, double maxAcceleration);
+  void SetMaxVelocity(int axis, double maxVelocity);
+
+  void AddSample(int axis, Clock::time_point time, double position);
+  // Move toward target started at time; speed 0 = the axis velocity limit
+  void SetCommand(int axis, Clock::time_point time, double target, double speed = 0.0);
+  void ClearCommand(int axis);    // Settled, stopped, jog or homing; -1 = all axes
+  void Reset();                   // Reconnect: history no longer continuous
+
+  Estimate Query(int axis, Clock::time_point time) const;
+  Estimate Query(int axis) const { return Query(axis, Clock::now()); }
+
+private:
+  struct Sample {
+    Clock::time_point time;
+    double position = 0.0;
+  };
+
+  struct AxisState {
+    Sample history[kHistory];
+    int head = 0;                 // Next write slot
+    int count = 0;
+    double maxVelocity = 0.0;
+    double maxAcceleration = 0.0;
+    bool commanded = false;
+    Clock::time_point commandTime;
+    double target = 0.0;
+    double speed = 0.0;
+  };
+
+  // Oldest first, i = 0..count-1
+  const Sample& At(const AxisState& state, int i) const {
+    return state.history[(state.head - state.count + i + kHistory) % kHistory];
+  }
+  double Bound(const AxisState& state, double dt, double velocity, double observed) const;
+
+  static bool ValidAxis(int axis) { return axis >= 0 && axis < kMaxAxes; }
+
+  mutable ProfiledMutex m_mutex{ "AxisStateEstimator::m_mutex" };
+  Settings m_settings;
+  AxisState m_axes[kMaxAxes];
+};
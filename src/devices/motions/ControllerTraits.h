@@ -0,0 +1,185 @@
+// ControllerTraits.h - Compile-time description of the supported controller models
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+/**
+ * ControllerTraits - Axis layout and features of each controller model
+ *
+ * Every model is a struct of constexpr members, so code written against a
+ * model gets fixed-size arrays and loops with no axis-string parsing:
+ *
+ *   using Hexapod = ControllerTraits::PIHexapodC887;
+ *   double positions[Hexapod::kAxisCount];
+ *
+ * Configuration is only known at run time (typeController / installAxes),
+ * so Resolve() maps it to a Model once, and Dispatch() calls a generic
+ * lambda with the matching traits type - the specialized code is chosen
+ * when a controller is configured, not on every call:
+ *
+ *   ControllerTraits::Dispatch(model, [&](auto traits) {
+ *     using Traits = typename decltype(traits)::Type;
+ *     if constexpr (ControllerTraits::Supports<Traits, Feature::OnTargetQuery>()) { ... }
+ *   });
+ *
+ * Layouts not described here (a gantry with an unusual axis set) resolve
+ * to Model::Generic, and callers keep their runtime path for those. Dispatch
+ * instantiates the lambda for every model, PI and ACS alike, so features are
+ * branched on with Supports<>() inside it, and code shared by every layout
+ * asks ModelSupports(model, feature) at run time.
+ */
+namespace ControllerTraits {
+
+  enum class Feature {
+    OnTargetQuery,     // Per-axis on-target state in one query (PI qONT)
+    DataRecorder,      // Controller-side sampling of axis signals (PI DRC/DRR, ACS DC)
+    FastAlignment,     // Controller-run area and gradient scans (PI FDR/FDG, FSA)
+    SegmentedMotion    // Streamed multi-point paths (ACS PATH/PVT)
+  };
+
+  // PI C-887 hexapod controller
+  struct PIHexapodC887 {
+    static constexpr const char* kName = "PI C-887";
+    static constexpr int kAxisCount = 6;
+    static constexpr std::array<std::string_view, kAxisCount> kAxes = { "X", "Y", "Z", "U", "V", "W" };
+    static constexpr const char* kAxesString = "X Y Z U V W";   // Batched query order
+    static constexpr std::array<int, kAxisCount> kAxisIndices = { 0, 1, 2, 3, 4, 5 };
+
+    static constexpr bool kOnTargetQuery = true;
+    static constexpr bool kDataRecorder = true;
+    static constexpr bool kFastAlignment = true;
+    static constexpr bool kSegmentedMotion = false;
+  };
+
+  // ACS gantry with X, Y and Z (ACSC_AXIS_X/Y/Z)
+  struct ACSGantryXYZ {
+    static constexpr const char* kName = "ACS gantry XYZ";
+    static constexpr int kAxisCount = 3;
+    static constexpr std::array<std::string_view, kAxisCount> kAxes = { "X", "Y", "Z" };
+    static constexpr const char* kAxesString = "X Y Z";
+    static constexpr std::array<int, kAxisCount> kAxisIndices = { 0, 1, 2 };
+
+    static constexpr bool kOnTargetQuery = false;   // Motion state (MST) only
+    static constexpr bool kDataRecorder = true;
+    static constexpr bool kFastAlignment = false;
+    static constexpr bool kSegmentedMotion = true;
+  };
+
+  // ACS gantry without a Z stage
+  struct ACSGantryXY {
+    static constexpr const char* kName = "ACS gantry XY";
+    static constexpr int kAxisCount = 2;
+    static constexpr std::array<std::string_view, kAxisCount> kAxes = { "X", "Y" };
+    static constexpr const char* kAxesString = "X Y";
+    static constexpr std::array<int, kAxisCount> kAxisIndices = { 0, 1 };
+
+    static constexpr bool kOnTargetQuery = false;
+    static constexpr bool kDataRecorder = true;
+    static constexpr bool kFastAlignment = false;
+    static constexpr bool kSegmentedMotion = true;
+  };
+
+  // Largest axis count of any model - sizes buffers shared by all models
+  constexpr int kMaxAxisCount = PIHexapodC887::kAxisCount;
+
+  template <typename Traits, Feature F>
+  constexpr bool Supports() {
+    if constexpr (F == Feature::OnTargetQuery) return Traits::kOnTargetQuery;
+    else if constexpr (F == Feature::DataRecorder) return Traits::kDataRecorder;
+    else if constexpr (F == Feature::FastAlignment) return Traits::kFastAlignment;
+    else return Traits::kSegmentedMotion;
+  }
+
+  // Position of an axis in the model's batched query order, -1 if not present
+  template <typename Traits>
+  constexpr int AxisSlot(std::string_view axis) {
+    for (int i = 0; i < Traits::kAxisCount; i++) {
+      if (Traits::kAxes[i] == axis) return i;
+    }
+    return -1;
+  }
+
+  // === RUNTIME TO STATIC DISPATCH ===
+
+  enum class Model {
+    Generic,           // Not described above - runtime axis handling
+    PIHexapodC887,
+    ACSGantryXYZ,
+    ACSGantryXY
+  };
+
+  template <typename T>
+  struct Tag {
+    using Type = T;
+  };
+
+  namespace Detail {
+    // installAxes as written in config: "X Y Z", "XYZ" or "X,Y,Z"
+    template <typename Traits>
+    constexpr bool AxesMatch(std::string_view installed) {
+      int count = 0;
+      for (char c : installed) {
+        if (c == ' ' || c == ',') continue;
+        if (count >= Traits::kAxisCount || Traits::kAxes[count][0] != c) return false;
+        count++;
+      }
+      return count == Traits::kAxisCount;
+    }
+  }
+
+  // Once per controller, at configuration time
+  constexpr Model Resolve(std::string_view controllerType, std::string_view installedAxes) {
+    if (controllerType == "PI") {
+      return (installedAxes.empty() || Detail::AxesMatch<PIHexapodC887>(installedAxes))
+        ? Model::PIHexapodC887 : Model::Generic;
+    }
+    if (controllerType == "ACS") {
+      if (installedAxes.empty() || Detail::AxesMatch<ACSGantryXYZ>(installedAxes)) return Model::ACSGantryXYZ;
+      if (Detail::AxesMatch<ACSGantryXY>(installedAxes)) return Model::ACSGantryXY;
+    }
+    return Model::Generic;
+  }
+
+  // Calls f(Tag<Traits>{}) for a described model; returns false for Generic
+  template <typename F>
+  bool Dispatch(Model model, F&& f) {
+    switch (model) {
+    case Model::PIHexapodC887: f(Tag<PIHexapodC887>{}); return true;
+    case Model::ACSGantryXYZ: f(Tag<ACSGantryXYZ>{}); return true;
+    case Model::ACSGantryXY: f(Tag<ACSGantryXY>{}); return true;
+    default: return false;
+    }
+  }
+
+  // Runtime feature check for code shared by all models; Generic proves nothing and supports nothing
+  inline bool ModelSupports(Model model, Feature feature) {
+    bool supported = false;
+    Dispatch(model, [&](auto traits) {
+      using Traits = typename decltype(traits)::Type;
+      switch (feature) {
+      case Feature::OnTargetQuery: supported = Supports<Traits, Feature::OnTargetQuery>(); break;
+      case Feature::DataRecorder: supported = Supports<Traits, Feature::DataRecorder>(); break;
+      case Feature::FastAlignment: supported = Supports<Traits, Feature::FastAlignment>(); break;
+      case Feature::SegmentedMotion: supported = Supports<Traits, Feature::SegmentedMotion>(); break;
+      }
+    });
+    return supported;
+  }
+
+  constexpr const char* ModelName(Model model) {
+    switch (model) {
+    case Model::PIHexapodC887: return PIHexapodC887::kName;
+    case Model::ACSGantryXYZ: return ACSGantryXYZ::kName;
+    case Model::ACSGantryXY: return ACSGantryXY::kName;
+    default: return "generic";
+    }
+  }
+
+  static_assert(Resolve("PI", "X Y Z U V W") == Model::PIHexapodC887);
+  static_assert(Resolve("ACS", "XYZ") == Model::ACSGantryXYZ);
+  static_assert(Resolve("ACS", "X Y") == Model::ACSGantryXY);
+  static_assert(Resolve("ACS", "X Y Z A") == Model::Generic);
+  static_assert(AxisSlot<PIHexapodC887>("V") == 4);
+}
@@ -0,0 +1,513 @@
+// CouplingModel.cpp
+#include "CouplingModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define COUPLING_MODEL_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define COUPLING_MODEL_AVX2_TARGET
+#else
+// Compiled for AVX2 per function, so the rest of the build keeps its baseline instruction set
+#define COUPLING_MODEL_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+namespace CouplingModel {
+
+  namespace {
+    constexpr int kMaxParameters = 2 + 2 * kMaxDims;   // peak, background, centres, widths
+    constexpr int kMaxTrialsPerIteration = 12;
+
+    // 0 width means the axis has no effect, as in the simulated coupling field
+    double InverseWidth(double width) {
+      return width > 0.0 ? 1.0 / width : 0.0;
+    }
+
+    // Unit-scale value of the peak for squared distance s
+    double Profile(Shape shape, double s) {
+      return shape == Shape::Gaussian ? std::exp(-2.0 * s) : 1.0 / (1.0 + s);
+    }
+
+    // === AVX2 KERNELS ===
+
+#ifdef COUPLING_MODEL_X86
+    // exp(x) for x <= 0: x = n ln2 + r with |r| <= ln2/2, Taylor polynomial in r, 2^n through the exponent bits
+    COUPLING_MODEL_AVX2_TARGET
+    __m256d ExpNonPositive(__m256d x) {
+      const __m256d kLog2e = _mm256_set1_pd(1.4426950408889634);
+      const __m256d kLn2Hi = _mm256_set1_pd(6.93147180369123816490e-01);
+      const __m256d kLn2Lo = _mm256_set1_pd(1.90821492927058770002e-10);
+
+      x = _mm256_max_pd(x, _mm256_set1_pd(-708.0));   // Below this the result is 0 to double precision anyway
+      const __m256d n = _mm256_round_pd(_mm256_mul_pd(x, kLog2e), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      __m256d r = _mm256_fnmadd_pd(n, kLn2Hi, x);
+      r = _mm256_fnmadd_pd(n, kLn2Lo, r);
+
+      static const double kCoefficients[] = {
+        1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0, 1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0,
+        1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0
+      };
+      __m256d p = _mm256_set1_pd(kCoefficients[0]);
+      for (size_t i = 1; i < sizeof(kCoefficients) / sizeof(kCoefficients[0]); i++) {
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(kCoefficients[i]));
+      }
+
+      const __m256i exponent = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+      const __m256i bits = _mm256_slli_epi64(_mm256_add_epi64(exponent, _mm256_set1_epi64x(1023)), 52);
+      return _mm256_mul_pd(p, _mm256_castsi256_pd(bits));
+    }
+
+    // Returns the number of points done; the caller finishes the tail
+    COUPLING_MODEL_AVX2_TARGET
+    size_t EvaluateAVX2(const Model& model, const double* const* coords, size_t count, double* out) {
+      __m256d center[kMaxDims];
+      __m256d inverseWidth[kMaxDims];
+      for (int d = 0; d < model.dims; d++) {
+        center[d] = _mm256_set1_pd(model.center[d]);
+        inverseWidth[d] = _mm256_set1_pd(InverseWidth(model.width[d]));
+      }
+      const __m256d peak = _mm256_set1_pd(model.peak);
+      const __m256d background = _mm256_set1_pd(model.background);
+      const __m256d one = _mm256_set1_pd(1.0);
+      const __m256d minusTwo = _mm256_set1_pd(-2.0);
+
+      size_t i = 0;
+      for (; i + 4 <= count; i += 4) {
+        __m256d s = _mm256_setzero_pd();
+        for (int d = 0; d < model.dims; d++) {
+          const __m256d u = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(coords[d] + i), center[d]), inverseWidth[d]);
+          s = _mm256_fmadd_pd(u, u, s);
+        }
+        const __m256d profile = model.shape == Shape::Gaussian
+          ? ExpNonPositive(_mm256_mul_pd(minusTwo, s))
+          : _mm256_div_pd(one, _mm256_add_pd(one, s));
+        _mm256_storeu_pd(out + i, _mm256_fmadd_pd(peak, profile, background));
+      }
+      return i;
+    }
+
+    COUPLING_MODEL_AVX2_TARGET
+    size_t SampleAVX2(const double* values, double originX, double originY, double stepX, double stepY,
+      int countX, int countY, const double* x, const double* y, size_t count, double* out) {
+      const __m256d x0 = _mm256_set1_pd(originX);
+      const __m256d y0 = _mm256_set1_pd(originY);
+      const __m256d inverseStepX = _mm256_set1_pd(1.0 / stepX);
+      const __m256d inverseStepY = _mm256_set1_pd(1.0 / stepY);
+      const __m256d maxX = _mm256_set1_pd(countX - 1.0);
+      const __m256d maxY = _mm256_set1_pd(countY - 1.0);
+      const __m256d lastCellX = _mm256_set1_pd(countX - 2.0);
+      const __m256d lastCellY = _mm256_set1_pd(countY - 2.0);
+      const __m256d rowLength = _mm256_set1_pd(static_cast<double>(countX));
+      const __m256d zero = _mm256_setzero_pd();
+      const double* right = values + 1;
+      const double* below = values + countX;
+      const double* belowRight = values + countX + 1;
+
+      size_t i = 0;
+      for (; i + 4 <= count; i += 4) {
+        __m256d fx = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(x + i), x0), inverseStepX);
+        __m256d fy = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(y + i), y0), inverseStepY);
+        fx = _mm256_min_pd(_mm256_max_pd(fx, zero), maxX);
+        fy = _mm256_min_pd(_mm256_max_pd(fy, zero), maxY);
+        const __m256d cellX = _mm256_min_pd(_mm256_floor_pd(fx), lastCellX);
+        const __m256d cellY = _mm256_min_pd(_mm256_floor_pd(fy), lastCellY);
+        const __m256d tx = _mm256_sub_pd(fx, cellX);
+        const __m256d ty = _mm256_sub_pd(fy, cellY);
+
+        const __m256i index = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(_mm256_fmadd_pd(cellY, rowLength, cellX)));
+        const __m256d v00 = _mm256_i64gather_pd(values, index, 8);
+        const __m256d v10 = _mm256_i64gather_pd(right, index, 8);
+        const __m256d v01 = _mm256_i64gather_pd(below, index, 8);
+        const __m256d v11 = _mm256_i64gather_pd(belowRight, index, 8);
+
+        const __m256d top = _mm256_fmadd_pd(tx, _mm256_sub_pd(v10, v00), v00);
+        const __m256d bottom = _mm256_fmadd_pd(tx, _mm256_sub_pd(v11, v01), v01);
+        _mm256_storeu_pd(out + i, _mm256_fmadd_pd(ty, _mm256_sub_pd(bottom, top), top));
+      }
+      return i;
+    }
+#endif
+
+    bool DetectAVX2() {
+#if defined(COUPLING_MODEL_X86) && defined(_MSC_VER)
+      int info[4] = { 0, 0, 0, 0 };
+      __cpuid(info, 0);
+      if (info[0] < 7) return false;
+      __cpuid(info, 1);
+      const bool fma = (info[2] & (1 << 12)) != 0;
+      const bool osxsave = (info[2] & (1 << 27)) != 0;
+      const bool avx = (info[2] & (1 << 28)) != 0;
+      if (!fma || !osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;   // OS saves the YMM registers
+      __cpuidex(info, 7, 0);
+      return (info[1] & (1 << 5)) != 0;
+#elif defined(COUPLING_MODEL_X86)
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+      return false;
+#endif
+    }
+
+    // === LEVENBERG-MARQUARDT HELPERS ===
+
+    // Parameter vector: peak, background, centre[dims], width[dims]
+    int ParameterCount(const Model& model) {
+      return 2 + 2 * model.dims;
+    }
+
+    void ToParameters(const Model& model, double* p) {
+      p[0] = model.peak;
+      p[1] = model.background;
+      for (int d = 0; d < model.dims; d++) {
+        p[2 + d] = model.center[d];
+        p[2 + model.dims + d] = model.width[d];
+      }
+    }
+
+    void FromParameters(const double* p, Model& model) {
+      model.peak = p[0];
+      model.background = p[1];
+      for (int d = 0; d < model.dims; d++) {
+        model.center[d] = p[2 + d];
+        model.width[d] = p[2 + model.dims + d];
+      }
+    }
+
+    double Cost(const Model& model, const double* const* coords, const double* values, size_t count,
+      std::vector<double>& scratch) {
+      EvaluateBatch(model, coords, count, scratch.data());
+      double cost = 0.0;
+      for (size_t i = 0; i < count; i++) {
+        const double r = values[i] - scratch[i];
+        cost += r * r;
+      }
+      return cost;
+    }
+
+    // Normal equations: a = J^T J, g = J^T r
+    void BuildNormalEquations(const Model& model, const double* const* coords, const double* values, size_t count,
+      double a[kMaxParameters][kMaxParameters], double* g) {
+      const int n = ParameterCount(model);
+      for (int i = 0; i < n; i++) {
+        g[i] = 0.0;
+        for (int j = 0; j < n; j++) a[i][j] = 0.0;
+      }
+
+      double inverseWidth[kMaxDims];
+      for (int d = 0; d < model.dims; d++) inverseWidth[d] = InverseWidth(model.width[d]);
+
+      double jacobian[kMaxParameters];
+      double u[kMaxDims];
+      for (size_t k = 0; k < count; k++) {
+        double s = 0.0;
+        for (int d = 0; d < model.dims; d++) {
+          u[d] = (coords[d][k] - model.center[d]) * inverseWidth[d];
+          s += u[d] * u[d];
+        }
+        const double profile = Profile(model.shape, s);
+        // -2 d(profile)/ds, shared by the centre and width derivatives
+        const double slope = model.shape == Shape::Gaussian ? 4.0 * profile : 2.0 * profile * profile;
+
+        jacobian[0] = profile;
+        jacobian[1] = 1.0;
+        for (int d = 0; d < model.dims; d++) {
+          jacobian[2 + d] = model.peak * slope * u[d] * inverseWidth[d];
+          jacobian[2 + model.dims + d] = model.peak * slope * u[d] * u[d] * inverseWidth[d];
+        }
+
+        const double r = values[k] - (model.background + model.peak * profile);
+        for (int i = 0; i < n; i++) {
+          g[i] += jacobian[i] * r;
+          for (int j = 0; j <= i; j++) a[i][j] += jacobian[i] * jacobian[j];
+        }
+      }
+      for (int i = 0; i < n; i++) {
+        for (int j = i + 1; j < n; j++) a[i][j] = a[j][i];
+      }
+    }
+
+    // In-place Cholesky of a symmetric positive definite n x n matrix (lower triangle)
+    bool Cholesky(double m[kMaxParameters][kMaxParameters], int n) {
+      for (int j = 0; j < n; j++) {
+        double diagonal = m[j][j];
+        for (int k = 0; k < j; k++) diagonal -= m[j][k] * m[j][k];
+        if (!(diagonal > 0.0)) return false;
+        m[j][j] = std::sqrt(diagonal);
+        for (int i = j + 1; i < n; i++) {
+          double sum = m[i][j];
+          for (int k = 0; k < j; k++) sum -= m[i][k] * m[j][k];
+          m[i][j] = sum / m[j][j];
+        }
+      }
+      return true;
+    }
+
+    void CholeskySolve(const double l[kMaxParameters][kMaxParameters], int n, const double* b, double* x) {
+      for (int i = 0; i < n; i++) {
+        double sum = b[i];
+        for (int k = 0; k < i; k++) sum -= l[i][k] * x[k];
+        x[i] = sum / l[i][i];
+      }
+      for (int i = n - 1; i >= 0; i--) {
+        double sum = x[i];
+        for (int k = i + 1; k < n; k++) sum -= l[k][i] * x[k];
+        x[i] = sum / l[i][i];
+      }
+    }
+
+    // Fixed parameters: identity row and column, zero gradient - their step is 0
+    void FixParameters(const bool* active, int n, double a[kMaxParameters][kMaxParameters], double* g) {
+      for (int i = 0; i < n; i++) {
+        if (active[i]) continue;
+        for (int j = 0; j < n; j++) {
+          a[i][j] = 0.0;
+          a[j][i] = 0.0;
+        }
+        a[i][i] = 1.0;
+        g[i] = 0.0;
+      }
+    }
+  }
+
+  // === EVALUATION ===
+
+  double Model::Evaluate(const double* position) const {
+    double s = 0.0;
+    for (int d = 0; d < dims; d++) {
+      const double u = (position[d] - center[d]) * InverseWidth(width[d]);
+      s += u * u;
+    }
+    return background + peak * Profile(shape, s);
+  }
+
+  bool HasAVX2() {
+    static const bool available = DetectAVX2();
+    return available;
+  }
+
+  const char* KernelName() {
+    return HasAVX2() ? "AVX2" : "scalar";
+  }
+
+  void EvaluateBatchScalar(const Model& model, const double* const* coords, size_t count, double* out) {
+    double inverseWidth[kMaxDims];
+    for (int d = 0; d < model.dims; d++) inverseWidth[d] = InverseWidth(model.width[d]);
+
+    for (size_t i = 0; i < count; i++) {
+      double s = 0.0;
+      for (int d = 0; d < model.dims; d++) {
+        const double u = (coords[d][i] - model.center[d]) * inverseWidth[d];
+        s += u * u;
+      }
+      out[i] = model.background + model.peak * Profile(model.shape, s);
+    }
+  }
+
+  void EvaluateBatch(const Model& model, const double* const* coords, size_t count, double* out) {
+    size_t done = 0;
+#ifdef COUPLING_MODEL_X86
+    if (HasAVX2()) {
+      done = EvaluateAVX2(model, coords, count, out);
+    }
+#endif
+    if (done < count) {
+      const double* tail[kMaxDims];
+      for (int d = 0; d < model.dims; d++) tail[d] = coords[d] + done;
+      EvaluateBatchScalar(model, tail, count - done, out + done);
+    }
+  }
+
+  // === PEAK FITTING ===
+
+  Model InitialGuess(Shape shape, int dims, const double* const* coords, const double* values, size_t count) {
+    Model model;
+    model.shape = shape;
+    model.dims = std::clamp(dims, 1, kMaxDims);
+    if (count == 0) {
+      return model;
+    }
+
+    const size_t brightest = static_cast<size_t>(std::max_element(values, values + count) - values);
+    const double minimum = *std::min_element(values, values + count);
+    model.peak = values[brightest] - minimum;
+    model.background = minimum;
+
+    // Spread of the background-subtracted signal around the brightest sample
+    for (int d = 0; d < model.dims; d++) {
+      model.center[d] = coords[d][brightest];
+      double weight = 0.0;
+      double moment = 0.0;
+      for (size_t i = 0; i < count; i++) {
+        const double w = values[i] - minimum;
+        const double offset = coords[d][i] - model.center[d];
+        weight += w;
+        moment += w * offset * offset;
+      }
+      if (weight > 0.0 && moment > 0.0) {
+        const double sigma = std::sqrt(moment / weight);
+        model.width[d] = shape == Shape::Gaussian ? 2.0 * sigma : sigma;   // Gaussian: 1/e^2 radius = 2 sigma
+      }
+    }
+    return model;
+  }
+
+  FitResult FitPeak(const Model& initial, const double* const* coords, const double* values,
+    size_t count, const FitOptions& options) {
+    FitResult result;
+    result.model = initial;
+    Model& model = result.model;
+    const int n = ParameterCount(model);
+
+    bool active[kMaxParameters];
+    int activeCount = 0;
+    for (int i = 0; i < n; i++) {
+      active[i] = !(i == 1 && !options.fitBackground) && !(i >= 2 + model.dims && !options.fitWidth);
+    }
+    for (int d = 0; d < model.dims; d++) {
+      if (model.width[d] <= 0.0) {
+        active[2 + d] = false;   // Axis without effect: nothing to fit
+        active[2 + model.dims + d] = false;
+      }
+    }
+    for (int i = 0; i < n; i++) {
+      activeCount += active[i] ? 1 : 0;
+    }
+    if (count <= static_cast<size_t>(activeCount)) {
+      return result;   // Not enough readings to pin the parameters down
+    }
+
+    std::vector<double> scratch(count);
+    double cost = Cost(model, coords, values, count, scratch);
+    double lambda = 1e-3;
+
+    double a[kMaxParameters][kMaxParameters];
+    double g[kMaxParameters];
+    double p[kMaxParameters];
+    for (result.iterations = 0; result.iterations < options.maxIterations; result.iterations++) {
+      BuildNormalEquations(model, coords, values, count, a, g);
+      FixParameters(active, n, a, g);
+      ToParameters(model, p);
+
+      bool accepted = false;
+      double trialCost = cost;
+      Model trial = model;
+      for (int attempt = 0; attempt < kMaxTrialsPerIteration && !accepted; attempt++) {
+        // Marquardt scaling: damp each parameter relative to its own curvature
+        double m[kMaxParameters][kMaxParameters];
+        for (int i = 0; i < n; i++) {
+          for (int j = 0; j < n; j++) m[i][j] = a[i][j];
+          m[i][i] += lambda * std::max(a[i][i], 1e-300);
+        }
+
+        double step[kMaxParameters];
+        if (Cholesky(m, n)) {
+          CholeskySolve(m, n, g, step);
+          double q[kMaxParameters];
+          for (int i = 0; i < n; i++) q[i] = p[i] + step[i];
+          FromParameters(q, trial);
+
+          bool valid = true;
+          for (int d = 0; d < model.dims; d++) valid &= trial.width[d] > 0.0 || model.width[d] <= 0.0;
+          if (valid) {
+            trialCost = Cost(trial, coords, values, count, scratch);
+            accepted = trialCost < cost;
+          }
+        }
+        lambda = accepted ? std::max(lambda * 0.1, 1e-12) : lambda * 10.0;
+      }
+
+      if (!accepted) {
+        // No downhill step at any damping: already at the minimum
+        result.converged = true;
+        break;
+      }
+
+      const double improvement = cost - trialCost;
+      model = trial;
+      cost = trialCost;
+      if (improvement <= options.tolerance * std::max(cost, 1e-300)) {
+        result.converged = true;
+        result.iterations++;
+        break;
+      }
+    }
+
+    result.rms = std::sqrt(cost / static_cast<double>(count));
+
+    // Covariance: residual variance times (J^T J)^-1 at the solution
+    BuildNormalEquations(model, coords, values, count, a, g);
+    FixParameters(active, n, a, g);
+    if (!Cholesky(a, n)) {
+      result.converged = false;   // Parameters not determined by the data (e.g. readings all off-peak)
+      return result;
+    }
+    const double variance = cost / static_cast<double>(count - activeCount);
+    for (int d = 0; d < model.dims; d++) {
+      double unit[kMaxParameters] = {};
+      double column[kMaxParameters];
+      unit[2 + d] = 1.0;
+      CholeskySolve(a, n, unit, column);
+      result.centerSigma[d] = std::sqrt(variance * column[2 + d]);
+    }
+    return result;
+  }
+
+  // === SAMPLED MAPS ===
+
+  SampledMap::SampledMap(double originX, double originY, double stepX, double stepY, int countX, int countY)
+    : m_originX(originX)
+    , m_originY(originY)
+    , m_stepX(stepX)
+    , m_stepY(stepY)
+    , m_countX(std::max(countX, 2))
+    , m_countY(std::max(countY, 2))
+    , m_values(static_cast<size_t>(m_countX) * m_countY, 0.0) {
+  }
+
+  void SampledMap::Fill(const Model& model) {
+    Model plane = model;
+    plane.dims = std::min(model.dims, 2);
+
+    std::vector<double> x(m_countX);
+    std::vector<double> y(m_countX);
+    for (int ix = 0; ix < m_countX; ix++) x[ix] = GetX(ix);
+    const double* coords[2] = { x.data(), y.data() };
+    for (int iy = 0; iy < m_countY; iy++) {
+      std::fill(y.begin(), y.end(), GetY(iy));
+      EvaluateBatch(plane, coords, m_countX, &At(0, iy));
+    }
+  }
+
+  double SampledMap::Sample(double x, double y) const {
+    if (m_values.empty()) {
+      return 0.0;
+    }
+    const double fx = std::clamp((x - m_originX) / m_stepX, 0.0, m_countX - 1.0);
+    const double fy = std::clamp((y - m_originY) / m_stepY, 0.0, m_countY - 1.0);
+    const int ix = std::min(static_cast<int>(fx), m_countX - 2);
+    const int iy = std::min(static_cast<int>(fy), m_countY - 2);
+    const double tx = fx - ix;
+    const double ty = fy - iy;
+
+    const double top = At(ix, iy) + tx * (At(ix + 1, iy) - At(ix, iy));
+    const double bottom = At(ix, iy + 1) + tx * (At(ix + 1, iy + 1) - At(ix, iy + 1));
+    return top + ty * (bottom - top);
+  }
+
+  void SampledMap::SampleBatch(const double* x, const double* y, size_t count, double* out) const {
+    size_t done = 0;
+#ifdef COUPLING_MODEL_X86
+    if (HasAVX2() && !m_values.empty()) {
+      done = SampleAVX2(m_values.data(), m_originX, m_originY, m_stepX, m_stepY, m_countX, m_countY,
+        x, y, count, out);
+    }
+#endif
+    for (size_t i = done; i < count; i++) {
+      out[i] = Sample(x[i], y[i]);
+    }
+  }
+}
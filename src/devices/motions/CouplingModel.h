@@ -0,0 +1,114 @@
+// CouplingModel.h - Numeric kernels for coupling peaks: batch evaluation, peak fitting, sampled maps
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * CouplingModel - Peak models of the coupled signal and the math around them
+ *
+ * Fibre-to-waveguide coupling near the optimum is a peak over two or three
+ * axes on top of a background. The alignment code uses these kernels to
+ * generate it (simulation), to fit it (locate the peak from a sparse set of
+ * readings instead of stepping onto it) and to look it up from a measured
+ * map.
+ *
+ * Coordinates are passed as one array per axis (structure of arrays), so a
+ * scan line is evaluated four points per AVX2 instruction. The vector path
+ * is chosen at run time from the CPU's feature bits; builds for other CPUs,
+ * and CPUs without AVX2/FMA, use the scalar loop. Both give the same result
+ * to rounding (the vector exp is a polynomial good to ~1e-14 relative).
+ *
+ * Usage:
+ *   CouplingModel::Model model;                      // 2D Gaussian
+ *   CouplingModel::EvaluateBatch(model, coords, n, values);
+ *
+ *   CouplingModel::Model guess = CouplingModel::InitialGuess(CouplingModel::Shape::Gaussian, 2, coords, values, n);
+ *   CouplingModel::FitResult fit = CouplingModel::FitPeak(guess, coords, values, n);
+ *   if (fit.converged) { double x = fit.model.center[0]; double sigmaX = fit.centerSigma[0]; }
+ */
+namespace CouplingModel {
+
+  constexpr int kMaxDims = 3;
+
+  enum class Shape {
+    Gaussian,    // peak * exp(-2 * sum(((x - c) / w)^2)), w = 1/e^2 radius (mode-field coupling)
+    Lorentzian   // peak / (1 + sum(((x - c) / w)^2)), w = half width at half maximum
+  };
+
+  struct Model {
+    Shape shape = Shape::Gaussian;
+    int dims = 2;
+    double peak = 1.0;
+    double background = 0.0;
+    double center[kMaxDims] = { 0.0, 0.0, 0.0 };
+    double width[kMaxDims] = { 0.005, 0.005, 0.02 };
+
+    double Evaluate(const double* position) const;   // position[dims]
+  };
+
+  // out[i] = model at (coords[0][i], ..., coords[dims - 1][i])
+  void EvaluateBatch(const Model& model, const double* const* coords, size_t count, double* out);
+  void EvaluateBatchScalar(const Model& model, const double* const* coords, size_t count, double* out);
+
+  bool HasAVX2();                 // Vector path available on this CPU
+  const char* KernelName();       // "AVX2" or "scalar", for logs
+
+  // === PEAK FITTING ===
+
+  struct FitOptions {
+    int maxIterations = 50;
+    double tolerance = 1e-10;     // Stop when the relative cost change falls below this
+    bool fitBackground = true;    // false: keep the initial background
+    bool fitWidth = true;         // false: keep the initial widths (known mode field)
+  };
+
+  struct FitResult {
+    bool converged = false;
+    Model model;
+    int iterations = 0;
+    double rms = 0.0;             // Residual RMS of the fitted model
+    double centerSigma[kMaxDims] = { 0.0, 0.0, 0.0 };   // 1-sigma uncertainty of each centre coordinate
+  };
+
+  // Levenberg-Marquardt over peak, background, centres and widths
+  FitResult FitPeak(const Model& initial, const double* const* coords, const double* values,
+    size_t count, const FitOptions& options = FitOptions());
+
+  // Starting point for FitPeak: brightest sample as centre, dimmest as background
+  Model InitialGuess(Shape shape, int dims, const double* const* coords, const double* values, size_t count);
+
+  // === SAMPLED MAPS ===
+
+  /**
+   * SampledMap - A regular 2D grid of readings with bilinear lookup
+   *
+   * Positions outside the grid are clamped to its edge.
+   */
+  class SampledMap {
+  public:
+    SampledMap() = default;
+    SampledMap(double originX, double originY, double stepX, double stepY, int countX, int countY);
+
+    void Fill(const Model& model);                    // First two dims of the model
+    double& At(int ix, int iy) { return m_values[static_cast<size_t>(iy) * m_countX + ix]; }
+    double At(int ix, int iy) const { return m_values[static_cast<size_t>(iy) * m_countX + ix]; }
+
+    double Sample(double x, double y) const;
+    void SampleBatch(const double* x, const double* y, size_t count, double* out) const;
+
+    int GetCountX() const { return m_countX; }
+    int GetCountY() const { return m_countY; }
+    double GetX(int ix) const { return m_originX + m_stepX * ix; }
+    double GetY(int iy) const { return m_originY + m_stepY * iy; }
+
+  private:
+    double m_originX = 0.0;
+    double m_originY = 0.0;
+    double m_stepX = 1.0;
+    double m_stepY = 1.0;
+    int m_countX = 0;
+    int m_countY = 0;
+    std::vector<double> m_values;
+  };
+}
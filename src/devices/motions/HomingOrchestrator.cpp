@@ -0,0 +1,358 @@
+// HomingOrchestrator.cpp
+#include "HomingOrchestrator.h"
+#include "ACSController.h"
+#include "ACSControllerManagerStandardized.h"
+#include "PIController.h"
+#include "PIControllerManagerStandardized.h"
+#include "../../utils/ThreadPolicy.h"
+
+#include <iostream>
+#include <set>
+
+HomingOrchestrator::HomingOrchestrator(ACSControllerManagerStandardized* acs, PIControllerManagerStandardized* pi)
+  : m_acs(acs), m_pi(pi) {
+}
+
+HomingOrchestrator::~HomingOrchestrator() {
+  if (m_running) {
+    Abort();
+  }
+  if (m_worker.joinable()) {
+    m_worker.join();
+  }
+}
+
+// === PLAN ===
+
+bool HomingOrchestrator::LoadPlan(const nlohmann::json& config) {
+  if (!config.contains("Phases") || !config["Phases"].is_array()) {
+    std::cout << "HomingOrchestrator: ERROR - Homing config has no Phases" << std::endl;
+    return false;
+  }
+
+  std::vector<Phase> phases;
+  bool valid = true;
+  for (const auto& phaseConfig : config["Phases"]) {
+    Phase phase;
+    phase.name = phaseConfig.value("Name", "Phase " + std::to_string(phases.size() + 1));
+
+    for (const auto& entry : phaseConfig.value("Steps", nlohmann::json::array())) {
+      const std::string type = entry.value("Type", "");
+      if (type == "ACSBuffer") {
+        valid &= AddACSBufferStep(phase, entry);
+      }
+      else if (type == "PIReference") {
+        valid &= AddPIReferenceStep(phase, entry);
+      }
+      else {
+        std::cout << "HomingOrchestrator: ERROR - Unknown step type '" << type << "' in " << phase.name << std::endl;
+        valid = false;
+      }
+    }
+
+    if (!phase.steps.empty()) {
+      phases.push_back(std::move(phase));
+    }
+  }
+
+  if (!valid) {
+    return false;
+  }
+
+  SetPlan(std::move(phases));
+  return true;
+}
+
+void HomingOrchestrator::SetPlan(std::vector<Phase> phases) {
+  if (m_running) {
+    std::cout << "HomingOrchestrator: ERROR - Cannot change the plan while homing" << std::endl;
+    return;
+  }
+  m_phases = std::move(phases);
+
+  size_t steps = 0;
+  for (const auto& phase : m_phases) {
+    steps += phase.steps.size();
+  }
+  std::cout << "HomingOrchestrator: Plan with " << m_phases.size() << " phases, " << steps << " steps" << std::endl;
+}
+
+// Devices not configured in the manager (disabled, other station) are left out of the plan
+bool HomingOrchestrator::AddACSBufferStep(Phase& phase, const nlohmann::json& entry) {
+  const std::string device = entry.value("Device", "");
+  const int buffer = entry.value("Buffer", -1);
+  const std::string label = entry.value("Label", "");
+  if (device.empty() || buffer < 0) {
+    std::cout << "HomingOrchestrator: ERROR - ACSBuffer step needs Device and Buffer in " << phase.name << std::endl;
+    return false;
+  }
+  if (!m_acs || !m_acs->HasDevice(device)) {
+    std::cout << "HomingOrchestrator: WARNING - " << device << " not configured - step skipped" << std::endl;
+    return true;
+  }
+
+  Step step;
+  step.device = device;
+  step.description = entry.value("Description", "Buffer " + std::to_string(buffer));
+  step.timeoutSeconds = entry.value("TimeoutSeconds", 120.0);
+  const int timeoutMs = static_cast<int>(step.timeoutSeconds * 1000.0);
+
+  step.run = [this, device, buffer, label, timeoutMs](std::string& message) {
+    ACSController* controller = m_acs->GetDevice(device);
+    if (!controller || !controller->IsConnected()) {
+      message = "not connected";
+      return StepState::Failed;
+    }
+    if (!controller->RunBuffer(buffer, label)) {
+      message = "buffer " + std::to_string(buffer) + " did not start";
+      return StepState::Failed;
+    }
+
+    const bool completed = controller->WaitForBufferCompletion(buffer, timeoutMs);
+    if (m_abort) {
+      message = "aborted";
+      return StepState::Failed;
+    }
+    if (!completed) {
+      message = "buffer " + std::to_string(buffer) + " failed or timed out";
+      return StepState::Failed;
+    }
+    message = "buffer " + std::to_string(buffer) + " complete";
+    return StepState::Done;
+  };
+
+  phase.steps.push_back(std::move(step));
+  return true;
+}
+
+bool HomingOrchestrator::AddPIReferenceStep(Phase& phase, const nlohmann::json& entry) {
+  const std::string device = entry.value("Device", "");
+  const bool force = entry.value("Force", false);
+  if (device.empty()) {
+    std::cout << "HomingOrchestrator: ERROR - PIReference step needs Device in " << phase.name << std::endl;
+    return false;
+  }
+  if (!m_pi || !m_pi->HasDevice(device)) {
+    std::cout << "HomingOrchestrator: WARNING - " << device << " not configured - step skipped" << std::endl;
+    return true;
+  }
+
+  Step step;
+  step.device = device;
+  step.description = entry.value("Description", "Reference (FRF)");
+  step.timeoutSeconds = entry.value("TimeoutSeconds", 120.0);
+  const double timeoutSeconds = step.timeoutSeconds;
+
+  step.run = [this, device, force, timeoutSeconds](std::string& message) {
+    PIController* controller = m_pi->GetDevice(device);
+    if (!controller || !controller->IsConnected()) {
+      message = "not connected";
+      return StepState::Failed;
+    }
+
+    bool referenced = false;
+    if (!force && controller->IsReferenced(referenced) && referenced) {
+      message = "already referenced";
+      return StepState::Skipped;
+    }
+
+    if (!controller->ReferenceAll()) {
+      message = "FRF rejected";
+      return StepState::Failed;
+    }
+    if (!controller->WaitForReferencing(timeoutSeconds, &m_abort)) {
+      message = m_abort ? "aborted" : "not referenced within " + std::to_string(static_cast<int>(timeoutSeconds)) + " s";
+      return StepState::Failed;
+    }
+    message = "referenced";
+    return StepState::Done;
+  };
+
+  phase.steps.push_back(std::move(step));
+  return true;
+}
+
+// === EXECUTION ===
+
+std::shared_future<HomingOrchestrator::Result> HomingOrchestrator::Start() {
+  if (m_running) {
+    std::cout << "HomingOrchestrator: WARNING - Homing already running" << std::endl;
+    return m_future;
+  }
+  if (m_worker.joinable()) {
+    m_worker.join();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_statusMutex);
+    m_status.clear();
+    for (size_t p = 0; p < m_phases.size(); p++) {
+      for (const auto& step : m_phases[p].steps) {
+        StepStatus status;
+        status.phase = static_cast<int>(p);
+        status.device = step.device;
+        status.description = step.description;
+        m_status.push_back(status);
+      }
+    }
+    m_startedAt.assign(m_status.size(), std::chrono::steady_clock::time_point());
+  }
+
+  m_promise = std::promise<Result>();
+  m_future = m_promise.get_future().share();
+  m_abort = false;
+  m_running = true;
+  m_worker = std::thread(&HomingOrchestrator::Execute, this);
+  return m_future;
+}
+
+void HomingOrchestrator::Abort() {
+  if (!m_running) {
+    return;
+  }
+  std::cout << "HomingOrchestrator: Aborting - stopping all devices" << std::endl;
+  m_abort = true;
+  StopDevices();
+}
+
+void HomingOrchestrator::Execute() {
+  ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::Background, "Homing");
+
+  const auto start = std::chrono::steady_clock::now();
+  bool failed = false;
+  size_t firstStep = 0;
+
+  for (size_t p = 0; p < m_phases.size() && !failed && !m_abort; p++) {
+    const Phase& phase = m_phases[p];
+    m_currentPhase = static_cast<int>(p);
+    std::cout << "HomingOrchestrator: Phase " << (p + 1) << "/" << m_phases.size() << " - " << phase.name
+      << " (" << phase.steps.size() << " devices in parallel)" << std::endl;
+
+    // One thread per step - every device in the phase references at once
+    std::vector<std::thread> threads;
+    for (size_t s = 0; s < phase.steps.size(); s++) {
+      threads.emplace_back([this, index = firstStep + s, &step = phase.steps[s]]() {
+        ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::Background, "Homing " + step.device);
+        RunStep(index, step);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_statusMutex);
+      for (size_t s = 0; s < phase.steps.size(); s++) {
+        failed |= m_status[firstStep + s].state == StepState::Failed;
+      }
+    }
+    firstStep += phase.steps.size();
+  }
+
+  Result result;
+  {
+    std::lock_guard<std::mutex> lock(m_statusMutex);
+    for (auto& status : m_status) {
+      if (status.state == StepState::Pending) {
+        status.state = StepState::Skipped;
+        status.message = m_abort ? "aborted" : "not run - earlier phase failed";
+      }
+    }
+    result.steps = m_status;
+  }
+
+  result.aborted = m_abort;
+  result.success = !failed && !m_abort;
+  result.totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "HomingOrchestrator: Homing " << (result.success ? "complete" : "FAILED") << " in "
+    << result.totalSeconds << " s" << std::endl;
+
+  m_currentPhase = -1;
+  m_running = false;
+  m_promise.set_value(result);
+}
+
+void HomingOrchestrator::RunStep(size_t statusIndex, const Step& step) {
+  if (m_abort) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_statusMutex);
+    m_startedAt[statusIndex] = std::chrono::steady_clock::now();
+  }
+  SetStatus(statusIndex, StepState::Running, "");
+
+  std::string message;
+  StepState state = StepState::Failed;
+  try {
+    state = step.run(message);
+  }
+  catch (const std::exception& e) {
+    message = e.what();
+    state = StepState::Failed;
+  }
+
+  SetStatus(statusIndex, state, message);
+  std::cout << "HomingOrchestrator: " << step.device << " - " << step.description << ": " << StateName(state)
+    << (message.empty() ? "" : " (" + message + ")") << std::endl;
+}
+
+void HomingOrchestrator::SetStatus(size_t statusIndex, StepState state, const std::string& message) {
+  std::lock_guard<std::mutex> lock(m_statusMutex);
+  StepStatus& status = m_status[statusIndex];
+  status.state = state;
+  status.message = message;
+  status.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startedAt[statusIndex]).count();
+}
+
+// Stop everything the plan touches - running homing buffers included
+void HomingOrchestrator::StopDevices() {
+  std::set<std::string> acsDevices;
+  std::set<std::string> piDevices;
+  for (const auto& phase : m_phases) {
+    for (const auto& step : phase.steps) {
+      if (m_acs && m_acs->HasDevice(step.device)) acsDevices.insert(step.device);
+      if (m_pi && m_pi->HasDevice(step.device)) piDevices.insert(step.device);
+    }
+  }
+
+  for (const auto& device : acsDevices) {
+    ACSController* controller = m_acs->GetDevice(device);
+    if (controller && controller->IsConnected()) {
+      controller->StopAllBuffers();
+      controller->StopAllAxes();
+    }
+  }
+  for (const auto& device : piDevices) {
+    PIController* controller = m_pi->GetDevice(device);
+    if (controller && controller->IsConnected()) {
+      controller->StopAllAxes();
+    }
+  }
+}
+
+// === PROGRESS ===
+
+std::vector<HomingOrchestrator::StepStatus> HomingOrchestrator::GetProgress() const {
+  std::lock_guard<std::mutex> lock(m_statusMutex);
+  std::vector<StepStatus> progress = m_status;
+  const auto now = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < progress.size(); i++) {
+    if (progress[i].state == StepState::Running) {
+      progress[i].elapsedSeconds = std::chrono::duration<double>(now - m_startedAt[i]).count();
+    }
+  }
+  return progress;
+}
+
+const char* HomingOrchestrator::StateName(StepState state) {
+  switch (state) {
+  case StepState::Pending: return "Pending";
+  case StepState::Running: return "Running";
+  case StepState::Done: return "Done";
+  case StepState::Failed: return "Failed";
+  case StepState::Skipped: return "Skipped";
+  }
+  return "Unknown";
+}
@@ -0,0 +1,118 @@
+// HomingOrchestrator.h - Machine homing in collision-safe phases, devices in parallel
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nlohmann/json.hpp"
+
+class ACSControllerManagerStandardized;
+class PIControllerManagerStandardized;
+
+/**
+ * HomingOrchestrator - References every device, concurrently where allowed
+ *
+ * The plan is a list of phases (config/homing.json). Phases run in order -
+ * that is the collision policy, e.g. gantry Z up before anything else moves.
+ * All steps of a phase run at the same time, one thread each, so the
+ * hexapods and the gantry XY reference together instead of one by one.
+ * A failed step stops the plan: later phases are skipped, since their
+ * safety assumption no longer holds.
+ *
+ * Step types:
+ *   "ACSBuffer"   - run the gantry's homing buffer and wait for its end
+ *   "PIReference" - FRF on a hexapod and wait until referenced
+ *                   (skipped when already referenced, unless "Force")
+ *
+ * Usage:
+ *   HomingOrchestrator homing(Services.ACS(), Services.PI());
+ *   homing.LoadPlan(ConfigManager::Instance().GetConfig(ConfigRegistry::Files::HOMING));
+ *   auto done = homing.Start();
+ *   ... homing.GetProgress() for the UI ...
+ *   HomingOrchestrator::Result result = done.get();
+ */
+class HomingOrchestrator {
+public:
+  enum class StepState {
+    Pending,
+    Running,
+    Done,
+    Failed,
+    Skipped
+  };
+
+  struct Step {
+    std::string device;
+    std::string description;
+    double timeoutSeconds = 120.0;
+    std::function<StepState(std::string& message)> run;   // Blocks until the device is referenced
+  };
+
+  struct Phase {
+    std::string name;
+    std::vector<Step> steps;
+  };
+
+  struct StepStatus {
+    int phase = 0;
+    std::string device;
+    std::string description;
+    StepState state = StepState::Pending;
+    double elapsedSeconds = 0.0;
+    std::string message;
+  };
+
+  struct Result {
+    bool success = false;
+    bool aborted = false;
+    double totalSeconds = 0.0;
+    std::vector<StepStatus> steps;
+  };
+
+  HomingOrchestrator(ACSControllerManagerStandardized* acs, PIControllerManagerStandardized* pi);
+  ~HomingOrchestrator();
+
+  // Plan
+  bool LoadPlan(const nlohmann::json& config);
+  void SetPlan(std::vector<Phase> phases);
+  const std::vector<Phase>& GetPlan() const { return m_phases; }
+
+  // Execution - the future completes when the last phase ends or the plan stops
+  std::shared_future<Result> Start();
+  void Abort();   // Stops every device in the plan
+  bool IsRunning() const { return m_running.load(); }
+
+  // Progress for the UI
+  std::vector<StepStatus> GetProgress() const;
+  int GetCurrentPhase() const { return m_currentPhase.load(); }
+
+  static const char* StateName(StepState state);
+
+private:
+  void Execute();
+  void RunStep(size_t statusIndex, const Step& step);
+  void SetStatus(size_t statusIndex, StepState state, const std::string& message);
+
+  bool AddACSBufferStep(Phase& phase, const nlohmann::json& entry);
+  bool AddPIReferenceStep(Phase& phase, const nlohmann::json& entry);
+  void StopDevices();
+
+  ACSControllerManagerStandardized* m_acs;
+  PIControllerManagerStandardized* m_pi;
+  std::vector<Phase> m_phases;
+
+  std::thread m_worker;
+  std::promise<Result> m_promise;
+  std::shared_future<Result> m_future;
+  std::atomic<bool> m_running{ false };
+  std::atomic<bool> m_abort{ false };
+  std::atomic<int> m_currentPhase{ -1 };
+
+  mutable std::mutex m_statusMutex;
+  std::vector<StepStatus> m_status;
+  std::vector<std::chrono::steady_clock::time_point> m_startedAt;
+};
@@ -0,0 +1,163 @@
+// MotionCell.cpp
+#include "MotionCell.h"
+#include "ACSControllerManagerStandardized.h"
+#include "PIControllerManagerStandardized.h"
+#include "../../core/ConfigRegistry.h"
+#include "../../core/ServiceLocator.h"
+#include "../../utils/IOExecutor.h"
+#include "../../utils/ThreadPolicy.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+MotionCell::MotionCell(ConfigManager& configManager)
+  : MotionCell(configManager, Settings{}) {
+}
+
+MotionCell::MotionCell(ConfigManager& configManager, const Settings& settings)
+  : m_configManager(configManager), m_settings(settings) {
+}
+
+MotionCell::~MotionCell() {
+  // Managers disconnect in their destructors; the executor goes last
+  m_stations.clear();
+}
+
+bool MotionCell::Initialize() {
+  if (m_isInitialized) {
+    return true;
+  }
+
+  std::vector<std::string> stationNames = Config::Motion::GetStationNames();
+  if (stationNames.empty()) {
+    stationNames.push_back("");
+  }
+  else {
+    for (const auto& device : Config::Motion::GetAllDevices()) {
+      if (device.station.empty()) {
+        std::cout << "MotionCell: WARNING - " << device.name
+          << " has no Station and is not managed by the cell" << std::endl;
+      }
+    }
+  }
+
+  const int threads = m_settings.ioThreads > 0
+    ? m_settings.ioThreads
+    : std::max(2, static_cast<int>(stationNames.size()));
+  if (m_settings.ioThreads >= 0) {
+    m_executor = std::make_unique<IOExecutor>("Motion IO", threads);
+  }
+
+  bool allSuccess = true;
+  for (const auto& name : stationNames) {
+    Station station;
+    station.pi = std::make_unique<PIControllerManagerStandardized>(m_configManager, m_settings.hardwareMode, name);
+    station.pi->SetIOExecutor(m_executor.get());
+    station.acs = std::make_unique<ACSControllerManagerStandardized>(m_configManager, name);
+    station.acs->SetIOExecutor(m_executor.get());
+
+    if (!station.pi->Initialize() || !station.acs->Initialize()) {
+      std::cout << "MotionCell: Station " << name << " failed to initialize" << std::endl;
+      allSuccess = false;
+    }
+    m_stations[name] = std::move(station);
+  }
+
+  m_isInitialized = true;
+  std::cout << "MotionCell: Initialized " << m_stations.size() << " stations, "
+    << (m_executor ? std::to_string(threads) + " shared I/O threads" : "one thread per controller") << std::endl;
+  return allSuccess;
+}
+
+bool MotionCell::ConnectAll() {
+  if (!m_isInitialized) {
+    std::cout << "MotionCell: Cannot connect - not initialized" << std::endl;
+    return false;
+  }
+
+  // One thread per station: connect time is the slowest station, not the sum
+  std::vector<std::thread> workers;
+  std::vector<char> results(m_stations.size(), 0);
+  size_t index = 0;
+  for (auto& [name, station] : m_stations) {
+    workers.emplace_back([&station, &results, index, stationName = name]() {
+      ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::Background, "Connect " + stationName);
+      const bool piConnected = station.pi->ConnectAll();
+      const bool acsConnected = station.acs->ConnectAll();
+      results[index] = (piConnected && acsConnected) ? 1 : 0;
+    });
+    index++;
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  bool allSuccess = true;
+  index = 0;
+  for (const auto& [name, station] : m_stations) {
+    if (!results[index++]) {
+      std::cout << "MotionCell: Station " << name << " did not connect completely" << std::endl;
+      allSuccess = false;
+    }
+  }
+  return allSuccess;
+}
+
+bool MotionCell::DisconnectAll() {
+  bool allSuccess = true;
+  for (auto& [name, station] : m_stations) {
+    if (!station.pi->DisconnectAll()) {
+      allSuccess = false;
+    }
+    if (!station.acs->DisconnectAll()) {
+      allSuccess = false;
+    }
+  }
+  return allSuccess;
+}
+
+void MotionCell::RegisterServices() {
+  for (auto& [name, station] : m_stations) {
+    if (name.empty()) {
+      ServiceLocator::Get().RegisterPI(station.pi.get());
+      ServiceLocator::Get().RegisterACS(station.acs.get());
+    }
+    else {
+      ServiceLocator::Get().RegisterStation(name, station.pi.get(), station.acs.get());
+    }
+  }
+}
+
+std::vector<std::string> MotionCell::GetStationNames() const {
+  std::vector<std::string> names;
+  for (const auto& [name, station] : m_stations) {
+    names.push_back(name);
+  }
+  return names;
+}
+
+PIControllerManagerStandardized* MotionCell::PI(const std::string& station) const {
+  auto it = m_stations.find(station);
+  return (it != m_stations.end()) ? it->second.pi.get() : nullptr;
+}
+
+ACSControllerManagerStandardized* MotionCell::ACS(const std::string& station) const {
+  auto it = m_stations.find(station);
+  return (it != m_stations.end()) ? it->second.acs.get() : nullptr;
+}
+
+void MotionCell::PrintStatus() const {
+  std::cout << "=== Motion Cell: " << m_stations.size() << " stations ===" << std::endl;
+  for (const auto& [name, station] : m_stations) {
+    std::cout << "--- Station " << (name.empty() ? "(default)" : name) << " ---" << std::endl;
+    station.pi->PrintDeviceStatus();
+    station.acs->PrintDeviceStatus();
+  }
+  if (m_executor) {
+    IOExecutor::Stats stats = m_executor->GetStats();
+    std::cout << "I/O executor: " << m_executor->GetThreadCount() << " threads, "
+      << m_executor->GetTaskCount() << " tasks, " << stats.runs << " runs, worst start delay "
+      << stats.maxLatenessMs << " ms" << std::endl;
+  }
+}
@@ -0,0 +1,72 @@
+// MotionCell.h - Per-station motion managers sharing one I/O executor
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ACSControllerManagerStandardized;
+class ConfigManager;
+class IOExecutor;
+class PIControllerManagerStandardized;
+
+/**
+ * MotionCell - Motion managers for a cell with several stations
+ *
+ * Devices in motion_config_devices.json may carry a "Station" name. The cell
+ * builds one PI and one ACS manager per station, so every station has its
+ * own device table and lock, and one station's connect or recovery never
+ * waits on another's. All controllers poll on one shared IOExecutor
+ * instead of one thread each.
+ *
+ * A config without any "Station" gives a single station "" holding every
+ * device - the same set the plain managers load - registered as the
+ * default Services.PI() / Services.ACS().
+ *
+ * Usage:
+ *   MotionCell cell(configManager);
+ *   cell.Initialize();
+ *   cell.ConnectAll();          // Stations connect in parallel
+ *   cell.RegisterServices();    // Services.Station("station-1")->PI()
+ *   PIController* hex = cell.PI("station-1")->GetDevice("hex-left");
+ */
+class MotionCell {
+public:
+  struct Settings {
+    int ioThreads = 0;           // 0 = one per station, at least 2; -1 = a thread per controller
+    bool hardwareMode = true;
+  };
+
+  explicit MotionCell(ConfigManager& configManager);
+  MotionCell(ConfigManager& configManager, const Settings& settings);
+  ~MotionCell();
+
+  MotionCell(const MotionCell&) = delete;
+  MotionCell& operator=(const MotionCell&) = delete;
+
+  bool Initialize();
+  bool ConnectAll();
+  bool DisconnectAll();
+  void RegisterServices();
+
+  std::vector<std::string> GetStationNames() const;
+  PIControllerManagerStandardized* PI(const std::string& station) const;
+  ACSControllerManagerStandardized* ACS(const std::string& station) const;
+  IOExecutor* GetExecutor() const { return m_executor.get(); }
+
+  void PrintStatus() const;
+
+private:
+  struct Station {
+    std::unique_ptr<PIControllerManagerStandardized> pi;
+    std::unique_ptr<ACSControllerManagerStandardized> acs;
+  };
+
+  ConfigManager& m_configManager;
+  Settings m_settings;
+
+  // Declared before the stations so it outlives every controller polling on it
+  std::unique_ptr<IOExecutor> m_executor;
+  std::map<std::string, Station> m_stations;
+  bool m_isInitialized = false;
+};
@@ -0,0 +1,313 @@
+// MotionTransaction.cpp
+#include "MotionTransaction.h"
+#include "ACSController.h"
+#include "PIController.h"
+#include "../../utils/ThreadPolicy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <latch>
+#include <thread>
+
+namespace {
+  // Strands busy-wait only this long before the release instant
+  constexpr auto kReleaseSpin = std::chrono::milliseconds(1);
+}
+
+MotionTransaction::MotionTransaction()
+  : MotionTransaction(Settings{}) {
+}
+
+MotionTransaction::MotionTransaction(const Settings& settings)
+  : m_settings(settings) {
+}
+
+MotionTransaction::~MotionTransaction() {
+  if (m_prepared && !m_committed) {
+    Abort();
+  }
+}
+
+MotionTransaction& MotionTransaction::Add(const std::string& name, PIController* hexapod,
+  const std::vector<std::string>& axes, const std::vector<double>& positions) {
+  if (!hexapod || axes.empty() || axes.size() != positions.size()) {
+    m_addError = name + ": invalid device or axes/positions";
+  }
+  else if (m_prepared) {
+    m_addError = name + ": added after Prepare";
+  }
+  else if (std::any_of(m_entries.begin(), m_entries.end(),
+    [hexapod](const Entry& entry) { return entry.hexapod == hexapod; })) {
+    m_addError = name + ": device added twice";
+  }
+  else {
+    Entry entry;
+    entry.name = name;
+    entry.hexapod = hexapod;
+    entry.axes = axes;
+    entry.positions = positions;
+    m_entries.push_back(std::move(entry));
+  }
+  return *this;
+}
+
+MotionTransaction& MotionTransaction::Add(const std::string& name, ACSController* gantry,
+  const std::vector<std::string>& axes, const std::vector<double>& positions) {
+  if (!gantry || axes.empty() || axes.size() != positions.size()) {
+    m_addError = name + ": invalid device or axes/positions";
+  }
+  else if (m_prepared) {
+    m_addError = name + ": added after Prepare";
+  }
+  else if (std::any_of(m_entries.begin(), m_entries.end(),
+    [gantry](const Entry& entry) { return entry.gantry == gantry; })) {
+    m_addError = name + ": device added twice";
+  }
+  else {
+    Entry entry;
+    entry.name = name;
+    entry.gantry = gantry;
+    entry.axes = axes;
+    entry.positions = positions;
+    m_entries.push_back(std::move(entry));
+  }
+  return *this;
+}
+
+// === PREPARE ===
+
+bool MotionTransaction::Prepare(std::string& error) {
+  if (m_prepared) {
+    return true;
+  }
+  if (!m_addError.empty()) {
+    error = m_addError;
+    return false;
+  }
+  if (m_entries.empty()) {
+    error = "no devices";
+    return false;
+  }
+
+  // Hexapods first - validating sends nothing, so a failure there needs no cancel
+  std::string reason;
+  for (const auto& entry : m_entries) {
+    if (entry.hexapod && !entry.hexapod->ValidateMove(entry.axes, entry.positions, reason)) {
+      error = entry.name + ": " + reason;
+      std::cout << "MotionTransaction: Rejected - " << error << std::endl;
+      return false;
+    }
+  }
+
+  for (auto& entry : m_entries) {
+    if (!entry.gantry) {
+      continue;
+    }
+    if (!entry.gantry->ArmMove(entry.axes, entry.positions, reason)) {
+      error = entry.name + ": " + reason;
+      std::cout << "MotionTransaction: Rejected - " << error << std::endl;
+      Abort();
+      return false;
+    }
+    entry.armed = true;
+  }
+
+  m_prepared = true;
+  std::cout << "MotionTransaction: Prepared " << m_entries.size() << " devices" << std::endl;
+  return true;
+}
+
+void MotionTransaction::Abort() {
+  if (m_committed) {
+    return;
+  }
+  for (auto& entry : m_entries) {
+    if (entry.armed) {
+      entry.gantry->CancelArmedMove(entry.axes);
+      entry.armed = false;
+    }
+  }
+  m_prepared = false;
+}
+
+// === COMMIT ===
+
+bool MotionTransaction::Start(Entry& entry) {
+  if (entry.hexapod) {
+    return entry.hexapod->StartValidatedMove(entry.axes, entry.positions);
+  }
+  const bool started = entry.gantry->StartArmedMove(entry.axes);
+  entry.armed = !started;
+  return started;
+}
+
+void MotionTransaction::Halt(Entry& entry) {
+  if (entry.hexapod) {
+    entry.hexapod->StopAllAxes();
+  }
+  else {
+    // Stops a started move and drops one that is still held
+    entry.gantry->CancelArmedMove(entry.axes);
+    entry.armed = false;
+  }
+}
+
+MotionTransaction::Result MotionTransaction::Commit() {
+  Result result;
+  if (m_committed) {
+    result.error = "already committed";
+    return result;
+  }
+  if (!m_prepared && !Prepare(result.error)) {
+    return result;
+  }
+  m_committed = true;
+
+  struct Timing {
+    std::chrono::steady_clock::time_point sent;
+    std::chrono::steady_clock::time_point replied;
+    bool started = false;
+  };
+  const size_t count = m_entries.size();
+  std::vector<Timing> timings(count);
+  std::latch parked(static_cast<std::ptrdiff_t>(count));
+  std::atomic<int64_t> releaseAt{ 0 };   // steady_clock ticks, 0 until every strand is parked
+
+  std::vector<std::thread> strands;
+  strands.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    strands.emplace_back([this, i, &timings, &parked, &releaseAt]() {
+      // Not MotionIO: FIFO strands pinned to the comm CPUs would queue behind
+      // each other and starve the controller comm threads while they spin
+      ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::Background, "Move strand " + m_entries[i].name);
+      parked.count_down();
+
+      releaseAt.wait(0, std::memory_order_acquire);
+      const std::chrono::steady_clock::time_point release{
+        std::chrono::steady_clock::duration(releaseAt.load(std::memory_order_acquire)) };
+
+      // Sleep most of the lead, spin only the last stretch - waking from a
+      // sleep is too coarse to line the strands up
+      std::this_thread::sleep_until(release - kReleaseSpin);
+      while (std::chrono::steady_clock::now() < release) {
+      }
+
+      timings[i].sent = std::chrono::steady_clock::now();
+      timings[i].started = Start(m_entries[i]);
+      timings[i].replied = std::chrono::steady_clock::now();
+    });
+  }
+
+  parked.wait();
+  const auto releaseTime = std::chrono::steady_clock::now() +
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(m_settings.releaseLead);
+  releaseAt.store(releaseTime.time_since_epoch().count(), std::memory_order_release);
+  releaseAt.notify_all();
+
+  for (auto& strand : strands) {
+    strand.join();
+  }
+
+  // === REPORT ===
+  auto firstSent = timings[0].sent;
+  auto lastSent = timings[0].sent;
+  auto firstReply = timings[0].replied;
+  auto lastReply = timings[0].replied;
+  for (const auto& timing : timings) {
+    firstSent = std::min(firstSent, timing.sent);
+    lastSent = std::max(lastSent, timing.sent);
+    firstReply = std::min(firstReply, timing.replied);
+    lastReply = std::max(lastReply, timing.replied);
+  }
+  auto microseconds = [](std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  };
+
+  result.started = true;
+  result.sendSpreadUs = microseconds(lastSent - firstSent);
+  result.replySpreadUs = microseconds(lastReply - firstReply);
+  for (size_t i = 0; i < count; i++) {
+    DeviceResult device;
+    device.device = m_entries[i].name;
+    device.started = timings[i].started;
+    device.sendOffsetUs = microseconds(timings[i].sent - firstSent);
+    device.replyOffsetUs = microseconds(timings[i].replied - firstSent);
+    if (!device.started) {
+      device.error = "start rejected";
+      result.started = false;
+    }
+    result.devices.push_back(device);
+  }
+
+  // Not all-or-nothing any more - stop whatever did start
+  if (!result.started) {
+    for (auto& entry : m_entries) {
+      Halt(entry);
+    }
+    result.rolledBack = true;
+    result.error = "start rejected by at least one device - all devices halted";
+    std::cout << "MotionTransaction: " << result.error << std::endl;
+  }
+  return result;
+}
+
+// === COMPLETION ===
+
+bool MotionTransaction::WaitForCompletion(double timeoutSeconds) {
+  if (!m_committed) {
+    return false;
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() +
+    std::chrono::milliseconds(static_cast<int>(timeoutSeconds * 1000.0));
+  auto remainingSeconds = [&deadline]() {
+    return std::max(0.0, std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count());
+  };
+
+  bool allDone = true;
+  for (auto& entry : m_entries) {
+    for (size_t i = 0; i < entry.axes.size(); i++) {
+      const std::string& axis = entry.axes[i];
+      if (entry.hexapod) {
+        // Settle tracking was armed by StartValidatedMove
+        if (!entry.hexapod->WaitForMotionCompletion(axis, remainingSeconds())) {
+          allDone = false;
+        }
+        continue;
+      }
+
+      // The gantry's cached moving flag can predate the GoM - also require the target
+      bool done = false;
+      while (!done && remainingSeconds() > 0.0) {
+        double position = 0.0;
+        done = !entry.gantry->IsMoving(axis) && entry.gantry->GetPosition(axis, position) &&
+          std::abs(position - entry.positions[i]) <= m_settings.acsTolerance;
+        if (!done) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+      }
+      allDone &= done;
+    }
+  }
+
+  if (!allDone) {
+    std::cout << "MotionTransaction: Timeout waiting for motion completion" << std::endl;
+  }
+  return allDone;
+}
+
+void MotionTransaction::PrintResult(const Result& result, std::ostream& out) {
+  out << "MotionTransaction: " << (result.started ? "started" : "FAILED") << " " << result.devices.size()
+    << " devices - send spread " << std::fixed << std::setprecision(1) << result.sendSpreadUs
+    << " us, reply spread " << result.replySpreadUs << " us" << std::endl;
+  for (const auto& device : result.devices) {
+    out << "  " << device.device << ": sent +" << device.sendOffsetUs << " us, replied +"
+      << device.replyOffsetUs << " us" << (device.started ? "" : " - " + device.error) << std::endl;
+  }
+  if (!result.error.empty()) {
+    out << "  " << result.error << std::endl;
+  }
+}
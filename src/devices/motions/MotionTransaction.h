@@ -0,0 +1,104 @@
+// MotionTransaction.h - Validated, simultaneous move start across several controllers
+#pragma once
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class ACSController;
+class PIController;
+
+/**
+ * MotionTransaction - Start moves on several devices at the same moment
+ *
+ * MoveToPositionMultiAxis starts all axes of one controller together, but
+ * two controllers started one after the other are a round trip or more
+ * apart - long enough for hex-left and hex-right to close on a fiber
+ * unevenly. A transaction runs in two phases:
+ *
+ *   Prepare - every device is checked before anything moves: connected,
+ *             servo on, and for hexapods referenced and reachable (PI_qVMO).
+ *             Gantry targets are already sent, held back (ACSC_AMF_WAIT).
+ *             Any failure cancels what was armed and nothing moves.
+ *   Commit  - one strand (thread) per device is parked in front of its
+ *             start call; all are released at the same instant, so only the
+ *             start calls themselves (PI_MOV / acsc_GoM) run in parallel.
+ *             If any start fails, the devices that did start are halted.
+ *
+ * The result reports the spread of the send times and of the replies, the
+ * latter being the best bound on when the controllers actually started.
+ * While a transaction is open its devices belong to it: another sequence
+ * moving the same axes would start the armed gantry targets early.
+ *
+ * Usage:
+ *   MotionTransaction move;
+ *   move.Add("hex-left", left, { "X", "Y" }, { 1.20, 0.35 })
+ *       .Add("hex-right", right, { "X", "Y" }, { -1.20, 0.35 });
+ *   MotionTransaction::Result result = move.Commit();
+ *   if (result.started) move.WaitForCompletion();
+ *   MotionTransaction::PrintResult(result, std::cout);
+ */
+class MotionTransaction {
+public:
+  struct Settings {
+    std::chrono::microseconds releaseLead{ 2000 };   // Strands are released this long after all are parked (sleep, then spin the last 1 ms)
+    double acsTolerance = 0.01;                       // Gantry completion window around the target (mm)
+  };
+
+  struct DeviceResult {
+    std::string device;
+    bool started = false;
+    std::string error;
+    double sendOffsetUs = 0.0;    // Start call sent, relative to the earliest send
+    double replyOffsetUs = 0.0;   // Start call returned, relative to the earliest send
+  };
+
+  struct Result {
+    bool started = false;         // Every device accepted its start
+    bool rolledBack = false;      // A start failed and the started devices were halted
+    std::string error;
+    double sendSpreadUs = 0.0;    // Latest minus earliest send
+    double replySpreadUs = 0.0;   // Latest minus earliest reply
+    std::vector<DeviceResult> devices;
+  };
+
+  MotionTransaction();
+  explicit MotionTransaction(const Settings& settings);
+  ~MotionTransaction();   // Cancels armed moves that were never committed
+
+  MotionTransaction(const MotionTransaction&) = delete;
+  MotionTransaction& operator=(const MotionTransaction&) = delete;
+
+  // Absolute targets; one entry per device
+  MotionTransaction& Add(const std::string& name, PIController* hexapod,
+    const std::vector<std::string>& axes, const std::vector<double>& positions);
+  MotionTransaction& Add(const std::string& name, ACSController* gantry,
+    const std::vector<std::string>& axes, const std::vector<double>& positions);
+
+  bool Prepare(std::string& error);
+  Result Commit();                  // Prepares first if needed
+  void Abort();                     // Cancel armed moves; only before Commit
+  bool WaitForCompletion(double timeoutSeconds = 30.0);
+
+  bool IsPrepared() const { return m_prepared; }
+  static void PrintResult(const Result& result, std::ostream& out);
+
+private:
+  struct Entry {
+    std::string name;
+    PIController* hexapod = nullptr;
+    ACSController* gantry = nullptr;
+    std::vector<std::string> axes;
+    std::vector<double> positions;
+    bool armed = false;           // Gantry targets sent and held
+  };
+
+  bool Start(Entry& entry);
+  void Halt(Entry& entry);
+
+  Settings m_settings;
+  std::vector<Entry> m_entries;
+  std::string m_addError;         // Bad Add() call, reported by Prepare
+  bool m_prepared = false;
+  bool m_committed = false;
+};
@@ -69,4 +69,7 @@ struct Settings {
     bool AutoReconnect = true;
     int ConnectionTimeout = 5000;
     double PositionTolerance = 0.001;
+    std::string SettleMode = "OnTarget";  // "OnTarget" or "MotionDone"
+    int SettleDwellMs = 20;
+    int SettleStoppedTimeoutMs = 1000;
 };
\ No newline at end of file
@@ -0,0 +1,412 @@
+// PIAdaptiveScan.cpp
+#include "PIAdaptiveScan.h"
+#include "PIController.h"
+#include "PISimulatedFastAlignment.h"
+#include "../../utils/ThreadPolicy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+	constexpr int kMaxDepth = 12;
+	// Readings above half maximum before a fit may end the scan - fewer do not pin down a width
+	constexpr int kMinResolvedSamples = 5;
+
+	// Moves and reads through the hexapod controller
+	class ControllerBackend : public PIAdaptiveScan::Backend {
+	public:
+		ControllerBackend(PIController& controller, int analogInput)
+			: m_controller(controller), m_analogInput(analogInput) {
+		}
+
+		bool GetPosition(const std::string& axis, double& position) override {
+			return m_controller.GetPosition(axis, position);
+		}
+
+		bool MoveTo(const std::string& scanAxis, double scan, const std::string& stepAxis, double step) override {
+			return m_controller.MoveToPositionMultiAxis({ scanAxis, stepAxis }, { scan, step }, true);
+		}
+
+		bool ReadSignal(double& value) override {
+			return m_controller.GetAnalogVoltage(m_analogInput, value);
+		}
+
+	private:
+		PIController& m_controller;
+		int m_analogInput;
+	};
+
+	// Moves the simulated platform and reads its coupling field
+	class SimulationBackend : public PIAdaptiveScan::Backend {
+	public:
+		explicit SimulationBackend(PISimulatedFastAlignment& simulation) : m_simulation(simulation) {
+		}
+
+		bool GetPosition(const std::string& axis, double& position) override {
+			position = m_simulation.GetPosition(axis);
+			return true;
+		}
+
+		bool MoveTo(const std::string& scanAxis, double scan, const std::string& stepAxis, double step) override {
+			m_simulation.SetPosition(scanAxis, scan);
+			m_simulation.SetPosition(stepAxis, step);
+			return true;
+		}
+
+		bool ReadSignal(double& value) override {
+			value = m_simulation.ReadInput();
+			return true;
+		}
+
+	private:
+		PISimulatedFastAlignment& m_simulation;
+	};
+}
+
+PIAdaptiveScan::PIAdaptiveScan(PIController& controller, int analogInput)
+	: m_backend(std::make_unique<ControllerBackend>(controller, analogInput)) {
+}
+
+PIAdaptiveScan::PIAdaptiveScan(PISimulatedFastAlignment& simulation)
+	: m_backend(std::make_unique<SimulationBackend>(simulation)) {
+}
+
+PIAdaptiveScan::PIAdaptiveScan(std::unique_ptr<Backend> backend)
+	: m_backend(std::move(backend)) {
+}
+
+PIAdaptiveScan::~PIAdaptiveScan() {
+	Cancel();
+}
+
+// === RUN ===
+
+PIAdaptiveScan::Result PIAdaptiveScan::Run(const Settings& settings) {
+	if (m_running) {
+		std::cout << "PIAdaptiveScan: Scan already running" << std::endl;
+		return GetResult();
+	}
+	if (m_background.joinable()) {
+		m_background.join();
+	}
+
+	if (settings.scanAxis == settings.stepAxis || settings.scanRange <= 0.0 || settings.stepRange <= 0.0 ||
+		settings.coarsePoints < 2) {
+		std::cout << "PIAdaptiveScan: Invalid scan settings" << std::endl;
+		return Result();
+	}
+
+	double scanCenter = 0.0;
+	double stepCenter = 0.0;
+	if (!m_backend->GetPosition(settings.scanAxis, scanCenter) || !m_backend->GetPosition(settings.stepAxis, stepCenter)) {
+		std::cout << "PIAdaptiveScan: Cannot read start position" << std::endl;
+		return Result();
+	}
+
+	m_settings = settings;
+	m_settings.maxDepth = std::clamp(settings.maxDepth, 0, kMaxDepth);
+	m_cancel = false;
+	m_exhausted = false;
+	m_startTime = std::chrono::steady_clock::now();
+	m_readings.clear();
+	m_samples.clear();
+	m_cells.clear();
+
+	// Lattice in units of the finest step; coarse points are `unit` apart
+	const int64_t unit = int64_t(1) << m_settings.maxDepth;
+	const int64_t extent = (m_settings.coarsePoints - 1) * unit;
+	m_finestScan = m_settings.scanRange / static_cast<double>(extent);
+	m_finestStep = m_settings.stepRange / static_cast<double>(extent);
+	m_scanOrigin = scanCenter - m_settings.scanRange / 2.0;
+	m_stepOrigin = stepCenter - m_settings.stepRange / 2.0;
+
+	{
+		std::lock_guard<std::mutex> lock(m_resultMutex);
+		m_result = Result();
+		m_result.denseSamples = static_cast<int>((extent + 1) * (extent + 1));
+	}
+
+	std::cout << "PIAdaptiveScan: Scanning " << m_settings.scanAxis << " " << m_settings.scanRange << " x "
+		<< m_settings.stepAxis << " " << m_settings.stepRange << ", coarse " << m_settings.coarsePoints << "x"
+		<< m_settings.coarsePoints << ", depth " << m_settings.maxDepth << std::endl;
+
+	// Coarse pass
+	std::vector<std::pair<int64_t, int64_t>> points;
+	for (int j = 0; j < m_settings.coarsePoints; j++) {
+		for (int i = 0; i < m_settings.coarsePoints; i++) {
+			points.emplace_back(i * unit, j * unit);
+		}
+	}
+	for (int j = 0; j + 1 < m_settings.coarsePoints; j++) {
+		for (int i = 0; i + 1 < m_settings.coarsePoints; i++) {
+			m_cells.push_back({ i * unit, j * unit, unit, 0 });
+		}
+	}
+	if (!MeasureAll(points)) {
+		std::cout << "PIAdaptiveScan: Coarse pass failed" << std::endl;
+		return GetResult();
+	}
+	Fit();
+
+	while (!m_cancel && !GetResult().confident && RefinePass()) {
+		Fit();
+	}
+
+	const Result early = GetResult();
+	if (early.confident && m_settings.continueInBackground && !m_cells.empty() && !m_cancel) {
+		std::cout << "PIAdaptiveScan: Confident after " << early.samples << " samples - refining in background" << std::endl;
+		m_running = true;
+		m_background = std::thread(&PIAdaptiveScan::BackgroundLoop, this);
+		return early;
+	}
+
+	Finish();
+	return GetResult();
+}
+
+void PIAdaptiveScan::BackgroundLoop() {
+	ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::Background, "Adaptive scan");
+	while (!m_cancel && RefinePass()) {
+		Fit();
+	}
+	Finish();
+	m_running = false;
+}
+
+PIAdaptiveScan::Result PIAdaptiveScan::GetResult() const {
+	std::lock_guard<std::mutex> lock(m_resultMutex);
+	return m_result;
+}
+
+bool PIAdaptiveScan::Wait(std::chrono::milliseconds timeout) {
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (m_running && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	if (m_running) {
+		return false;
+	}
+	if (m_background.joinable()) {
+		m_background.join();
+	}
+	return true;
+}
+
+void PIAdaptiveScan::Cancel() {
+	m_cancel = true;
+	if (m_background.joinable()) {
+		m_background.join();
+	}
+}
+
+// === MEASUREMENT ===
+
+bool PIAdaptiveScan::Measure(int64_t x, int64_t y, double& value) {
+	const uint64_t key = Key(x, y);
+	auto it = m_readings.find(key);
+	if (it != m_readings.end()) {
+		value = it->second;
+		return true;
+	}
+
+	const double scan = ScanAt(x);
+	const double step = StepAt(y);
+	if (!m_backend->MoveTo(m_settings.scanAxis, scan, m_settings.stepAxis, step) || !m_backend->ReadSignal(value)) {
+		return false;
+	}
+	m_readings[key] = value;
+	m_samples.push_back({ scan, step, value });
+	return true;
+}
+
+// Serpentine order: rows along the scan axis, alternating direction, so no move crosses the area
+bool PIAdaptiveScan::MeasureAll(std::vector<std::pair<int64_t, int64_t>>& points) {
+	std::sort(points.begin(), points.end(), [](const auto& a, const auto& b) {
+		return a.second != b.second ? a.second < b.second : a.first < b.first;
+	});
+	points.erase(std::unique(points.begin(), points.end()), points.end());
+
+	bool reverse = false;
+	for (auto row = points.begin(); row != points.end();) {
+		auto rowEnd = std::find_if(row, points.end(), [&row](const auto& p) { return p.second != row->second; });
+		if (reverse) {
+			std::reverse(row, rowEnd);
+		}
+		reverse = !reverse;
+		row = rowEnd;
+	}
+
+	for (const auto& point : points) {
+		double value = 0.0;
+		if (m_cancel || !Measure(point.first, point.second, value)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// === REFINEMENT ===
+
+bool PIAdaptiveScan::RefinePass() {
+	if (m_cells.empty() || m_samples.empty()) {
+		m_exhausted = true;
+		return false;
+	}
+
+	double background = m_samples[0].value;
+	double brightest = m_samples[0].value;
+	for (const auto& sample : m_samples) {
+		background = std::min(background, sample.value);
+		brightest = std::max(brightest, sample.value);
+	}
+	const double cutoff = std::max(m_settings.threshold,
+		background + m_settings.refineFraction * (brightest - background));
+
+	// Highest value a cell may hide: its brightest corner plus half the rise across it
+	struct Candidate {
+		Cell cell;
+		double potential;
+	};
+	std::vector<Candidate> candidates;
+	for (const Cell& cell : m_cells) {
+		if (cell.depth >= m_settings.maxDepth) {
+			continue;
+		}
+		const double v00 = m_readings[Key(cell.x, cell.y)];
+		const double v10 = m_readings[Key(cell.x + cell.size, cell.y)];
+		const double v01 = m_readings[Key(cell.x, cell.y + cell.size)];
+		const double v11 = m_readings[Key(cell.x + cell.size, cell.y + cell.size)];
+		const double gradientScan = 0.5 * ((v10 + v11) - (v00 + v01));
+		const double gradientStep = 0.5 * ((v01 + v11) - (v00 + v10));
+		const double potential = std::max({ v00, v10, v01, v11 }) +
+			0.5 * std::sqrt(gradientScan * gradientScan + gradientStep * gradientStep);
+		if (potential >= cutoff) {
+			candidates.push_back({ cell, potential });
+		}
+	}
+
+	// Most promising first, within the sample budget (a subdivision takes up to 5 readings)
+	std::sort(candidates.begin(), candidates.end(),
+		[](const Candidate& a, const Candidate& b) { return a.potential > b.potential; });
+	const int budget = m_settings.maxSamples - static_cast<int>(m_samples.size());
+	const size_t affordable = budget > 0 ? static_cast<size_t>(budget / 5) : 0;
+	if (candidates.size() > affordable) {
+		candidates.resize(affordable);
+	}
+	if (candidates.empty()) {
+		m_cells.clear();
+		m_exhausted = true;
+		return false;
+	}
+
+	std::vector<Cell> children;
+	std::vector<std::pair<int64_t, int64_t>> points;
+	for (const Candidate& candidate : candidates) {
+		const Cell& cell = candidate.cell;
+		const int64_t half = cell.size / 2;
+		points.emplace_back(cell.x + half, cell.y);
+		points.emplace_back(cell.x, cell.y + half);
+		points.emplace_back(cell.x + half, cell.y + half);
+		points.emplace_back(cell.x + cell.size, cell.y + half);
+		points.emplace_back(cell.x + half, cell.y + cell.size);
+		for (int k = 0; k < 4; k++) {
+			children.push_back({ cell.x + (k % 2) * half, cell.y + (k / 2) * half, half, cell.depth + 1 });
+		}
+	}
+	// Cells not subdivided are dark or at full depth - they drop out for good
+	m_cells = std::move(children);
+
+	if (!MeasureAll(points)) {
+		m_cells.clear();
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_resultMutex);
+	m_result.depth = std::max(m_result.depth, m_cells.front().depth);
+	return true;
+}
+
+// === PEAK ESTIMATE ===
+
+void PIAdaptiveScan::Fit() {
+	const size_t count = m_samples.size();
+	std::vector<double> scan(count);
+	std::vector<double> step(count);
+	std::vector<double> values(count);
+	size_t brightest = 0;
+	for (size_t i = 0; i < count; i++) {
+		scan[i] = m_samples[i].scan;
+		step[i] = m_samples[i].step;
+		values[i] = m_samples[i].value;
+		if (values[i] > values[brightest]) brightest = i;
+	}
+	const double* coords[2] = { scan.data(), step.data() };
+	const double background = *std::min_element(values.begin(), values.end());
+	const double halfMaximum = background + 0.5 * (values[brightest] - background);
+	const int resolved = static_cast<int>(std::count_if(values.begin(), values.end(),
+		[halfMaximum](double value) { return value >= halfMaximum; }));
+
+	Result result = GetResult();
+	result.samples = static_cast<int>(count);
+	result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_startTime);
+
+	// Fallback: the brightest reading, uncertain to the finest cell around it
+	const int depth = m_cells.empty() ? m_settings.maxDepth : m_cells.front().depth;
+	const double cellScan = m_finestScan * static_cast<double>(int64_t(1) << (m_settings.maxDepth - depth));
+	const double cellStep = m_finestStep * static_cast<double>(int64_t(1) << (m_settings.maxDepth - depth));
+	result.fitted = false;
+	result.peakScan = scan[brightest];
+	result.peakStep = step[brightest];
+	result.peakValue = values[brightest];
+	result.sigmaScan = cellScan / 2.0;
+	result.sigmaStep = cellStep / 2.0;
+
+	if (resolved >= kMinResolvedSamples) {
+		const CouplingModel::Model guess = CouplingModel::InitialGuess(m_settings.shape, 2, coords, values.data(), count);
+		const CouplingModel::FitResult fit = CouplingModel::FitPeak(guess, coords, values.data(), count);
+		const double* fitted = fit.model.center;
+		const bool inside = std::abs(fitted[0] - (m_scanOrigin + m_settings.scanRange / 2.0)) <= m_settings.scanRange / 2.0 &&
+			std::abs(fitted[1] - (m_stepOrigin + m_settings.stepRange / 2.0)) <= m_settings.stepRange / 2.0;
+		if (fit.converged && inside && fit.model.peak > 0.0) {
+			result.fitted = true;
+			result.model = fit.model;
+			result.peakScan = fitted[0];
+			result.peakStep = fitted[1];
+			result.peakValue = fit.model.peak + fit.model.background;
+			result.sigmaScan = fit.centerSigma[0];
+			result.sigmaStep = fit.centerSigma[1];
+		}
+	}
+
+	result.success = result.peakValue >= m_settings.threshold && values[brightest] > background;
+	result.confident = result.success && result.fitted &&
+		result.sigmaScan <= m_settings.targetSigma && result.sigmaStep <= m_settings.targetSigma;
+
+	std::lock_guard<std::mutex> lock(m_resultMutex);
+	m_result = result;
+}
+
+void PIAdaptiveScan::Finish() {
+	Result result = GetResult();
+	// Stopped on confidence, cancel or a failed reading is not complete
+	result.complete = m_exhausted && !m_cancel;
+	result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_startTime);
+
+	if (result.success && m_settings.moveToPeak && !m_cancel) {
+		if (!m_backend->MoveTo(m_settings.scanAxis, result.peakScan, m_settings.stepAxis, result.peakStep)) {
+			std::cout << "PIAdaptiveScan: Failed to move to the peak" << std::endl;
+			result.success = false;
+		}
+	}
+
+	std::cout << "PIAdaptiveScan: " << (result.success ? "Peak" : "No peak") << " at "
+		<< m_settings.scanAxis << "=" << result.peakScan << " (+-" << result.sigmaScan << ") "
+		<< m_settings.stepAxis << "=" << result.peakStep << " (+-" << result.sigmaStep << "), value "
+		<< result.peakValue << (result.fitted ? " (fitted)" : " (brightest reading)") << " - "
+		<< result.samples << " of " << result.denseSamples << " dense samples, " << result.duration.count() << " ms"
+		<< std::endl;
+
+	std::lock_guard<std::mutex> lock(m_resultMutex);
+	m_result = result;
+}
@@ -0,0 +1,147 @@
+// PIAdaptiveScan.h - Host-side area scan that refines only near the signal and stops at a confident peak
+#pragma once
+
+#include "CouplingModel.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class PIController;
+class PISimulatedFastAlignment;
+
+/**
+ * PIAdaptiveScan - Area scan with quadtree refinement and early stop
+ *
+ * FSA/FSC/FSM and FDR raster the whole area at one line spacing, so most of
+ * the scan time goes into reading darkness far from the peak. This scan
+ * starts with a coarse grid, then subdivides only the cells whose corner
+ * readings (their level plus the gradient across the cell) say the peak may
+ * be inside. After every refinement pass the readings are fitted with a
+ * peak model (CouplingModel::FitPeak); once the fitted centre's uncertainty
+ * is below targetSigma on both axes the scan stops and moves to the peak.
+ *
+ * With continueInBackground, Run() returns the result as soon as it is
+ * confident, and the refinement carries on in a background thread down to
+ * maxDepth; the platform then moves to the final peak. GetResult() returns
+ * the latest result, Wait() blocks until the background pass is done.
+ * The platform keeps moving during that time - do not start other motion
+ * on the scan axes until IsRunning() is false.
+ *
+ * Usage:
+ *   PIAdaptiveScan scan(hexapod, 1);
+ *   PIAdaptiveScan::Settings settings;
+ *   settings.scanRange = settings.stepRange = 0.05;
+ *   PIAdaptiveScan::Result result = scan.Run(settings);
+ *   if (result.success) { ... result.peakScan, result.peakStep ... }
+ */
+class PIAdaptiveScan {
+public:
+  struct Settings {
+    std::string scanAxis = "X";
+    double scanRange = 0.05;          // Full range, centred on the current position
+    std::string stepAxis = "Y";
+    double stepRange = 0.05;
+    int coarsePoints = 5;             // Coarse grid per axis (>= 2)
+    int maxDepth = 4;                 // Subdivisions of a coarse cell; finest step = coarse step / 2^maxDepth
+    double threshold = 0.0;           // Minimum signal that counts as a peak (same unit as the input)
+    double refineFraction = 0.2;      // Refine cells that may reach this fraction of the signal span above background
+    double targetSigma = 0.0002;      // Early stop: fitted centre uncertainty per axis (axis units)
+    int maxSamples = 600;
+    CouplingModel::Shape shape = CouplingModel::Shape::Gaussian;
+    bool continueInBackground = false;
+    bool moveToPeak = true;
+  };
+
+  struct Result {
+    bool success = false;             // Peak above threshold located
+    bool confident = false;           // Stopped because targetSigma was met
+    bool complete = false;            // Refinement ran out (maxDepth, maxSamples or no cell left) - not an early stop
+    int samples = 0;
+    int denseSamples = 0;             // Readings a full raster at the finest step would take
+    int depth = 0;                    // Deepest refinement pass done
+    double peakScan = 0.0;
+    double peakStep = 0.0;
+    double peakValue = 0.0;
+    double sigmaScan = 0.0;
+    double sigmaStep = 0.0;
+    bool fitted = false;              // Peak from the model fit; false = brightest reading
+    CouplingModel::Model model;
+    std::chrono::milliseconds duration{ 0 };
+  };
+
+  // Platform and input used by the scan
+  class Backend {
+  public:
+    virtual ~Backend() = default;
+    virtual bool GetPosition(const std::string& axis, double& position) = 0;
+    virtual bool MoveTo(const std::string& scanAxis, double scan, const std::string& stepAxis, double step) = 0;  // Settled on return
+    virtual bool ReadSignal(double& value) = 0;
+  };
+
+  PIAdaptiveScan(PIController& controller, int analogInput);   // Hexapod and its analog input (qTAV)
+  explicit PIAdaptiveScan(PISimulatedFastAlignment& simulation);
+  explicit PIAdaptiveScan(std::unique_ptr<Backend> backend);
+  ~PIAdaptiveScan();   // Cancels a background pass
+
+  PIAdaptiveScan(const PIAdaptiveScan&) = delete;
+  PIAdaptiveScan& operator=(const PIAdaptiveScan&) = delete;
+
+  Result Run(const Settings& settings);
+  Result GetResult() const;
+  bool IsRunning() const { return m_running.load(); }
+  bool Wait(std::chrono::milliseconds timeout);
+  void Cancel();
+
+private:
+  // Square cell of the quadtree in units of the finest step
+  struct Cell {
+    int64_t x = 0;
+    int64_t y = 0;
+    int64_t size = 0;
+    int depth = 0;
+  };
+
+  struct Sample {
+    double scan = 0.0;
+    double step = 0.0;
+    double value = 0.0;
+  };
+
+  bool Measure(int64_t x, int64_t y, double& value);
+  bool MeasureAll(std::vector<std::pair<int64_t, int64_t>>& points);
+  bool RefinePass();                  // Subdivide promising cells; false = nothing left to refine
+  void Fit();
+  void Finish();
+  void BackgroundLoop();
+
+  double ScanAt(int64_t x) const { return m_scanOrigin + x * m_finestScan; }
+  double StepAt(int64_t y) const { return m_stepOrigin + y * m_finestStep; }
+  static uint64_t Key(int64_t x, int64_t y) { return (static_cast<uint64_t>(x) << 32) | static_cast<uint32_t>(y); }
+
+  std::unique_ptr<Backend> m_backend;
+
+  // Scan state - owned by the thread running the scan
+  Settings m_settings;
+  double m_scanOrigin = 0.0;
+  double m_stepOrigin = 0.0;
+  double m_finestScan = 0.0;
+  double m_finestStep = 0.0;
+  std::vector<Cell> m_cells;          // Leaves still worth refining
+  bool m_exhausted = false;           // RefinePass ran out of cells, depth or budget
+  std::unordered_map<uint64_t, double> m_readings;
+  std::vector<Sample> m_samples;
+  std::chrono::steady_clock::time_point m_startTime;
+
+  mutable std::mutex m_resultMutex;
+  Result m_result;
+
+  std::thread m_background;
+  std::atomic<bool> m_running{ false };
+  std::atomic<bool> m_cancel{ false };
+};
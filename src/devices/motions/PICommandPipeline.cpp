@@ -0,0 +1,219 @@
+// PICommandPipeline.cpp
+#include "PICommandPipeline.h"
+#include "PIController.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <locale>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace {
+	std::mutex g_translationMutex;
+	std::map<int, std::string> g_translations;
+
+	// PI_CNTR_STOP - "Controller was stopped by command", set by every HLT
+	constexpr int kStoppedByCommand = 10;
+}
+
+PICommandPipeline::PICommandPipeline(PIController& controller)
+	: m_controller(controller) {
+}
+
+// === QUEUEING ===
+
+PICommandPipeline& PICommandPipeline::Add(const std::string& command, bool replayable) {
+	if (command.empty()) {
+		m_buildError = "empty command";
+		return *this;
+	}
+	m_commands.push_back({ command, replayable, 0 });
+	return *this;
+}
+
+PICommandPipeline& PICommandPipeline::AddAxisValues(const char* command, const std::vector<std::string>& axes,
+	const std::vector<double>& values, bool replayable) {
+	if (axes.empty() || axes.size() != values.size()) {
+		m_buildError = std::string(command) + ": axes and values do not match";
+		return *this;
+	}
+
+	// GCS wants '.' decimals whatever the process locale is
+	std::ostringstream text;
+	text.imbue(std::locale::classic());
+	text << command << std::setprecision(10);
+	for (size_t i = 0; i < axes.size(); i++) {
+		text << " " << axes[i] << " " << values[i];
+	}
+	return Add(text.str(), replayable);
+}
+
+// Motion and state commands are never replayed - a replayed MOV would move the
+// platform after e.g. a following SVO had switched the servo on
+PICommandPipeline& PICommandPipeline::Move(const std::vector<std::string>& axes, const std::vector<double>& positions) {
+	return AddAxisValues("MOV", axes, positions, false);
+}
+
+PICommandPipeline& PICommandPipeline::MoveRelative(const std::vector<std::string>& axes, const std::vector<double>& distances) {
+	return AddAxisValues("MVR", axes, distances, false);
+}
+
+PICommandPipeline& PICommandPipeline::SetVelocity(const std::vector<std::string>& axes, const std::vector<double>& velocities) {
+	return AddAxisValues("VEL", axes, velocities, true);
+}
+
+PICommandPipeline& PICommandPipeline::SetSystemVelocity(double velocity) {
+	std::ostringstream text;
+	text.imbue(std::locale::classic());
+	text << "VLS " << std::setprecision(10) << velocity;
+	return Add(text.str(), true);
+}
+
+PICommandPipeline& PICommandPipeline::SetServo(const std::vector<std::string>& axes, bool enable) {
+	return AddAxisValues("SVO", axes, std::vector<double>(axes.size(), enable ? 1.0 : 0.0), false);
+}
+
+PICommandPipeline& PICommandPipeline::Halt(const std::vector<std::string>& axes) {
+	if (axes.empty()) {
+		m_buildError = "HLT: no axes";
+		return *this;
+	}
+	std::string text = "HLT";
+	for (const auto& axis : axes) {
+		text += " " + axis;
+	}
+	Add(text, false);
+	m_commands.back().expectedError = kStoppedByCommand;
+	return *this;
+}
+
+void PICommandPipeline::Clear() {
+	m_commands.clear();
+	m_buildError.clear();
+}
+
+// === EXECUTION ===
+
+PICommandPipeline::Result PICommandPipeline::Execute(bool clearPending) {
+	Result result;
+	if (!m_buildError.empty() || m_commands.empty()) {
+		result.failures.push_back({ -1, "", 0, m_buildError.empty() ? "no commands" : m_buildError });
+		Clear();
+		return result;
+	}
+	if (!m_controller.IsConnected()) {
+		result.failures.push_back({ -1, "", 0, "not connected" });
+		Clear();
+		return result;
+	}
+
+	const int id = m_controller.GetControllerId();
+
+	// Nothing else on this connection may touch the error register until the last ERR?
+	ProfiledLockGuard commandLock(m_controller.GetCommandMutex());
+
+	// Whatever is in the register now is not ours - read it out so it is not charged to the batch
+	if (clearPending) {
+		result.roundTrips++;
+		if (!PI_qERR(id, &result.pendingError)) {
+			result.error = PI_GetError(id);
+			result.failures.push_back({ -1, "ERR?", result.error, TranslateError(result.error) });
+			Clear();
+			return result;
+		}
+	}
+
+	for (size_t i = 0; i < m_commands.size(); i++) {
+		// A local failure (link down) is reported by the library itself - exact attribution
+		if (!PI_GcsCommandset(id, m_commands[i].text.c_str())) {
+			const int error = PI_GetError(id);
+			result.error = error;
+			result.failures.push_back({ static_cast<int>(i), m_commands[i].text, error, TranslateError(error) });
+			Clear();
+			return result;
+		}
+	}
+
+	result.roundTrips++;
+	if (!PI_qERR(id, &result.error)) {
+		result.error = PI_GetError(id);
+		result.failures.push_back({ -1, "ERR?", result.error, TranslateError(result.error) });
+		Clear();
+		return result;
+	}
+
+	// A halting batch always leaves "stopped by command" behind
+	const bool expected = result.error != 0 && std::any_of(m_commands.begin(), m_commands.end(),
+		[&result](const Command& command) { return command.expectedError == result.error; });
+	if (expected) {
+		result.error = 0;
+	}
+
+	result.success = (result.error == 0);
+	if (!result.success) {
+		Attribute(id, result);
+	}
+	Clear();
+	return result;
+}
+
+// Replay the pure parameter sets one at a time; motion and state commands stay unattributed
+void PICommandPipeline::Attribute(int id, Result& result) {
+	for (size_t i = 0; i < m_commands.size(); i++) {
+		if (!m_commands[i].replayable) {
+			continue;
+		}
+		int error = 0;
+		result.roundTrips++;
+		if (!PI_GcsCommandset(id, m_commands[i].text.c_str()) || !PI_qERR(id, &error)) {
+			break;
+		}
+		if (error != 0) {
+			result.failures.push_back({ static_cast<int>(i), m_commands[i].text, error, TranslateError(error) });
+		}
+	}
+
+	if (result.failures.empty()) {
+		result.failures.push_back({ -1, "", result.error,
+			TranslateError(result.error) + " (unattributed - motion/state commands are not replayed)" });
+	}
+}
+
+// === ERROR TEXT ===
+
+std::string PICommandPipeline::TranslateError(int error) {
+	std::lock_guard<std::mutex> lock(g_translationMutex);
+	auto it = g_translations.find(error);
+	if (it != g_translations.end()) {
+		return it->second;
+	}
+
+	char buffer[256] = { 0 };
+	std::string text = PI_TranslateError(error, buffer, sizeof(buffer))
+		? std::string(buffer)
+		: "error " + std::to_string(error);
+	g_translations[error] = text;
+	return text;
+}
+
+std::string PICommandPipeline::Describe(const Result& result) {
+	std::ostringstream text;
+	text << "PICommandPipeline: " << (result.success ? "OK" : "FAILED") << ", " << result.roundTrips
+		<< " error " << (result.roundTrips == 1 ? "query" : "queries") << std::endl;
+	if (result.pendingError != 0) {
+		text << "  cleared before the batch: error " << result.pendingError << " - "
+			<< TranslateError(result.pendingError) << std::endl;
+	}
+	for (const auto& failure : result.failures) {
+		text << "  ";
+		if (failure.index >= 0) {
+			text << "#" << failure.index << " '" << failure.command << "': ";
+		}
+		if (failure.error != 0) {
+			text << "error " << failure.error << " - ";
+		}
+		text << failure.text << std::endl;
+	}
+	return text.str();
+}
@@ -0,0 +1,100 @@
+// PICommandPipeline.h - Several GCS set commands checked with one error query
+#pragma once
+
+#include <string>
+#include <vector>
+
+class PIController;
+
+/**
+ * PICommandPipeline - Batch GCS set commands behind a single ERR?
+ *
+ * The typed PI_xxx calls each send their command and then ERR?, so a group
+ * of set commands (servo, velocities, a move) costs one round trip per
+ * command. The pipeline sends the group as raw commands (PI_GcsCommandset,
+ * no reply) and checks the controller's error register once at the end:
+ * one round trip for the whole group. PI_SetErrorCheck would do the same
+ * for the typed calls, but it is connection-wide and would also silence
+ * the error check of the polling thread.
+ *
+ * The controller keeps only one error code, so a failed batch does not say
+ * which command failed. Only then does the pipeline replay the replayable
+ * commands - pure parameter sets such as VEL/VLS - one at a time, each with
+ * its own ERR?, to map the error back to its command. Commands that move or
+ * change state (MOV, MVR, SVO, HLT) are never replayed: an error check must
+ * not move the machine. An error no replay reproduces is reported as
+ * unattributed.
+ *
+ * The typed calls leave the error register cleared, so a batch needs no
+ * leading ERR?. A caller that cannot rule out a stale error (e.g. after a
+ * raw command of its own) passes clearPending: Execute() then reads it out
+ * first and reports it as Result::pendingError instead of charging it to
+ * the batch, at the cost of a second round trip. HLT always sets error 10
+ * (stopped by command); a batch that halts expects it and does not fail on it.
+ *
+ * The error register is per connection. Execute() holds the controller's
+ * command mutex from the first command to the last ERR?, and the
+ * communication thread takes the same mutex for its status reads, so the
+ * polling cannot consume or add to the batch's error.
+ *
+ * Usage:
+ *   PICommandPipeline pipeline(controller);
+ *   pipeline.SetServo({ "X", "Y" }, true)
+ *           .SetVelocity({ "X", "Y" }, { 5.0, 5.0 })
+ *           .Move({ "X", "Y" }, { 1.0, 2.0 });
+ *   PICommandPipeline::Result result = pipeline.Execute();
+ *   if (!result.success) std::cout << PICommandPipeline::Describe(result);
+ */
+class PICommandPipeline {
+public:
+  struct Failure {
+    int index = -1;               // Command that reproduced the error, -1 if none did
+    std::string command;
+    int error = 0;
+    std::string text;             // Translated error
+  };
+
+  struct Result {
+    bool success = false;
+    int error = 0;                // Trailing ERR? of the batch
+    int pendingError = 0;         // Cleared before the batch - left by an earlier call
+    int roundTrips = 0;           // Error queries issued, replays included
+    std::vector<Failure> failures;
+  };
+
+  explicit PICommandPipeline(PIController& controller);
+
+  // Raw GCS set command, e.g. "VEL X 5 Y 5". Replayable only if it sets parameters and
+  // neither moves nor changes state - sending it again during attribution must be harmless.
+  PICommandPipeline& Add(const std::string& command, bool replayable = false);
+
+  PICommandPipeline& Move(const std::vector<std::string>& axes, const std::vector<double>& positions);
+  PICommandPipeline& MoveRelative(const std::vector<std::string>& axes, const std::vector<double>& distances);
+  PICommandPipeline& SetVelocity(const std::vector<std::string>& axes, const std::vector<double>& velocities);
+  PICommandPipeline& SetSystemVelocity(double velocity);
+  PICommandPipeline& SetServo(const std::vector<std::string>& axes, bool enable);
+  PICommandPipeline& Halt(const std::vector<std::string>& axes);
+
+  Result Execute(bool clearPending = false);   // Sends and clears the queued commands
+  void Clear();
+  size_t Size() const { return m_commands.size(); }
+
+  // PI_TranslateError, cached per code
+  static std::string TranslateError(int error);
+  static std::string Describe(const Result& result);
+
+private:
+  struct Command {
+    std::string text;
+    bool replayable = false;
+    int expectedError = 0;        // Error this command always leaves (HLT: 10)
+  };
+
+  PICommandPipeline& AddAxisValues(const char* command, const std::vector<std::string>& axes,
+    const std::vector<double>& values, bool replayable);
+  void Attribute(int id, Result& result);
+
+  PIController& m_controller;
+  std::vector<Command> m_commands;
+  std::string m_buildError;       // Malformed helper call, reported by Execute
+};
@@ -1,19 +1,49 @@
 ﻿// pi_controller.cpp
 #include "PIController.h"
+#include "PICommandPipeline.h"
+#include "PICoordinateSystems.h"
+#include "../../core/TelemetrySegment.h"
+#include "../../utils/AllocationTracker.h"
+#include "../../utils/IOExecutor.h"
+#include "../../utils/ThreadPolicy.h"
 
 
 #include <iostream>
 #include <chrono>
 #include <sstream>
 #include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace {
+	// Fixed C-887 axis set for the batched status queries in the comm thread.
+	// Static storage keeps the per-tick path free of heap allocations.
+	using Hexapod = ControllerTraits::PIHexapodC887;
+	const char* const kHexapodAxesString = Hexapod::kAxesString;
+	constexpr int kHexapodAxisCount = Hexapod::kAxisCount;
+	const std::string kHexapodAxes[kHexapodAxisCount] = { "X", "Y", "Z", "U", "V", "W" };
+
+	constexpr int kMaxAnalogChannels = 16;
+	constexpr int kMaxMoveAxes = 6;
+
+	// Comm tick while a move is waiting to settle, so completion is not held
+	// back by the normal 50 ms status interval
+	constexpr auto kSettlePollInterval = std::chrono::milliseconds(10);
+
+	int HexapodAxisIndex(const std::string& axis) {
+		return ControllerTraits::AxisSlot<Hexapod>(axis);
+	}
+}
 
 // Modify the constructor to initialize timestamps
 // Updated constructor - initialize analog reading
-PIController::PIController()
-	: m_controllerId(-1),
+PIController::PIController(IOExecutor* executor)
+	: m_executor(executor),
+	m_controllerId(-1),
 	m_port(50000),
 	m_lastStatusUpdate(std::chrono::steady_clock::now()),
-	m_lastPositionUpdate(std::chrono::steady_clock::now()) {
+	m_lastPositionUpdate(std::chrono::steady_clock::now()),
+	m_coordinateSystems(std::make_unique<PICoordinateSystems>(*this)) {
 
 	// Initialize atomic variables
 	m_isConnected.store(false);
@@ -37,6 +67,9 @@ PIController::PIController()
 PIController::~PIController() {
 	std::cout << "PIController: Shutting down controller" << std::endl;
 
+	// Unregister first - waits for any recovery that is still using this controller
+	HealthWatchdog::Instance().Unregister(m_watchdogId.exchange(-1));
+
 	// CRITICAL: Stop communication thread FIRST without holding any locks
 	StopCommunicationThread();
 
@@ -44,6 +77,16 @@ PIController::~PIController() {
 	if (m_isConnected) {
 		Disconnect();
 	}
+
+	// Last resort: a thread still blocked in a vendor call must finish before we go away
+	if (m_communicationThread.joinable()) {
+		std::cout << "PIController: Waiting for blocked communication thread" << std::endl;
+		m_communicationThread.join();
+	}
+	if (m_executor && m_threadRunning.load()) {
+		std::cout << "PIController: Waiting for blocked communication task" << std::endl;
+		m_executor->Cancel(m_executorTask, IOExecutor::kWaitForever);
+	}
 }
 
 bool PIController::GetDeviceIdentification(std::string& manufacturerInfo) {
@@ -76,6 +119,14 @@ void PIController::StartCommunicationThread() {
 	if (!m_threadRunning) {
 		m_threadRunning.store(true);
 		m_terminateThread.store(false);
+		m_threadExited.store(false);
+
+		if (m_executor) {
+			m_executorTask = m_executor->Schedule(CommThreadName(), [this]() { return CommunicationTick(); });
+			std::cout << "PIController: Communication task scheduled on " << m_executor->GetName() << std::endl;
+			return;
+		}
+
 		m_communicationThread = std::thread(&PIController::CommunicationThreadFunc, this);
 		
 		std::cout << "PIController: Communication thread started" << std::endl;
@@ -83,14 +134,37 @@ void PIController::StartCommunicationThread() {
 }
 
 
-void PIController::StopCommunicationThread() {
+bool PIController::StopCommunicationThread(std::chrono::milliseconds timeout) {
 	if (m_threadRunning.load()) {
 		// Signal termination using atomic - NO MUTEX NEEDED
 		m_terminateThread.store(true);
 
+		if (m_executor) {
+			// Returns once no tick is in flight; a tick blocked in a vendor call keeps it running
+			if (!m_executor->Cancel(m_executorTask, timeout)) {
+				std::cout << "PIController: Communication task did not finish within " << timeout.count()
+					<< " ms - still blocked in a controller call" << std::endl;
+				return false;
+			}
+			m_threadExited.store(true);
+			m_threadRunning.store(false);
+			std::cout << "PIController: Communication task cancelled" << std::endl;
+			return true;
+		}
+
 		// Wake up the thread if it's sleeping
 		m_condVar.notify_all();
 
+		// A hung vendor call would block join() forever - wait with a deadline first
+		{
+			ProfiledUniqueLock lock(m_mutex);
+			if (!m_condVar.wait_for(lock, timeout, [this]() { return m_threadExited.load(); })) {
+				std::cout << "PIController: Communication thread did not exit within " << timeout.count()
+					<< " ms - still blocked in a controller call" << std::endl;
+				return false;
+			}
+		}
+
 		// Join the thread
 		if (m_communicationThread.joinable()) {
 			m_communicationThread.join();
@@ -99,6 +173,7 @@ void PIController::StopCommunicationThread() {
 		m_threadRunning.store(false);
 		std::cout << "PIController: Communication thread stopped" << std::endl;
 	}
+	return true;
 }
 
 
@@ -106,61 +181,174 @@ void PIController::StopCommunicationThread() {
 
 // === PIController.cpp - REWRITE COMMUNICATION THREAD ===
 
-void PIController::CommunicationThreadFunc() {
-	const auto updateInterval = std::chrono::milliseconds(50);
-	int frameCounter = 0;
+std::string PIController::CommThreadName() const {
+	return m_deviceName.empty() ? "PI comm" : "PI comm " + m_deviceName;
+}
 
+void PIController::CommunicationThreadFunc() {
 	std::cout << "PIController: Communication thread started" << std::endl;
+	ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::MotionIO, CommThreadName());
 
 	while (!m_terminateThread.load()) {
-		if (m_isConnected.load()) {
-			frameCounter++;
-
-			// Update positions (use short-lived locks)
-			std::map<std::string, double> positions;
-			if (GetPositions(positions)) {
-				{
-					std::lock_guard<std::mutex> lock(m_mutex);
-					m_axisPositions = positions;
-				}
-			}
+		// CRITICAL: Simple sleep with termination check - NO MUTEX
+		std::this_thread::sleep_for(CommunicationTick());
+	}
 
-			// Update motion status (short-lived lock)
-			{
-				const char* allAxes = "X Y Z U V W";
-				BOOL isMovingArray[6] = { FALSE, FALSE, FALSE, FALSE, FALSE, FALSE };
-
-				if (PI_IsMoving(m_controllerId, allAxes, isMovingArray)) {
-					std::lock_guard<std::mutex> lock(m_mutex);
-					const std::vector<std::string> axisNames = { "X", "Y", "Z", "U", "V", "W" };
-					for (int i = 0; i < 6; i++) {
-						m_axisMoving[axisNames[i]] = (isMovingArray[i] == TRUE);
-					}
-				}
-			}
+	std::cout << "PIController: Communication thread exiting cleanly" << std::endl;
+
+	// Tell StopCommunicationThread we are done
+	{
+		ProfiledLockGuard lock(m_mutex);
+		m_threadExited.store(true);
+	}
+	m_condVar.notify_all();
+}
+
+std::chrono::milliseconds PIController::CommunicationTick() {
+	const auto updateInterval = std::chrono::milliseconds(50);
+
+	if (m_terminateThread.load()) {
+		return IOExecutor::kStop;
+	}
+
+	HealthWatchdog::Instance().Heartbeat(m_watchdogId.load());
+
+	if (m_isConnected.load()) {
+		AllocationTracker::Scope allocScope("PIController::CommTick");
+		m_frameCounter++;
+
+		// Moves armed after this point must not be judged by this tick's reads
+		const auto sampleTime = std::chrono::steady_clock::now();
+
+		// Batched status reads for the configured layout (see ApplyAxisLayout)
+		const bool wantOnTarget = m_pendingSettles.load() > 0 &&
+			GetSettleSettings().mode == SettleMode::OnTarget;
+		StatusRead status;
+		{
+			ProfiledLockGuard commandLock(m_commandMutex);
+			(this->*m_readStatus)(status, wantOnTarget, m_frameCounter % 3 == 0);
+		}
 
-			// Update servo status less frequently (short-lived locks)
-			if (frameCounter % 3 == 0) {
-				for (const auto& axis : m_availableAxes) {
-					bool enabled;
-					if (IsServoEnabled(axis, enabled)) {
-						std::lock_guard<std::mutex> lock(m_mutex);
-						m_axisServoEnabled[axis] = enabled;
-					}
+		if (status.positionsRead) {
+			// Midway through the round trip is the best guess of when qPOS sampled
+			const auto positionTime = sampleTime + (status.positionsAt - sampleTime) / 2;
+			for (int i = 0; i < kHexapodAxisCount; i++) {
+				if (status.slotMask & (1u << i)) {
+					m_estimator.AddSample(i, positionTime, status.positions[i]);
 				}
 			}
+		}
 
-			// Update analog readings (short-lived locks)
-			if (m_enableAnalogReading.load() && frameCounter % 2 == 0) {
-				UpdateAnalogReadings();
-			}
+		// Jog: retarget ahead of the fresh position, restore VLS once released
+		if (status.positionsRead && (IsJogging() || m_jogSystemVelocity > 0.0)) {
+			UpdateJog(status.positions);
 		}
 
-		// CRITICAL: Simple sleep with termination check - NO MUTEX
-		std::this_thread::sleep_for(updateInterval);
+		// Settle detection - qONT costs a round trip, so it was only read while a move is pending
+		if (m_pendingSettles.load() > 0 && status.positionsRead && status.movingRead &&
+			(!wantOnTarget || status.onTargetRead)) {
+			EvaluateSettle(sampleTime, status.positions, status.moving, status.onTarget);
+		}
+
+		// Update analog readings (short-lived locks)
+		if (m_enableAnalogReading.load() && m_frameCounter % 2 == 0) {
+			UpdateAnalogReadings();
+		}
+
+		PublishTelemetry();
 	}
 
-	std::cout << "PIController: Communication thread exiting cleanly" << std::endl;
+	return m_pendingSettles.load() > 0 ? kSettlePollInterval : updateInterval;
+}
+
+// === HEALTH MONITORING ===
+
+void PIController::RegisterWatchdog() {
+	HealthWatchdog::ChannelOptions options;
+	options.deadline = m_watchdogDeadline;
+	options.recovery = m_watchdogRecovery;
+	options.onStaleChanged = [this](bool stale) {
+		m_dataStale.store(stale);
+		TelemetrySegment::Instance().UpdateMotionFlags(m_telemetrySlot.load(),
+			stale ? Telemetry::kFlagStale : 0, stale ? 0 : Telemetry::kFlagStale);
+	};
+	if (m_watchdogRecovery == HealthWatchdog::Recovery::Reconnect) {
+		options.onRecover = [this]() { return Reconnect(); };
+	}
+	else if (m_watchdogRecovery == HealthWatchdog::Recovery::SafeStop) {
+		options.onRecover = [this]() { return StopAllAxes(); };
+	}
+
+	std::string name = "PI:" + (m_deviceName.empty() ? m_ipAddress : m_deviceName);
+	m_watchdogId.store(HealthWatchdog::Instance().Register(name, options));
+}
+
+void PIController::SetWatchdogPolicy(std::chrono::milliseconds deadline, HealthWatchdog::Recovery recovery) {
+	m_watchdogDeadline = deadline;
+	m_watchdogRecovery = recovery;
+
+	// Re-register so the new policy takes effect immediately
+	if (m_watchdogId.load() >= 0) {
+		HealthWatchdog::Instance().Unregister(m_watchdogId.exchange(-1));
+		RegisterWatchdog();
+		HealthWatchdog::Instance().SetMonitored(m_watchdogId.load(), m_isConnected.load());
+	}
+}
+
+bool PIController::Reconnect() {
+	const std::string ipAddress = m_ipAddress;
+	const int port = m_port;
+
+	std::cout << "PIController: Reconnecting to " << ipAddress << ":" << port << std::endl;
+
+	Disconnect();
+
+	if (!StopCommunicationThread()) {
+		std::cout << "PIController: Reconnect aborted - communication thread still blocked" << std::endl;
+		return false;
+	}
+
+	if (!Connect(ipAddress, port)) {
+		return false;
+	}
+
+	StartCommunicationThread();
+	return true;
+}
+
+// Copy the cached status into this controller's telemetry slot
+void PIController::PublishTelemetry() {
+	if (m_telemetrySlot < 0) {
+		return;
+	}
+
+	Telemetry::MotionSnapshot snapshot{};
+	snapshot.timestampNs = TelemetrySegment::NowNs();
+	snapshot.frameCounter = ++m_telemetryFrame;
+	snapshot.flags = Telemetry::kFlagConnected;
+
+	{
+		ProfiledLockGuard lock(m_mutex);
+		const int axisCount = std::min<int>(static_cast<int>(m_availableAxes.size()), Telemetry::kMaxAxes);
+		for (int i = 0; i < axisCount; i++) {
+			const std::string& axis = m_availableAxes[i];
+			auto pos = m_axisPositions.find(axis);
+			if (pos != m_axisPositions.end()) snapshot.positions[i] = pos->second;
+			auto moving = m_axisMoving.find(axis);
+			if (moving != m_axisMoving.end() && moving->second) snapshot.movingMask |= (1u << i);
+			auto servo = m_axisServoEnabled.find(axis);
+			if (servo != m_axisServoEnabled.end() && servo->second) snapshot.servoMask |= (1u << i);
+		}
+
+		for (const auto& [channel, voltage] : m_analogVoltages) {
+			if (channel >= 1 && channel <= Telemetry::kMaxAnalogChannels) {
+				snapshot.analog[channel - 1] = voltage;
+				snapshot.analogMask |= (1u << (channel - 1));
+			}
+		}
+	}
+
+	TelemetrySegment::Instance().PublishMotion(m_telemetrySlot, snapshot);
 }
 
 // NEW: Update analog readings in communication thread
@@ -169,21 +357,23 @@ void PIController::UpdateAnalogReadings() {
 		return;
 	}
 
-	std::map<int, double> voltages;
-	if (GetAnalogVoltages(m_activeAnalogChannels, voltages)) {
-		// Update cached values
-		{
-			std::lock_guard<std::mutex> lock(m_mutex);
-			m_analogVoltages = voltages;
+	// Fixed buffers instead of vector/map temporaries - this runs every other tick
+	const int count = std::min<int>(static_cast<int>(m_activeAnalogChannels.size()), kMaxAnalogChannels);
+	int channels[kMaxAnalogChannels];
+	double values[kMaxAnalogChannels] = { 0.0 };
+	std::copy_n(m_activeAnalogChannels.begin(), count, channels);
+
+	if (!PI_qTAV(m_controllerId, channels, values, count)) {
+		if (m_debugVerbose) {
+			std::cout << "PIController: Failed to read analog channels. Error: " << PI_GetError(m_controllerId) << std::endl;
 		}
+		return;
+	}
 
-		//// Update global data store
-		//if (m_dataStore && !m_deviceName.empty()) {
-		//	for (const auto& [channel, voltage] : voltages) {
-		//		std::string dataKey = m_deviceName + "-A-" + std::to_wstring(channel);
-		//		m_dataStore->SetValue(dataKey, static_cast<float>(voltage));
-		//	}
-		//}
+	// Update cached values in place
+	ProfiledLockGuard lock(m_mutex);
+	for (int i = 0; i < count; i++) {
+		m_analogVoltages[channels[i]] = values[i];
 	}
 }
 
@@ -226,16 +416,20 @@ bool PIController::GetAnalogVoltage(int channel, double& voltage) {
 }
 
 // NEW: Get multiple analog voltages
-bool PIController::GetAnalogVoltages(std::vector<int> channels, std::map<int, double>& voltages) {
+bool PIController::GetAnalogVoltages(const std::vector<int>& channels, std::map<int, double>& voltages) {
 	if (!m_isConnected || channels.empty()) {
 		return false;
 	}
 
-	// Convert vector to array
-	std::vector<int> channelIds = channels;
-	std::vector<double> values(channels.size(), 0.0);
+	if (channels.size() > static_cast<size_t>(kMaxAnalogChannels)) {
+		std::cout << "PIController: Too many analog channels requested (" << channels.size()
+			<< ", max " << kMaxAnalogChannels << ")" << std::endl;
+		return false;
+	}
+
+	double values[kMaxAnalogChannels] = { 0.0 };
 
-	if (!PI_qTAV(m_controllerId, channelIds.data(), values.data(), static_cast<int>(channels.size()))) {
+	if (!PI_qTAV(m_controllerId, channels.data(), values, static_cast<int>(channels.size()))) {
 		int error = PI_GetError(m_controllerId);
 		if (m_debugVerbose) {
 			
@@ -282,12 +476,13 @@ bool PIController::Connect(const std::string& ipAddress, int port) {
 	}
 
 	m_isConnected.store(true);
+	m_estimator.Reset();
 	
 	std::cout << "PIController: Successfully connected to controller with ID: " << m_controllerId << std::endl;
 
 	// Initialize the position and status maps
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
+		ProfiledLockGuard lock(m_mutex);
 		for (const auto& axis : m_availableAxes) {
 			m_axisPositions[axis] = 0.0;
 			m_axisMoving[axis] = false;
@@ -306,10 +501,23 @@ bool PIController::Connect(const std::string& ipAddress, int port) {
 	// Update cached positions and statuses
 	std::map<std::string, double> positions;
 	if (GetPositions(positions)) {
-		std::lock_guard<std::mutex> lock(m_mutex);
+		ProfiledLockGuard lock(m_mutex);
 		m_axisPositions = positions;
 	}
 
+	// Frames survive a reconnect but not a power cycle - start from what the controller holds
+	m_coordinateSystems->Sync();
+
+	// Publish snapshots for external analysis tools
+	m_telemetrySlot = TelemetrySegment::Instance().AcquireMotionSlot(
+		m_deviceName.empty() ? m_ipAddress : m_deviceName, "PI", m_availableAxes);
+
+	// Start deadline monitoring of the communication thread
+	if (m_watchdogId.load() < 0) {
+		RegisterWatchdog();
+	}
+	HealthWatchdog::Instance().SetMonitored(m_watchdogId.load(), true);
+
 	return true;
 }
 
@@ -324,7 +532,7 @@ void PIController::InitializeAnalogChannels() {
 		
 		std::cout << "PIController: Found " << m_numAnalogChannels << " analog channels" << std::endl;
 		// Initialize analog voltage cache
-		std::lock_guard<std::mutex> lock(m_mutex);
+		ProfiledLockGuard lock(m_mutex);
 		for (int channel : m_activeAnalogChannels) {
 			if (channel <= m_numAnalogChannels) {
 				m_analogVoltages[channel] = 0.0;
@@ -344,7 +552,10 @@ void PIController::Disconnect() {
 	if (!m_isConnected) {
 		return;
 	}
-	StopCommunicationThread();
+
+	// Intentional disconnect - not a stall
+	HealthWatchdog::Instance().SetMonitored(m_watchdogId.load(), false);
+	bool threadStopped = StopCommunicationThread();
 	
 	std::cout << "PIController: Disconnecting from controller" << std::endl;
 
@@ -354,8 +565,19 @@ void PIController::Disconnect() {
 	// Close connection
 	PI_CloseConnection(m_controllerId);
 
+	// Closing the connection unblocks a hung vendor call - finish stopping the thread
+	if (!threadStopped) {
+		StopCommunicationThread();
+	}
+
+	TelemetrySegment::Instance().ReleaseMotionSlot(m_telemetrySlot.exchange(-1));
+
 	m_isConnected.store(false);
 	m_controllerId = -1;
+	m_coordinateSystems->Invalidate();
+
+	// Nothing will settle any more - release anyone waiting
+	CancelSettle("");
 
 	std::cout << "PIController: Disconnected from controller" << std::endl;
 }
@@ -366,6 +588,9 @@ bool PIController::MoveToPosition(const std::string& axis, double position, bool
 		std::cout << "PIController: Cannot move axis - not connected" << std::endl;
 		return false;
 	}
+	if (!CheckTargetFrame("move axis")) {
+		return false;
+	}
 
 	// Only log at debug level to reduce overhead
 	if (m_enableDebug) {
@@ -378,17 +603,17 @@ bool PIController::MoveToPosition(const std::string& axis, double position, bool
 
 	// Command the move
 	if (!PI_MOV(m_controllerId, axes, positions)) {
-		int error = 0;
-		PI_qERR(m_controllerId, &error);
+		int error = PI_GetError(m_controllerId);
 		std::cout << "PIController: Failed to move axis " << axis << " to position " << position << ". Error code: " << error << std::endl;
 		return false;
 	}
 
 	// Update the cache to reflect we're now moving
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
+		ProfiledLockGuard lock(m_mutex);
 		m_axisMoving[axis] = true;
 	}
+	ArmSettle(axis, position);
 
 	// If blocking mode, wait for motion to complete
 	if (blocking) {
@@ -407,6 +632,9 @@ bool PIController::MoveRelative(const std::string& axis, double distance, bool b
 		std::cout << "PIController: Cannot move axis - not connected" << std::endl;
 		return false;
 	}
+	if (!CheckTargetFrame("move axis relative")) {
+		return false;
+	}
 
 	// Only log if verbose is enabled
 	if (m_debugVerbose) {
@@ -438,8 +666,7 @@ bool PIController::MoveRelative(const std::string& axis, double distance, bool b
 	bool moveResult = PI_MVR(m_controllerId, axes, distances);
 
 	if (!moveResult) {
-		int error = 0;
-		PI_qERR(m_controllerId, &error);
+		int error = PI_GetError(m_controllerId);
 		std::string errorMsg = "PIController: Failed to move axis relatively. Error code: " + std::to_string(error);
 
 		std::cout << "PIController: Failed to move axis relatively. Error code: " << error << std::endl;
@@ -448,10 +675,7 @@ bool PIController::MoveRelative(const std::string& axis, double distance, bool b
 			std::cout << errorMsg << std::endl;
 
 			// Add detailed error information
-			char errorText[256] = { 0 };
-			if (PI_TranslateError(error, errorText, sizeof(errorText))) {
-				std::cout << "PIController: Error translation: " << errorText << std::endl;
-			}
+			std::cout << "PIController: Error translation: " << PICommandPipeline::TranslateError(error) << std::endl;
 		}
 
 		return false;
@@ -461,10 +685,16 @@ bool PIController::MoveRelative(const std::string& axis, double distance, bool b
 		std::cout << "PIController: MVR command sent successfully" << std::endl;
 	}
 
+	// The controller knows the absolute target; the cached position may lag
+	double target = 0.0;
+	if (PI_qMOV(m_controllerId, axes, &target)) {
+		ArmSettle(axis, target);
+	}
+
 	// *** KEY FIX: IMMEDIATELY UPDATE THE MOVING STATUS AFTER SENDING THE COMMAND ***
 	// This ensures that the UI reflects that the axis is moving right away
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
+		ProfiledLockGuard lock(m_mutex);
 		m_axisMoving[axis] = true;
 
 		if (m_debugVerbose) {
@@ -509,14 +739,14 @@ bool PIController::HomeAxis(const std::string& axis) {
 	}
 
 	std::cout << "PIController: Homing axis " << axis << std::endl;
+	ClearEstimatorCommand(axis);
 
 	// Convert single-axis string to char array for PI GCS2 API
 	const char* axes = axis.c_str();
 
 	// Command the homing operation
 	if (!PI_FRF(m_controllerId, axes)) {
-		int error = 0;
-		PI_qERR(m_controllerId, &error);
+		int error = PI_GetError(m_controllerId);
 
 		std::cout << "PIController: Failed to home axis " << axis << ". Error code: " << error << std::endl;
 		return false;
@@ -535,18 +765,19 @@ bool PIController::StopAxis(const std::string& axis) {
 
 
 	std::cout << "PIController: Stopping axis " << axis << std::endl;
+	ClearJog(HexapodAxisIndex(axis));
 
 	// Convert single-axis string to char array for PI GCS2 API
 	const char* axes = axis.c_str();
 
 	// Command the stop
 	if (!PI_HLT(m_controllerId, axes)) {
-		int error = 0;
-		PI_qERR(m_controllerId, &error);
+		int error = PI_GetError(m_controllerId);
 		std::cout << "PIController: Failed to stop axis " << axis << ". Error code: " << error << std::endl;
 		return false;
 	}
 
+	CancelSettle(axis);
 	return true;
 }
 
@@ -557,18 +788,180 @@ bool PIController::StopAllAxes() {
 	}
 
 	std::cout << "PIController: Stopping all axes" << std::endl;
+	ClearJog(-1);
 
 	// Command the stop for all axes
 	if (!PI_STP(m_controllerId)) {
-		int error = 0;
-		PI_qERR(m_controllerId, &error);
+		int error = PI_GetError(m_controllerId);
 		std::cout << "PIController: Failed to stop all axes. Error code: " << error << std::endl;
 		return false;
 	}
 
+	CancelSettle("");
 	return true;
 }
 
+// === JOG ===
+
+bool PIController::Jog(const std::string& axis, double velocity) {
+	if (!m_isConnected) {
+		std::cout << "PIController: Cannot jog - not connected" << std::endl;
+		return false;
+	}
+
+	const int axisIndex = HexapodAxisIndex(axis);
+	if (axisIndex < 0) {
+		std::cout << "PIController: Cannot jog unknown axis " << axis << std::endl;
+		return false;
+	}
+
+	if (velocity != 0.0) {
+		ProfiledLockGuard lock(m_mutex);
+		AxisJogState& jog = m_jogState[axisIndex];
+		if (!jog.active) {
+			jog.active = true;
+			m_activeJogs++;
+			m_estimator.ClearCommand(axisIndex);   // The jog retargets every tick - no fixed target
+		}
+		jog.velocity = velocity;
+		jog.refreshed = std::chrono::steady_clock::now();
+		return true;
+	}
+
+	// Release: halt now - the communication thread restores VLS on its next tick
+	std::lock_guard<std::mutex> jogLock(m_jogMutex);
+	{
+		ProfiledLockGuard lock(m_mutex);
+		if (!m_jogState[axisIndex].active) {
+			return true;
+		}
+		m_jogState[axisIndex].active = false;
+		m_activeJogs--;
+	}
+
+	if (!PI_HLT(m_controllerId, axis.c_str())) {
+		int error = PI_GetError(m_controllerId);
+		std::cout << "PIController: Failed to halt jog on axis " << axis << ". Error code: " << error << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool PIController::StopJog() {
+	if (!IsJogging()) {
+		return true;
+	}
+
+	std::lock_guard<std::mutex> jogLock(m_jogMutex);
+	ClearJog(-1);
+	if (m_isConnected && !PI_HLT(m_controllerId, kHexapodAxesString)) {
+		int error = PI_GetError(m_controllerId);
+		std::cout << "PIController: Failed to halt jog. Error code: " << error << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void PIController::ClearJog(int axisIndex) {
+	ProfiledLockGuard lock(m_mutex);
+	for (int i = 0; i < kHexapodAxisCount; i++) {
+		if ((axisIndex < 0 || axisIndex == i) && m_jogState[i].active) {
+			m_jogState[i].active = false;
+			m_activeJogs--;
+		}
+	}
+}
+
+// One MOV for all jogging axes, kJogLookahead of travel ahead of the position
+// just read. If the refreshes stop the hexapod still halts within that lead.
+void PIController::UpdateJog(const double* positions) {
+	std::lock_guard<std::mutex> jogLock(m_jogMutex);
+
+	char axes[2 * kHexapodAxisCount] = { 0 };
+	double targets[kHexapodAxisCount] = { 0.0 };
+	int length = 0;
+	int count = 0;
+	double speedSquared = 0.0;
+	bool expired = false;
+
+	{
+		ProfiledLockGuard lock(m_mutex);
+		const auto now = std::chrono::steady_clock::now();
+		for (int i = 0; i < kHexapodAxisCount; i++) {
+			AxisJogState& jog = m_jogState[i];
+			if (!jog.active) {
+				continue;
+			}
+			if (now - jog.refreshed > kJogDeadman) {
+				jog.active = false;
+				m_activeJogs--;
+				expired = true;
+				continue;
+			}
+			// Single-letter hexapod axes: "X Z W"
+			if (count > 0) {
+				axes[length++] = ' ';
+			}
+			axes[length++] = kHexapodAxes[i][0];
+			targets[count++] = positions[i] + jog.velocity * kJogLookahead;
+			speedSquared += jog.velocity * jog.velocity;
+		}
+	}
+
+	if (expired) {
+		std::cout << "PIController: Jog not refreshed - halting" << std::endl;
+		ProfiledLockGuard commandLock(m_commandMutex);
+		PI_HLT(m_controllerId, kHexapodAxesString);
+	}
+
+	// Released: put the system velocity back
+	if (count == 0) {
+		if (m_jogSystemVelocity > 0.0 && m_jogRestoreVelocity > 0.0) {
+			ProfiledLockGuard commandLock(m_commandMutex);
+			PI_VLS(m_controllerId, m_jogRestoreVelocity);
+		}
+		m_jogSystemVelocity = 0.0;
+		m_jogRestoreVelocity = 0.0;
+		return;
+	}
+
+	// Path speed of the combined jog vector
+	const double speed = std::sqrt(speedSquared);
+	if (std::abs(speed - m_jogSystemVelocity) <= 0.02 * m_jogSystemVelocity) {
+		ProfiledLockGuard commandLock(m_commandMutex);
+		if (PI_MOV(m_controllerId, axes, targets)) {
+			return;
+		}
+		int error = PI_GetError(m_controllerId);
+		std::cout << "PIController: Jog move failed. Error code: " << error << " - stopping jog" << std::endl;
+		ClearJog(-1);
+		return;
+	}
+
+	// Speed changed: VLS and the retarget go out as one batch behind one ERR?
+	if (m_jogSystemVelocity == 0.0) {
+		ProfiledLockGuard commandLock(m_commandMutex);
+		if (!PI_qVLS(m_controllerId, &m_jogRestoreVelocity)) {
+			m_jogRestoreVelocity = 0.0;
+		}
+	}
+	std::vector<std::string> jogAxes;
+	for (int i = 0; i < count; i++) {
+		jogAxes.emplace_back(1, axes[2 * i]);
+	}
+	PICommandPipeline pipeline(*this);
+	pipeline.SetSystemVelocity(speed)
+		.Move(jogAxes, std::vector<double>(targets, targets + count));
+	const PICommandPipeline::Result result = pipeline.Execute();
+	if (!result.success) {
+		std::cout << "PIController: Jog retarget failed - stopping jog" << std::endl
+			<< PICommandPipeline::Describe(result);
+		ClearJog(-1);
+		return;
+	}
+	m_jogSystemVelocity = speed;
+}
+
 // IsMoving optimized to use less frequent direct API calls
 // Updated IsMoving method in PIController with better detection
 // 3. Updated IsMoving method for PIController implementation in pi_controller.cpp
@@ -593,7 +986,7 @@ bool PIController::IsMoving(const std::string& axis) {
 
 		// Explicitly update the cache
 		{
-			std::lock_guard<std::mutex> lock(m_mutex);
+			ProfiledLockGuard lock(m_mutex);
 			m_axisMoving[axis] = (isMovingArray[0] == TRUE);
 		}
 
@@ -608,7 +1001,7 @@ bool PIController::IsMoving(const std::string& axis) {
 		}
 
 		// Keep existing status if query fails
-		std::lock_guard<std::mutex> lock(m_mutex);
+		ProfiledLockGuard lock(m_mutex);
 		auto it = m_axisMoving.find(axis);
 		return (it != m_axisMoving.end() && it->second);
 	}
@@ -623,22 +1016,15 @@ bool PIController::GetPositions(std::map<std::string, double>& positions) {
 	}
 
 	// For C-887, we need space-separated axis names for batch query
-	std::string allAxes = "X Y Z U V W";  // Query all six hexapod axes at once
-
-	// Allocate array for positions - 6 axes for hexapod
-	double posArray[6] = { 0.0 };
-
-	// Query positions in a single API call
-	bool success = PI_qPOS(m_controllerId, allAxes.c_str(), posArray);
+	// Query all six hexapod axes in a single API call
+	double posArray[kHexapodAxisCount] = { 0.0 };
+	bool success = PI_qPOS(m_controllerId, kHexapodAxesString, posArray);
 
 	if (success) {
 		// Fill the map with results
-		positions["X"] = posArray[0];
-		positions["Y"] = posArray[1];
-		positions["Z"] = posArray[2];
-		positions["U"] = posArray[3];
-		positions["V"] = posArray[4];
-		positions["W"] = posArray[5];
+		for (int i = 0; i < kHexapodAxisCount; i++) {
+			positions[kHexapodAxes[i]] = posArray[i];
+		}
 
 		// Log the positions (occasionally to reduce log spam)
 		static int callCount = 0;
@@ -671,8 +1057,7 @@ bool PIController::EnableServo(const std::string& axis, bool enable) {
 	BOOL states[1] = { enable ? TRUE : FALSE };
 
 	if (!PI_SVO(m_controllerId, axes, states)) {
-		int error = 0;
-		PI_qERR(m_controllerId, &error);
+		int error = PI_GetError(m_controllerId);
 		std::cout << "PIController: Failed to set servo state for axis " << axis
 			<< ". Error code: " << error << std::endl;
 		return false;
@@ -694,7 +1079,7 @@ bool PIController::IsServoEnabled(const std::string& axis, bool& enabled) {
 
 	if (elapsed < m_statusUpdateInterval) {
 		// Use cached value if it exists and is recent
-		std::lock_guard<std::mutex> lock(m_mutex);
+		ProfiledLockGuard lock(m_mutex);
 		auto it = m_axisServoEnabled.find(axis);
 		if (it != m_axisServoEnabled.end()) {
 			enabled = it->second;
@@ -712,7 +1097,7 @@ bool PIController::IsServoEnabled(const std::string& axis, bool& enabled) {
 		enabled = (states[0] == TRUE);
 
 		// Update the cache
-		std::lock_guard<std::mutex> lock(m_mutex);
+		ProfiledLockGuard lock(m_mutex);
 		m_axisServoEnabled[axis] = enabled;
 		m_lastStatusUpdate = now;
 		return true;
@@ -732,8 +1117,7 @@ bool PIController::SetVelocity(const std::string& axis, double velocity) {
 	double velocities[1] = { velocity };
 
 	if (!PI_VEL(m_controllerId, axes, velocities)) {
-		int error = 0;
-		PI_qERR(m_controllerId, &error);
+		int error = PI_GetError(m_controllerId);
 		std::cout << "PIController: Failed to set velocity for axis " << axis
 			<< ". Error code: " << error << std::endl;
 		return false;
@@ -767,6 +1151,26 @@ bool PIController::WaitForMotionCompletion(const std::string& axis, double timeo
 		return false;
 	}
 
+	// Settle-tracked move: the communication thread decides when it is done
+	const int axisIndex = HexapodAxisIndex(axis);
+	if (axisIndex >= 0) {
+		ProfiledUniqueLock lock(m_mutex);
+		const AxisSettleState& state = m_settleState[axisIndex];
+		if (state.active) {
+			const uint64_t sequence = state.sequence;
+			const auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::duration<double>(timeoutSeconds));
+
+			if (!m_condVar.wait_for(lock, timeout, [&]() { return state.completedSequence >= sequence; })) {
+				std::cout << "PIController: Timeout waiting for axis " << axis << " to settle" << std::endl;
+				return false;
+			}
+
+			// A later move superseded ours - ours never reached its target
+			return state.completedSequence == sequence && state.lastResult;
+		}
+	}
+
 	// Use system clock for timeout
 	auto startTime = std::chrono::steady_clock::now();
 	int checkCount = 0;
@@ -777,7 +1181,7 @@ bool PIController::WaitForMotionCompletion(const std::string& axis, double timeo
 		// First check if we have recent cached motion status
 		bool stillMoving = false;
 		{
-			std::lock_guard<std::mutex> lock(m_mutex);
+			ProfiledLockGuard lock(m_mutex);
 			auto it = m_axisMoving.find(axis);
 			if (it != m_axisMoving.end()) {
 				stillMoving = it->second;
@@ -790,7 +1194,7 @@ bool PIController::WaitForMotionCompletion(const std::string& axis, double timeo
 			stillMoving = IsMoving(axis);
 
 			// Update the cache
-			std::lock_guard<std::mutex> lock(m_mutex);
+			ProfiledLockGuard lock(m_mutex);
 			m_axisMoving[axis] = stillMoving;
 		}
 
@@ -825,6 +1229,131 @@ bool PIController::WaitForMotionCompletion(const std::string& axis, double timeo
 	}
 }
 
+// === SETTLE DETECTION ===
+
+void PIController::SetSettleSettings(const SettleSettings& settings) {
+	ProfiledLockGuard lock(m_mutex);
+	m_settle = settings;
+
+	std::cout << "PIController: Settle mode " << (settings.mode == SettleMode::OnTarget ? "OnTarget" : "MotionDone")
+		<< " (tolerance " << settings.tolerance << ", dwell " << settings.dwell.count() << " ms)" << std::endl;
+}
+
+PIController::SettleSettings PIController::GetSettleSettings() const {
+	ProfiledLockGuard lock(m_mutex);
+	return m_settle;
+}
+
+bool PIController::IsSettlePending(const std::string& axis) const {
+	const int axisIndex = HexapodAxisIndex(axis);
+	if (axisIndex < 0) {
+		return false;
+	}
+
+	ProfiledLockGuard lock(m_mutex);
+	return m_settleState[axisIndex].active;
+}
+
+void PIController::ArmSettle(const std::string& axis, double target) {
+	const int axisIndex = HexapodAxisIndex(axis);
+	if (axisIndex < 0) {
+		return;
+	}
+
+	ProfiledLockGuard lock(m_mutex);
+	AxisSettleState& state = m_settleState[axisIndex];
+
+	// A new move on the axis supersedes the pending one
+	if (state.active) {
+		CompleteSettle(axisIndex, false);
+	}
+
+	state.active = true;
+	state.target = target;
+	state.sequence++;
+	state.inWindow = false;
+	state.stopped = false;
+	state.armedAt = std::chrono::steady_clock::now();
+	m_pendingSettles.fetch_add(1);
+	m_estimator.SetCommand(axisIndex, state.armedAt, target);
+}
+
+void PIController::CancelSettle(const std::string& axis) {
+	ProfiledLockGuard lock(m_mutex);
+	for (int i = 0; i < kHexapodAxisCount; i++) {
+		if (axis.empty() || kHexapodAxes[i] == axis) {
+			m_estimator.ClearCommand(i);
+			if (m_settleState[i].active) {
+				CompleteSettle(i, false);
+			}
+		}
+	}
+}
+
+// Called with m_mutex held
+void PIController::CompleteSettle(int axisIndex, bool settled) {
+	AxisSettleState& state = m_settleState[axisIndex];
+	state.active = false;
+	state.lastResult = settled;
+	m_estimator.ClearCommand(axisIndex);
+	state.completedSequence = state.sequence;
+	m_pendingSettles.fetch_sub(1);
+	m_condVar.notify_all();
+}
+
+void PIController::EvaluateSettle(std::chrono::steady_clock::time_point sampleTime,
+	const double* positions, const BOOL* moving, const BOOL* onTarget) {
+	ProfiledLockGuard lock(m_mutex);
+	const auto now = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < kHexapodAxisCount; i++) {
+		AxisSettleState& state = m_settleState[i];
+
+		// Reads started before the move was commanded say nothing about it
+		if (!state.active || state.armedAt > sampleTime) {
+			continue;
+		}
+
+		const bool stopped = moving[i] == FALSE;
+		if (stopped && !state.stopped) {
+			state.stoppedSince = now;
+		}
+		state.stopped = stopped;
+
+		if (m_settle.mode == SettleMode::MotionDone) {
+			if (stopped) {
+				CompleteSettle(i, true);
+			}
+			continue;
+		}
+
+		const bool inWindow = stopped && onTarget[i] == TRUE &&
+			std::abs(positions[i] - state.target) <= m_settle.tolerance;
+
+		if (!inWindow) {
+			state.inWindow = false;
+			if (stopped && now - state.stoppedSince >= m_settle.stoppedTimeout) {
+				std::cout << "PIController: Axis " << kHexapodAxes[i] << " stopped " << (positions[i] - state.target)
+					<< " from target without settling" << std::endl;
+				CompleteSettle(i, false);
+			}
+			continue;
+		}
+
+		if (!state.inWindow) {
+			state.inWindow = true;
+			state.windowStart = now;
+		}
+
+		if (now - state.windowStart >= m_settle.dwell) {
+			if (m_enableDebug) {
+				std::cout << "PIController: Axis " << kHexapodAxes[i] << " settled at " << positions[i] << std::endl;
+			}
+			CompleteSettle(i, true);
+		}
+	}
+}
+
 //
 // Updated ConfigureFromDevice method for PIController to handle space-separated InstalledAxes
 //
@@ -876,9 +1405,160 @@ bool PIController::ConfigureFromDevice(const MotionDevice& device) {
 		std::cout << "PIController: Using default hexapod axes: X Y Z U V W" << std::endl;
 	}
 
+	return ApplyAxisLayout();
+}
+
+// Pick the status read for the configured axes - once, not per tick
+bool PIController::ApplyAxisLayout() {
+	// Status buffers are sized for the largest model - refuse rather than poll a subset
+	if (m_availableAxes.size() > static_cast<size_t>(ControllerTraits::kMaxAxisCount)) {
+		std::cout << "PIController: ERROR - " << m_availableAxes.size() << " installed axes, at most "
+			<< ControllerTraits::kMaxAxisCount << " supported" << std::endl;
+		return false;
+	}
+
+	// Only single-letter axes can match a model
+	std::string installed;
+	bool singleLetters = true;
+	for (const auto& axis : m_availableAxes) {
+		if (!installed.empty()) installed += " ";
+		installed += axis;
+		singleLetters &= (axis.size() == 1);
+	}
+
+	m_model = singleLetters ? ControllerTraits::Resolve("PI", installed) : ControllerTraits::Model::Generic;
+	m_readStatus = &PIController::ReadStatusGeneric;
+	ControllerTraits::Dispatch(m_model, [this](auto traits) {
+		using Traits = typename decltype(traits)::Type;
+		m_readStatus = &PIController::ReadStatusFixed<Traits>;
+	});
+
+	m_polledAxisCount = static_cast<int>(m_availableAxes.size());
+	m_polledAxesString.clear();
+	for (int i = 0; i < m_polledAxisCount; i++) {
+		if (i > 0) m_polledAxesString += " ";
+		m_polledAxesString += m_availableAxes[i];
+		m_polledSlot[i] = HexapodAxisIndex(m_availableAxes[i]);
+	}
+
+	std::cout << "PIController: Axis layout " << ControllerTraits::ModelName(m_model) << std::endl;
 	return true;
 }
 
+// Described model: compile-time axis string and slots, no per-tick parsing
+template <typename Traits>
+void PIController::ReadStatusFixed(StatusRead& status, bool onTarget, bool servo) {
+	constexpr int kCount = Traits::kAxisCount;
+	int slots[kCount];
+	for (int i = 0; i < kCount; i++) {
+		slots[i] = ControllerTraits::AxisSlot<Hexapod>(Traits::kAxes[i]);
+		if (slots[i] >= 0) status.slotMask |= (1u << slots[i]);
+	}
+
+	// m_availableAxes matches Traits::kAxes for this model, and the cache
+	// keys already exist, so steady-state ticks do not touch the heap
+	double posArray[kCount] = { 0.0 };
+	status.positionsRead = PI_qPOS(m_controllerId, Traits::kAxesString, posArray) == TRUE;
+	status.positionsAt = std::chrono::steady_clock::now();
+	if (status.positionsRead) {
+		ProfiledLockGuard lock(m_mutex);
+		for (int i = 0; i < kCount; i++) {
+			if (slots[i] >= 0) status.positions[slots[i]] = posArray[i];
+			m_axisPositions[m_availableAxes[i]] = posArray[i];
+		}
+	}
+
+	BOOL movingArray[kCount] = {};
+	status.movingRead = PI_IsMoving(m_controllerId, Traits::kAxesString, movingArray) == TRUE;
+	if (status.movingRead) {
+		ProfiledLockGuard lock(m_mutex);
+		for (int i = 0; i < kCount; i++) {
+			if (slots[i] >= 0) status.moving[slots[i]] = movingArray[i];
+			m_axisMoving[m_availableAxes[i]] = (movingArray[i] == TRUE);
+		}
+	}
+
+	if constexpr (ControllerTraits::Supports<Traits, ControllerTraits::Feature::OnTargetQuery>()) {
+		if (onTarget) {
+			BOOL onTargetArray[kCount] = {};
+			status.onTargetRead = PI_qONT(m_controllerId, Traits::kAxesString, onTargetArray) == TRUE;
+			if (status.onTargetRead) {
+				for (int i = 0; i < kCount; i++) {
+					if (slots[i] >= 0) status.onTarget[slots[i]] = onTargetArray[i];
+				}
+			}
+		}
+	}
+
+	// Servo state changes rarely - one batched query every few ticks
+	if (servo) {
+		BOOL servoArray[kCount] = {};
+		if (PI_qSVO(m_controllerId, Traits::kAxesString, servoArray)) {
+			ProfiledLockGuard lock(m_mutex);
+			for (int i = 0; i < kCount; i++) {
+				m_axisServoEnabled[m_availableAxes[i]] = (servoArray[i] == TRUE);
+			}
+			m_lastStatusUpdate = std::chrono::steady_clock::now();
+		}
+	}
+}
+
+// Any other configured axis set - queries only the installed axes
+void PIController::ReadStatusGeneric(StatusRead& status, bool onTarget, bool servo) {
+	const int count = m_polledAxisCount;
+	if (count == 0) {
+		return;
+	}
+	const char* axes = m_polledAxesString.c_str();
+	for (int i = 0; i < count; i++) {
+		if (m_polledSlot[i] >= 0) status.slotMask |= (1u << m_polledSlot[i]);
+	}
+
+	double posArray[ControllerTraits::kMaxAxisCount] = { 0.0 };
+	status.positionsRead = PI_qPOS(m_controllerId, axes, posArray) == TRUE;
+	status.positionsAt = std::chrono::steady_clock::now();
+	if (status.positionsRead) {
+		ProfiledLockGuard lock(m_mutex);
+		for (int i = 0; i < count; i++) {
+			if (m_polledSlot[i] >= 0) status.positions[m_polledSlot[i]] = posArray[i];
+			m_axisPositions[m_availableAxes[i]] = posArray[i];
+		}
+	}
+
+	BOOL movingArray[ControllerTraits::kMaxAxisCount] = {};
+	status.movingRead = PI_IsMoving(m_controllerId, axes, movingArray) == TRUE;
+	if (status.movingRead) {
+		ProfiledLockGuard lock(m_mutex);
+		for (int i = 0; i < count; i++) {
+			if (m_polledSlot[i] >= 0) status.moving[m_polledSlot[i]] = movingArray[i];
+			m_axisMoving[m_availableAxes[i]] = (movingArray[i] == TRUE);
+		}
+	}
+
+	// Unknown layout: qONT is tried, a controller without it falls back to
+	// the motion state like any other failed read
+	if (onTarget) {
+		BOOL onTargetArray[ControllerTraits::kMaxAxisCount] = {};
+		status.onTargetRead = PI_qONT(m_controllerId, axes, onTargetArray) == TRUE;
+		if (status.onTargetRead) {
+			for (int i = 0; i < count; i++) {
+				if (m_polledSlot[i] >= 0) status.onTarget[m_polledSlot[i]] = onTargetArray[i];
+			}
+		}
+	}
+
+	if (servo) {
+		BOOL servoArray[ControllerTraits::kMaxAxisCount] = {};
+		if (PI_qSVO(m_controllerId, axes, servoArray)) {
+			ProfiledLockGuard lock(m_mutex);
+			for (int i = 0; i < count; i++) {
+				m_axisServoEnabled[m_availableAxes[i]] = (servoArray[i] == TRUE);
+			}
+			m_lastStatusUpdate = std::chrono::steady_clock::now();
+		}
+	}
+}
+
 
 
 bool PIController::MoveToNamedPosition(const std::string& deviceName, const std::string& positionName) {
@@ -896,9 +1576,14 @@ bool PIController::GetPosition(const std::string& axis, double& position) {
 		return false;
 	}
 
+	// Cached values from a stalled communication thread are not live data
+	if (m_dataStale.load()) {
+		return false;
+	}
+
 	// First check if we have a recent cached value
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
+		ProfiledLockGuard lock(m_mutex);
 		auto it = m_axisPositions.find(axis);
 		if (it != m_axisPositions.end()) {
 			position = it->second;
@@ -916,7 +1601,7 @@ bool PIController::GetPosition(const std::string& axis, double& position) {
 		position = positions[0];
 
 		// Update the cache with this new value
-		std::lock_guard<std::mutex> lock(m_mutex);
+		ProfiledLockGuard lock(m_mutex);
 		m_axisPositions[axis] = position;
 	}
 
@@ -929,8 +1614,9 @@ bool PIController::MoveToPositionAll(double x, double y, double z, double u, dou
 		std::cout << "PIController: Cannot move axes - not connected" << std::endl;
 		return false;
 	}
-
-
+	if (!CheckTargetFrame("move all axes")) {
+		return false;
+	}
 
 	std::cout << "PIController: Moving all axes to position X=" << x
 		<< ", Y=" << y
@@ -953,6 +1639,10 @@ bool PIController::MoveToPositionAll(double x, double y, double z, double u, dou
 		return false;
 	}
 
+	for (int i = 0; i < kHexapodAxisCount; i++) {
+		ArmSettle(kHexapodAxes[i], pdValueArray[i]);
+	}
+
 	// If blocking mode, wait for motion to complete on all axes
 	if (blocking) {
 		bool success = true;
@@ -987,39 +1677,38 @@ bool PIController::MoveToPositionMultiAxis(const std::vector<std::string>& axes,
 		std::cout << "PIController: Invalid axes/positions arrays for multi-axis move" << std::endl;
 		return false;
 	}
-
-	// Log the motion command
-	std::stringstream ss;
-	ss << "PIController: Moving multiple axes to positions: ";
-	for (size_t i = 0; i < axes.size(); i++) {
-		ss << axes[i] << "=" << positions[i] << " ";
+	if (!CheckTargetFrame("move axes")) {
+		return false;
 	}
-	
-	std::cout << ss.str() << std::endl;
 
-	// Create space-separated string of axes (e.g., "X Y Z")
-	std::string axesStr;
+	AllocationTracker::Scope allocScope("PIController::MoveToPositionMultiAxis");
+
+	// Log the motion command (streamed directly - no temporary string)
+	std::cout << "PIController: Moving multiple axes to positions: ";
 	for (size_t i = 0; i < axes.size(); i++) {
-		axesStr += axes[i];
-		if (i < axes.size() - 1) {
-			axesStr += " "; // Add space between axes
-		}
+		std::cout << axes[i] << "=" << positions[i] << " ";
 	}
+	std::cout << std::endl;
 
-	// Convert to C-style arrays for PI API
-	const char* szAxes = axesStr.c_str();
-
-	// Create a copy of the positions array that can be modified by the PI API
-	std::vector<double> posArray = positions;
+	// Create space-separated string of axes (e.g., "X Y Z") in a stack buffer
+	char szAxes[kMaxMoveAxes * 4];
+	if (!FormatAxes(axes, szAxes, sizeof(szAxes))) {
+		std::cout << "PIController: Too many axes for multi-axis move" << std::endl;
+		return false;
+	}
 
-	// Call the PI_MOV function to move to the specified positions
-	if (!PI_MOV(m_controllerId, szAxes, posArray.data())) {
+	// PI_MOV takes the positions as const - no copy needed
+	if (!PI_MOV(m_controllerId, szAxes, positions.data())) {
 		int error = PI_GetError(m_controllerId);
 		
 		std::cout << "PIController: Failed to move axes. Error code: " << error << std::endl;
 		return false;
 	}
 
+	for (size_t i = 0; i < axes.size(); i++) {
+		ArmSettle(axes[i], positions[i]);
+	}
+
 	// If blocking, wait for motion to complete on all axes
 	if (blocking) {
 		bool success = true;
@@ -1035,6 +1724,75 @@ bool PIController::MoveToPositionMultiAxis(const std::vector<std::string>& axes,
 	return true;
 }
 
+bool PIController::ValidateMove(const std::vector<std::string>& axes, const std::vector<double>& positions,
+	std::string& reason) {
+	if (!m_isConnected) {
+		reason = "not connected";
+		return false;
+	}
+
+	char szAxes[kMaxMoveAxes * 4];
+	if (axes.empty() || axes.size() != positions.size() || !FormatAxes(axes, szAxes, sizeof(szAxes))) {
+		reason = "invalid axes/positions";
+		return false;
+	}
+	if (!m_coordinateSystems->IsTargetFrameEnabled(reason)) {
+		return false;
+	}
+
+	// Query directly - the servo cache can lag an SVO by a poll interval
+	BOOL servo[kMaxMoveAxes] = { FALSE };
+	if (!PI_qSVO(m_controllerId, szAxes, servo)) {
+		reason = "qSVO failed, error " + std::to_string(PI_GetError(m_controllerId));
+		return false;
+	}
+	for (size_t i = 0; i < axes.size(); i++) {
+		if (!servo[i]) {
+			reason = "servo off on axis " + axes[i];
+			return false;
+		}
+	}
+
+	bool referenced = false;
+	if (!IsReferenced(referenced) || !referenced) {
+		reason = "not referenced";
+		return false;
+	}
+
+	// Virtual move: the controller checks the targets against its workspace limits
+	BOOL movePossible = FALSE;
+	if (!PI_qVMO(m_controllerId, szAxes, positions.data(), &movePossible)) {
+		reason = "qVMO failed, error " + std::to_string(PI_GetError(m_controllerId));
+		return false;
+	}
+	if (!movePossible) {
+		reason = "target outside the reachable workspace";
+		return false;
+	}
+	return true;
+}
+
+bool PIController::StartValidatedMove(const std::vector<std::string>& axes, const std::vector<double>& positions) {
+	char szAxes[kMaxMoveAxes * 4];
+	if (!m_isConnected || axes.size() != positions.size() || !FormatAxes(axes, szAxes, sizeof(szAxes))) {
+		return false;
+	}
+	// Host-side compare only - a frame switched since ValidateMove must not slip through
+	if (!CheckTargetFrame("start validated move")) {
+		return false;
+	}
+
+	if (!PI_MOV(m_controllerId, szAxes, positions.data())) {
+		std::cout << "PIController: Failed to start validated move. Error code: " << PI_GetError(m_controllerId) << std::endl;
+		return false;
+	}
+
+	for (size_t i = 0; i < axes.size(); i++) {
+		ArmSettle(axes[i], positions[i]);
+	}
+	return true;
+}
+
 
 // Add to pi_controller.cpp:
 
@@ -1069,6 +1827,12 @@ bool PIController::FSA(const std::string& axis1, double length1,
 	}
 
 
+	if (!ControllerTraits::ModelSupports(m_model, ControllerTraits::Feature::FastAlignment)) {
+		std::cout << "PIController: Cannot perform FSA scan - not supported by "
+			<< ControllerTraits::ModelName(m_model) << " layout" << std::endl;
+		return false;
+	}
+
 	std::cout << "PIController: Starting FSA scan" << std::endl;
 
 	// Call the PI GCS2 function
@@ -1118,6 +1882,12 @@ bool PIController::FSC(const std::string& axis1, double length1,
 	}
 
 
+	if (!ControllerTraits::ModelSupports(m_model, ControllerTraits::Feature::FastAlignment)) {
+		std::cout << "PIController: Cannot perform FSC scan - not supported by "
+			<< ControllerTraits::ModelName(m_model) << " layout" << std::endl;
+		return false;
+	}
+
 	std::cout << "PIController: Starting FSC scan" << std::endl;
 
 	// Call the PI GCS2 function
@@ -1166,6 +1936,12 @@ bool PIController::FSM(const std::string& axis1, double length1,
 	}
 
 
+	if (!ControllerTraits::ModelSupports(m_model, ControllerTraits::Feature::FastAlignment)) {
+		std::cout << "PIController: Cannot perform FSM scan - not supported by "
+			<< ControllerTraits::ModelName(m_model) << " layout" << std::endl;
+		return false;
+	}
+
 	std::cout << "PIController: Starting FSM scan" << std::endl;
 
 	// Call the PI GCS2 function
@@ -1192,7 +1968,7 @@ bool PIController::CopyPositionToClipboard() {
 	// Create a copy of current positions to avoid locking the mutex for too long
 	std::map<std::string, double> positions;
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
+		ProfiledLockGuard lock(m_mutex);
 		positions = m_axisPositions;
 	}
 
@@ -1251,13 +2027,13 @@ bool PIController::SetSystemVelocity(double velocity) {
 	std::cout << "PIController: Setting system velocity to " << velocity << std::endl;
 
 	if (!PI_VLS(m_controllerId, velocity)) {
-		int error = 0;
-		PI_qERR(m_controllerId, &error);
+		int error = PI_GetError(m_controllerId);
 
 		std::cout << "PIController: Failed to set system velocity. Error code: " << error << std::endl;
 		return false;
 	}
 
+	UpdateEstimatorLimits(velocity);
 	return true;
 }
 
@@ -1267,15 +2043,40 @@ bool PIController::GetSystemVelocity(double& velocity) {
 	}
 
 	if (!PI_qVLS(m_controllerId, &velocity)) {
-		int error = 0;
-		PI_qERR(m_controllerId, &error);
+		int error = PI_GetError(m_controllerId);
 
 		std::cout << "PIController: Failed to get system velocity. Error code: " << error << std::endl;
 		return false;
 	}
 
+	UpdateEstimatorLimits(velocity);
 	return true;
 }
+
+// VLS limits the linear path speed; U V W are left to the observed velocity
+void PIController::UpdateEstimatorLimits(double systemVelocity) {
+	for (int i = 0; i < 3; i++) {
+		m_estimator.SetMaxVelocity(i, systemVelocity);
+	}
+}
+
+bool PIController::GetEstimatedPosition(const std::string& axis, AxisStateEstimator::Estimate& estimate,
+	std::chrono::steady_clock::time_point time) const {
+	const int axisIndex = HexapodAxisIndex(axis);
+	if (axisIndex < 0) {
+		return false;
+	}
+	estimate = m_estimator.Query(axisIndex, time);
+	return estimate.valid;
+}
+
+// Homing and referencing move the axis to a target the estimator never saw
+void PIController::ClearEstimatorCommand(const std::string& axis) {
+	const int axisIndex = HexapodAxisIndex(axis);
+	if (axisIndex >= 0) {
+		m_estimator.ClearCommand(axisIndex);
+	}
+}
 // Add these to your pi_controller.cpp file:
 
 bool PIController::Home(const std::string& axis) {
@@ -1296,6 +2097,7 @@ bool PIController::Home(const std::string& axis) {
 	// }
 
 	std::cout << "PIController: Homing axis: " << axis << std::endl;
+	ClearEstimatorCommand(axis);
 
 	// Call PI_GOH with single axis
 	BOOL result = PI_GOH(m_controllerId, axis.c_str());
@@ -1318,6 +2120,7 @@ bool PIController::HomeAll() {
 	}
 
 	std::cout << "PIController: Homing all axes" << std::endl;
+	m_estimator.ClearCommand(-1);
 
 	// Call PI_GOH with empty string to home all axes
 	BOOL result = PI_GOH(m_controllerId, "");
@@ -1355,6 +2158,9 @@ bool PIController::HomeAxes(const std::vector<std::string>& axes) {
 	std::string axesString = AxesToString(axes);
 
 	std::cout << "PIController: Homing axes: " << axesString << std::endl;
+	for (const std::string& axis : axes) {
+		ClearEstimatorCommand(axis);
+	}
 
 	// Call PI_GOH with axes string
 	BOOL result = PI_GOH(m_controllerId, axesString.c_str());
@@ -1382,6 +2188,7 @@ bool PIController::HomeAxes(const std::string& axesString) {
 	}
 
 	std::cout << "PIController: Homing axes: " << axesString << std::endl;
+	m_estimator.ClearCommand(-1);
 
 	// Call PI_GOH with provided axes string
 	BOOL result = PI_GOH(m_controllerId, axesString.c_str());
@@ -1397,6 +2204,82 @@ bool PIController::HomeAxes(const std::string& axesString) {
 	return true;
 }
 
+// === REFERENCING ===
+
+bool PIController::ReferenceAll() {
+	if (!IsConnected()) {
+		std::cerr << "PIController::ReferenceAll failed: Controller not connected" << std::endl;
+		return false;
+	}
+
+	std::cout << "PIController: Starting reference move (FRF)" << std::endl;
+	m_estimator.ClearCommand(-1);
+
+	// Empty axis string references the whole hexapod
+	if (!PI_FRF(m_controllerId, "")) {
+		int errorCode = PI_GetError(m_controllerId);
+		std::cerr << "PIController::ReferenceAll failed with PI error: " << errorCode << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool PIController::IsReferenced(bool& referenced) {
+	if (!IsConnected()) {
+		return false;
+	}
+
+	BOOL referencedArray[kHexapodAxisCount] = { FALSE, FALSE, FALSE, FALSE, FALSE, FALSE };
+	if (!PI_qFRF(m_controllerId, kHexapodAxesString, referencedArray)) {
+		return false;
+	}
+
+	referenced = std::all_of(std::begin(referencedArray), std::end(referencedArray),
+		[](BOOL value) { return value == TRUE; });
+	return true;
+}
+
+// Referenced on every axis and no longer moving, queried directly (qFRF / #5).
+// With Force on an already referenced hexapod qFRF never drops, so completion
+// also needs the reference motion to have been seen - or, for a move too short
+// to catch, a grace period without any motion after FRF was issued.
+bool PIController::WaitForReferencing(double timeoutSeconds, const std::atomic<bool>* cancel) {
+	constexpr auto kReferenceStartGrace = std::chrono::seconds(2);
+
+	const auto waitStart = std::chrono::steady_clock::now();
+	const auto deadline = waitStart + std::chrono::milliseconds(static_cast<int>(timeoutSeconds * 1000.0));
+	bool sawMotion = false;
+
+	while (std::chrono::steady_clock::now() < deadline) {
+		if (!IsConnected()) {
+			std::cerr << "PIController::WaitForReferencing failed: Controller disconnected" << std::endl;
+			return false;
+		}
+		if (cancel && cancel->load()) {
+			return false;
+		}
+
+		BOOL movingArray[kHexapodAxisCount] = { FALSE, FALSE, FALSE, FALSE, FALSE, FALSE };
+		if (PI_IsMoving(m_controllerId, kHexapodAxesString, movingArray)) {
+			const bool moving = std::any_of(std::begin(movingArray), std::end(movingArray),
+				[](BOOL value) { return value == TRUE; });
+			sawMotion |= moving;
+
+			bool referenced = false;
+			const bool started = sawMotion || std::chrono::steady_clock::now() - waitStart >= kReferenceStartGrace;
+			if (!moving && started && IsReferenced(referenced) && referenced) {
+				std::cout << "PIController: Reference move complete" << std::endl;
+				return true;
+			}
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	std::cerr << "PIController::WaitForReferencing timed out after " << timeoutSeconds << " s" << std::endl;
+	return false;
+}
+
 bool PIController::DefineHome(const std::string& axis) {
 	if (!IsConnected()) {
 		std::cerr << "PIController::DefineHome failed: Controller not connected" << std::endl;
@@ -1463,6 +2346,34 @@ bool PIController::DefineHomeAll() {
 	return success;
 }
 
+// Allocation-free variant of AxesToString for command paths
+// MOV/MVR are interpreted in the enabled frame - targets in any other frame land elsewhere
+bool PIController::CheckTargetFrame(const char* action) const {
+	std::string reason;
+	if (m_coordinateSystems->IsTargetFrameEnabled(reason)) {
+		return true;
+	}
+	std::cout << "PIController: Cannot " << action << " - " << reason << std::endl;
+	return false;
+}
+
+bool PIController::FormatAxes(const std::vector<std::string>& axes, char* buffer, size_t bufferSize) const {
+	size_t length = 0;
+	for (size_t i = 0; i < axes.size(); i++) {
+		const size_t needed = axes[i].size() + (i > 0 ? 1 : 0);
+		if (length + needed >= bufferSize) {
+			return false;
+		}
+		if (i > 0) {
+			buffer[length++] = ' ';
+		}
+		std::memcpy(buffer + length, axes[i].data(), axes[i].size());
+		length += axes[i].size();
+	}
+	buffer[length] = '\0';
+	return true;
+}
+
 std::string PIController::AxesToString(const std::vector<std::string>& axes) const {
 	if (axes.empty()) {
 		return "";
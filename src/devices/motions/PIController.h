@@ -8,16 +8,39 @@
 #include <condition_variable>
 #include <vector>
 #include <map>
+#include <memory>
+#include "AxisStateEstimator.h"
+#include "ControllerTraits.h"
 #include "MotionTypes.h"
+#include "../../core/HealthWatchdog.h"
+#include "../../utils/ProfiledMutex.h"
 #include <iomanip>
 
 // Include PI GCS2 library
 #include "PI_GCS2_DLL.h"
 
 
+class PICoordinateSystems;
+class IOExecutor;
+
 class PIController {
 public:
-  PIController();
+  // When a move counts as complete
+  enum class SettleMode {
+    MotionDone,   // Trajectory finished (PI_IsMoving == FALSE)
+    OnTarget      // PI_qONT on target and within tolerance of the target for the dwell window
+  };
+
+  struct SettleSettings {
+    SettleMode mode = SettleMode::OnTarget;
+    double tolerance = 0.001;                          // Axis units (mm / deg)
+    std::chrono::milliseconds dwell{ 20 };             // Must stay inside the window this long
+    std::chrono::milliseconds stoppedTimeout{ 1000 };  // Stopped but never settled -> move failed
+  };
+
+  // With an executor the status polling runs as a task on its shared workers
+  // instead of on a thread of its own (see utils/IOExecutor.h)
+  explicit PIController(IOExecutor* executor = nullptr);
   ~PIController();
 
   // Toggle verbose debug output
@@ -44,6 +67,12 @@ public:
   bool GetPosition(const std::string& axis, double& position);
   bool GetPositions(std::map<std::string, double>& positions);
 
+  // Position between polls from the estimator - for displays and collision
+  // prediction; the cached GetPosition only changes once per poll
+  bool GetEstimatedPosition(const std::string& axis, AxisStateEstimator::Estimate& estimate,
+    std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now()) const;
+  AxisStateEstimator& GetEstimator() { return m_estimator; }
+
   // Servo control
   bool EnableServo(const std::string& axis, bool enable);
   bool IsServoEnabled(const std::string& axis, bool& enabled);
@@ -65,18 +94,54 @@ public:
   // Helper methods
   bool WaitForMotionCompletion(const std::string& axis, double timeoutSeconds = 30.0);
 
+  // Settle detection for MOV/MVR moves, evaluated by the communication thread
+  void SetSettleSettings(const SettleSettings& settings);
+  SettleSettings GetSettleSettings() const;
+  bool IsSettlePending(const std::string& axis) const;
+
+  // Continuous jog. Hexapods have no velocity mode: every communication tick
+  // retargets a MOV kJogLookahead seconds of travel ahead of the current
+  // position, at the jog speed (VLS). Call every UI frame while the input is
+  // held; 0 halts. An unrefreshed jog is halted after kJogDeadman.
+  bool Jog(const std::string& axis, double velocity);
+  bool StopJog();
+  bool IsJogging() const { return m_activeJogs.load() > 0; }
+
+  // Held from a command batch to its ERR? (PICommandPipeline) and by the
+  // communication thread around its reads, so neither sees the other's error
+  ProfiledMutex& GetCommandMutex() { return m_commandMutex; }
+
+  // Model matched to the configured axes (see ControllerTraits.h)
+  ControllerTraits::Model GetModel() const { return m_model; }
+
+  // Work/tool frames on the controller (KSW/KST/KEN) - synced on every connect
+  PICoordinateSystems& GetCoordinateSystems() { return *m_coordinateSystems; }
+
   // Multi-axis moves
   bool MoveToPositionAll(double x, double y, double z, double u, double v, double w, bool blocking = true);
   bool MoveToPositionMultiAxis(const std::vector<std::string>& axes,
     const std::vector<double>& positions,
     bool blocking = true);
 
+  // Two-phase start for MotionTransaction: ValidateMove checks servo,
+  // referencing and reachability (PI_qVMO) without moving; StartValidatedMove
+  // then sends only the MOV, with no logging or queries in front of it
+  bool ValidateMove(const std::vector<std::string>& axes, const std::vector<double>& positions,
+    std::string& reason);
+  bool StartValidatedMove(const std::vector<std::string>& axes, const std::vector<double>& positions);
+
   // Home axis functions
   bool Home(const std::string& axis);
   bool HomeAll();
   bool HomeAxes(const std::vector<std::string>& axes);
   bool HomeAxes(const std::string& axesString);  // Space-separated axes like "X Y Z"
 
+  // Reference move (FRF) - required after power-up before absolute moves
+  bool ReferenceAll();
+  bool IsReferenced(bool& referenced);
+  // Call right after ReferenceAll - completion requires the reference motion to have run
+  bool WaitForReferencing(double timeoutSeconds = 120.0, const std::atomic<bool>* cancel = nullptr);
+
   // Set home position definition (if controller supports PI_DFH)
   bool DefineHome(const std::string& axis);
   bool DefineHomeAll();
@@ -103,13 +168,19 @@ public:
   // NEW: Analog reading methods
   bool GetAnalogChannelCount(int& numChannels);
   bool GetAnalogVoltage(int channel, double& voltage);
-  bool GetAnalogVoltages(std::vector<int> channels, std::map<int, double>& voltages);
+  bool GetAnalogVoltages(const std::vector<int>& channels, std::map<int, double>& voltages);
 
   // Enable/disable analog reading in communication thread
   void EnableAnalogReading(bool enable) { m_enableAnalogReading = enable; }
   bool IsAnalogReadingEnabled() const { return m_enableAnalogReading; }
 
-  void StopCommunicationThread();
+  // Returns false if the thread is still blocked in a controller call after the timeout
+  bool StopCommunicationThread(std::chrono::milliseconds timeout = std::chrono::milliseconds(2000));
+
+  // Health monitoring (see core/HealthWatchdog.h)
+  bool IsDataStale() const { return m_dataStale.load(); }
+  bool Reconnect();
+  void SetWatchdogPolicy(std::chrono::milliseconds deadline, HealthWatchdog::Recovery recovery);
 
 private:
   bool m_debugVerbose = false;
@@ -118,17 +189,112 @@ private:
   // Communication thread methods
   void StartCommunicationThread();
   void CommunicationThreadFunc();
+  // Per-device name for the thread report and executor tasks
+  std::string CommThreadName() const;
+  // One poll cycle; returns the delay until the next one
+  std::chrono::milliseconds CommunicationTick();
+
+  // Batched status reads of one tick, scattered to hexapod slots (X Y Z U V W)
+  // so settle, jog and estimator code is shared by every layout
+  struct StatusRead {
+    double positions[ControllerTraits::kMaxAxisCount] = { 0.0 };
+    BOOL moving[ControllerTraits::kMaxAxisCount] = { FALSE, FALSE, FALSE, FALSE, FALSE, FALSE };
+    BOOL onTarget[ControllerTraits::kMaxAxisCount] = { TRUE, TRUE, TRUE, TRUE, TRUE, TRUE };
+    uint32_t slotMask = 0;                   // Bit i = slot i was polled
+    bool positionsRead = false;
+    bool movingRead = false;
+    bool onTargetRead = false;
+    std::chrono::steady_clock::time_point positionsAt;
+  };
+
+  // Axis layout, resolved from InstalledAxes at configuration: the model picks
+  // the ReadStatus variant, so the comm thread never queries axes that are
+  // not installed and a known model uses its compile-time axis string.
+  // False for more axes than the status buffers hold (kMaxAxisCount)
+  bool ApplyAxisLayout();
+  template <typename Traits>
+  void ReadStatusFixed(StatusRead& status, bool onTarget, bool servo);
+  void ReadStatusGeneric(StatusRead& status, bool onTarget, bool servo);
+  ControllerTraits::Model m_model = ControllerTraits::Model::PIHexapodC887;
+  void (PIController::*m_readStatus)(StatusRead&, bool, bool) =
+    &PIController::ReadStatusFixed<ControllerTraits::PIHexapodC887>;
+  std::string m_polledAxesString;            // Generic layout only
+  int m_polledSlot[ControllerTraits::kMaxAxisCount] = { 0 };
+  int m_polledAxisCount = 0;
+
+  // Settle tracking per hexapod axis (indexed X Y Z U V W). A move arms its
+  // axes; the communication thread completes them from its batched reads and
+  // wakes waiters on m_condVar. Sequence numbers tell a waiter whether the
+  // completion it sees belongs to its own move or to a later one.
+  struct AxisSettleState {
+    bool active = false;
+    double target = 0.0;
+    uint64_t sequence = 0;             // Last armed move
+    uint64_t completedSequence = 0;    // Last completed move
+    bool lastResult = false;
+    bool inWindow = false;
+    bool stopped = false;
+    std::chrono::steady_clock::time_point armedAt;
+    std::chrono::steady_clock::time_point windowStart;
+    std::chrono::steady_clock::time_point stoppedSince;
+  };
+  void ArmSettle(const std::string& axis, double target);
+  void CancelSettle(const std::string& axis);  // Empty = all axes
+  void EvaluateSettle(std::chrono::steady_clock::time_point sampleTime,
+    const double* positions, const BOOL* moving, const BOOL* onTarget);
+  void CompleteSettle(int axisIndex, bool settled);  // Called with m_mutex held
+  void UpdateEstimatorLimits(double systemVelocity);
+  void ClearEstimatorCommand(const std::string& axis);
+
+  SettleSettings m_settle;
+  AxisSettleState m_settleState[ControllerTraits::PIHexapodC887::kAxisCount];
+  std::atomic<int> m_pendingSettles{ 0 };
+
+  // Jog state per hexapod axis (indexed X Y Z U V W), guarded by m_mutex.
+  // m_jogMutex serialises the jog MOVs with the release HLT, so a retarget
+  // computed before a release can never be sent after it.
+  struct AxisJogState {
+    bool active = false;
+    double velocity = 0.0;
+    std::chrono::steady_clock::time_point refreshed;
+  };
+  void UpdateJog(const double* positions);   // Communication thread
+  void ClearJog(int axisIndex);              // -1 = all axes
+  AxisJogState m_jogState[ControllerTraits::PIHexapodC887::kAxisCount];
+  std::atomic<int> m_activeJogs{ 0 };
+  std::mutex m_jogMutex;
+  double m_jogRestoreVelocity = 0.0;         // VLS before the jog, communication thread only
+  double m_jogSystemVelocity = 0.0;          // VLS set for the jog, 0 = none
+  static constexpr std::chrono::milliseconds kJogDeadman{ 300 };
+  static constexpr double kJogLookahead = 0.15;   // Seconds of travel ahead of the position
 
   // NEW: Analog reading methods for communication thread
   void UpdateAnalogReadings();
   void InitializeAnalogChannels();
 
+  // Shared-memory telemetry (see core/TelemetrySegment.h)
+  void PublishTelemetry();
+  std::atomic<int> m_telemetrySlot{ -1 };
+  uint64_t m_telemetryFrame = 0;
+
+  // Watchdog channel for the communication thread
+  void RegisterWatchdog();
+  std::atomic<int> m_watchdogId{ -1 };
+  std::atomic<bool> m_dataStale{ false };
+  std::atomic<bool> m_threadExited{ true };
+  std::chrono::milliseconds m_watchdogDeadline{ 1000 };
+  HealthWatchdog::Recovery m_watchdogRecovery = HealthWatchdog::Recovery::Reconnect;
+
   std::string m_windowTitle = "PI Controller";
 
   // Thread-related members
   std::thread m_communicationThread;
-  std::mutex m_mutex;
-  std::condition_variable m_condVar;
+  IOExecutor* m_executor = nullptr;
+  uint64_t m_executorTask = 0;
+  int m_frameCounter = 0;
+  mutable ProfiledMutex m_mutex{ "PIController::m_mutex" };
+  ProfiledMutex m_commandMutex{ "PIController::m_commandMutex" };   // Before m_mutex when both are taken
+  std::condition_variable_any m_condVar;
 
   std::atomic<bool> m_threadRunning{ false };
   std::atomic<bool> m_terminateThread{ false };
@@ -144,6 +310,7 @@ private:
   std::map<std::string, double> m_axisPositions;
   std::map<std::string, bool> m_axisMoving;
   std::map<std::string, bool> m_axisServoEnabled;
+  AxisStateEstimator m_estimator;   // Slots in X Y Z U V W order, fed by every qPOS
 
   // NEW: Analog reading state
   std::atomic<bool> m_enableAnalogReading{ true };  // Enable by default
@@ -168,6 +335,11 @@ private:
 
   bool m_enableDebug = false;  // Add this line
 
+  // Host-side model of the controller's coordinate systems
+  std::unique_ptr<PICoordinateSystems> m_coordinateSystems;
+  bool CheckTargetFrame(const char* action) const;  // Refuses moves while another frame is enabled
+
   // Helper method to convert vector of axes to space-separated string
   std::string AxesToString(const std::vector<std::string>& axes) const;
+  bool FormatAxes(const std::vector<std::string>& axes, char* buffer, size_t bufferSize) const;
 };
\ No newline at end of file
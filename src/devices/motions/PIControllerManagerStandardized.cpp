@@ -1,5 +1,7 @@
 #include "PIControllerManagerStandardized.h"
 #include "PIController.h"
+#include "PICoordinateSystems.h"
+#include "HomingOrchestrator.h"
 #include "MotionTypes.h"
 #include "core/ConfigRegistry.h"
 #include <iostream>
@@ -8,10 +10,12 @@
 #include <algorithm>
 
 // Constructor
-PIControllerManagerStandardized::PIControllerManagerStandardized(ConfigManager& configManager, bool hardwareMode)
+PIControllerManagerStandardized::PIControllerManagerStandardized(ConfigManager& configManager, bool hardwareMode,
+	const std::string& station)
 	: DeviceManagerBase("PI_Controller_Manager"),
 	m_configManager(configManager),
-	m_hardwareMode(hardwareMode) {
+	m_hardwareMode(hardwareMode),
+	m_station(station) {
 
 	//std::cout << "PIControllerManagerStandardized: Created "
 	//	<< (m_hardwareMode ? "[HARDWARE MODE]" : "[MOCK MODE]") << std::endl;
@@ -62,21 +66,29 @@ bool PIControllerManagerStandardized::ConnectAll() {
 	bool allSuccess = true;
 
 	if (m_hardwareMode) {
-		// Connect to real hardware - only enabled devices
-		std::lock_guard<std::mutex> lock(m_devicesMutex);
-		for (const auto& [deviceName, config] : m_deviceConfigs) {
-			if (config.isEnabled) {
-				std::cout << "  Connecting to enabled device: " << deviceName << std::endl;
-				if (!CreateRealDevice(deviceName)) {
-					std::cout << "  Failed to connect: " << deviceName << std::endl;
-					allSuccess = false;
+		// Connect to real hardware - only enabled devices. CreateRealDevice takes
+		// m_devicesMutex itself, so the list is copied and the lock released first.
+		std::vector<std::string> enabledDevices;
+		{
+			ProfiledLockGuard lock(m_devicesMutex);
+			for (const auto& [deviceName, config] : m_deviceConfigs) {
+				if (config.isEnabled) {
+					enabledDevices.push_back(deviceName);
 				}
 				else {
-					std::cout << "  Successfully connected: " << deviceName << std::endl;
+					std::cout << "  Skipping disabled device: " << deviceName << std::endl;
 				}
 			}
+		}
+
+		for (const auto& deviceName : enabledDevices) {
+			std::cout << "  Connecting to enabled device: " << deviceName << std::endl;
+			if (!CreateRealDevice(deviceName)) {
+				std::cout << "  Failed to connect: " << deviceName << std::endl;
+				allSuccess = false;
+			}
 			else {
-				std::cout << "  Skipping disabled device: " << deviceName << std::endl;
+				std::cout << "  Successfully connected: " << deviceName << std::endl;
 			}
 		}
 	}
@@ -108,7 +120,7 @@ bool PIControllerManagerStandardized::DisconnectAll() {
 
 		// Move all devices out of the map while holding the lock
 		{
-			std::lock_guard<std::mutex> lock(m_devicesMutex);
+			ProfiledLockGuard lock(m_devicesMutex);
 			devicesToDestroy.reserve(m_realDevices.size());
 
 			for (auto& [name, device] : m_realDevices) {
@@ -167,7 +179,7 @@ const PIController* PIControllerManagerStandardized::GetDevice(const std::string
 
 int PIControllerManagerStandardized::GetDeviceCount() const {
 	if (m_hardwareMode) {
-		std::lock_guard<std::mutex> lock(m_devicesMutex);
+		ProfiledLockGuard lock(m_devicesMutex);
 		return static_cast<int>(m_deviceConfigs.size());
 	}
 	else {
@@ -177,7 +189,7 @@ int PIControllerManagerStandardized::GetDeviceCount() const {
 
 std::vector<std::string> PIControllerManagerStandardized::GetDeviceNames() const {
 	if (m_hardwareMode) {
-		std::lock_guard<std::mutex> lock(m_devicesMutex);
+		ProfiledLockGuard lock(m_devicesMutex);
 		std::vector<std::string> names;
 		names.reserve(m_deviceConfigs.size());
 		for (const auto& [name, config] : m_deviceConfigs) {
@@ -236,7 +248,7 @@ bool PIControllerManagerStandardized::DisconnectDevice(const std::string& device
 
 		// Move device out of map while holding lock briefly
 		{
-			std::lock_guard<std::mutex> lock(m_devicesMutex);
+			ProfiledLockGuard lock(m_devicesMutex);
 			auto it = m_realDevices.find(deviceName);
 			if (it != m_realDevices.end()) {
 				deviceToDestroy = std::move(it->second);
@@ -291,7 +303,7 @@ bool PIControllerManagerStandardized::AddDeviceConfig(const std::string& deviceN
 		return false;
 	}
 
-	std::lock_guard<std::mutex> lock(m_devicesMutex);
+	ProfiledLockGuard lock(m_devicesMutex);
 
 	PIDeviceConfig config(deviceName, ipAddress, port);
 	if (!ValidateDeviceConfig(config)) {
@@ -305,7 +317,7 @@ bool PIControllerManagerStandardized::AddDeviceConfig(const std::string& deviceN
 }
 
 bool PIControllerManagerStandardized::RemoveDeviceConfig(const std::string& deviceName) {
-	std::lock_guard<std::mutex> lock(m_devicesMutex);
+	ProfiledLockGuard lock(m_devicesMutex);
 
 	// Disconnect if connected
 	auto deviceIt = m_realDevices.find(deviceName);
@@ -329,7 +341,7 @@ PIControllerManagerStandardized::PIDeviceConfig PIControllerManagerStandardized:
 }
 
 std::vector<PIControllerManagerStandardized::PIDeviceConfig> PIControllerManagerStandardized::GetAllDeviceConfigs() const {
-	std::lock_guard<std::mutex> lock(m_devicesMutex);
+	ProfiledLockGuard lock(m_devicesMutex);
 	std::vector<PIDeviceConfig> configs;
 	configs.reserve(m_deviceConfigs.size());
 	for (const auto& [name, config] : m_deviceConfigs) {
@@ -379,7 +391,7 @@ void PIControllerManagerStandardized::AddMockDevice(const std::string& deviceNam
 
 int PIControllerManagerStandardized::GetConnectedDeviceCount() const {
 	if (m_hardwareMode) {
-		std::lock_guard<std::mutex> lock(m_devicesMutex);
+		ProfiledLockGuard lock(m_devicesMutex);
 		int count = 0;
 		for (const auto& [name, device] : m_realDevices) {
 			if (device && device->IsConnected()) {
@@ -414,8 +426,13 @@ void PIControllerManagerStandardized::PrintDeviceStatus() const {
 	std::cout << "=== PI Controller Device Status ===" << std::endl;
 
 	if (m_hardwareMode) {
-		std::lock_guard<std::mutex> lock(m_devicesMutex);
-		for (const auto& [deviceName, config] : m_deviceConfigs) {
+		// Copy first - the lookups below take m_devicesMutex themselves
+		std::unordered_map<std::string, PIDeviceConfig> configs;
+		{
+			ProfiledLockGuard lock(m_devicesMutex);
+			configs = m_deviceConfigs;
+		}
+		for (const auto& [deviceName, config] : configs) {
 			bool connected = IsRealDeviceConnected(deviceName);
 			std::cout << "  " << deviceName << ": "
 				<< (config.isEnabled ? "ENABLED" : "DISABLED") << " | "
@@ -444,18 +461,48 @@ void PIControllerManagerStandardized::PrintDeviceStatus() const {
 
 // === BATCH OPERATIONS ===
 
+// One phase of forced FRF steps: every hexapod references at the same time and
+// the call returns once all are referenced. Blocks - never call from a comm thread.
+// Machine homing with the gantry phases goes through Services.Homing() instead.
 bool PIControllerManagerStandardized::HomeAllDevices() {
 	std::cout << "PIControllerManagerStandardized: Homing all connected devices..." << std::endl;
 
+	nlohmann::json steps = nlohmann::json::array();
+	for (const std::string& deviceName : GetConnectedDeviceNames()) {
+		steps.push_back({ { "Type", "PIReference" }, { "Device", deviceName }, { "Force", true } });
+	}
+	if (steps.empty()) {
+		std::cout << "  No connected devices to home" << std::endl;
+		return true;
+	}
+
+	HomingOrchestrator homing(nullptr, this);
+	nlohmann::json plan = { { "Phases", nlohmann::json::array({ { { "Name", "PI reference" }, { "Steps", steps } } }) } };
+	if (!homing.LoadPlan(plan)) {
+		return false;
+	}
+
+	HomingOrchestrator::Result result = homing.Start().get();
+	for (const auto& step : result.steps) {
+		if (step.state == HomingOrchestrator::StepState::Failed) {
+			std::cout << "  Failed to home device: " << step.device << " - " << step.message << std::endl;
+		}
+	}
+	return result.success;
+}
+
+bool PIControllerManagerStandardized::StopAllDevices() {
+	std::cout << "PIControllerManagerStandardized: Stopping all connected devices..." << std::endl;
+
 	bool allSuccess = true;
 	auto connectedDevices = GetConnectedDeviceNames();
 
 	for (const std::string& deviceName : connectedDevices) {
 		PIController* device = GetDevice(deviceName);
 		if (device && device->IsConnected()) {
-			std::cout << "  Homing device: " << deviceName << std::endl;
-			if (!device->HomeAll()) {
-				std::cout << "  Failed to home device: " << deviceName << std::endl;
+			std::cout << "  Stopping device: " << deviceName << std::endl;
+			if (!device->StopAllAxes()) {
+				std::cout << "  Failed to stop device: " << deviceName << std::endl;
 				allSuccess = false;
 			}
 		}
@@ -464,8 +511,16 @@ bool PIControllerManagerStandardized::HomeAllDevices() {
 	return allSuccess;
 }
 
-bool PIControllerManagerStandardized::StopAllDevices() {
-	std::cout << "PIControllerManagerStandardized: Stopping all connected devices..." << std::endl;
+// Frames that are already on a controller cost a single KEN per hexapod
+bool PIControllerManagerStandardized::ApplyProductFrames(const std::string& product) {
+	std::cout << "PIControllerManagerStandardized: Switching to " << product << " coordinate systems..." << std::endl;
+
+	if (!m_configManager.HasConfig(ConfigRegistry::Files::COORDINATE_SYSTEMS) &&
+		!m_configManager.LoadConfig(ConfigRegistry::Files::COORDINATE_SYSTEMS)) {
+		std::cout << "  " << ConfigRegistry::Files::COORDINATE_SYSTEMS << " not available" << std::endl;
+		return false;
+	}
+	auto config = m_configManager.GetConfig(ConfigRegistry::Files::COORDINATE_SYSTEMS);
 
 	bool allSuccess = true;
 	auto connectedDevices = GetConnectedDeviceNames();
@@ -473,9 +528,8 @@ bool PIControllerManagerStandardized::StopAllDevices() {
 	for (const std::string& deviceName : connectedDevices) {
 		PIController* device = GetDevice(deviceName);
 		if (device && device->IsConnected()) {
-			std::cout << "  Stopping device: " << deviceName << std::endl;
-			if (!device->StopAllAxes()) {
-				std::cout << "  Failed to stop device: " << deviceName << std::endl;
+			if (!device->GetCoordinateSystems().ApplyProduct(config, product, deviceName)) {
+				std::cout << "  Failed to apply " << product << " frames on device: " << deviceName << std::endl;
 				allSuccess = false;
 			}
 		}
@@ -488,7 +542,7 @@ std::vector<std::string> PIControllerManagerStandardized::GetConnectedDeviceName
 	std::vector<std::string> connected;
 
 	if (m_hardwareMode) {
-		std::lock_guard<std::mutex> lock(m_devicesMutex);
+		ProfiledLockGuard lock(m_devicesMutex);
 		for (const auto& [name, device] : m_realDevices) {
 			if (device && device->IsConnected()) {
 				connected.push_back(name);
@@ -513,7 +567,7 @@ void PIControllerManagerStandardized::LoadDevicesFromConfig() {
 
 	// Clear existing data
 	{
-		std::lock_guard<std::mutex> lock(m_devicesMutex);
+		ProfiledLockGuard lock(m_devicesMutex);
 		m_deviceConfigs.clear();
 	}
 	m_mockDeviceNames.clear();
@@ -526,6 +580,10 @@ void PIControllerManagerStandardized::LoadDevicesFromConfig() {
 		int piDeviceCount = 0;
 		for (const auto& device : devices) {
 			if (device.typeController == "PI") {
+				if (!m_station.empty() && device.station != m_station) {
+					continue;
+				}
+
 				PIDeviceConfig config;
 				config.name = device.name;
 				config.ipAddress = device.ipAddress;
@@ -535,7 +593,7 @@ void PIControllerManagerStandardized::LoadDevicesFromConfig() {
 				config.installAxes = device.installAxes;
 
 				{
-					std::lock_guard<std::mutex> lock(m_devicesMutex);
+					ProfiledLockGuard lock(m_devicesMutex);
 					m_deviceConfigs[device.name] = config;
 				}
 
@@ -551,7 +609,8 @@ void PIControllerManagerStandardized::LoadDevicesFromConfig() {
 		}
 
 		std::cout << "PIControllerManagerStandardized: Loaded " << piDeviceCount
-			<< " PI devices from configuration" << std::endl;
+			<< " PI devices from configuration"
+			<< (m_station.empty() ? "" : " for station " + m_station) << std::endl;
 
 	}
 	catch (const std::exception& e) {
@@ -571,7 +630,7 @@ void PIControllerManagerStandardized::CreateDefaultConfigs() {
 	};
 
 	{
-		std::lock_guard<std::mutex> lock(m_devicesMutex);
+		ProfiledLockGuard lock(m_devicesMutex);
 		for (const auto& [name, ip, port] : defaultDevices) {
 			PIDeviceConfig config(name, ip, port);
 			m_deviceConfigs[name] = config;
@@ -596,7 +655,7 @@ bool PIControllerManagerStandardized::CreateRealDevice(const std::string& device
 			<< " @ " << config->ipAddress << ":" << config->port << std::endl;
 
 		// Create PIController instance
-		auto device = std::make_unique<PIController>();
+		auto device = std::make_unique<PIController>(m_executor);
 
 		// Create MotionDevice for configuration
 		MotionDevice motionDevice = CreateMotionDeviceFromConfig(*config);
@@ -606,6 +665,7 @@ bool PIControllerManagerStandardized::CreateRealDevice(const std::string& device
 			std::cout << "  Failed to configure PI device: " << deviceName << std::endl;
 			return false;
 		}
+		ApplySettleSettings(*device);
 
 		// Attempt connection
 		if (device->Connect(config->ipAddress, config->port)) {
@@ -617,7 +677,7 @@ bool PIControllerManagerStandardized::CreateRealDevice(const std::string& device
 
 			// Store the connected device
 			{
-				std::lock_guard<std::mutex> lock(m_devicesMutex);
+				ProfiledLockGuard lock(m_devicesMutex);
 				m_realDevices[deviceName] = std::move(device);
 				config->isConnected = true;
 			}
@@ -637,6 +697,26 @@ bool PIControllerManagerStandardized::CreateRealDevice(const std::string& device
 	}
 }
 
+// Settle detection comes from the shared motion Settings block
+void PIControllerManagerStandardized::ApplySettleSettings(PIController& device) {
+	auto config = m_configManager.GetConfig(ConfigRegistry::Files::MOTION_DEVICES);
+	if (!config.contains("Settings")) {
+		return;
+	}
+
+	const auto& settings = config["Settings"];
+	PIController::SettleSettings settle;
+	const std::string mode = ConfigHelper::GetValue<std::string>(settings, "SettleMode", "OnTarget");
+	settle.mode = (mode == "MotionDone") ? PIController::SettleMode::MotionDone : PIController::SettleMode::OnTarget;
+	settle.tolerance = ConfigHelper::GetValue<double>(settings, "PositionTolerance", settle.tolerance);
+	settle.dwell = std::chrono::milliseconds(
+		ConfigHelper::GetValue<int>(settings, "SettleDwellMs", static_cast<int>(settle.dwell.count())));
+	settle.stoppedTimeout = std::chrono::milliseconds(
+		ConfigHelper::GetValue<int>(settings, "SettleStoppedTimeoutMs", static_cast<int>(settle.stoppedTimeout.count())));
+
+	device.SetSettleSettings(settle);
+}
+
 void PIControllerManagerStandardized::DestroyRealDevice(const std::string& deviceName) {
 	// Note: mutex should already be locked by caller
 	auto it = m_realDevices.find(deviceName);
@@ -715,7 +795,7 @@ bool PIControllerManagerStandardized::DisconnectDeviceUnsafe(const std::string&
 
 PIController* PIControllerManagerStandardized::GetRealDevice(const std::string& deviceName) {
 	if (m_hardwareMode) {
-		std::lock_guard<std::mutex> lock(m_devicesMutex);
+		ProfiledLockGuard lock(m_devicesMutex);
 		auto it = m_realDevices.find(deviceName);
 		return (it != m_realDevices.end()) ? it->second.get() : nullptr;
 	}
@@ -724,7 +804,7 @@ PIController* PIControllerManagerStandardized::GetRealDevice(const std::string&
 
 const PIController* PIControllerManagerStandardized::GetRealDevice(const std::string& deviceName) const {
 	if (m_hardwareMode) {
-		std::lock_guard<std::mutex> lock(m_devicesMutex);
+		ProfiledLockGuard lock(m_devicesMutex);
 		auto it = m_realDevices.find(deviceName);
 		return (it != m_realDevices.end()) ? it->second.get() : nullptr;
 	}
@@ -757,7 +837,7 @@ PIControllerManagerStandardized::PIDeviceConfig* PIControllerManagerStandardized
 }
 
 const PIControllerManagerStandardized::PIDeviceConfig* PIControllerManagerStandardized::GetConstDeviceConfig(const std::string& deviceName) const {
-	std::lock_guard<std::mutex> lock(m_devicesMutex);
+	ProfiledLockGuard lock(m_devicesMutex);
 	auto it = m_deviceConfigs.find(deviceName);
 	return (it != m_deviceConfigs.end()) ? &it->second : nullptr;
 }
@@ -3,6 +3,7 @@
 
 #include "devices/IDeviceManagerInterface.h"
 #include "core/ConfigManager.h"
+#include "utils/ProfiledMutex.h"
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -12,12 +13,17 @@
 
 // Forward declaration - include PIController.h only in .cpp file
 class PIController;
+class IOExecutor;
 struct MotionDevice;
 
 /**
  * Standardized PI Controller Manager
  * Manages PIController instances based on configuration
  * Supports both hardware and mock modes
+ *
+ * A manager constructed with a station name only loads the devices whose
+ * "Station" matches, so a multi-station cell runs one manager - one device
+ * table and one lock - per station (see MotionCell.h).
  */
 class PIControllerManagerStandardized : public DeviceManagerBase<PIController> {
 public:
@@ -55,12 +61,17 @@ private:
   // Operating mode
   bool m_hardwareMode;
 
+  // Station filter ("" = every PI device) and shared poller for new controllers
+  std::string m_station;
+  IOExecutor* m_executor = nullptr;
+
   // Thread safety
-  mutable std::mutex m_devicesMutex;
+  mutable ProfiledMutex m_devicesMutex{ "PIControllerManagerStandardized::m_devicesMutex" };
 
 public:
   // Constructor
-  explicit PIControllerManagerStandardized(ConfigManager& configManager, bool hardwareMode = true);
+  explicit PIControllerManagerStandardized(ConfigManager& configManager, bool hardwareMode = true,
+    const std::string& station = "");
 
   // Destructor - explicitly declared for unique_ptr with forward declaration
   ~PIControllerManagerStandardized();
@@ -93,6 +104,11 @@ public:
   void SetHardwareMode(bool enabled);
   bool IsHardwareMode() const { return m_hardwareMode; }
 
+  // === STATION ===
+  const std::string& GetStation() const { return m_station; }
+  // Controllers created after this poll on the executor instead of their own thread
+  void SetIOExecutor(IOExecutor* executor) { m_executor = executor; }
+
   // === TESTING/MOCK UTILITIES ===
   void SetMockDeviceConnected(const std::string& deviceName, bool connected);
   void AddMockDevice(const std::string& deviceName);
@@ -106,6 +122,7 @@ public:
   // === BATCH OPERATIONS ===
   bool HomeAllDevices();
   bool StopAllDevices();
+  bool ApplyProductFrames(const std::string& product);  // Recipe change: work/tool frames on every hexapod (target frame unchanged)
   std::vector<std::string> GetConnectedDeviceNames() const;
   // Device information
   bool GetDeviceIdentification(const std::string& deviceName, std::string& manufacturerInfo) override;
@@ -129,6 +146,7 @@ private:
   PIDeviceConfig* GetMutableDeviceConfig(const std::string& deviceName);
   const PIDeviceConfig* GetConstDeviceConfig(const std::string& deviceName) const;
   MotionDevice CreateMotionDeviceFromConfig(const PIDeviceConfig& config) const;
+  void ApplySettleSettings(PIController& device);
 
   // Validation
   bool ValidateDeviceConfig(const PIDeviceConfig& config) const;
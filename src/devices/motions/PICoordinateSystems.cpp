@@ -0,0 +1,386 @@
+// PICoordinateSystems.cpp
+#include "PICoordinateSystems.h"
+#include "PIController.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace {
+	const char* const kFrameAxes = "X Y Z U V W";
+	const char* const kAxisKeys[] = { "X", "Y", "Z", "U", "V", "W" };
+
+	const char* TypeName(PICoordinateSystems::FrameType type) {
+		return type == PICoordinateSystems::FrameType::Tool ? "tool" : "work";
+	}
+}
+
+bool PICoordinateSystems::Frame::operator==(const Frame& other) const {
+	return name == other.name && type == other.type && std::equal(values, values + 6, other.values);
+}
+
+PICoordinateSystems::PICoordinateSystems(PIController& controller)
+	: m_controller(controller) {
+}
+
+// === CONTROLLER SYNCHRONIZATION ===
+
+// Rebuild the model from what the controller actually holds
+bool PICoordinateSystems::Sync() {
+	if (!CheckConnected("sync")) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return SyncLocked();
+}
+
+bool PICoordinateSystems::SyncLocked() {
+	const int id = m_controller.GetControllerId();
+
+	char buffer[2048] = { 0 };
+	if (!PI_qKET(id, "", buffer, sizeof(buffer))) {
+		LogError("qKET");
+		return false;
+	}
+	m_controllerFrames = ParseNames(buffer);
+
+	// Frames the controller lost (power cycle, KRM from another client) must be defined again
+	for (auto it = m_defined.begin(); it != m_defined.end();) {
+		const bool present = std::find(m_controllerFrames.begin(), m_controllerFrames.end(), it->first)
+			!= m_controllerFrames.end();
+		it = present ? std::next(it) : m_defined.erase(it);
+	}
+	for (auto it = m_links.begin(); it != m_links.end();) {
+		it = m_defined.count(it->first) ? std::next(it) : m_links.erase(it);
+	}
+
+	std::memset(buffer, 0, sizeof(buffer));
+	if (!PI_qKEN(id, "", buffer, sizeof(buffer))) {
+		LogError("qKEN");
+		return false;
+	}
+
+	// qKEN lists the enabled chain; keep our name when it is still part of it
+	const std::vector<std::string> enabled = ParseNames(buffer);
+	if (std::find(enabled.begin(), enabled.end(), m_enabled) == enabled.end()) {
+		m_enabled = enabled.empty() ? DEFAULT_SYSTEM : enabled.front();
+	}
+
+	m_synced = true;
+	std::cout << "PICoordinateSystems: Synced - " << m_controllerFrames.size()
+		<< " frames on controller, enabled: " << m_enabled << std::endl;
+	return true;
+}
+
+// Keep the model - frames survive a reconnect, and Sync drops whatever the controller lost
+void PICoordinateSystems::Invalidate() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_synced = false;
+}
+
+// === FRAME MANAGEMENT ===
+
+bool PICoordinateSystems::DefineFrame(const Frame& frame) {
+	if (!CheckConnected("define frame")) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return DefineFrameLocked(frame);
+}
+
+bool PICoordinateSystems::DefineFrameLocked(const Frame& frame) {
+	if (!IsValidName(frame.name)) {
+		std::cout << "PICoordinateSystems: Invalid frame name '" << frame.name
+			<< "' (1-" << MAX_NAME_LENGTH << " alphanumeric characters)" << std::endl;
+		return false;
+	}
+
+	// Same definition already on the controller - nothing to send
+	auto it = m_defined.find(frame.name);
+	if (it != m_defined.end() && it->second == frame) {
+		return true;
+	}
+
+	// The controller refuses to change a frame that is in use
+	if (IsInEnabledChain(frame.name) && !EnableLocked(DEFAULT_SYSTEM)) {
+		return false;
+	}
+
+	const int id = m_controller.GetControllerId();
+	const BOOL result = (frame.type == FrameType::Tool)
+		? PI_KST(id, frame.name.c_str(), kFrameAxes, frame.values)
+		: PI_KSW(id, frame.name.c_str(), kFrameAxes, frame.values);
+	if (!result) {
+		LogError(std::string(frame.type == FrameType::Tool ? "KST " : "KSW ") + frame.name);
+		return false;
+	}
+
+	// Redefinition drops links from and to the frame
+	m_defined[frame.name] = frame;
+	for (auto link = m_links.begin(); link != m_links.end();) {
+		link = (link->first == frame.name || link->second == frame.name) ? m_links.erase(link) : std::next(link);
+	}
+	if (std::find(m_controllerFrames.begin(), m_controllerFrames.end(), frame.name) == m_controllerFrames.end()) {
+		m_controllerFrames.push_back(frame.name);
+	}
+
+	std::cout << "PICoordinateSystems: Defined " << TypeName(frame.type) << " frame " << frame.name << std::endl;
+	return true;
+}
+
+bool PICoordinateSystems::RemoveFrame(const std::string& name) {
+	if (!CheckConnected("remove frame")) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (IsInEnabledChain(name) && !EnableLocked(DEFAULT_SYSTEM)) {
+		return false;
+	}
+
+	if (!PI_KRM(m_controller.GetControllerId(), name.c_str())) {
+		LogError("KRM " + name);
+		return false;
+	}
+
+	m_defined.erase(name);
+	m_links.erase(name);
+	m_controllerFrames.erase(std::remove(m_controllerFrames.begin(), m_controllerFrames.end(), name),
+		m_controllerFrames.end());
+	return true;
+}
+
+bool PICoordinateSystems::Enable(const std::string& name) {
+	if (!CheckConnected("enable frame")) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return EnableLocked(name);
+}
+
+bool PICoordinateSystems::EnableDefault() {
+	return Enable(DEFAULT_SYSTEM);
+}
+
+bool PICoordinateSystems::EnableLocked(const std::string& name) {
+	if (m_enabled == name) {
+		return true;
+	}
+
+	if (!PI_KEN(m_controller.GetControllerId(), name.c_str())) {
+		LogError("KEN " + name);
+		return false;
+	}
+
+	// Positions reported from here on are in the new frame
+	m_enabled = name;
+	std::cout << "PICoordinateSystems: Enabled " << name << std::endl;
+	return true;
+}
+
+bool PICoordinateSystems::LinkLocked(const std::string& child, const std::string& parent) {
+	auto it = m_links.find(child);
+	if (it != m_links.end() && it->second == parent) {
+		return true;
+	}
+
+	if (!PI_KLN(m_controller.GetControllerId(), child.c_str(), parent.c_str())) {
+		LogError("KLN " + child + " " + parent);
+		return false;
+	}
+
+	m_links[child] = parent;
+	return true;
+}
+
+// === PRODUCT FRAMES ===
+
+// Define (if needed), link and enable the product's frames - one KEN when they are already known
+bool PICoordinateSystems::ApplyProduct(const nlohmann::json& config, const std::string& product,
+	const std::string& deviceName) {
+	std::vector<Frame> frames;
+	if (!LoadFrames(config, product, deviceName, frames)) {
+		return false;
+	}
+
+	if (!CheckConnected("apply product frames")) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_synced && !SyncLocked()) {
+		return false;
+	}
+
+	const Frame* work = nullptr;
+	const Frame* tool = nullptr;
+	for (const auto& frame : frames) {
+		if (!DefineFrameLocked(frame)) {
+			return false;
+		}
+		(frame.type == FrameType::Tool ? tool : work) = &frame;
+	}
+
+	// Tool on top of work: enabling the tool enables the whole chain
+	if (tool && work && !LinkLocked(tool->name, work->name)) {
+		return false;
+	}
+
+	const std::string& target = tool ? tool->name : work->name;
+	if (!EnableLocked(target)) {
+		return false;
+	}
+
+	std::cout << "PICoordinateSystems: " << deviceName << " now in " << product << " frames ("
+		<< (work ? work->name : "-") << " / " << (tool ? tool->name : "-") << ")" << std::endl;
+	return true;
+}
+
+// Products -> <product> -> <device> -> { "Work": {...}, "Tool": {...} }
+bool PICoordinateSystems::LoadFrames(const nlohmann::json& config, const std::string& product,
+	const std::string& deviceName, std::vector<Frame>& frames) {
+	frames.clear();
+
+	if (!config.contains("Products") || !config["Products"].contains(product)) {
+		std::cout << "PICoordinateSystems: No frames configured for product " << product << std::endl;
+		return false;
+	}
+
+	const auto& productConfig = config["Products"][product];
+	if (!productConfig.contains(deviceName)) {
+		std::cout << "PICoordinateSystems: Product " << product << " has no frames for " << deviceName << std::endl;
+		return false;
+	}
+
+	const auto& deviceConfig = productConfig[deviceName];
+	try {
+		for (const auto& [key, type] : { std::make_pair("Work", FrameType::Work), std::make_pair("Tool", FrameType::Tool) }) {
+			if (!deviceConfig.contains(key)) {
+				continue;
+			}
+
+			const auto& entry = deviceConfig[key];
+			Frame frame;
+			frame.type = type;
+			frame.name = entry.at("Name").get<std::string>();
+			for (int i = 0; i < 6; i++) {
+				frame.values[i] = entry.value(kAxisKeys[i], 0.0);
+			}
+			frames.push_back(frame);
+		}
+	}
+	catch (const std::exception& e) {
+		std::cout << "PICoordinateSystems: Invalid frame entry for " << product << "/" << deviceName
+			<< ": " << e.what() << std::endl;
+		return false;
+	}
+
+	if (frames.empty()) {
+		std::cout << "PICoordinateSystems: Product " << product << " defines neither Work nor Tool for "
+			<< deviceName << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// === HOST-SIDE MODEL ===
+
+std::string PICoordinateSystems::GetEnabled() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_enabled;
+}
+
+bool PICoordinateSystems::IsDefaultEnabled() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_enabled == DEFAULT_SYSTEM;
+}
+
+void PICoordinateSystems::SetTargetFrame(const std::string& name) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_targetFrame = name.empty() ? DEFAULT_SYSTEM : name;
+	std::cout << "PICoordinateSystems: Move targets are now in " << m_targetFrame << std::endl;
+}
+
+std::string PICoordinateSystems::GetTargetFrame() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_targetFrame;
+}
+
+// The tool frame of a chain is the one KEN reports, so the target frame must match it exactly
+bool PICoordinateSystems::IsTargetFrameEnabled(std::string& reason) const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_enabled == m_targetFrame) {
+		return true;
+	}
+	reason = "frame " + m_enabled + " is enabled, targets are in " + m_targetFrame;
+	return false;
+}
+
+std::vector<std::string> PICoordinateSystems::GetControllerFrames() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_controllerFrames;
+}
+
+bool PICoordinateSystems::IsDefined(const std::string& name) const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_defined.count(name) > 0;
+}
+
+// === HELPERS ===
+
+// Called with m_mutex held: the enabled frame or one of its linked parents
+bool PICoordinateSystems::IsInEnabledChain(const std::string& name) const {
+	std::string current = m_enabled;
+	for (size_t depth = 0; depth <= m_links.size(); depth++) {
+		if (current == name) {
+			return true;
+		}
+		auto it = m_links.find(current);
+		if (it == m_links.end()) {
+			return false;
+		}
+		current = it->second;
+	}
+	return false;
+}
+
+bool PICoordinateSystems::CheckConnected(const char* action) const {
+	if (!m_controller.IsConnected()) {
+		std::cout << "PICoordinateSystems: Cannot " << action << " - not connected" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void PICoordinateSystems::LogError(const std::string& action) const {
+	std::cout << "PICoordinateSystems: " << action << " failed. Error code: "
+		<< PI_GetError(m_controller.GetControllerId()) << std::endl;
+}
+
+bool PICoordinateSystems::IsValidName(const std::string& name) {
+	if (name.empty() || name.size() > MAX_NAME_LENGTH) {
+		return false;
+	}
+	return std::all_of(name.begin(), name.end(), [](unsigned char c) { return std::isalnum(c) != 0; });
+}
+
+// qKET/qKEN answer one "<name>=<value>" (or bare "<name>") per line
+std::vector<std::string> PICoordinateSystems::ParseNames(const char* response) {
+	std::vector<std::string> names;
+	std::istringstream lines(response);
+	std::string line;
+	while (std::getline(lines, line)) {
+		const size_t end = line.find('=');
+		std::istringstream token(line.substr(0, end));
+		std::string name;
+		if (token >> name) {
+			names.push_back(name);
+		}
+	}
+	return names;
+}
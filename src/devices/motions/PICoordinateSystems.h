@@ -0,0 +1,102 @@
+// PICoordinateSystems.h - Work/tool coordinate systems on a PI hexapod controller
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "nlohmann/json.hpp"
+
+class PIController;
+
+/**
+ * PICoordinateSystems - Host-side model of the controller's coordinate systems
+ *
+ * Work (KSW) and tool (KST) frames are defined per product in
+ * config/coordinate_systems.json. ApplyProduct() defines whatever the
+ * controller is missing, links the tool frame to the work frame (KLN) and
+ * enables the chain with a single KEN, after which MOV/qPOS on the hexapod
+ * are in tool coordinates - no host-side transformation per point.
+ *
+ * The model caches what has been defined so switching between products
+ * that were already used costs one command. Sync() checks it against the
+ * controller (qKET/qKEN) after every connect and before the next
+ * ApplyProduct, so a power-cycled controller is never assumed to still hold
+ * our frames while a plain reconnect does not resend them.
+ *
+ * Move targets are tagged with a target frame, ZERO by default, which is
+ * what named positions, graph moves and config limits are in. The PI move
+ * entry points refuse to move while any other frame is enabled, so a KEN
+ * nobody asked for cannot turn config coordinates into tool coordinates.
+ * Process code that wants to move in product coordinates calls
+ * SetTargetFrame() after ApplyProduct() and sets it back when done.
+ */
+class PICoordinateSystems {
+public:
+  enum class FrameType {
+    Work,
+    Tool
+  };
+
+  struct Frame {
+    std::string name;              // Controller name, max 8 characters
+    FrameType type = FrameType::Work;
+    double values[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };  // X Y Z U V W
+
+    bool operator==(const Frame& other) const;
+  };
+
+  explicit PICoordinateSystems(PIController& controller);
+
+  // Controller synchronization
+  bool Sync();
+  void Invalidate();  // Re-check the model with Sync before trusting it, e.g. on disconnect
+
+  // Frame management
+  bool DefineFrame(const Frame& frame);
+  bool RemoveFrame(const std::string& name);
+  bool Enable(const std::string& name);        // Enables the frame and its linked parents
+  bool EnableDefault();                        // Back to the ZERO system
+
+  // Product frames from config/coordinate_systems.json
+  bool ApplyProduct(const nlohmann::json& config, const std::string& product, const std::string& deviceName);
+  static bool LoadFrames(const nlohmann::json& config, const std::string& product,
+    const std::string& deviceName, std::vector<Frame>& frames);
+
+  // Host-side model
+  std::string GetEnabled() const;                    // Last frame enabled through this model
+  bool IsDefaultEnabled() const;                     // MOV/qPOS are in config (ZERO) coordinates
+
+  // Frame the callers' move targets are in - moves need it to be the enabled one
+  void SetTargetFrame(const std::string& name);
+  std::string GetTargetFrame() const;
+  bool IsTargetFrameEnabled(std::string& reason) const;
+  std::vector<std::string> GetControllerFrames() const;  // Names reported by the last Sync
+  bool IsDefined(const std::string& name) const;
+
+  static constexpr size_t MAX_NAME_LENGTH = 8;
+  static constexpr const char* DEFAULT_SYSTEM = "ZERO";
+
+private:
+  // Called with m_mutex held
+  bool SyncLocked();
+  bool DefineFrameLocked(const Frame& frame);
+  bool EnableLocked(const std::string& name);
+  bool LinkLocked(const std::string& child, const std::string& parent);
+  bool IsInEnabledChain(const std::string& name) const;
+
+  bool CheckConnected(const char* action) const;
+  void LogError(const std::string& action) const;
+  static bool IsValidName(const std::string& name);
+  static std::vector<std::string> ParseNames(const char* response);
+
+  PIController& m_controller;
+
+  mutable std::mutex m_mutex;
+  std::map<std::string, Frame> m_defined;          // Frames this model defined and the controller still holds
+  std::map<std::string, std::string> m_links;      // child -> parent
+  std::vector<std::string> m_controllerFrames;     // qKET at the last Sync
+  std::string m_enabled = DEFAULT_SYSTEM;
+  std::string m_targetFrame = DEFAULT_SYSTEM;
+  bool m_synced = false;                           // Model checked against the controller since connect
+};
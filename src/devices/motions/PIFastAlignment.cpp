@@ -0,0 +1,302 @@
+// PIFastAlignment.cpp
+#include "PIFastAlignment.h"
+
+#include <Windows.h>
+#include "PI_GCS2_DLL.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace {
+	// FRP options
+	constexpr int kOptionStop = 0;
+	constexpr int kOptionPause = 1;
+	constexpr int kOptionResume = 2;
+
+	const int kResultIds[] = {
+		PIFastAlignment::RESULT_SUCCESS,
+		PIFastAlignment::RESULT_MAX_VALUE,
+		PIFastAlignment::RESULT_MAX_POS_SCAN_AXIS,
+		PIFastAlignment::RESULT_MAX_POS_STEP_AXIS
+	};
+	constexpr int kResultCount = 4;
+
+	// Forwards to the PI GCS2 DLL
+	class GCS2Backend : public PIFastAlignment::Backend {
+	public:
+		explicit GCS2Backend(int controllerId) : m_id(controllerId) {}
+
+		bool FDR(const char* routine, const char* scanAxis, double scanRange,
+			const char* stepAxis, double stepRange, const char* parameters) override {
+			return PI_FDR(m_id, routine, scanAxis, scanRange, stepAxis, stepRange, parameters) == TRUE;
+		}
+
+		bool FDG(const char* routine, const char* scanAxis, const char* stepAxis, const char* parameters) override {
+			return PI_FDG(m_id, routine, scanAxis, stepAxis, parameters) == TRUE;
+		}
+
+		bool FRS(const char* routines) override { return PI_FRS(m_id, routines) == TRUE; }
+		bool FRP(const char* routines, const int* options) override { return PI_FRP(m_id, routines, options) == TRUE; }
+		bool qFRP(const char* routines, int* states) override { return PI_qFRP(m_id, routines, states) == TRUE; }
+
+		bool qFRRArray(const char* routines, const int* resultIds, char* buffer, int bufferSize) override {
+			return PI_qFRRArray(m_id, routines, resultIds, buffer, bufferSize) == TRUE;
+		}
+
+		int GetError() override { return PI_GetError(m_id); }
+
+	private:
+		int m_id;
+	};
+}
+
+PIFastAlignment::PIFastAlignment(int controllerId)
+	: m_backend(std::make_unique<GCS2Backend>(controllerId)) {
+}
+
+PIFastAlignment::PIFastAlignment(std::unique_ptr<Backend> backend)
+	: m_backend(std::move(backend)) {
+}
+
+PIFastAlignment::~PIFastAlignment() = default;
+
+// === ROUTINE DEFINITION ===
+
+bool PIFastAlignment::DefineAreaScan(const std::string& routine, const AreaScan& scan) {
+	std::ostringstream parameters;
+	parameters << "L " << scan.threshold
+		<< " A " << scan.analogInput
+		<< " F " << scan.frequency
+		<< " V " << scan.velocity
+		<< " TT " << scan.trajectoryType;
+
+	if (!m_backend->FDR(routine.c_str(), scan.scanAxis.c_str(), scan.scanRange,
+		scan.stepAxis.c_str(), scan.stepRange, parameters.str().c_str())) {
+		LogError("FDR " + routine);
+		return false;
+	}
+
+	std::cout << "PIFastAlignment: Defined area scan " << routine << " (" << scan.scanAxis << " "
+		<< scan.scanRange << " x " << scan.stepAxis << " " << scan.stepRange << ")" << std::endl;
+	return true;
+}
+
+bool PIFastAlignment::DefineGradientSearch(const std::string& routine, const GradientSearch& search) {
+	std::ostringstream parameters;
+	parameters << "ML " << search.minLevel
+		<< " A " << search.analogInput
+		<< " MIA " << search.minAmplitude
+		<< " MAA " << search.maxAmplitude
+		<< " F " << search.frequency
+		<< " SP " << search.speedFactor;
+
+	if (!m_backend->FDG(routine.c_str(), search.scanAxis.c_str(), search.stepAxis.c_str(),
+		parameters.str().c_str())) {
+		LogError("FDG " + routine);
+		return false;
+	}
+
+	std::cout << "PIFastAlignment: Defined gradient search " << routine << " ("
+		<< search.scanAxis << "/" << search.stepAxis << ")" << std::endl;
+	return true;
+}
+
+// === CONTROL ===
+
+bool PIFastAlignment::Start(const std::vector<std::string>& routines) {
+	std::string joined;
+	if (!JoinRoutines(routines, joined)) {
+		return false;
+	}
+
+	if (!m_backend->FRS(joined.c_str())) {
+		LogError("FRS " + joined);
+		return false;
+	}
+
+	std::cout << "PIFastAlignment: Started " << joined << std::endl;
+	return true;
+}
+
+bool PIFastAlignment::Stop(const std::vector<std::string>& routines) {
+	return SetRoutineOption(routines, kOptionStop, "stop");
+}
+
+bool PIFastAlignment::Pause(const std::vector<std::string>& routines) {
+	return SetRoutineOption(routines, kOptionPause, "pause");
+}
+
+bool PIFastAlignment::Resume(const std::vector<std::string>& routines) {
+	return SetRoutineOption(routines, kOptionResume, "resume");
+}
+
+bool PIFastAlignment::SetRoutineOption(const std::vector<std::string>& routines, int option, const char* action) {
+	std::string joined;
+	if (!JoinRoutines(routines, joined)) {
+		return false;
+	}
+
+	int options[MAX_ROUTINES];
+	for (size_t i = 0; i < routines.size(); i++) {
+		options[i] = option;
+	}
+
+	if (!m_backend->FRP(joined.c_str(), options)) {
+		LogError(std::string("FRP ") + action + " " + joined);
+		return false;
+	}
+	return true;
+}
+
+// === PROGRESS ===
+
+bool PIFastAlignment::GetStates(const std::vector<std::string>& routines, std::vector<State>& states) {
+	states.assign(routines.size(), State::Unknown);
+
+	std::string joined;
+	if (!JoinRoutines(routines, joined)) {
+		return false;
+	}
+
+	int raw[MAX_ROUTINES] = { 0 };
+	if (!m_backend->qFRP(joined.c_str(), raw)) {
+		LogError("qFRP " + joined);
+		return false;
+	}
+
+	for (size_t i = 0; i < routines.size(); i++) {
+		states[i] = (raw[i] >= 0 && raw[i] <= 2) ? static_cast<State>(raw[i]) : State::Unknown;
+	}
+	return true;
+}
+
+bool PIFastAlignment::IsAnyRunning(const std::vector<std::string>& routines) {
+	std::vector<State> states;
+	if (!GetStates(routines, states)) {
+		return false;
+	}
+
+	for (State state : states) {
+		if (state == State::Running || state == State::Paused) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool PIFastAlignment::WaitForCompletion(const std::vector<std::string>& routines,
+	std::chrono::milliseconds timeout, std::chrono::milliseconds pollInterval) {
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	std::vector<State> states;
+
+	while (true) {
+		if (!GetStates(routines, states)) {
+			return false;
+		}
+
+		bool running = false;
+		for (State state : states) {
+			running |= (state == State::Running || state == State::Paused);
+		}
+		if (!running) {
+			return true;
+		}
+
+		if (std::chrono::steady_clock::now() >= deadline) {
+			std::cout << "PIFastAlignment: Timeout waiting for routines to finish - stopping them" << std::endl;
+			Stop(routines);
+			return false;
+		}
+
+		std::this_thread::sleep_for(pollInterval);
+	}
+}
+
+// === RESULTS ===
+
+bool PIFastAlignment::GetResults(const std::vector<std::string>& routines, std::vector<Result>& results) {
+	results.clear();
+	if (routines.empty() || routines.size() > MAX_ROUTINES) {
+		std::cout << "PIFastAlignment: Invalid routine count " << routines.size() << std::endl;
+		return false;
+	}
+
+	// qFRRArray pairs the n-th routine name with the n-th result id, so each
+	// routine is listed once per result id - all results in one round trip
+	std::string names;
+	int resultIds[MAX_ROUTINES * kResultCount];
+	int count = 0;
+	for (const auto& routine : routines) {
+		for (int id : kResultIds) {
+			if (!names.empty()) names += " ";
+			names += routine;
+			resultIds[count++] = id;
+		}
+	}
+
+	char buffer[4096] = { 0 };
+	if (!m_backend->qFRRArray(names.c_str(), resultIds, buffer, sizeof(buffer))) {
+		LogError("qFRR " + names);
+		return false;
+	}
+
+	for (const auto& routine : routines) {
+		Result result;
+		result.routine = routine;
+		results.push_back(result);
+	}
+
+	// Lines are "<routine> <resultId>=<value>"
+	std::istringstream lines(buffer);
+	std::string line;
+	while (std::getline(lines, line)) {
+		size_t equals = line.find('=');
+		if (equals == std::string::npos) {
+			continue;
+		}
+
+		std::istringstream key(line.substr(0, equals));
+		std::string routine;
+		int resultId = 0;
+		if (!(key >> routine >> resultId)) {
+			continue;
+		}
+		const double value = std::strtod(line.c_str() + equals + 1, nullptr);
+
+		for (auto& result : results) {
+			if (result.routine != routine) continue;
+			result.valid = true;
+			switch (resultId) {
+			case RESULT_SUCCESS: result.success = value != 0.0; break;
+			case RESULT_MAX_VALUE: result.maxValue = value; break;
+			case RESULT_MAX_POS_SCAN_AXIS: result.scanAxisPosition = value; break;
+			case RESULT_MAX_POS_STEP_AXIS: result.stepAxisPosition = value; break;
+			default: break;
+			}
+		}
+	}
+
+	return true;
+}
+
+// === HELPERS ===
+
+bool PIFastAlignment::JoinRoutines(const std::vector<std::string>& routines, std::string& joined) const {
+	if (routines.empty() || routines.size() > MAX_ROUTINES) {
+		std::cout << "PIFastAlignment: Invalid routine count " << routines.size() << std::endl;
+		return false;
+	}
+
+	joined.clear();
+	for (const auto& routine : routines) {
+		if (!joined.empty()) joined += " ";
+		joined += routine;
+	}
+	return true;
+}
+
+void PIFastAlignment::LogError(const std::string& action) {
+	std::cout << "PIFastAlignment: " << action << " failed. Error code: " << m_backend->GetError() << std::endl;
+}
@@ -0,0 +1,130 @@
+// PIFastAlignment.h - Controller-side fast alignment (FDR area scans, FDG gradient search)
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * PIFastAlignment - Wrapper for the hexapod controller's fast-alignment engine
+ *
+ * Unlike the legacy FSA/FSC/FSM wrappers in PIController, routines here are
+ * defined once, started together (several may run in parallel on one
+ * hexapod), polled without blocking, and their results read back in bulk.
+ * The search itself runs in firmware at servo rate.
+ *
+ * All controller traffic goes through a Backend: GCS2Backend forwards to the
+ * PI DLL, PISimulatedFastAlignment (PISimulatedFastAlignment.h) emulates the
+ * engine over a synthetic coupling field for use without hardware.
+ *
+ * The backend only has a controller id, so the caller checks the layout
+ * (ControllerTraits::ModelSupports(controller.GetModel(), Feature::FastAlignment)).
+ *
+ * Usage:
+ *   PIFastAlignment align(controller.GetControllerId());
+ *   align.DefineAreaScan("1", { "X", 0.05, "Y", 0.05 });
+ *   align.DefineGradientSearch("2", { "Z", "U" });
+ *   align.Start({ "1", "2" });
+ *   align.WaitForCompletion({ "1", "2" }, std::chrono::seconds(10));
+ *   std::vector<PIFastAlignment::Result> results;
+ *   align.GetResults({ "1", "2" }, results);
+ */
+class PIFastAlignment {
+public:
+  // FDR - area scan around the current position, then move to the maximum
+  struct AreaScan {
+    std::string scanAxis = "X";
+    double scanRange = 0.05;      // Full range along the scan axis
+    std::string stepAxis = "Y";
+    double stepRange = 0.05;      // Full range along the step axis
+    double threshold = 0.0;       // L  - minimum input level that counts as signal
+    int analogInput = 1;          // A  - fast-alignment input id
+    double frequency = 10.0;      // F  - scan frequency (Hz)
+    double velocity = 0.5;        // V  - path velocity
+    int trajectoryType = 1;       // TT - 0 sinusoidal, 1 spiral (constant frequency), 2 spiral (constant velocity)
+  };
+
+  // FDG - gradient search from the current position to the local maximum
+  struct GradientSearch {
+    std::string scanAxis = "X";
+    std::string stepAxis = "Y";
+    double minLevel = 0.0;        // ML  - minimum input level to keep searching
+    int analogInput = 1;          // A   - fast-alignment input id
+    double minAmplitude = 0.0005; // MIA - smallest dither circle
+    double maxAmplitude = 0.005;  // MAA - largest dither circle
+    double frequency = 10.0;      // F   - dither frequency (Hz)
+    double speedFactor = 10.0;    // SP  - gradient speed factor
+  };
+
+  enum class State {
+    Stopped = 0,   // Not started, finished or aborted (qFRP)
+    Running = 1,
+    Paused = 2,
+    Unknown = -1   // Query failed
+  };
+
+  struct Result {
+    std::string routine;
+    bool valid = false;           // Results could be read
+    bool success = false;         // Routine found a maximum
+    double maxValue = 0.0;        // Input value at the maximum
+    double scanAxisPosition = 0.0;
+    double stepAxisPosition = 0.0;
+  };
+
+  // Result ids for qFRR
+  static constexpr int RESULT_SUCCESS = 1;
+  static constexpr int RESULT_MAX_VALUE = 2;
+  static constexpr int RESULT_MAX_POS_SCAN_AXIS = 3;
+  static constexpr int RESULT_MAX_POS_STEP_AXIS = 4;
+
+  // Controller calls used by the wrapper - same shape as the GCS2 functions
+  class Backend {
+  public:
+    virtual ~Backend() = default;
+    virtual bool FDR(const char* routine, const char* scanAxis, double scanRange,
+      const char* stepAxis, double stepRange, const char* parameters) = 0;
+    virtual bool FDG(const char* routine, const char* scanAxis, const char* stepAxis,
+      const char* parameters) = 0;
+    virtual bool FRS(const char* routines) = 0;
+    virtual bool FRP(const char* routines, const int* options) = 0;
+    virtual bool qFRP(const char* routines, int* states) = 0;
+    virtual bool qFRRArray(const char* routines, const int* resultIds, char* buffer, int bufferSize) = 0;
+    virtual int GetError() = 0;
+  };
+
+  explicit PIFastAlignment(int controllerId);          // Real controller via the PI DLL
+  explicit PIFastAlignment(std::unique_ptr<Backend> backend);
+  ~PIFastAlignment();
+
+  // Routine definition - takes effect on the next Start
+  bool DefineAreaScan(const std::string& routine, const AreaScan& scan);
+  bool DefineGradientSearch(const std::string& routine, const GradientSearch& search);
+
+  // Control (one controller command for all routines)
+  bool Start(const std::vector<std::string>& routines);
+  bool Stop(const std::vector<std::string>& routines);
+  bool Pause(const std::vector<std::string>& routines);
+  bool Resume(const std::vector<std::string>& routines);
+
+  // Progress - one qFRP for all routines
+  bool GetStates(const std::vector<std::string>& routines, std::vector<State>& states);
+  bool IsAnyRunning(const std::vector<std::string>& routines);
+  bool WaitForCompletion(const std::vector<std::string>& routines, std::chrono::milliseconds timeout,
+    std::chrono::milliseconds pollInterval = std::chrono::milliseconds(20));
+
+  // Results - one qFRRArray for all routines and result ids
+  bool GetResults(const std::vector<std::string>& routines, std::vector<Result>& results);
+
+  Backend& GetBackend() { return *m_backend; }
+
+  static constexpr int MAX_ROUTINES = 8;
+
+private:
+  bool SetRoutineOption(const std::vector<std::string>& routines, int option, const char* action);
+  bool JoinRoutines(const std::vector<std::string>& routines, std::string& joined) const;
+  void LogError(const std::string& action);
+
+  std::unique_ptr<Backend> m_backend;
+};
@@ -0,0 +1,361 @@
+// PIPowerTracker.cpp
+#include "PIPowerTracker.h"
+#include "PIController.h"
+#include "PISimulatedFastAlignment.h"
+#include "../../utils/ThreadPolicy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+	constexpr double kPi = 3.14159265358979323846;
+
+	// MOV without logging or queries in front of it, after one ValidateMove at start
+	class ControllerBackend : public PIPowerTracker::Backend {
+	public:
+		ControllerBackend(PIController& controller, int analogInput)
+			: m_controller(controller), m_analogInput(analogInput) {
+		}
+
+		bool GetPosition(const std::string& axis, double& position) override {
+			return m_controller.GetPosition(axis, position);
+		}
+
+		bool Prepare(const std::vector<std::string>& axes, const std::vector<double>& positions, std::string& reason) override {
+			return m_controller.ValidateMove(axes, positions, reason);
+		}
+
+		bool MoveTo(const std::vector<std::string>& axes, const std::vector<double>& positions) override {
+			return m_controller.StartValidatedMove(axes, positions);
+		}
+
+		// StartValidatedMove armed a settle per axis; the comm thread completes it
+		bool WaitOnTarget(const std::vector<std::string>& axes, std::chrono::milliseconds timeout) override {
+			const double timeoutSeconds = std::chrono::duration<double>(timeout).count();
+			for (const auto& axis : axes) {
+				if (!m_controller.WaitForMotionCompletion(axis, timeoutSeconds)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool ReadSignal(double& value) override {
+			return m_controller.GetAnalogVoltage(m_analogInput, value);
+		}
+
+	private:
+		PIController& m_controller;
+		int m_analogInput;
+	};
+
+	class SimulationBackend : public PIPowerTracker::Backend {
+	public:
+		explicit SimulationBackend(PISimulatedFastAlignment& simulation) : m_simulation(simulation) {
+		}
+
+		bool GetPosition(const std::string& axis, double& position) override {
+			position = m_simulation.GetPosition(axis);
+			return true;
+		}
+
+		bool Prepare(const std::vector<std::string>&, const std::vector<double>&, std::string&) override {
+			return true;
+		}
+
+		bool MoveTo(const std::vector<std::string>& axes, const std::vector<double>& positions) override {
+			for (size_t i = 0; i < axes.size(); i++) {
+				m_simulation.SetPosition(axes[i], positions[i]);
+			}
+			return true;
+		}
+
+		// Simulated moves land immediately
+		bool WaitOnTarget(const std::vector<std::string>&, std::chrono::milliseconds) override {
+			return true;
+		}
+
+		bool ReadSignal(double& value) override {
+			value = m_simulation.ReadInput();
+			return true;
+		}
+
+	private:
+		PISimulatedFastAlignment& m_simulation;
+	};
+}
+
+PIPowerTracker::PIPowerTracker(PIController& controller, int analogInput)
+	: m_backend(std::make_unique<ControllerBackend>(controller, analogInput)) {
+}
+
+PIPowerTracker::PIPowerTracker(PISimulatedFastAlignment& simulation)
+	: m_backend(std::make_unique<SimulationBackend>(simulation)) {
+}
+
+PIPowerTracker::PIPowerTracker(std::unique_ptr<Backend> backend)
+	: m_backend(std::move(backend)) {
+}
+
+PIPowerTracker::~PIPowerTracker() {
+	Stop();
+}
+
+// === CONTROL ===
+
+bool PIPowerTracker::Start(const Settings& settings, std::function<bool()> cureActive) {
+	if (m_running) {
+		std::cout << "PIPowerTracker: Already tracking" << std::endl;
+		return false;
+	}
+	if (m_thread.joinable()) {
+		m_thread.join();
+	}
+
+	const size_t axisCount = settings.axes.size();
+	if (axisCount == 0 || axisCount > 3 || settings.ditherAmplitude <= 0.0 || settings.modeFieldRadius <= 0.0) {
+		std::cout << "PIPowerTracker: Invalid settings (1 to 3 axes, positive dither and mode field)" << std::endl;
+		return false;
+	}
+
+	m_settings = settings;
+	// cos(2x) needs at least 6 samples per cycle to stay apart from cos(x) and sin(x)
+	m_settings.samplesPerCycle = std::max(settings.samplesPerCycle, axisCount == 3 ? 6 : 4);
+	m_cureActive = std::move(cureActive);
+
+	std::vector<double> start(axisCount);
+	for (size_t i = 0; i < axisCount; i++) {
+		if (!m_backend->GetPosition(m_settings.axes[i], start[i])) {
+			std::cout << "PIPowerTracker: Cannot read position of " << m_settings.axes[i] << std::endl;
+			return false;
+		}
+		m_start[i] = start[i];
+		m_center[i] = start[i];
+	}
+	std::string reason;
+	if (!m_backend->Prepare(m_settings.axes, start, reason)) {
+		std::cout << "PIPowerTracker: Cannot track - " << reason << std::endl;
+		return false;
+	}
+
+	// Dither references: a circle for the first two axes, twice the rate for the third
+	const int samples = m_settings.samplesPerCycle;
+	for (size_t j = 0; j < 3; j++) {
+		m_reference[j].assign(samples, 0.0);
+	}
+	for (int k = 0; k < samples; k++) {
+		const double phase = 2.0 * kPi * k / samples;
+		m_reference[0][k] = std::cos(phase);
+		m_reference[1][k] = std::sin(phase);
+		m_reference[2][k] = std::cos(2.0 * phase);
+	}
+	m_targets.assign(axisCount, 0.0);
+
+	{
+		std::lock_guard<std::mutex> lock(m_logMutex);
+		m_log.clear();
+		m_summary = Summary();
+		m_summary.running = true;
+	}
+
+	std::cout << "PIPowerTracker: Tracking";
+	for (size_t i = 0; i < axisCount; i++) {
+		std::cout << " " << m_settings.axes[i] << "=" << m_start[i];
+	}
+	std::cout << ", dither " << m_settings.ditherAmplitude << ", " << samples << " samples per cycle" << std::endl;
+
+	m_stop = false;
+	m_running = true;
+	m_startTime = std::chrono::steady_clock::now();
+	m_thread = std::thread(&PIPowerTracker::TrackingLoop, this);
+	return true;
+}
+
+void PIPowerTracker::Stop() {
+	m_stop = true;
+	if (m_thread.joinable()) {
+		m_thread.join();
+	}
+}
+
+// === TRACKING LOOP ===
+
+void PIPowerTracker::TrackingLoop() {
+	// Waits on the comm thread's settle reports - never in the comm threads' own class
+	ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::Background, "Power tracker");
+
+	const size_t axisCount = m_settings.axes.size();
+	auto nextLog = m_startTime + m_settings.logInterval;
+	std::string reason = "stopped";
+
+	while (!m_stop) {
+		if (m_cureActive && !m_cureActive()) {
+			reason = "cure finished";
+			break;
+		}
+
+		double correction[3] = { 0.0, 0.0, 0.0 };
+		double meanSignal = 0.0;
+		if (!RunCycle(correction, meanSignal)) {
+			reason = m_stop ? "stopped" : "controller error";
+			break;
+		}
+		if (meanSignal < m_settings.minSignal) {
+			reason = "signal lost";
+			break;
+		}
+
+		bool limited = false;
+		for (size_t i = 0; i < axisCount; i++) {
+			if (std::abs(m_center[i] + correction[i] - m_start[i]) > m_settings.maxTotalCorrection) {
+				limited = true;
+			}
+		}
+		if (limited) {
+			reason = "correction limit reached";
+			break;
+		}
+
+		Record record;
+		record.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+		record.meanSignal = meanSignal;
+		for (size_t i = 0; i < axisCount; i++) {
+			m_center[i] += correction[i];
+			record.correction[i] = correction[i];
+			record.center[i] = m_center[i];
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_logMutex);
+			m_log.push_back(record);
+			m_summary.cycles++;
+			m_summary.meanSignal = meanSignal;
+			m_summary.sampleRateHz = record.time > 0.0
+				? m_summary.cycles * m_settings.samplesPerCycle / record.time : 0.0;
+			for (size_t i = 0; i < axisCount; i++) {
+				m_summary.totalCorrection[i] = m_center[i] - m_start[i];
+			}
+		}
+
+		if (std::chrono::steady_clock::now() >= nextLog) {
+			nextLog += m_settings.logInterval;
+			const Summary summary = GetSummary();
+			std::cout << "PIPowerTracker: " << std::fixed << std::setprecision(1) << record.time << " s, signal "
+				<< std::setprecision(4) << meanSignal << ", drift compensated";
+			for (size_t i = 0; i < axisCount; i++) {
+				std::cout << " " << m_settings.axes[i] << "=" << std::showpos << std::setprecision(5)
+					<< summary.totalCorrection[i] << std::noshowpos;
+			}
+			std::cout << std::defaultfloat << " (" << static_cast<int>(summary.sampleRateHz) << " samples/s)" << std::endl;
+		}
+	}
+
+	Finish(reason);
+}
+
+// One dither cycle: returns the bounded centre correction per axis
+bool PIPowerTracker::RunCycle(double* correction, double& meanSignal) {
+	const size_t axisCount = m_settings.axes.size();
+	const int samples = m_settings.samplesPerCycle;
+	const double amplitude = m_settings.ditherAmplitude;
+
+	double sum = 0.0;
+	double demodulated[3] = { 0.0, 0.0, 0.0 };
+	auto sampleTime = std::chrono::steady_clock::now();
+
+	for (int k = 0; k < samples; k++) {
+		for (size_t i = 0; i < axisCount; i++) {
+			m_targets[i] = m_center[i] + amplitude * m_reference[i][k];
+		}
+		if (m_stop || !m_backend->MoveTo(m_settings.axes, m_targets)) {
+			return false;
+		}
+		// Read at the dither point, not on the way to it - a lagging stage
+		// would rotate the response out of phase with the reference
+		if (!m_backend->WaitOnTarget(m_settings.axes, m_settings.settleTimeout)) {
+			return false;
+		}
+		if (m_settings.samplePeriod.count() > 0) {
+			sampleTime += m_settings.samplePeriod;
+			std::this_thread::sleep_until(sampleTime);
+		}
+
+		double value = 0.0;
+		if (!m_backend->ReadSignal(value)) {
+			return false;
+		}
+		sum += value;
+		for (size_t i = 0; i < axisCount; i++) {
+			demodulated[i] += value * m_reference[i][k];
+		}
+	}
+	meanSignal = sum / samples;
+
+	// Lock-in output / sum(ref^2) = amplitude * dV/dx. For a Gaussian peak
+	// (dV/dx) / V = -4 (x - c) / w^2, so the offset to the peak follows from
+	// the relative gradient without knowing the absolute power.
+	for (size_t i = 0; i < axisCount; i++) {
+		double norm = 0.0;
+		for (int k = 0; k < samples; k++) {
+			norm += m_reference[i][k] * m_reference[i][k];
+		}
+		const double relativeGradient = meanSignal > 0.0 ? demodulated[i] / norm / (amplitude * meanSignal) : 0.0;
+		const double offset = relativeGradient * m_settings.modeFieldRadius * m_settings.modeFieldRadius / 4.0;
+		correction[i] = std::clamp(m_settings.gain * offset, -m_settings.maxStep, m_settings.maxStep);
+	}
+	return true;
+}
+
+void PIPowerTracker::Finish(const std::string& reason) {
+	// Leave the platform on the tracked centre, not on a dither point
+	const size_t axisCount = m_settings.axes.size();
+	std::vector<double> center(m_center, m_center + axisCount);
+	m_backend->MoveTo(m_settings.axes, center);
+
+	Summary summary;
+	{
+		std::lock_guard<std::mutex> lock(m_logMutex);
+		m_summary.running = false;
+		m_summary.stopReason = reason;
+		summary = m_summary;
+	}
+
+	std::cout << "PIPowerTracker: Stopped (" << reason << ") after " << summary.cycles << " cycles, drift compensated";
+	for (size_t i = 0; i < axisCount; i++) {
+		std::cout << " " << m_settings.axes[i] << "=" << summary.totalCorrection[i];
+	}
+	std::cout << std::endl;
+	m_running = false;
+}
+
+// === LOG ===
+
+PIPowerTracker::Summary PIPowerTracker::GetSummary() const {
+	std::lock_guard<std::mutex> lock(m_logMutex);
+	return m_summary;
+}
+
+std::vector<PIPowerTracker::Record> PIPowerTracker::GetLog() const {
+	std::lock_guard<std::mutex> lock(m_logMutex);
+	return m_log;
+}
+
+void PIPowerTracker::WriteLog(std::ostream& out) const {
+	const std::vector<Record> log = GetLog();
+	const size_t axisCount = m_settings.axes.size();
+
+	out << "time_s,mean_signal";
+	for (size_t i = 0; i < axisCount; i++) out << ",step_" << m_settings.axes[i];
+	for (size_t i = 0; i < axisCount; i++) out << ",center_" << m_settings.axes[i];
+	out << "\n";
+
+	out << std::setprecision(9);
+	for (const auto& record : log) {
+		out << record.time << "," << record.meanSignal;
+		for (size_t i = 0; i < axisCount; i++) out << "," << record.correction[i];
+		for (size_t i = 0; i < axisCount; i++) out << "," << record.center[i];
+		out << "\n";
+	}
+}
@@ -0,0 +1,129 @@
+// PIPowerTracker.h - Keeps the hexapod on the coupling peak while the UV cure runs
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class PIController;
+class PISimulatedFastAlignment;
+
+/**
+ * PIPowerTracker - Closed-loop peak tracking with dither and lock-in demodulation
+ *
+ * The epoxy shrinks while it cures and the coupling drifts off the peak the
+ * alignment found. The tracker circles each tracked axis pair around the
+ * current centre with a small dither (samplesPerCycle positions per cycle,
+ * one MOV, a wait for on-target and one analog read each, no faster than
+ * samplePeriod). Every reading is taken at its commanded dither point, so
+ * demodulating against the dither reference (lock-in) gives the signal
+ * gradient per axis without a phase error from stage lag; the centre is
+ * stepped up the gradient once per cycle.
+ *
+ * Every correction is bounded: at most maxStep per axis per cycle, and at
+ * most maxTotalCorrection away from where tracking started - beyond that
+ * the tracker stops rather than follow a wrong signal. It also stops when
+ * the signal falls below minSignal, or when the cureActive callback (bound
+ * by the cure sequence to the UV_PLC output state, e.g. UV_PLC1) returns
+ * false. On stop the hexapod is left on the last centre, without dither.
+ *
+ * Each cycle is recorded (GetLog / WriteLog) and a summary line is printed
+ * every logInterval.
+ *
+ * Usage:
+ *   PIPowerTracker tracker(hexapod, 1);
+ *   PIPowerTracker::Settings settings;
+ *   tracker.Start(settings, [&]() { return cureRunning.load(); });
+ *   ... UV exposure ...
+ *   tracker.Stop();
+ *   tracker.WriteLog(file);
+ */
+class PIPowerTracker {
+public:
+  struct Settings {
+    std::vector<std::string> axes = { "X", "Y" };   // 1 to 3 axes
+    double ditherAmplitude = 0.0002;      // Dither radius (axis units) - small against the mode field
+    int samplesPerCycle = 8;              // >= 4; references cos, sin and cos(2x) of the dither phase
+    std::chrono::microseconds samplePeriod{ 2000 };   // Minimum per dither position; 0 = as fast as move, settle + read allow
+    std::chrono::milliseconds settleTimeout{ 500 };    // Per dither position; an axis not on target by then stops tracking
+    double modeFieldRadius = 0.005;       // 1/e^2 radius of the coupling peak; scales gradient to offset
+    double gain = 0.5;                    // Fraction of the estimated offset corrected per cycle
+    double maxStep = 0.0005;              // Per axis per cycle
+    double maxTotalCorrection = 0.02;     // Per axis from the start centre
+    double minSignal = 0.0;               // Stop below this mean signal (lost coupling)
+    std::chrono::milliseconds logInterval{ 1000 };
+  };
+
+  struct Record {
+    double time = 0.0;                    // Seconds since Start
+    double meanSignal = 0.0;              // Mean over the cycle
+    double correction[3] = { 0.0, 0.0, 0.0 };   // Step applied this cycle
+    double center[3] = { 0.0, 0.0, 0.0 };
+  };
+
+  struct Summary {
+    bool running = false;
+    std::string stopReason;
+    int cycles = 0;
+    double sampleRateHz = 0.0;            // Achieved move + settle + read rate
+    double meanSignal = 0.0;              // Last cycle
+    double totalCorrection[3] = { 0.0, 0.0, 0.0 };   // Current centre minus start centre
+  };
+
+  // Platform and input used by the tracker
+  class Backend {
+  public:
+    virtual ~Backend() = default;
+    virtual bool GetPosition(const std::string& axis, double& position) = 0;
+    virtual bool Prepare(const std::vector<std::string>& axes, const std::vector<double>& positions, std::string& reason) = 0;
+    virtual bool MoveTo(const std::vector<std::string>& axes, const std::vector<double>& positions) = 0;  // No wait
+    virtual bool WaitOnTarget(const std::vector<std::string>& axes, std::chrono::milliseconds timeout) = 0;
+    virtual bool ReadSignal(double& value) = 0;
+  };
+
+  PIPowerTracker(PIController& controller, int analogInput);   // Hexapod and its analog input (qTAV)
+  explicit PIPowerTracker(PISimulatedFastAlignment& simulation);
+  explicit PIPowerTracker(std::unique_ptr<Backend> backend);
+  ~PIPowerTracker();   // Stops tracking
+
+  PIPowerTracker(const PIPowerTracker&) = delete;
+  PIPowerTracker& operator=(const PIPowerTracker&) = delete;
+
+  bool Start(const Settings& settings, std::function<bool()> cureActive = nullptr);
+  void Stop();
+  bool IsRunning() const { return m_running.load(); }
+
+  Summary GetSummary() const;
+  std::vector<Record> GetLog() const;
+  void WriteLog(std::ostream& out) const;   // CSV, one row per cycle
+
+private:
+  void TrackingLoop();
+  bool RunCycle(double* correction, double& meanSignal);
+  void Finish(const std::string& reason);
+
+  std::unique_ptr<Backend> m_backend;
+  Settings m_settings;
+  std::function<bool()> m_cureActive;
+
+  // Loop state - owned by the tracking thread
+  double m_start[3] = { 0.0, 0.0, 0.0 };
+  double m_center[3] = { 0.0, 0.0, 0.0 };
+  std::vector<double> m_reference[3];     // Dither pattern per axis, one value per sample
+  std::vector<double> m_targets;
+  std::chrono::steady_clock::time_point m_startTime;
+
+  mutable std::mutex m_logMutex;
+  std::vector<Record> m_log;
+  Summary m_summary;
+
+  std::thread m_thread;
+  std::atomic<bool> m_running{ false };
+  std::atomic<bool> m_stop{ false };
+};
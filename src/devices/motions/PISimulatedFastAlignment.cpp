@@ -0,0 +1,407 @@
+// PISimulatedFastAlignment.cpp
+#include "PISimulatedFastAlignment.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace {
+	const char* const kAxisNames[] = { "X", "Y", "Z", "U", "V", "W" };
+
+	// GCS error codes reported through GetError()
+	constexpr int kErrorInvalidAxis = 15;
+	constexpr int kErrorUnknownRoutine = 17;
+
+	// FDR sample grid per axis
+	constexpr int kAreaScanPoints = 41;
+	constexpr int kMaxGradientIterations = 2000;
+}
+
+double PISimulatedFastAlignment::CouplingField::Evaluate(const double* position) const {
+	double exponent = 0.0;
+	for (int i = 0; i < 6; i++) {
+		if (waist[i] > 0.0) {
+			const double d = (position[i] - center[i]) / waist[i];
+			exponent += 2.0 * d * d;
+		}
+	}
+	return background + peakValue * std::exp(-exponent);
+}
+
+CouplingModel::Model PISimulatedFastAlignment::CouplingField::Slice(int axisA, int axisB, const double* position) const {
+	double exponent = 0.0;
+	for (int i = 0; i < 6; i++) {
+		if (i != axisA && i != axisB && waist[i] > 0.0) {
+			const double d = (position[i] - center[i]) / waist[i];
+			exponent += 2.0 * d * d;
+		}
+	}
+
+	CouplingModel::Model model;
+	model.shape = CouplingModel::Shape::Gaussian;
+	model.dims = 2;
+	model.peak = peakValue * std::exp(-exponent);
+	model.background = background;
+	model.center[0] = center[axisA];
+	model.center[1] = center[axisB];
+	model.width[0] = waist[axisA];
+	model.width[1] = waist[axisB];
+	return model;
+}
+
+PISimulatedFastAlignment::PISimulatedFastAlignment()
+	: PISimulatedFastAlignment(CouplingField()) {
+}
+
+PISimulatedFastAlignment::PISimulatedFastAlignment(const CouplingField& field)
+	: m_field(field) {
+	std::cout << "PISimulatedFastAlignment: Simulated fast-alignment engine ready" << std::endl;
+}
+
+// === SIMULATED PLATFORM ===
+
+void PISimulatedFastAlignment::SetPosition(const std::string& axis, double position) {
+	const int index = AxisIndex(axis.c_str());
+	if (index >= 0) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_position[index] = position;
+	}
+}
+
+double PISimulatedFastAlignment::GetPosition(const std::string& axis) {
+	const int index = AxisIndex(axis.c_str());
+	std::lock_guard<std::mutex> lock(m_mutex);
+	UpdateRoutines();
+	return index >= 0 ? m_position[index] : 0.0;
+}
+
+void PISimulatedFastAlignment::SetField(const CouplingField& field) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_field = field;
+	m_fieldSetAt = std::chrono::steady_clock::now();
+}
+
+double PISimulatedFastAlignment::ReadInput() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	UpdateRoutines();
+	return Sample(m_position);
+}
+
+// Called with m_mutex held
+PISimulatedFastAlignment::CouplingField PISimulatedFastAlignment::FieldNow() const {
+	CouplingField field = m_field;
+	const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_fieldSetAt).count();
+	for (int i = 0; i < 6; i++) {
+		field.center[i] += field.drift[i] * elapsed;
+	}
+	return field;
+}
+
+// Called with m_mutex held
+double PISimulatedFastAlignment::Sample(const double* position) {
+	return AddNoise(FieldNow().Evaluate(position));
+}
+
+// Called with m_mutex held
+double PISimulatedFastAlignment::AddNoise(double value) {
+	if (m_field.relativeNoise > 0.0) {
+		std::normal_distribution<double> noise(0.0, m_field.relativeNoise);
+		value *= 1.0 + noise(m_random);
+	}
+	return value;
+}
+
+// === BACKEND: DEFINITION ===
+
+bool PISimulatedFastAlignment::FDR(const char* routine, const char* scanAxis, double scanRange,
+	const char* stepAxis, double stepRange, const char* parameters) {
+	const int scan = AxisIndex(scanAxis);
+	const int step = AxisIndex(stepAxis);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (scan < 0 || step < 0 || scan == step) {
+		m_lastError = kErrorInvalidAxis;
+		return false;
+	}
+
+	const auto params = ParseParameters(parameters);
+	Routine& entry = m_routines[routine];
+	entry = Routine();
+	entry.gradient = false;
+	entry.scanAxis = scan;
+	entry.stepAxis = step;
+	entry.scanRange = scanRange;
+	entry.stepRange = stepRange;
+	entry.level = params.count("L") ? params.at("L") : 0.0;
+	return true;
+}
+
+bool PISimulatedFastAlignment::FDG(const char* routine, const char* scanAxis, const char* stepAxis,
+	const char* parameters) {
+	const int scan = AxisIndex(scanAxis);
+	const int step = AxisIndex(stepAxis);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (scan < 0 || step < 0 || scan == step) {
+		m_lastError = kErrorInvalidAxis;
+		return false;
+	}
+
+	const auto params = ParseParameters(parameters);
+	Routine& entry = m_routines[routine];
+	entry = Routine();
+	entry.gradient = true;
+	entry.scanAxis = scan;
+	entry.stepAxis = step;
+	entry.level = params.count("ML") ? params.at("ML") : 0.0;
+	if (params.count("MIA")) entry.minAmplitude = params.at("MIA");
+	if (params.count("MAA")) entry.maxAmplitude = params.at("MAA");
+	return true;
+}
+
+// === BACKEND: CONTROL ===
+
+bool PISimulatedFastAlignment::FRS(const char* routines) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	UpdateRoutines();
+
+	std::istringstream names(routines);
+	std::string name;
+	const auto now = std::chrono::steady_clock::now();
+
+	while (names >> name) {
+		Routine* routine = FindRoutine(name);
+		if (routine == nullptr) {
+			m_lastError = kErrorUnknownRoutine;
+			return false;
+		}
+
+		// The search outcome is computed up front; the platform only moves to
+		// the maximum when the simulated runtime has elapsed
+		size_t samples = 0;
+		if (routine->gradient) {
+			RunGradientSearch(*routine, samples);
+		}
+		else {
+			RunAreaScan(*routine, samples);
+		}
+
+		routine->state = 1;
+		routine->finishAt = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			m_timePerSample * static_cast<long long>(samples));
+	}
+	return true;
+}
+
+bool PISimulatedFastAlignment::FRP(const char* routines, const int* options) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	UpdateRoutines();
+
+	std::istringstream names(routines);
+	std::string name;
+	const auto now = std::chrono::steady_clock::now();
+
+	for (int i = 0; names >> name; i++) {
+		Routine* routine = FindRoutine(name);
+		if (routine == nullptr) {
+			m_lastError = kErrorUnknownRoutine;
+			return false;
+		}
+
+		switch (options[i]) {
+		case 0:  // Stop - aborted routines report no success
+			if (routine->state != 0) {
+				routine->state = 0;
+				routine->success = false;
+			}
+			break;
+		case 1:  // Pause
+			if (routine->state == 1) {
+				routine->remaining = routine->finishAt - now;
+				routine->state = 2;
+			}
+			break;
+		case 2:  // Resume
+			if (routine->state == 2) {
+				routine->finishAt = now + routine->remaining;
+				routine->state = 1;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	return true;
+}
+
+bool PISimulatedFastAlignment::qFRP(const char* routines, int* states) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	UpdateRoutines();
+
+	std::istringstream names(routines);
+	std::string name;
+	for (int i = 0; names >> name; i++) {
+		Routine* routine = FindRoutine(name);
+		if (routine == nullptr) {
+			m_lastError = kErrorUnknownRoutine;
+			return false;
+		}
+		states[i] = routine->state;
+	}
+	return true;
+}
+
+bool PISimulatedFastAlignment::qFRRArray(const char* routines, const int* resultIds, char* buffer, int bufferSize) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	UpdateRoutines();
+
+	std::ostringstream out;
+	out.precision(10);
+	std::istringstream names(routines);
+	std::string name;
+	for (int i = 0; names >> name; i++) {
+		Routine* routine = FindRoutine(name);
+		if (routine == nullptr) {
+			m_lastError = kErrorUnknownRoutine;
+			return false;
+		}
+
+		out << name << " " << resultIds[i] << "=";
+		switch (resultIds[i]) {
+		case PIFastAlignment::RESULT_SUCCESS: out << (routine->success ? 1 : 0); break;
+		case PIFastAlignment::RESULT_MAX_VALUE: out << routine->maxValue; break;
+		case PIFastAlignment::RESULT_MAX_POS_SCAN_AXIS: out << routine->maxScan; break;
+		case PIFastAlignment::RESULT_MAX_POS_STEP_AXIS: out << routine->maxStep; break;
+		default: out << 0; break;
+		}
+		out << "\n";
+	}
+
+	const std::string text = out.str();
+	if (static_cast<int>(text.size()) >= bufferSize) {
+		return false;
+	}
+	std::memcpy(buffer, text.c_str(), text.size() + 1);
+	return true;
+}
+
+int PISimulatedFastAlignment::GetError() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const int error = m_lastError;
+	m_lastError = 0;
+	return error;
+}
+
+// === ROUTINE EXECUTION ===
+
+// Called with m_mutex held: finish routines whose runtime has elapsed
+void PISimulatedFastAlignment::UpdateRoutines() {
+	const auto now = std::chrono::steady_clock::now();
+	for (auto& [name, routine] : m_routines) {
+		if (routine.state == 1 && now >= routine.finishAt) {
+			routine.state = 0;
+			if (routine.success) {
+				m_position[routine.scanAxis] = routine.maxScan;
+				m_position[routine.stepAxis] = routine.maxStep;
+			}
+		}
+	}
+}
+
+// Raster over the range centred on the current position, one scan line per batch evaluation
+void PISimulatedFastAlignment::RunAreaScan(Routine& routine, size_t& samples) {
+	const CouplingModel::Model plane = FieldNow().Slice(routine.scanAxis, routine.stepAxis, m_position);
+
+	const double scanStart = m_position[routine.scanAxis] - routine.scanRange / 2.0;
+	const double stepStart = m_position[routine.stepAxis] - routine.stepRange / 2.0;
+
+	double scan[kAreaScanPoints];
+	double step[kAreaScanPoints];
+	double line[kAreaScanPoints];
+	const double* coords[2] = { scan, step };
+	for (int i = 0; i < kAreaScanPoints; i++) {
+		scan[i] = scanStart + routine.scanRange * i / (kAreaScanPoints - 1);
+	}
+
+	routine.maxValue = -1.0;
+	for (int j = 0; j < kAreaScanPoints; j++) {
+		std::fill(step, step + kAreaScanPoints, stepStart + routine.stepRange * j / (kAreaScanPoints - 1));
+		CouplingModel::EvaluateBatch(plane, coords, kAreaScanPoints, line);
+		for (int i = 0; i < kAreaScanPoints; i++) {
+			const double value = AddNoise(line[i]);
+			samples++;
+			if (value > routine.maxValue) {
+				routine.maxValue = value;
+				routine.maxScan = scan[i];
+				routine.maxStep = step[i];
+			}
+		}
+	}
+
+	routine.success = routine.maxValue >= routine.level;
+}
+
+// Hill climb from the current position with a shrinking step
+void PISimulatedFastAlignment::RunGradientSearch(Routine& routine, size_t& samples) {
+	double position[6];
+	std::copy(m_position, m_position + 6, position);
+
+	double best = Sample(position);
+	samples++;
+	double step = routine.maxAmplitude;
+
+	for (int iteration = 0; iteration < kMaxGradientIterations && step >= routine.minAmplitude; iteration++) {
+		static const int kDirections[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+		bool improved = false;
+
+		for (const auto& direction : kDirections) {
+			double candidate[6];
+			std::copy(position, position + 6, candidate);
+			candidate[routine.scanAxis] += direction[0] * step;
+			candidate[routine.stepAxis] += direction[1] * step;
+
+			const double value = Sample(candidate);
+			samples++;
+			if (value > best) {
+				best = value;
+				std::copy(candidate, candidate + 6, position);
+				improved = true;
+			}
+		}
+
+		if (!improved) {
+			step /= 2.0;
+		}
+	}
+
+	routine.maxValue = best;
+	routine.maxScan = position[routine.scanAxis];
+	routine.maxStep = position[routine.stepAxis];
+	routine.success = best >= routine.level;
+}
+
+// === HELPERS ===
+
+int PISimulatedFastAlignment::AxisIndex(const char* axis) {
+	for (int i = 0; i < 6; i++) {
+		if (std::strcmp(kAxisNames[i], axis) == 0) return i;
+	}
+	return -1;
+}
+
+// "KEY value KEY value ..." as used by FDR/FDG
+std::map<std::string, double> PISimulatedFastAlignment::ParseParameters(const char* parameters) {
+	std::map<std::string, double> result;
+	std::istringstream tokens(parameters ? parameters : "");
+	std::string key;
+	double value = 0.0;
+	while (tokens >> key >> value) {
+		result[key] = value;
+	}
+	return result;
+}
+
+PISimulatedFastAlignment::Routine* PISimulatedFastAlignment::FindRoutine(const std::string& name) {
+	auto it = m_routines.find(name);
+	return it != m_routines.end() ? &it->second : nullptr;
+}
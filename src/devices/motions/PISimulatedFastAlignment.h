@@ -0,0 +1,102 @@
+// PISimulatedFastAlignment.h - Fast-alignment engine emulation for running without a hexapod
+#pragma once
+
+#include "CouplingModel.h"
+#include "PIFastAlignment.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+
+/**
+ * PISimulatedFastAlignment - PIFastAlignment backend over a synthetic coupling field
+ *
+ * Emulates the controller behaviour the wrapper relies on: routines are
+ * defined with FDR/FDG, run for a simulated duration after FRS, report
+ * running/stopped through qFRP and leave the platform at the maximum found,
+ * with the results available through qFRR.
+ *
+ * The coupling field is a Gaussian over the six hexapod axes plus background
+ * and relative noise, the usual model for fibre-to-waveguide coupling. Its
+ * centre can drift at a constant rate from SetField on, for exercising
+ * tracking loops (PIPowerTracker).
+ */
+class PISimulatedFastAlignment : public PIFastAlignment::Backend {
+public:
+  struct CouplingField {
+    double center[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };       // Optimum (X Y Z U V W)
+    double waist[6] = { 0.005, 0.005, 0.02, 0.0, 0.0, 0.0 };   // 1/e^2 radius, 0 = axis has no effect
+    double peakValue = 1.0;
+    double background = 0.001;
+    double relativeNoise = 0.0;
+    double drift[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };        // Centre drift per second, e.g. epoxy shrinkage during cure
+
+    double Evaluate(const double* position) const;
+    // 2D model over two axes, the other four held at position[]
+    CouplingModel::Model Slice(int axisA, int axisB, const double* position) const;
+  };
+
+  PISimulatedFastAlignment();
+  explicit PISimulatedFastAlignment(const CouplingField& field);
+
+  // Simulated platform
+  void SetPosition(const std::string& axis, double position);
+  double GetPosition(const std::string& axis);
+  void SetField(const CouplingField& field);
+  double ReadInput();  // Coupling at the current position, with noise
+
+  // Routine runtime = points visited * this
+  void SetTimePerSample(std::chrono::microseconds time) { m_timePerSample = time; }
+
+  // Backend
+  bool FDR(const char* routine, const char* scanAxis, double scanRange,
+    const char* stepAxis, double stepRange, const char* parameters) override;
+  bool FDG(const char* routine, const char* scanAxis, const char* stepAxis,
+    const char* parameters) override;
+  bool FRS(const char* routines) override;
+  bool FRP(const char* routines, const int* options) override;
+  bool qFRP(const char* routines, int* states) override;
+  bool qFRRArray(const char* routines, const int* resultIds, char* buffer, int bufferSize) override;
+  int GetError() override;
+
+private:
+  struct Routine {
+    bool gradient = false;
+    int scanAxis = 0;
+    int stepAxis = 1;
+    double scanRange = 0.0;
+    double stepRange = 0.0;
+    double level = 0.0;          // L (FDR) or ML (FDG)
+    double minAmplitude = 0.0005;  // FDG dither range - the climb step shrinks from max to min
+    double maxAmplitude = 0.005;
+
+    int state = 0;               // qFRP: 0 stopped, 1 running, 2 paused
+    std::chrono::steady_clock::time_point finishAt;
+    std::chrono::steady_clock::duration remaining{};  // While paused
+    bool success = false;
+    double maxValue = 0.0;
+    double maxScan = 0.0;
+    double maxStep = 0.0;
+  };
+
+  void UpdateRoutines();  // Called with m_mutex held
+  void RunAreaScan(Routine& routine, size_t& samples);
+  void RunGradientSearch(Routine& routine, size_t& samples);
+  CouplingField FieldNow() const;  // With the drift applied; called with m_mutex held
+  double Sample(const double* position);
+  double AddNoise(double value);
+
+  static int AxisIndex(const char* axis);
+  static std::map<std::string, double> ParseParameters(const char* parameters);
+  Routine* FindRoutine(const std::string& name);
+
+  mutable std::mutex m_mutex;
+  CouplingField m_field;
+  std::chrono::steady_clock::time_point m_fieldSetAt = std::chrono::steady_clock::now();
+  double m_position[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+  std::map<std::string, Routine> m_routines;
+  std::chrono::microseconds m_timePerSample{ 100 };
+  std::mt19937 m_random{ 12345 };
+  int m_lastError = 0;
+};
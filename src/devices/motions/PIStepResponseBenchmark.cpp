@@ -0,0 +1,399 @@
+// PIStepResponseBenchmark.cpp
+#include "PIStepResponseBenchmark.h"
+#include "PICommandPipeline.h"
+#include "PIController.h"
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace {
+	// Servo update time (seconds) - used to convert record points to time
+	constexpr unsigned int kServoUpdateTimeParameter = 0x0E000200;
+	constexpr double kFallbackServoCycleTime = 0.001;
+
+	// DRT trigger source: any command that changes the target position (MOV)
+	constexpr int kTriggerOnPositionCommand = 1;
+
+	// Target deviations below this fraction of the step do not count as the step start
+	constexpr double kStepStartFraction = 0.001;
+
+	constexpr auto kRecordReadTimeout = std::chrono::seconds(5);
+	constexpr double kMotionTimeoutSeconds = 10.0;
+}
+
+PIStepResponseBenchmark::PIStepResponseBenchmark(PIController& controller, const std::string& deviceName)
+	: m_controller(controller), m_deviceName(deviceName) {
+}
+
+// === RUN ===
+
+bool PIStepResponseBenchmark::Run(const Plan& plan) {
+	m_results.clear();
+	m_recommendations.clear();
+
+	if (!m_controller.IsConnected()) {
+		std::cout << "PIStepResponseBenchmark: Cannot run - " << m_deviceName << " not connected" << std::endl;
+		return false;
+	}
+	if (!ControllerTraits::ModelSupports(m_controller.GetModel(), ControllerTraits::Feature::DataRecorder)) {
+		std::cout << "PIStepResponseBenchmark: Cannot run - no data recorder on "
+			<< ControllerTraits::ModelName(m_controller.GetModel()) << " layout" << std::endl;
+		return false;
+	}
+	if (plan.axes.empty() || plan.velocities.empty() || plan.stepSizes.empty() || plan.recordRate < 1) {
+		std::cout << "PIStepResponseBenchmark: Invalid plan" << std::endl;
+		return false;
+	}
+
+	double originalVelocity = 0.0;
+	const bool restoreVelocity = m_controller.GetSystemVelocity(originalVelocity);
+
+	std::map<std::string, double> startPositions;
+	for (const auto& axis : plan.axes) {
+		double position = 0.0;
+		if (!m_controller.GetPosition(axis, position)) {
+			std::cout << "PIStepResponseBenchmark: Cannot read start position of axis " << axis << std::endl;
+			return false;
+		}
+		startPositions[axis] = position;
+	}
+
+	m_samplePeriod = QueryServoCycleTime() * plan.recordRate;
+	if (!PI_RTR(m_controller.GetControllerId(), plan.recordRate)) {
+		LogError("RTR");
+		return false;
+	}
+
+	std::vector<double> velocities = plan.velocities;
+	std::sort(velocities.begin(), velocities.end());
+
+	std::cout << "PIStepResponseBenchmark: " << m_deviceName << " - " << velocities.size() << " velocities x "
+		<< plan.axes.size() << " axes x " << plan.stepSizes.size() << " steps, sample period "
+		<< m_samplePeriod * 1000.0 << " ms" << std::endl;
+
+	std::vector<double> target;
+	std::vector<double> actual;
+	for (double velocity : velocities) {
+		if (!m_controller.SetSystemVelocity(velocity)) {
+			continue;
+		}
+
+		for (const auto& axis : plan.axes) {
+			const double start = startPositions[axis];
+			for (double stepSize : plan.stepSizes) {
+				StepMetrics metrics;
+				if (RecordStep(axis, start, stepSize, velocity, plan, target, actual)) {
+					metrics = Analyze(target, actual, m_samplePeriod, start + stepSize,
+						plan.tolerance, plan.maxSettlingTime);
+				}
+				metrics.axis = axis;
+				metrics.velocity = velocity;
+				metrics.stepSize = stepSize;
+				m_results.push_back(metrics);
+			}
+
+			m_controller.MoveToPosition(axis, start, true);
+		}
+	}
+
+	if (restoreVelocity) {
+		m_controller.SetSystemVelocity(originalVelocity);
+	}
+
+	m_recommendations = Recommend(m_results, plan.overshootLimit);
+	PrintSummary();
+
+	return std::any_of(m_results.begin(), m_results.end(), [](const StepMetrics& m) { return m.valid; });
+}
+
+// === RECORDING ===
+
+bool PIStepResponseBenchmark::ConfigureRecorder(const std::string& axis) {
+	// Runs before every step - DRC and DRT share one batch (both pure configuration, so replayable)
+	const std::string target = std::to_string(TARGET_TABLE);
+	const std::string actual = std::to_string(ACTUAL_TABLE);
+	PICommandPipeline pipeline(m_controller);
+	pipeline.Add("DRC " + target + " " + axis + " " + std::to_string(PI_DRC_AXIS_TARGET_POS) + " " +
+		actual + " " + axis + " " + std::to_string(PI_DRC_AXIS_ACTUAL_POS), true);
+	// Table 0 = all tables; recording restarts with the next MOV
+	pipeline.Add("DRT 0 " + std::to_string(kTriggerOnPositionCommand) + " 0", true);
+
+	PICommandPipeline::Result result = pipeline.Execute();
+	if (!result.success) {
+		std::cout << "PIStepResponseBenchmark: Recorder setup for " << axis << " failed" << std::endl
+			<< PICommandPipeline::Describe(result);
+		return false;
+	}
+	return true;
+}
+
+bool PIStepResponseBenchmark::RecordStep(const std::string& axis, double start, double stepSize, double velocity,
+	const Plan& plan, std::vector<double>& target, std::vector<double>& actual) {
+	if (!m_controller.MoveToPosition(axis, start, true)) {
+		return false;
+	}
+	if (!ConfigureRecorder(axis)) {
+		return false;
+	}
+	if (!m_controller.MoveToPosition(axis, start + stepSize, false)) {
+		return false;
+	}
+
+	// Travel at the system velocity plus the settling window, so slow steps are recorded to the end
+	const double captureTime = plan.captureTime + (velocity > 0.0 ? std::abs(stepSize) / velocity : 0.0);
+	std::this_thread::sleep_for(std::chrono::duration<double>(captureTime));
+	m_controller.WaitForMotionCompletion(axis, kMotionTimeoutSeconds);
+
+	const int tables[2] = { TARGET_TABLE, ACTUAL_TABLE };
+	int recorded[2] = { 0, 0 };
+	if (!PI_qDRL(m_controller.GetControllerId(), tables, recorded, 2)) {
+		LogError("qDRL");
+		return false;
+	}
+
+	const int wanted = static_cast<int>(captureTime / m_samplePeriod) + 1;
+	const int points = std::min({ recorded[0], recorded[1], wanted, MAX_POINTS });
+	if (points < 2) {
+		std::cout << "PIStepResponseBenchmark: No data recorded for " << axis << " step " << stepSize << std::endl;
+		return false;
+	}
+
+	return ReadRecord(points, target, actual);
+}
+
+// qDRR fills its buffer in the background - wait until all points are in
+bool PIStepResponseBenchmark::ReadRecord(int points, std::vector<double>& target, std::vector<double>& actual) {
+	const int id = m_controller.GetControllerId();
+	const int tables[2] = { TARGET_TABLE, ACTUAL_TABLE };
+	double* data = nullptr;
+	char header[4096] = { 0 };
+
+	if (!PI_qDRR(id, tables, 2, 1, points, &data, header, sizeof(header))) {
+		LogError("qDRR");
+		return false;
+	}
+
+	const int values = points * 2;
+	const auto deadline = std::chrono::steady_clock::now() + kRecordReadTimeout;
+	while (PI_GetAsyncBufferIndex(id) < values) {
+		if (std::chrono::steady_clock::now() >= deadline) {
+			std::cout << "PIStepResponseBenchmark: Timeout reading data recorder ("
+				<< PI_GetAsyncBufferIndex(id) << "/" << values << " values)" << std::endl;
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	// Values are interleaved per point: table 1, table 2, table 1, ...
+	target.resize(points);
+	actual.resize(points);
+	for (int i = 0; i < points; i++) {
+		target[i] = data[i * 2];
+		actual[i] = data[i * 2 + 1];
+	}
+	return true;
+}
+
+double PIStepResponseBenchmark::QueryServoCycleTime() {
+	unsigned int parameter = kServoUpdateTimeParameter;
+	double value = 0.0;
+	if (PI_qSPA(m_controller.GetControllerId(), "1", &parameter, &value, nullptr, 0) && value > 0.0) {
+		return value;
+	}
+
+	std::cout << "PIStepResponseBenchmark: Servo update time unavailable - assuming "
+		<< kFallbackServoCycleTime * 1000.0 << " ms" << std::endl;
+	return kFallbackServoCycleTime;
+}
+
+// === ANALYSIS ===
+
+PIStepResponseBenchmark::StepMetrics PIStepResponseBenchmark::Analyze(const std::vector<double>& target,
+	const std::vector<double>& actual, double samplePeriod, double commandedTarget, double tolerance,
+	double maxSettlingTime) {
+	StepMetrics metrics;
+	const size_t n = std::min(target.size(), actual.size());
+	metrics.samples = n;
+	if (n < 2 || samplePeriod <= 0.0) {
+		return metrics;
+	}
+
+	const double initial = actual[0];
+	const double step = commandedTarget - initial;
+	if (std::abs(step) < 1e-12) {
+		return metrics;
+	}
+
+	// The trigger fires on the MOV, but the trajectory may start a few cycles later
+	size_t stepStart = 0;
+	for (size_t i = 0; i < n; i++) {
+		if (std::abs(target[i] - target[0]) > std::abs(step) * kStepStartFraction) {
+			stepStart = i > 0 ? i - 1 : 0;
+			break;
+		}
+	}
+
+	// Settling counts from the sample where the commanded trajectory reaches its final value
+	size_t trajectoryEnd = n;
+	for (size_t i = n; i-- > stepStart;) {
+		if (std::abs(target[i] - target[n - 1]) > std::abs(step) * kStepStartFraction) {
+			break;
+		}
+		trajectoryEnd = i;
+	}
+
+	const double direction = step > 0.0 ? 1.0 : -1.0;
+	size_t rise10 = n;
+	size_t rise90 = n;
+	size_t lastOutside = stepStart;
+	bool everOutside = false;
+	double overshoot = 0.0;
+
+	for (size_t i = stepStart; i < n; i++) {
+		const double progress = (actual[i] - initial) / step;
+		if (rise10 == n && progress >= 0.1) rise10 = i;
+		if (rise90 == n && progress >= 0.9) rise90 = i;
+
+		overshoot = std::max(overshoot, (actual[i] - commandedTarget) * direction);
+
+		if (std::abs(actual[i] - commandedTarget) > tolerance) {
+			lastOutside = i;
+			everOutside = true;
+		}
+	}
+
+	metrics.valid = true;
+	metrics.riseTime = (rise10 < n && rise90 < n) ? (rise90 - rise10) * samplePeriod : 0.0;
+	metrics.overshoot = overshoot;
+	metrics.finalError = actual[n - 1] - commandedTarget;
+	metrics.moveTime = (trajectoryEnd - stepStart) * samplePeriod;
+	metrics.settlingTime = (everOutside && lastOutside + 1 > trajectoryEnd)
+		? (lastOutside + 1 - trajectoryEnd) * samplePeriod : 0.0;
+	// A trajectory still running at the end of the capture never counts as settled
+	metrics.settled = trajectoryEnd < n - 1 && lastOutside < n - 1 && metrics.settlingTime <= maxSettlingTime;
+	return metrics;
+}
+
+std::map<std::string, PIStepResponseBenchmark::Recommendation> PIStepResponseBenchmark::Recommend(
+	const std::vector<StepMetrics>& results, double overshootLimit) {
+	// axis -> velocity -> (all steps passed, worst settling time)
+	std::map<std::string, std::map<double, std::pair<bool, double>>> outcome;
+	for (const auto& m : results) {
+		auto& entry = outcome[m.axis].try_emplace(m.velocity, true, 0.0).first->second;
+		entry.first = entry.first && m.valid && m.settled && m.overshoot <= overshootLimit;
+		entry.second = std::max(entry.second, m.settlingTime);
+	}
+
+	std::map<std::string, Recommendation> recommendations;
+	for (const auto& [axis, velocities] : outcome) {
+		Recommendation recommendation;
+		recommendation.axis = axis;
+		// Ascending velocities: a pass above a failure is a lucky run, not headroom
+		for (const auto& [velocity, result] : velocities) {
+			if (!result.first) {
+				if (recommendation.firstFailure == 0.0) {
+					recommendation.firstFailure = velocity;
+				}
+			}
+			else if (recommendation.firstFailure > 0.0) {
+				recommendation.nonMonotonic = true;
+			}
+			else {
+				recommendation.found = true;
+				recommendation.velocity = velocity;
+				recommendation.worstSettlingTime = result.second;
+			}
+		}
+		recommendations[axis] = recommendation;
+	}
+	return recommendations;
+}
+
+// === RESULTS ===
+
+bool PIStepResponseBenchmark::SaveResults(const std::string& path) const {
+	nlohmann::json doc;
+	doc["device"] = m_deviceName;
+	doc["samplePeriod"] = m_samplePeriod;
+
+	nlohmann::json steps = nlohmann::json::array();
+	for (const auto& m : m_results) {
+		steps.push_back({
+			{ "axis", m.axis }, { "velocity", m.velocity }, { "stepSize", m.stepSize },
+			{ "valid", m.valid }, { "settled", m.settled }, { "riseTime", m.riseTime },
+			{ "overshoot", m.overshoot }, { "moveTime", m.moveTime }, { "settlingTime", m.settlingTime },
+			{ "finalError", m.finalError }, { "samples", m.samples }
+		});
+	}
+	doc["steps"] = steps;
+
+	nlohmann::json recommendations = nlohmann::json::object();
+	for (const auto& [axis, r] : m_recommendations) {
+		recommendations[axis] = { { "found", r.found }, { "velocity", r.velocity },
+			{ "worstSettlingTime", r.worstSettlingTime }, { "nonMonotonic", r.nonMonotonic },
+			{ "firstFailure", r.firstFailure } };
+	}
+	doc["recommendations"] = recommendations;
+
+	try {
+		const std::filesystem::path filePath(path);
+		if (filePath.has_parent_path()) {
+			std::filesystem::create_directories(filePath.parent_path());
+		}
+		std::ofstream file(filePath);
+		if (!file.is_open()) {
+			std::cout << "PIStepResponseBenchmark: Cannot write " << path << std::endl;
+			return false;
+		}
+		file << doc.dump(2);
+	}
+	catch (const std::exception& e) {
+		std::cout << "PIStepResponseBenchmark: Failed to save " << path << ": " << e.what() << std::endl;
+		return false;
+	}
+
+	std::cout << "PIStepResponseBenchmark: Results saved to " << path << std::endl;
+	return true;
+}
+
+void PIStepResponseBenchmark::PrintSummary() const {
+	std::cout << "PIStepResponseBenchmark: " << m_deviceName << " results" << std::endl;
+	std::cout << "  Axis  Velocity      Step   Rise(ms)  Overshoot    Move(ms)  Settle(ms)  Settled" << std::endl;
+	for (const auto& m : m_results) {
+		std::cout << "  " << std::setw(4) << m.axis << std::setw(10) << m.velocity << std::setw(10) << m.stepSize;
+		if (!m.valid) {
+			std::cout << "   (no data)" << std::endl;
+			continue;
+		}
+		std::cout << std::setw(11) << std::fixed << std::setprecision(2) << m.riseTime * 1000.0
+			<< std::setw(11) << std::setprecision(6) << m.overshoot
+			<< std::setw(12) << std::setprecision(2) << m.moveTime * 1000.0
+			<< std::setw(12) << std::setprecision(2) << m.settlingTime * 1000.0
+			<< std::setw(9) << (m.settled ? "yes" : "no") << std::defaultfloat << std::endl;
+	}
+
+	for (const auto& [axis, r] : m_recommendations) {
+		if (r.found) {
+			std::cout << "  Recommended velocity for " << axis << ": " << r.velocity
+				<< " (worst settling " << r.worstSettlingTime * 1000.0 << " ms)" << std::endl;
+		}
+		else {
+			std::cout << "  No tested velocity meets tolerance for " << axis << std::endl;
+		}
+		if (r.nonMonotonic) {
+			std::cout << "  WARNING: " << axis << " passed above the failure at " << r.firstFailure
+				<< " - results are not monotonic, rerun before raising the velocity" << std::endl;
+		}
+	}
+}
+
+void PIStepResponseBenchmark::LogError(const std::string& action) const {
+	std::cout << "PIStepResponseBenchmark: " << action << " failed. Error code: "
+		<< PI_GetError(m_controller.GetControllerId()) << std::endl;
+}
@@ -0,0 +1,104 @@
+// PIStepResponseBenchmark.h - Step-response and settling characterization of a PI hexapod
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+class PIController;
+
+/**
+ * PIStepResponseBenchmark - Finds the fastest system velocity that still settles in tolerance
+ *
+ * For every velocity (VLS) and axis in the plan, a family of step moves is
+ * commanded while the controller's data recorder captures target and actual
+ * position at servo rate (DRC/DRT/RTR, read back with qDRR). Each trace is
+ * reduced to rise time, overshoot and settling time - the latter counted
+ * from the end of the commanded trajectory, so travel time at slow
+ * velocities does not count against maxSettlingTime - and per axis the
+ * highest velocity whose steps all stay within the overshoot limit and
+ * settle in time is recommended.
+ *
+ * Usage:
+ *   PIStepResponseBenchmark bench(controller, "hex-left");
+ *   PIStepResponseBenchmark::Plan plan;
+ *   plan.axes = { "X", "Z" };
+ *   plan.velocities = { 2.0, 5.0, 10.0 };
+ *   if (bench.Run(plan)) bench.SaveResults("benchmarks/step_response_hex-left.json");
+ *
+ * The hexapod moves: run it on a clear platform only.
+ */
+class PIStepResponseBenchmark {
+public:
+  struct Plan {
+    std::vector<std::string> axes = { "X", "Y", "Z" };
+    std::vector<double> velocities = { 1.0, 2.0, 5.0, 10.0 };  // VLS values to try
+    std::vector<double> stepSizes = { 0.001, 0.01, 0.1, 1.0 };  // mm / deg, relative to the start position
+    double tolerance = 0.0005;             // Settled once |actual - target| stays below this
+    double overshootLimit = 0.0005;        // Maximum acceptable overshoot (absolute)
+    double maxSettlingTime = 0.5;          // Seconds after the trajectory ends; longer counts as not settled
+    double captureTime = 1.0;              // Seconds recorded per step after the expected travel time
+    int recordRate = 1;                    // RTR - servo cycles per recorded point
+  };
+
+  // One recorded step, reduced
+  struct StepMetrics {
+    std::string axis;
+    double velocity = 0.0;
+    double stepSize = 0.0;
+    bool valid = false;            // Trace could be recorded and analysed
+    bool settled = false;          // Entered the tolerance band and stayed within maxSettlingTime
+    double riseTime = 0.0;         // 10% -> 90% of the step (s)
+    double overshoot = 0.0;        // Travel past the target (absolute, >= 0)
+    double moveTime = 0.0;         // Step start -> end of the commanded trajectory (s)
+    double settlingTime = 0.0;     // End of the commanded trajectory -> last exit of the tolerance band (s)
+    double finalError = 0.0;       // actual - target at the end of the capture
+    size_t samples = 0;
+  };
+
+  struct Recommendation {
+    std::string axis;
+    bool found = false;
+    double velocity = 0.0;         // Highest velocity below the first one that failed a step
+    double worstSettlingTime = 0.0;
+    bool nonMonotonic = false;     // A velocity above the first failure passed - worth a rerun
+    double firstFailure = 0.0;     // Lowest failing velocity, 0 if none failed
+  };
+
+  PIStepResponseBenchmark(PIController& controller, const std::string& deviceName);
+
+  // Runs the whole plan; restores the start position and system velocity afterwards
+  bool Run(const Plan& plan);
+
+  const std::vector<StepMetrics>& GetResults() const { return m_results; }
+  const std::map<std::string, Recommendation>& GetRecommendations() const { return m_recommendations; }
+  bool SaveResults(const std::string& path) const;
+  void PrintSummary() const;
+
+  // Reduce one trace; target and actual are sampled every samplePeriod seconds
+  static StepMetrics Analyze(const std::vector<double>& target, const std::vector<double>& actual,
+    double samplePeriod, double commandedTarget, double tolerance, double maxSettlingTime);
+
+  static std::map<std::string, Recommendation> Recommend(const std::vector<StepMetrics>& results,
+    double overshootLimit);
+
+private:
+  bool ConfigureRecorder(const std::string& axis);
+  bool RecordStep(const std::string& axis, double start, double stepSize, double velocity, const Plan& plan,
+    std::vector<double>& target, std::vector<double>& actual);
+  bool ReadRecord(int points, std::vector<double>& target, std::vector<double>& actual);
+  double QueryServoCycleTime();
+  void LogError(const std::string& action) const;
+
+  PIController& m_controller;
+  std::string m_deviceName;
+  double m_samplePeriod = 0.0;
+
+  std::vector<StepMetrics> m_results;
+  std::map<std::string, Recommendation> m_recommendations;
+
+  static constexpr int TARGET_TABLE = 1;
+  static constexpr int ACTUAL_TABLE = 2;
+  static constexpr int MAX_POINTS = 65536;
+};
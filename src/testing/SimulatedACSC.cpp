@@ -0,0 +1,370 @@
+// SimulatedACSC.cpp - ACSC library functions backed by SimulatedHardware
+// Linked instead of the ACSC library by simulation targets - see SimulatedHardware.h
+#include "SimulatedHardware.h"
+#include "ACSC.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+  thread_local int t_lastError = 0;
+
+  std::mutex s_pendingMutex;
+  std::map<ACSC_WAITBLOCK*, std::chrono::steady_clock::time_point> s_pending;   // Async call -> reply due
+
+  SimulatedHardware& Sim() {
+    return SimulatedHardware::Instance();
+  }
+
+  // Synchronous calls pay the round trip now, asynchronous ones when waited for;
+  // results are written immediately either way
+  std::shared_ptr<SimulatedController> Link(HANDLE handle, ACSC_WAITBLOCK* wait) {
+    auto controller = Sim().FindACS(handle);
+    if (!controller) {
+      t_lastError = ACSC_INVALIDHANDLE;
+      return nullptr;
+    }
+
+    if (wait == ACSC_SYNCHRONOUS) {
+      Sim().RoundTrip(*controller);
+    }
+    else if (wait != ACSC_IGNORE && wait != ACSC_ASYNCHRONOUS) {
+      wait->Ret = 0;
+      std::lock_guard<std::mutex> lock(s_pendingMutex);
+      s_pending[wait] = std::chrono::steady_clock::now() + Sim().NextLatency();
+    }
+    return controller;
+  }
+
+  int Fail(int error) {
+    t_lastError = error;
+    return 0;
+  }
+
+  int Unsupported(HANDLE handle) {
+    return Fail(Sim().FindACS(handle) ? ACSC_FUNCTIONNOTSUPPORTED : ACSC_INVALIDHANDLE);
+  }
+
+  int CopyString(const std::string& text, char* buffer, int count, int* received) {
+    if (!buffer || count <= 0) {
+      return Fail(ACSC_INVALIDPARAMETERS);
+    }
+    std::snprintf(buffer, count, "%s", text.c_str());
+    if (received) {
+      *received = static_cast<int>(std::min<size_t>(text.size(), count - 1));
+    }
+    return 1;
+  }
+
+  // Scalars are addressed with ACSC_NONE indices
+  int ElementCount(int from, int to) {
+    return from == ACSC_NONE ? 1 : to - from + 1;
+  }
+}
+
+// === CONNECTION ===
+
+HANDLE _ACSCLIB_ WINAPI acsc_OpenCommEthernet(char* Address, int Port) {
+  return static_cast<HANDLE>(Sim().OpenACS(std::string(Address ? Address : "") + ":" + std::to_string(Port)));
+}
+
+int _ACSCLIB_ WINAPI acsc_CloseComm(HANDLE Handle) {
+  return Sim().CloseACS(Handle) ? 1 : Fail(ACSC_INVALIDHANDLE);
+}
+
+int _ACSCLIB_ WINAPI acsc_GetLastError() {
+  return t_lastError;
+}
+
+int _ACSCLIB_ WINAPI acsc_GetFirmwareVersion(HANDLE Handle, char* Version, int Count, int* Received,
+  ACSC_WAITBLOCK* Wait) {
+  if (!Link(Handle, Wait)) return 0;
+  return CopyString("SPiiPlus simulated 3.0", Version, Count, Received);
+}
+
+int _ACSCLIB_ WINAPI acsc_GetSerialNumber(HANDLE Handle, char* SerialNumber, int Count, int* Received,
+  ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  return CopyString("SIM-" + controller->GetAddress(), SerialNumber, Count, Received);
+}
+
+// === ASYNCHRONOUS CALLS ===
+
+int _ACSCLIB_ WINAPI acsc_WaitForAsyncCall(HANDLE /*Handle*/, void* /*Buf*/, int* Received, ACSC_WAITBLOCK* Wait,
+  int /*Timeout*/) {
+  std::chrono::steady_clock::time_point due;
+  {
+    std::lock_guard<std::mutex> lock(s_pendingMutex);
+    auto it = s_pending.find(Wait);
+    if (it == s_pending.end()) {
+      return Fail(ACSC_INVALIDPARAMETERS);
+    }
+    due = it->second;
+    s_pending.erase(it);
+  }
+
+  Sim().WaitUntil(due);
+  Wait->Ret = 1;
+  if (Received) {
+    *Received = 0;
+  }
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_CancelOperation(HANDLE /*Handle*/, ACSC_WAITBLOCK* Wait) {
+  std::lock_guard<std::mutex> lock(s_pendingMutex);
+  s_pending.erase(Wait);
+  return 1;
+}
+
+// === MOTION ===
+
+int _ACSCLIB_ WINAPI acsc_ToPoint(HANDLE Handle, int Flags, int Axis, double Point, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  if (Flags & ACSC_AMF_WAIT) {
+    controller->Arm(Axis, Point, (Flags & ACSC_AMF_RELATIVE) != 0);
+  }
+  else {
+    controller->Move(Axis, Point, (Flags & ACSC_AMF_RELATIVE) != 0);
+  }
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_ToPointM(HANDLE Handle, int Flags, int* Axes, double* Point, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  for (int i = 0; Axes[i] != ACSC_NONE; i++) {
+    if (Flags & ACSC_AMF_WAIT) {
+      controller->Arm(Axes[i], Point[i], (Flags & ACSC_AMF_RELATIVE) != 0);
+    }
+    else {
+      controller->Move(Axes[i], Point[i], (Flags & ACSC_AMF_RELATIVE) != 0);
+    }
+  }
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_GoM(HANDLE Handle, int* Axes, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  for (int i = 0; Axes[i] != ACSC_NONE; i++) {
+    controller->Go(Axes[i]);
+  }
+  return 1;
+}
+
+// Jog: run toward a far target at the jog speed until halted
+int _ACSCLIB_ WINAPI acsc_Jog(HANDLE Handle, int /*Flags*/, int Axis, double Velocity, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  if (Velocity == 0.0) {
+    controller->Halt(Axis);
+    return 1;
+  }
+  controller->SetVelocity(Axis, std::abs(Velocity));
+  controller->Move(Axis, Velocity > 0.0 ? 1.0e6 : -1.0e6, false);
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_Halt(HANDLE Handle, int Axis, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  controller->Halt(Axis);
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_HaltM(HANDLE Handle, int* Axes, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  for (int i = 0; Axes[i] != ACSC_NONE; i++) {
+    controller->Halt(Axes[i]);
+  }
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_KillAll(HANDLE Handle, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  controller->HaltAll();
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_Enable(HANDLE Handle, int Axis, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  controller->SetServo(Axis, true);
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_Disable(HANDLE Handle, int Axis, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  controller->Halt(Axis);
+  controller->SetServo(Axis, false);
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_FaultClear(HANDLE Handle, int /*Axis*/, ACSC_WAITBLOCK* Wait) {
+  return Link(Handle, Wait) ? 1 : 0;
+}
+
+int _ACSCLIB_ WINAPI acsc_SetVelocity(HANDLE Handle, int Axis, double Velocity, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  controller->SetVelocity(Axis, Velocity);
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_GetVelocity(HANDLE Handle, int Axis, double* Velocity, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  *Velocity = controller->GetVelocity(Axis);
+  return 1;
+}
+
+// === STATUS ===
+
+int _ACSCLIB_ WINAPI acsc_GetFPosition(HANDLE Handle, int Axis, double* FPosition, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  *FPosition = controller->GetPosition(Axis);
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_GetMotorState(HANDLE Handle, int Axis, int* State, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  *State = (controller->IsServoEnabled(Axis) ? ACSC_MST_ENABLE : 0) |
+    (controller->IsMoving(Axis) ? ACSC_MST_MOVE : ACSC_MST_INPOS);
+  return 1;
+}
+
+// === BUFFER PROGRAMS ===
+
+int _ACSCLIB_ WINAPI acsc_LoadBuffer(HANDLE Handle, int Buffer, char* Text, int Count, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  controller->LoadProgram(Buffer, std::string(Text, Count));
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_UploadBuffer(HANDLE Handle, int Buffer, int Offset, char* Text, int Count, int* Received,
+  ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  const std::string program = controller->GetProgram(Buffer);
+  const size_t start = std::min<size_t>(Offset, program.size());
+  const int length = static_cast<int>(std::min<size_t>(program.size() - start, Count));
+  std::memcpy(Text, program.data() + start, length);
+  *Received = length;
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_CompileBuffer(HANDLE Handle, int /*Buffer*/, ACSC_WAITBLOCK* Wait) {
+  return Link(Handle, Wait) ? 1 : 0;
+}
+
+int _ACSCLIB_ WINAPI acsc_GetProgramState(HANDLE Handle, int Buffer, int* State, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  *State = ACSC_PST_COMPILED | (controller->IsProgramRunning(Buffer) ? ACSC_PST_RUN : 0);
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_GetProgramError(HANDLE Handle, int /*Buffer*/, int* Error, ACSC_WAITBLOCK* Wait) {
+  if (!Link(Handle, Wait)) return 0;
+  *Error = 0;
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_RunBuffer(HANDLE Handle, int Buffer, char* /*Label*/, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  controller->RunProgram(Buffer, Sim().GetSettings().programRunTime);
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_StopBuffer(HANDLE Handle, int Buffer, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  controller->StopProgram(Buffer);
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_WaitProgramEnd(HANDLE Handle, int Buffer, int Timeout) {
+  auto controller = Link(Handle, ACSC_SYNCHRONOUS);
+  if (!controller) return 0;
+
+  // Poll rather than sleep to the end - StopBuffer from another thread ends the wait early
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(Timeout);
+  while (controller->IsProgramRunning(Buffer)) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return Fail(ACSC_TIMEOUT);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return 1;
+}
+
+// === VARIABLES ===
+
+int _ACSCLIB_ WINAPI acsc_DeclareVariable(HANDLE Handle, int /*Type*/, char* /*Name*/, ACSC_WAITBLOCK* Wait) {
+  return Link(Handle, Wait) ? 1 : 0;
+}
+
+int _ACSCLIB_ WINAPI acsc_WriteReal(HANDLE Handle, int /*NBuf*/, char* Var, int From1, int To1, int From2, int /*To2*/,
+  double* Values, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  if (From2 != ACSC_NONE) return Fail(ACSC_FUNCTIONNOTSUPPORTED);   // Matrices are not simulated
+  controller->WriteVariable(Var, From1 == ACSC_NONE ? 0 : From1, Values, ElementCount(From1, To1));
+  return 1;
+}
+
+int _ACSCLIB_ WINAPI acsc_ReadReal(HANDLE Handle, int /*NBuf*/, char* Var, int From1, int To1, int From2, int /*To2*/,
+  double* Values, ACSC_WAITBLOCK* Wait) {
+  auto controller = Link(Handle, Wait);
+  if (!controller) return 0;
+  if (From2 != ACSC_NONE) return Fail(ACSC_FUNCTIONNOTSUPPORTED);
+  if (!controller->ReadVariable(Var, From1 == ACSC_NONE ? 0 : From1, Values, ElementCount(From1, To1))) {
+    return Fail(ACSC_INVALIDPARAMETERS);
+  }
+  return 1;
+}
+
+// === NOT SIMULATED ===
+// PVT splines and data collection: rejected as unsupported functions
+
+int _ACSCLIB_ WINAPI acsc_SplineM(HANDLE Handle, int /*Flags*/, int* /*Axes*/, double /*Period*/, ACSC_WAITBLOCK* /*Wait*/) {
+  return Unsupported(Handle);
+}
+
+int _ACSCLIB_ WINAPI acsc_AddPVTPointM(HANDLE Handle, int* /*Axis*/, double* /*Point*/, double* /*Velocity*/,
+  double /*TimeInterval*/, ACSC_WAITBLOCK* /*Wait*/) {
+  return Unsupported(Handle);
+}
+
+int _ACSCLIB_ WINAPI acsc_EndSequenceM(HANDLE Handle, int* /*Axes*/, ACSC_WAITBLOCK* /*Wait*/) {
+  return Unsupported(Handle);
+}
+
+int _ACSCLIB_ WINAPI acsc_DataCollectionExt(HANDLE Handle, int /*Flags*/, int /*Axis*/, char* /*Array*/, int /*NSample*/,
+  double /*Period*/, char* /*Vars*/, ACSC_WAITBLOCK* /*Wait*/) {
+  return Unsupported(Handle);
+}
+
+int _ACSCLIB_ WINAPI acsc_StopCollect(HANDLE Handle, ACSC_WAITBLOCK* /*Wait*/) {
+  return Unsupported(Handle);
+}
+
+int _ACSCLIB_ WINAPI acsc_WaitCollectEndExt(HANDLE Handle, int /*Timeout*/, int /*Axis*/) {
+  return Unsupported(Handle);
+}
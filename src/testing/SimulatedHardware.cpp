@@ -0,0 +1,328 @@
+// SimulatedHardware.cpp
+#include "SimulatedHardware.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+  thread_local double t_vendorSeconds = 0.0;
+
+  double Seconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+  }
+}
+
+// === SIMULATED CONTROLLER ===
+
+SimulatedController::SimulatedController(const std::string& address, int axisCount, double velocity)
+  : m_address(address), m_axes(axisCount) {
+  const auto now = std::chrono::steady_clock::now();
+  for (auto& axis : m_axes) {
+    axis.velocity = velocity;
+    axis.startTime = now;
+  }
+}
+
+double SimulatedController::PositionAt(const Axis& axis, std::chrono::steady_clock::time_point now) const {
+  const double distance = axis.target - axis.start;
+  const double travelled = axis.velocity * Seconds(now - axis.startTime);
+  if (travelled >= std::abs(distance)) {
+    return axis.target;
+  }
+  return axis.start + (distance < 0.0 ? -travelled : travelled);
+}
+
+void SimulatedController::StartMove(Axis& axis, double target, std::chrono::steady_clock::time_point now) {
+  axis.start = PositionAt(axis, now);
+  axis.target = target;
+  axis.startTime = now;
+}
+
+void SimulatedController::Move(int axis, double target, bool relative) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!ValidAxis(axis) || !m_axes[axis].servo) return;
+  const auto now = std::chrono::steady_clock::now();
+  Axis& a = m_axes[axis];
+  StartMove(a, relative ? a.target + target : target, now);
+}
+
+void SimulatedController::Arm(int axis, double target, bool relative) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!ValidAxis(axis)) return;
+  Axis& a = m_axes[axis];
+  a.armed = relative ? a.target + target : target;
+  a.hasArmed = true;
+}
+
+void SimulatedController::Go(int axis) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!ValidAxis(axis) || !m_axes[axis].hasArmed) return;
+  Axis& a = m_axes[axis];
+  a.hasArmed = false;
+  if (a.servo) {
+    StartMove(a, a.armed, std::chrono::steady_clock::now());
+  }
+}
+
+void SimulatedController::Halt(int axis) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!ValidAxis(axis)) return;
+  Axis& a = m_axes[axis];
+  const double position = PositionAt(a, std::chrono::steady_clock::now());
+  a.start = position;
+  a.target = position;
+  a.hasArmed = false;
+}
+
+void SimulatedController::HaltAll() {
+  for (int i = 0; i < GetAxisCount(); i++) {
+    Halt(i);
+  }
+}
+
+void SimulatedController::Reference(int axis) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!ValidAxis(axis)) return;
+  StartMove(m_axes[axis], 0.0, std::chrono::steady_clock::now());
+  m_axes[axis].referenced = true;
+}
+
+double SimulatedController::GetPosition(int axis) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return ValidAxis(axis) ? PositionAt(m_axes[axis], std::chrono::steady_clock::now()) : 0.0;
+}
+
+double SimulatedController::GetTarget(int axis) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return ValidAxis(axis) ? m_axes[axis].target : 0.0;
+}
+
+bool SimulatedController::IsMoving(int axis) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!ValidAxis(axis)) return false;
+  const Axis& a = m_axes[axis];
+  return PositionAt(a, std::chrono::steady_clock::now()) != a.target;
+}
+
+bool SimulatedController::IsReferenced(int axis) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return ValidAxis(axis) && m_axes[axis].referenced;
+}
+
+void SimulatedController::SetVelocity(int axis, double velocity) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!ValidAxis(axis) || velocity <= 0.0) return;
+  // Re-anchor so the change applies from now on
+  Axis& a = m_axes[axis];
+  StartMove(a, a.target, std::chrono::steady_clock::now());
+  a.velocity = velocity;
+}
+
+double SimulatedController::GetVelocity(int axis) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return ValidAxis(axis) ? m_axes[axis].velocity : 0.0;
+}
+
+void SimulatedController::SetServo(int axis, bool enabled) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (ValidAxis(axis)) m_axes[axis].servo = enabled;
+}
+
+bool SimulatedController::IsServoEnabled(int axis) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return ValidAxis(axis) && m_axes[axis].servo;
+}
+
+double SimulatedController::AnalogSignal(int channel) const {
+  const double x = GetAxisCount() > 0 ? GetPosition(0) : 0.0;
+  const double y = GetAxisCount() > 1 ? GetPosition(1) : 0.0;
+  const double width = 0.05 * std::max(channel, 1);   // mm - channels differ so they are told apart
+  return 5.0 * std::exp(-(x * x + y * y) / (2.0 * width * width));
+}
+
+void SimulatedController::SetError(int code) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_error = code;
+}
+
+int SimulatedController::TakeError() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const int error = m_error;
+  m_error = 0;
+  return error;
+}
+
+// === BUFFER PROGRAMS AND VARIABLES ===
+
+void SimulatedController::LoadProgram(int buffer, const std::string& text) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_programs[buffer] = text;
+}
+
+std::string SimulatedController::GetProgram(int buffer) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_programs.find(buffer);
+  return it != m_programs.end() ? it->second : std::string();
+}
+
+void SimulatedController::RunProgram(int buffer, std::chrono::milliseconds runTime) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_programEnds[buffer] = std::chrono::steady_clock::now() + runTime;
+}
+
+void SimulatedController::StopProgram(int buffer) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (buffer < 0) {
+    m_programEnds.clear();
+  }
+  else {
+    m_programEnds.erase(buffer);
+  }
+}
+
+bool SimulatedController::IsProgramRunning(int buffer) const {
+  return ProgramEnd(buffer) > std::chrono::steady_clock::now();
+}
+
+std::chrono::steady_clock::time_point SimulatedController::ProgramEnd(int buffer) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_programEnds.find(buffer);
+  return it != m_programEnds.end() ? it->second : std::chrono::steady_clock::time_point();
+}
+
+void SimulatedController::WriteVariable(const std::string& name, int from, const double* values, int count) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<double>& variable = m_variables[name];
+  if (static_cast<int>(variable.size()) < from + count) {
+    variable.resize(from + count, 0.0);
+  }
+  std::copy(values, values + count, variable.begin() + from);
+}
+
+bool SimulatedController::ReadVariable(const std::string& name, int from, double* values, int count) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_variables.find(name);
+  if (it == m_variables.end() || static_cast<int>(it->second.size()) < from + count) {
+    return false;
+  }
+  std::copy(it->second.begin() + from, it->second.begin() + from + count, values);
+  return true;
+}
+
+// === REGISTRY ===
+
+SimulatedHardware& SimulatedHardware::Instance() {
+  static SimulatedHardware instance;
+  return instance;
+}
+
+void SimulatedHardware::SetSettings(const Settings& settings) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_settings = settings;
+}
+
+SimulatedHardware::Settings SimulatedHardware::GetSettings() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_settings;
+}
+
+int SimulatedHardware::OpenPI(const std::string& address) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const int id = m_nextPIId++;
+  m_pi[id] = std::make_shared<SimulatedController>(address, 6, m_settings.piVelocity);
+  std::lock_guard<std::mutex> statsLock(m_statsMutex);
+  m_stats.piConnections++;
+  return id;
+}
+
+void* SimulatedHardware::OpenACS(const std::string& address) {
+  auto controller = std::make_shared<SimulatedController>(address, 8, GetSettings().acsVelocity);
+  void* handle = controller.get();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_acs[handle] = std::move(controller);
+  std::lock_guard<std::mutex> statsLock(m_statsMutex);
+  m_stats.acsConnections++;
+  return handle;
+}
+
+std::shared_ptr<SimulatedController> SimulatedHardware::FindPI(int id) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_pi.find(id);
+  return it != m_pi.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<SimulatedController> SimulatedHardware::FindACS(void* handle) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_acs.find(handle);
+  return it != m_acs.end() ? it->second : nullptr;
+}
+
+bool SimulatedHardware::ClosePI(int id) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_pi.erase(id) == 0) return false;
+  std::lock_guard<std::mutex> statsLock(m_statsMutex);
+  m_stats.piConnections--;
+  return true;
+}
+
+bool SimulatedHardware::CloseACS(void* handle) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_acs.erase(handle) == 0) return false;
+  std::lock_guard<std::mutex> statsLock(m_statsMutex);
+  m_stats.acsConnections--;
+  return true;
+}
+
+// === TIMING ===
+
+std::chrono::steady_clock::duration SimulatedHardware::NextLatency() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto latency = std::chrono::duration_cast<std::chrono::steady_clock::duration>(m_settings.callLatency);
+  if (m_settings.callJitter.count() > 0) {
+    // xorshift - cheap and good enough for jitter
+    m_rng ^= m_rng << 13;
+    m_rng ^= m_rng >> 7;
+    m_rng ^= m_rng << 17;
+    latency += std::chrono::microseconds(m_rng % (m_settings.callJitter.count() + 1));
+  }
+  return latency;
+}
+
+void SimulatedHardware::RoundTrip(SimulatedController& controller) {
+  Occupy(controller, NextLatency());
+}
+
+void SimulatedHardware::Occupy(SimulatedController& controller, std::chrono::steady_clock::duration duration) {
+  const auto queued = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> wire(controller.Wire());
+  const auto start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_until(start + duration);
+  const auto end = std::chrono::steady_clock::now();
+  Account(Seconds(start - queued), Seconds(end - start));
+}
+
+void SimulatedHardware::WaitUntil(std::chrono::steady_clock::time_point due) {
+  const auto start = std::chrono::steady_clock::now();
+  if (due > start) {
+    std::this_thread::sleep_until(due);
+  }
+  Account(0.0, Seconds(std::chrono::steady_clock::now() - start));
+}
+
+void SimulatedHardware::Account(double waitSeconds, double callSeconds) {
+  t_vendorSeconds += waitSeconds + callSeconds;
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+  m_stats.calls++;
+  m_stats.wireWaitSeconds += waitSeconds;
+  m_stats.callSeconds += callSeconds;
+}
+
+SimulatedHardware::Stats SimulatedHardware::GetStats() const {
+  std::lock_guard<std::mutex> lock(m_statsMutex);
+  return m_stats;
+}
+
+double SimulatedHardware::ThreadVendorSeconds() {
+  return t_vendorSeconds;
+}
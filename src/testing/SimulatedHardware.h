@@ -0,0 +1,167 @@
+// SimulatedHardware.h - In-process PI hexapods and ACS gantries for soak and load tests
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * SimulatedController - One simulated controller connection
+ *
+ * Axes move at their set velocity toward the commanded target, in wall-clock
+ * time, so the controllers' polling threads see motion exactly as they would
+ * on hardware. Servo, referencing and buffer program state are kept too.
+ * All methods are thread-safe.
+ */
+class SimulatedController {
+public:
+  SimulatedController(const std::string& address, int axisCount, double velocity);
+
+  // Motion
+  void Move(int axis, double target, bool relative);
+  void Arm(int axis, double target, bool relative);   // Held until Go (ACS ToPoint with ACSC_AMF_WAIT)
+  void Go(int axis);
+  void Halt(int axis);
+  void HaltAll();
+  void Reference(int axis);                           // Drives to 0 and marks the axis referenced
+
+  double GetPosition(int axis) const;
+  double GetTarget(int axis) const;
+  bool IsMoving(int axis) const;
+  bool IsReferenced(int axis) const;
+
+  void SetVelocity(int axis, double velocity);
+  double GetVelocity(int axis) const;
+  void SetServo(int axis, bool enabled);
+  bool IsServoEnabled(int axis) const;
+
+  // Analog input: a Gaussian peak over the first two axes, like a fibre coupling signal
+  double AnalogSignal(int channel) const;
+
+  // Error register - read and cleared like PI_GetError
+  void SetError(int code);
+  int TakeError();
+
+  // Buffer programs (ACS) - a run lasts programRunTime unless stopped
+  void LoadProgram(int buffer, const std::string& text);
+  std::string GetProgram(int buffer) const;
+  void RunProgram(int buffer, std::chrono::milliseconds runTime);
+  void StopProgram(int buffer);   // ACSC_NONE: all
+  bool IsProgramRunning(int buffer) const;
+  std::chrono::steady_clock::time_point ProgramEnd(int buffer) const;
+
+  // Global variables (ACS)
+  void WriteVariable(const std::string& name, int from, const double* values, int count);
+  bool ReadVariable(const std::string& name, int from, double* values, int count) const;
+
+  int GetAxisCount() const { return static_cast<int>(m_axes.size()); }
+  const std::string& GetAddress() const { return m_address; }
+
+  // Calls on one connection are serialized, like requests on one TCP link
+  std::mutex& Wire() { return m_wire; }
+
+private:
+  struct Axis {
+    double start = 0.0;
+    double target = 0.0;
+    double armed = 0.0;
+    double velocity = 10.0;
+    bool hasArmed = false;
+    bool servo = true;
+    bool referenced = false;
+    std::chrono::steady_clock::time_point startTime;
+  };
+
+  bool ValidAxis(int axis) const { return axis >= 0 && axis < static_cast<int>(m_axes.size()); }
+  double PositionAt(const Axis& axis, std::chrono::steady_clock::time_point now) const;
+  void StartMove(Axis& axis, double target, std::chrono::steady_clock::time_point now);
+
+  std::string m_address;
+  mutable std::mutex m_mutex;
+  std::mutex m_wire;
+  std::vector<Axis> m_axes;
+  int m_error = 0;
+  std::map<int, std::string> m_programs;
+  std::map<int, std::chrono::steady_clock::time_point> m_programEnds;
+  std::map<std::string, std::vector<double>> m_variables;
+};
+
+/**
+ * SimulatedHardware - Stand-in for the PI GCS2 and ACSC libraries
+ *
+ * SimulatedPIGCS2.cpp and SimulatedACSC.cpp define the vendor functions the
+ * controllers call on top of this registry. A target linking them instead
+ * of the vendor libraries (TestSoak) runs PIController, ACSController and
+ * the managers unmodified - their threads and locks included - with no
+ * hardware attached. Any address connects; each connection is a new
+ * SimulatedController.
+ *
+ * Every synchronous call is one round trip: queue for the connection's
+ * wire, then hold it for callLatency plus up to callJitter. Asynchronous
+ * ACSC calls are charged when waited for, so pipelined requests overlap as
+ * they do on the real link. Time spent queueing and in round trips is
+ * counted globally and per calling thread, which lets a harness split an
+ * operation's latency into controller time and application-side waiting.
+ */
+class SimulatedHardware {
+public:
+  struct Settings {
+    std::chrono::microseconds callLatency{ 500 };   // One request/reply on the controller link
+    std::chrono::microseconds callJitter{ 200 };    // Uniform extra latency, 0..callJitter
+    double piVelocity = 10.0;                       // Default axis velocity (mm/s)
+    double acsVelocity = 50.0;
+    std::chrono::milliseconds programRunTime{ 200 };  // ACS buffer program duration
+  };
+
+  struct Stats {
+    uint64_t calls = 0;
+    double wireWaitSeconds = 0.0;   // Callers queued behind another call on the same connection
+    double callSeconds = 0.0;       // Round trips themselves
+    int piConnections = 0;
+    int acsConnections = 0;
+  };
+
+  static SimulatedHardware& Instance();
+
+  void SetSettings(const Settings& settings);
+  Settings GetSettings() const;
+
+  // Connections
+  int OpenPI(const std::string& address);      // Controller ID, like PI_ConnectTCPIP
+  void* OpenACS(const std::string& address);   // Communication handle, like acsc_OpenCommEthernet
+  std::shared_ptr<SimulatedController> FindPI(int id) const;
+  std::shared_ptr<SimulatedController> FindACS(void* handle) const;
+  bool ClosePI(int id);
+  bool CloseACS(void* handle);
+
+  // One synchronous round trip on a connection
+  void RoundTrip(SimulatedController& controller);
+  // Hold the connection for a long-running call (FSA scan, referencing)
+  void Occupy(SimulatedController& controller, std::chrono::steady_clock::duration duration);
+  // Wait for an asynchronous reply that is due at 'due'
+  void WaitUntil(std::chrono::steady_clock::time_point due);
+  std::chrono::steady_clock::duration NextLatency();
+
+  Stats GetStats() const;
+  static double ThreadVendorSeconds();   // Calling thread's time inside simulated vendor calls
+
+private:
+  SimulatedHardware() = default;
+  SimulatedHardware(const SimulatedHardware&) = delete;
+  SimulatedHardware& operator=(const SimulatedHardware&) = delete;
+
+  void Account(double waitSeconds, double callSeconds);
+
+  mutable std::mutex m_mutex;
+  Settings m_settings;
+  int m_nextPIId = 0;
+  std::map<int, std::shared_ptr<SimulatedController>> m_pi;
+  std::map<void*, std::shared_ptr<SimulatedController>> m_acs;
+  uint64_t m_rng = 0x9E3779B97F4A7C15ull;
+
+  mutable std::mutex m_statsMutex;
+  Stats m_stats;
+};
@@ -0,0 +1,555 @@
+// SimulatedPIGCS2.cpp - PI GCS2 library functions backed by SimulatedHardware
+// Linked instead of PI_GCS2_DLL by simulation targets - see SimulatedHardware.h
+#include "SimulatedHardware.h"
+#include "PI_GCS2_DLL.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+  constexpr int kParameterSyntax = 1;      // GCS: parameter syntax error
+  constexpr int kUnknownCommand = 2;       // GCS: unknown command
+  constexpr int kServoOff = 5;             // GCS: move attempted with servo off
+  constexpr int kOutOfLimits = 7;          // GCS: position out of limits
+  constexpr int kInvalidAxis = 15;         // GCS: invalid axis identifier
+  constexpr int kConnectionError = -1;     // No such controller ID
+  const char* const kAxisLetters = "XYZUVW";
+  // Symmetric travel per axis (mm, deg), roughly a C-887 hexapod at the default pivot
+  const double kTravelRange[] = { 50.0, 50.0, 25.0, 15.0, 15.0, 30.0 };
+
+  SimulatedHardware& Sim() {
+    return SimulatedHardware::Instance();
+  }
+
+  // One round trip to the controller; nullptr for an unknown ID
+  std::shared_ptr<SimulatedController> Link(int id) {
+    auto controller = Sim().FindPI(id);
+    if (controller) {
+      Sim().RoundTrip(*controller);
+    }
+    return controller;
+  }
+
+  // "X Y Z", "XYZ", "" or NULL (all axes) -> axis indices; false on an unknown axis
+  bool ParseAxes(const char* szAxes, std::vector<int>& axes) {
+    axes.clear();
+    if (!szAxes || !*szAxes) {
+      for (int i = 0; kAxisLetters[i]; i++) axes.push_back(i);
+      return true;
+    }
+    for (const char* c = szAxes; *c; c++) {
+      if (*c == ' ') continue;
+      const char* found = std::strchr(kAxisLetters, *c);
+      if (!found) return false;
+      axes.push_back(static_cast<int>(found - kAxisLetters));
+    }
+    return true;
+  }
+
+  bool Axes(SimulatedController& controller, const char* szAxes, std::vector<int>& axes) {
+    if (!ParseAxes(szAxes, axes)) {
+      controller.SetError(kInvalidAxis);
+      return false;
+    }
+    return true;
+  }
+
+  BOOL Unsupported(int id) {
+    if (auto controller = Link(id)) {
+      controller->SetError(kUnknownCommand);
+    }
+    return FALSE;
+  }
+
+  // Why the controller would refuse an absolute move, 0 if it accepts it
+  int MoveError(const SimulatedController& controller, int axis, double target) {
+    if (!controller.IsServoEnabled(axis)) return kServoOff;
+    if (std::abs(target) > kTravelRange[axis]) return kOutOfLimits;
+    return 0;
+  }
+
+  // Blocking like the real call: the connection is busy for the scan's duration,
+  // then the platform sits on the best point of the scanned area
+  BOOL AreaScan(int ID, const char* szAxis1, double dLength1, const char* szAxis2, double dLength2, double dDistance) {
+    auto controller = Sim().FindPI(ID);
+    if (!controller) return FALSE;
+    std::vector<int> axis1;
+    std::vector<int> axis2;
+    if (!Axes(*controller, szAxis1, axis1) || !Axes(*controller, szAxis2, axis2) ||
+      axis1.size() != 1 || axis2.size() != 1 || dDistance <= 0.0) {
+      controller->SetError(kInvalidAxis);
+      return FALSE;
+    }
+
+    const double lines = std::max(1.0, std::ceil(dLength2 / dDistance));
+    const double seconds = lines * dLength1 / controller->GetVelocity(axis1[0]);
+    Sim().Occupy(*controller, std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(seconds)));
+
+    const double center1 = controller->GetTarget(axis1[0]);
+    const double center2 = controller->GetTarget(axis2[0]);
+    controller->Move(axis1[0], std::clamp(0.0, center1 - dLength1 / 2.0, center1 + dLength1 / 2.0), false);
+    controller->Move(axis2[0], std::clamp(0.0, center2 - dLength2 / 2.0, center2 + dLength2 / 2.0), false);
+    return TRUE;
+  }
+
+  void CopyString(const std::string& text, char* buffer, int size) {
+    if (buffer && size > 0) {
+      std::snprintf(buffer, size, "%s", text.c_str());
+    }
+  }
+}
+
+// === CONNECTION ===
+
+int PI_FUNC_DECL PI_ConnectTCPIP(const char* szHostname, int port) {
+  return Sim().OpenPI(std::string(szHostname ? szHostname : "") + ":" + std::to_string(port));
+}
+
+void PI_FUNC_DECL PI_CloseConnection(int ID) {
+  Sim().ClosePI(ID);
+}
+
+int PI_FUNC_DECL PI_GetInitError() {
+  return 0;
+}
+
+int PI_FUNC_DECL PI_GetError(int ID) {
+  auto controller = Sim().FindPI(ID);
+  return controller ? controller->TakeError() : kConnectionError;
+}
+
+BOOL PI_FUNC_DECL PI_qERR(int ID, int* pnError) {
+  auto controller = Link(ID);
+  if (!controller) return FALSE;
+  *pnError = controller->TakeError();
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_TranslateError(int errNr, char* szBuffer, int iBufferSize) {
+  CopyString("Simulated controller error " + std::to_string(errNr), szBuffer, iBufferSize);
+  return TRUE;
+}
+
+// Raw command: written to the link without waiting for a reply - a failure
+// only shows in the error register, read by the next ERR?
+BOOL PI_FUNC_DECL PI_GcsCommandset(int ID, const char* szCommand) {
+  auto controller = Sim().FindPI(ID);
+  if (!controller || !szCommand) return FALSE;
+  // Queued behind calls in flight on the link, but no round trip of its own
+  std::lock_guard<std::mutex> wire(controller->Wire());
+
+  std::istringstream line(szCommand);
+  line.imbue(std::locale::classic());
+  std::string command;
+  line >> command;
+
+  if (command == "STP") {
+    controller->HaltAll();
+    return TRUE;
+  }
+  if (command == "VLS") {
+    double velocity = 0.0;
+    if (!(line >> velocity) || velocity <= 0.0) {
+      controller->SetError(kParameterSyntax);
+      return TRUE;
+    }
+    for (int i = 0; i < controller->GetAxisCount(); i++) {
+      controller->SetVelocity(i, velocity);
+    }
+    return TRUE;
+  }
+
+  const bool hasValues = (command == "MOV" || command == "MVR" || command == "VEL" || command == "SVO");
+  if (!hasValues && command != "HLT") {
+    controller->SetError(kUnknownCommand);
+    return TRUE;
+  }
+
+  // Everything is checked before anything is applied, like the controller
+  std::vector<int> axes;
+  std::vector<double> values;
+  std::string axis;
+  while (line >> axis) {
+    std::vector<int> parsed;
+    if (axis.size() != 1 || !ParseAxes(axis.c_str(), parsed)) {
+      controller->SetError(kInvalidAxis);
+      return TRUE;
+    }
+    double value = 0.0;
+    if (hasValues && !(line >> value)) {
+      controller->SetError(kParameterSyntax);
+      return TRUE;
+    }
+    axes.push_back(parsed[0]);
+    values.push_back(value);
+  }
+  if (hasValues && axes.empty()) {
+    controller->SetError(kParameterSyntax);
+    return TRUE;
+  }
+  for (size_t i = 0; i < axes.size(); i++) {
+    const int error = command == "MOV" ? MoveError(*controller, axes[i], values[i])
+      : command == "MVR" && !controller->IsServoEnabled(axes[i]) ? kServoOff
+      : command == "VEL" && values[i] <= 0.0 ? kParameterSyntax
+      : 0;
+    if (error) {
+      controller->SetError(error);
+      return TRUE;
+    }
+  }
+
+  if (command == "HLT" && axes.empty()) {
+    controller->HaltAll();
+  }
+  for (size_t i = 0; i < axes.size(); i++) {
+    if (command == "MOV" || command == "MVR") controller->Move(axes[i], values[i], command == "MVR");
+    else if (command == "VEL") controller->SetVelocity(axes[i], values[i]);
+    else if (command == "SVO") controller->SetServo(axes[i], values[i] != 0.0);
+    else controller->Halt(axes[i]);
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_qIDN(int ID, char* szBuffer, int iBufferSize) {
+  auto controller = Link(ID);
+  if (!controller) return FALSE;
+  CopyString("Physik Instrumente (PI), C-887 (simulated), " + controller->GetAddress() + ", 1.0", szBuffer, iBufferSize);
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_INI(int ID, const char* /*szAxes*/) {
+  return Link(ID) ? TRUE : FALSE;
+}
+
+// === MOTION ===
+
+BOOL PI_FUNC_DECL PI_MOV(int ID, const char* szAxes, const double* pdValueArray) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    if (const int error = MoveError(*controller, axes[i], pdValueArray[i])) {
+      controller->SetError(error);
+      return FALSE;
+    }
+  }
+  for (size_t i = 0; i < axes.size(); i++) {
+    controller->Move(axes[i], pdValueArray[i], false);
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_MVR(int ID, const char* szAxes, const double* pdValueArray) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    controller->Move(axes[i], pdValueArray[i], true);
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_qMOV(int ID, const char* szAxes, double* pdValueArray) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    pdValueArray[i] = controller->GetTarget(axes[i]);
+  }
+  return TRUE;
+}
+
+// Virtual move: reachable when every target is inside the axis travel
+BOOL PI_FUNC_DECL PI_qVMO(int ID, const char* szAxes, const double* pdValarray, BOOL* pbMovePossible) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  *pbMovePossible = TRUE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    if (std::abs(pdValarray[i]) > kTravelRange[axes[i]]) {
+      *pbMovePossible = FALSE;
+    }
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_qPOS(int ID, const char* szAxes, double* pdValueArray) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    pdValueArray[i] = controller->GetPosition(axes[i]);
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_IsMoving(int ID, const char* szAxes, BOOL* pbValueArray) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    pbValueArray[i] = controller->IsMoving(axes[i]) ? TRUE : FALSE;
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_qONT(int ID, const char* szAxes, BOOL* pbValueArray) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    pbValueArray[i] = controller->IsMoving(axes[i]) ? FALSE : TRUE;
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_HLT(int ID, const char* szAxes) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (int axis : axes) {
+    controller->Halt(axis);
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_STP(int ID) {
+  auto controller = Link(ID);
+  if (!controller) return FALSE;
+  controller->HaltAll();
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_VEL(int ID, const char* szAxes, const double* pdValueArray) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    controller->SetVelocity(axes[i], pdValueArray[i]);
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_qVEL(int ID, const char* szAxes, double* pdValueArray) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    pdValueArray[i] = controller->GetVelocity(axes[i]);
+  }
+  return TRUE;
+}
+
+// The hexapod's system velocity drives all axes together
+BOOL PI_FUNC_DECL PI_VLS(int ID, double dSystemVelocity) {
+  auto controller = Link(ID);
+  if (!controller || dSystemVelocity <= 0.0) return FALSE;
+  for (int i = 0; i < controller->GetAxisCount(); i++) {
+    controller->SetVelocity(i, dSystemVelocity);
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_qVLS(int ID, double* pdSystemVelocity) {
+  auto controller = Link(ID);
+  if (!controller) return FALSE;
+  *pdSystemVelocity = controller->GetVelocity(0);
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_SVO(int ID, const char* szAxes, const BOOL* pbValueArray) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    controller->SetServo(axes[i], pbValueArray[i] == TRUE);
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_qSVO(int ID, const char* szAxes, BOOL* pbValueArray) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    pbValueArray[i] = controller->IsServoEnabled(axes[i]) ? TRUE : FALSE;
+  }
+  return TRUE;
+}
+
+// === REFERENCING ===
+
+BOOL PI_FUNC_DECL PI_FRF(int ID, const char* szAxes) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (int axis : axes) {
+    controller->Reference(axis);
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_qFRF(int ID, const char* szAxes, BOOL* pbValueArray) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (size_t i = 0; i < axes.size(); i++) {
+    pbValueArray[i] = controller->IsReferenced(axes[i]) ? TRUE : FALSE;
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_GOH(int ID, const char* szAxes) {
+  auto controller = Link(ID);
+  std::vector<int> axes;
+  if (!controller || !Axes(*controller, szAxes, axes)) return FALSE;
+  for (int axis : axes) {
+    controller->Move(axis, 0.0, false);
+  }
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_DFH(int ID, const char* /*szAxes*/) {
+  return Link(ID) ? TRUE : FALSE;
+}
+
+// === ANALOG INPUTS ===
+
+BOOL PI_FUNC_DECL PI_qTAC(int ID, int* pnNrChannels) {
+  auto controller = Link(ID);
+  if (!controller) return FALSE;
+  *pnNrChannels = 2;
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_qTAV(int ID, const int* piChannelsArray, double* pdValueArray, int iArraySize) {
+  auto controller = Link(ID);
+  if (!controller) return FALSE;
+  for (int i = 0; i < iArraySize; i++) {
+    pdValueArray[i] = controller->AnalogSignal(piChannelsArray[i]);
+  }
+  return TRUE;
+}
+
+// === AREA SCANS ===
+
+BOOL PI_FUNC_DECL PI_FSA(int ID, const char* szAxis1, double dLength1, const char* szAxis2, double dLength2,
+  double /*dThreshold*/, double dDistance, double /*dAlignStep*/, int /*iAnalogInput*/) {
+  return AreaScan(ID, szAxis1, dLength1, szAxis2, dLength2, dDistance);
+}
+
+BOOL PI_FUNC_DECL PI_FSC(int ID, const char* szAxis1, double dLength1, const char* szAxis2, double dLength2,
+  double /*dThreshold*/, double dDistance, int /*iAnalogInput*/) {
+  return AreaScan(ID, szAxis1, dLength1, szAxis2, dLength2, dDistance);
+}
+
+BOOL PI_FUNC_DECL PI_FSM(int ID, const char* szAxis1, double dLength1, const char* szAxis2, double dLength2,
+  double /*dThreshold*/, double dDistance, int /*iAnalogInput*/) {
+  return AreaScan(ID, szAxis1, dLength1, szAxis2, dLength2, dDistance);
+}
+
+// === COORDINATE SYSTEMS ===
+// Accepted and forgotten - the simulation moves in the ZERO frame only
+
+BOOL PI_FUNC_DECL PI_KEN(int ID, const char* /*szNameOfCoordSystem*/) {
+  return Link(ID) ? TRUE : FALSE;
+}
+
+BOOL PI_FUNC_DECL PI_KLN(int ID, const char* /*szNameOfChild*/, const char* /*szNameOfParent*/) {
+  return Link(ID) ? TRUE : FALSE;
+}
+
+BOOL PI_FUNC_DECL PI_KRM(int ID, const char* /*szNameOfCoordSystem*/) {
+  return Link(ID) ? TRUE : FALSE;
+}
+
+BOOL PI_FUNC_DECL PI_KST(int ID, const char* /*szNameOfCoordSystem*/, const char* /*szAxes*/, const double* /*pdValueArray*/) {
+  return Link(ID) ? TRUE : FALSE;
+}
+
+BOOL PI_FUNC_DECL PI_KSW(int ID, const char* /*szNameOfCoordSystem*/, const char* /*szAxes*/, const double* /*pdValueArray*/) {
+  return Link(ID) ? TRUE : FALSE;
+}
+
+BOOL PI_FUNC_DECL PI_qKEN(int ID, const char* /*szNamesOfCoordSystems*/, char* buffer, int bufsize) {
+  if (!Link(ID)) return FALSE;
+  CopyString("", buffer, bufsize);
+  return TRUE;
+}
+
+BOOL PI_FUNC_DECL PI_qKET(int ID, const char* /*szTypes*/, char* buffer, int bufsize) {
+  if (!Link(ID)) return FALSE;
+  CopyString("", buffer, bufsize);
+  return TRUE;
+}
+
+// === NOT SIMULATED ===
+// Fast alignment routines, data recorder and parameters: rejected as unknown commands
+
+BOOL PI_FUNC_DECL PI_FDR(int ID, const char* /*szScanRoutineName*/, const char* /*szScanAxis*/, const double /*dScanAxisRange*/,
+  const char* /*szStepAxis*/, const double /*dStepAxisRange*/, const char* /*szParameters*/) {
+  return Unsupported(ID);
+}
+
+BOOL PI_FUNC_DECL PI_FDG(int ID, const char* /*szScanRoutineName*/, const char* /*szScanAxis*/, const char* /*szStepAxis*/,
+  const char* /*szParameters*/) {
+  return Unsupported(ID);
+}
+
+BOOL PI_FUNC_DECL PI_FRS(int ID, const char* /*szScanRoutineNames*/) {
+  return Unsupported(ID);
+}
+
+BOOL PI_FUNC_DECL PI_FRP(int ID, const char* /*szScanRoutineNames*/, const int* /*piOptionsArray*/) {
+  return Unsupported(ID);
+}
+
+BOOL PI_FUNC_DECL PI_qFRP(int ID, const char* /*szScanRoutineNames*/, int* /*piOptionsArray*/) {
+  return Unsupported(ID);
+}
+
+BOOL PI_FUNC_DECL PI_qFRRArray(int ID, const char* /*szScanRoutineNames*/, const int* /*iResultIds*/, char* /*szResult*/,
+  int /*iBufferSize*/) {
+  return Unsupported(ID);
+}
+
+BOOL PI_FUNC_DECL PI_DRC(int ID, const int* /*piRecordTableIdsArray*/, const char* /*szRecordSourceIds*/,
+  const int* /*piRecordOptionArray*/) {
+  return Unsupported(ID);
+}
+
+BOOL PI_FUNC_DECL PI_DRT(int ID, const int* /*piRecordChannelIdsArray*/, const int* /*piTriggerSourceArray*/,
+  const char* /*szValues*/, int /*iArraySize*/) {
+  return Unsupported(ID);
+}
+
+BOOL PI_FUNC_DECL PI_RTR(int ID, int /*piReportTableRate*/) {
+  return Unsupported(ID);
+}
+
+BOOL PI_FUNC_DECL PI_qDRL(int ID, const int* /*piRecordChannelIdsArray*/, int* /*piNuberOfRecordedValuesArray*/,
+  int /*iArraySize*/) {
+  return Unsupported(ID);
+}
+
+BOOL PI_FUNC_DECL PI_qDRR(int ID, const int* /*piRecTableIdIdsArray*/, int /*iNumberOfRecTables*/,
+  int /*iOffsetOfFirstPointInRecordTable*/, int /*iNumberOfValues*/, double** /*pdValueArray*/, char* /*szGcsArrayHeader*/,
+  int /*iGcsArrayHeaderMaxSize*/) {
+  return Unsupported(ID);
+}
+
+int PI_FUNC_DECL PI_GetAsyncBufferIndex(int /*ID*/) {
+  return -1;
+}
+
+BOOL PI_FUNC_DECL PI_qSPA(int ID, const char* /*szItems*/, unsigned int* /*iParameterArray*/, double* /*pdValueArray*/,
+  char* /*szStrings*/, int /*iMaxNameSize*/) {
+  return Unsupported(ID);
+}
@@ -0,0 +1,220 @@
+// src/ui/JogInput.cpp
+#include "JogInput.h"
+#include "imgui.h"
+#include "../core/ServiceLocator.h"
+#include "../devices/motions/ACSControllerManagerStandardized.h"
+#include "../devices/motions/PIControllerManagerStandardized.h"
+#include "../devices/motions/ACSController.h"
+#include "../devices/motions/PIController.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+  const char* const kAxisNames[JogInput::AXIS_COUNT] = { "X", "Y", "Z", "U", "V", "W" };
+}
+
+JogInput& JogInput::Instance() {
+  static JogInput instance;
+  return instance;
+}
+
+JogInput::~JogInput() {
+  if (m_gamepad) {
+    SDL_GameControllerClose(m_gamepad);
+  }
+}
+
+void JogInput::SetTarget(const Target& target) {
+  if (target == m_target) {
+    return;
+  }
+  StopAll();
+  m_target = target;
+}
+
+void JogInput::SetInputEnabled(bool enabled) {
+  if (!enabled && m_inputEnabled) {
+    StopAll();
+  }
+  m_inputEnabled = enabled;
+}
+
+void JogInput::HoldButton(const std::string& axis, int direction) {
+  const int index = AxisIndex(axis);
+  if (index >= 0) {
+    m_axes[index].buttonDirection = direction < 0 ? -1 : 1;
+  }
+}
+
+// === MAIN LOOP ===
+
+void JogInput::HandleEvent(const SDL_Event& event) {
+  switch (event.type) {
+  case SDL_CONTROLLERDEVICEADDED:
+    if (!m_gamepad && SDL_IsGameController(event.cdevice.which)) {
+      m_gamepad = SDL_GameControllerOpen(event.cdevice.which);
+      if (m_gamepad) {
+        m_gamepadId = SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(m_gamepad));
+        std::cout << "JogInput: Gamepad connected - " << SDL_GameControllerName(m_gamepad) << std::endl;
+      }
+    }
+    break;
+
+  case SDL_CONTROLLERDEVICEREMOVED:
+    if (m_gamepad && event.cdevice.which == m_gamepadId) {
+      StopAll();
+      SDL_GameControllerClose(m_gamepad);
+      m_gamepad = nullptr;
+      m_gamepadId = -1;
+      std::cout << "JogInput: Gamepad removed" << std::endl;
+    }
+    break;
+
+  case SDL_WINDOWEVENT:
+    // Key-up events go to the focused window - without focus a release could be missed
+    if (event.window.event == SDL_WINDOWEVENT_FOCUS_LOST) {
+      StopAll();
+    }
+    break;
+
+  default:
+    break;
+  }
+}
+
+void JogInput::Update() {
+  const auto now = std::chrono::steady_clock::now();
+  const bool hexapod = m_target.kind == Target::Kind::Hexapod;
+  const int axisCount = hexapod ? AXIS_COUNT : 3;
+
+  // Keyboard and gamepad, unless a text field has the keyboard
+  int keyDirection[AXIS_COUNT] = { 0 };
+  double stick[AXIS_COUNT] = { 0.0 };
+  const bool typing = ImGui::GetCurrentContext() && ImGui::GetIO().WantTextInput;
+
+  if (m_inputEnabled && !typing && m_target.kind != Target::Kind::None) {
+    const Uint8* keys = SDL_GetKeyboardState(nullptr);
+    const bool rotate = hexapod && (keys[SDL_SCANCODE_LSHIFT] || keys[SDL_SCANCODE_RSHIFT]);
+    const int horizontal = keys[SDL_SCANCODE_RIGHT] - keys[SDL_SCANCODE_LEFT];
+    const int vertical = keys[SDL_SCANCODE_UP] - keys[SDL_SCANCODE_DOWN];
+    const int depth = keys[SDL_SCANCODE_PAGEUP] - keys[SDL_SCANCODE_PAGEDOWN];
+    keyDirection[rotate ? 3 : 0] = horizontal;
+    keyDirection[rotate ? 4 : 1] = vertical;
+    keyDirection[rotate ? 5 : 2] = depth;
+
+    if (m_gamepad) {
+      stick[0] = ReadStick(SDL_CONTROLLER_AXIS_LEFTX);
+      stick[1] = -ReadStick(SDL_CONTROLLER_AXIS_LEFTY);   // SDL: down is positive
+      stick[2] = -ReadStick(SDL_CONTROLLER_AXIS_RIGHTY);
+    }
+  }
+
+  for (int i = 0; i < axisCount; i++) {
+    AxisInput& input = m_axes[i];
+
+    // Buttons win over keys, keys over the stick
+    int direction = input.buttonDirection != 0 ? input.buttonDirection : keyDirection[i];
+    double velocity = 0.0;
+    if (direction != 0) {
+      if (direction != input.direction) {
+        input.heldSince = now;
+      }
+      const double held = std::chrono::duration<double>(now - input.heldSince).count();
+      velocity = direction * RampSpeed(m_profile, held);
+    }
+    else if (stick[i] != 0.0) {
+      velocity = stick[i] * m_profile.maxSpeed;
+    }
+    input.direction = direction;
+    input.buttonDirection = 0;
+
+    // Refresh every frame while held, one 0 on release
+    if (velocity != 0.0 || input.velocity != 0.0) {
+      if (!Send(i, velocity) && velocity != 0.0) {
+        input.velocity = 0.0;
+        continue;
+      }
+      input.velocity = velocity;
+    }
+  }
+}
+
+void JogInput::StopAll() {
+  for (int i = 0; i < AXIS_COUNT; i++) {
+    AxisInput& input = m_axes[i];
+    if (input.velocity != 0.0) {
+      Send(i, 0.0);
+    }
+    input = AxisInput();
+  }
+}
+
+// === STATUS ===
+
+double JogInput::GetVelocity(const std::string& axis) const {
+  const int index = AxisIndex(axis);
+  return index >= 0 ? m_axes[index].velocity : 0.0;
+}
+
+bool JogInput::GetEstimatedPosition(const std::string& axis, double& position, double& uncertainty) const {
+  AxisStateEstimator::Estimate estimate;
+  bool valid = false;
+  if (m_target.kind == Target::Kind::Gantry && Services.HasACS()) {
+    ACSController* controller = Services.ACS()->GetDevice(m_target.device);
+    valid = controller && controller->IsConnected() && controller->GetEstimatedPosition(axis, estimate);
+  }
+  else if (m_target.kind == Target::Kind::Hexapod && Services.HasPI()) {
+    PIController* controller = Services.PI()->GetDevice(m_target.device);
+    valid = controller && controller->IsConnected() && controller->GetEstimatedPosition(axis, estimate);
+  }
+  if (valid) {
+    position = estimate.position;
+    uncertainty = estimate.uncertainty;
+  }
+  return valid;
+}
+
+double JogInput::RampSpeed(const SpeedProfile& profile, double heldSeconds) {
+  if (heldSeconds <= profile.rampDelay || profile.rampTime <= 0.0) {
+    return profile.minSpeed;
+  }
+  // Quadratic ramp: slow to leave the fine range, quick near the top
+  const double u = std::clamp((heldSeconds - profile.rampDelay) / profile.rampTime, 0.0, 1.0);
+  return profile.minSpeed + (profile.maxSpeed - profile.minSpeed) * u * u;
+}
+
+// === HELPERS ===
+
+int JogInput::AxisIndex(const std::string& axis) {
+  for (int i = 0; i < AXIS_COUNT; i++) {
+    if (axis == kAxisNames[i]) return i;
+  }
+  return -1;
+}
+
+// Stick position in [-1, 1] outside the deadzone, squared for fine control near centre
+double JogInput::ReadStick(SDL_GameControllerAxis axis) const {
+  const double raw = SDL_GameControllerGetAxis(m_gamepad, axis) / 32767.0;
+  const double magnitude = std::min(std::abs(raw), 1.0);
+  if (magnitude <= m_profile.padDeadzone) {
+    return 0.0;
+  }
+  const double scaled = (magnitude - m_profile.padDeadzone) / (1.0 - m_profile.padDeadzone);
+  return (raw < 0.0 ? -1.0 : 1.0) * scaled * scaled;
+}
+
+bool JogInput::Send(int axisIndex, double velocity) {
+  const std::string axis = kAxisNames[axisIndex];
+
+  if (m_target.kind == Target::Kind::Gantry && Services.HasACS()) {
+    ACSController* controller = Services.ACS()->GetDevice(m_target.device);
+    return controller && controller->IsConnected() && controller->Jog(axis, velocity);
+  }
+  if (m_target.kind == Target::Kind::Hexapod && Services.HasPI()) {
+    PIController* controller = Services.PI()->GetDevice(m_target.device);
+    return controller && controller->IsConnected() && controller->Jog(axis, velocity);
+  }
+  return false;
+}
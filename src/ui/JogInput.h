@@ -0,0 +1,98 @@
+// src/ui/JogInput.h - Hold-to-move jogging from UI buttons, keyboard and gamepad
+#pragma once
+#include <SDL.h>
+#include <chrono>
+#include <string>
+
+/**
+ * JogInput - Turns held inputs into continuous jog velocities
+ *
+ * Sources, all driving the selected target device:
+ *   - UI buttons: HoldButton() every frame the button is active
+ *   - Keyboard (when input is enabled): arrows = X/Y, PageUp/PageDown = Z,
+ *     with Shift on a hexapod: arrows = U/V, PageUp/PageDown = W
+ *   - Gamepad (when input is enabled): left stick = X/Y, right stick = Z
+ *
+ * Digital inputs start at minSpeed and ramp to maxSpeed the longer they are
+ * held; stick deflection scales the speed directly. Update() sends every
+ * held axis to ACSController::Jog / PIController::Jog once per frame (which
+ * keeps their deadman alive) and a single 0 on release. Focus loss, target
+ * changes and gamepad removal stop everything.
+ */
+class JogInput {
+public:
+  struct Target {
+    enum class Kind {
+      None,
+      Gantry,    // ACS device
+      Hexapod    // PI device
+    };
+    Kind kind = Kind::None;
+    std::string device;
+
+    bool operator==(const Target& other) const { return kind == other.kind && device == other.device; }
+  };
+
+  struct SpeedProfile {
+    double minSpeed = 0.05;     // mm/s (deg/s) when a key or button is first pressed
+    double maxSpeed = 10.0;     // mm/s (deg/s) after the ramp, or at full stick
+    double rampDelay = 0.4;     // s at minSpeed before ramping - taps stay fine
+    double rampTime = 2.0;      // s from minSpeed to maxSpeed
+    double padDeadzone = 0.15;  // Fraction of stick travel ignored
+  };
+
+  static constexpr int AXIS_COUNT = 6;   // X Y Z U V W
+
+  static JogInput& Instance();
+
+  void SetTarget(const Target& target);
+  Target GetTarget() const { return m_target; }
+
+  void SetSpeedProfile(const SpeedProfile& profile) { m_profile = profile; }
+  SpeedProfile GetSpeedProfile() const { return m_profile; }
+
+  // Keyboard and gamepad jogging - off by default so typing never moves an axis
+  void SetInputEnabled(bool enabled);
+  bool IsInputEnabled() const { return m_inputEnabled; }
+
+  // Hold-to-move button: call every frame while held (direction -1 or +1)
+  void HoldButton(const std::string& axis, int direction);
+
+  // Main loop
+  void HandleEvent(const SDL_Event& event);
+  void Update();
+  void StopAll();
+
+  // Status for the UI
+  double GetVelocity(const std::string& axis) const;
+  // Target's position between polls (AxisStateEstimator) - smooth while jogging
+  bool GetEstimatedPosition(const std::string& axis, double& position, double& uncertainty) const;
+  bool HasGamepad() const { return m_gamepad != nullptr; }
+
+  // Speed after a digital input has been held for heldSeconds
+  static double RampSpeed(const SpeedProfile& profile, double heldSeconds);
+
+private:
+  JogInput() = default;
+  ~JogInput();
+  JogInput(const JogInput&) = delete;
+  JogInput& operator=(const JogInput&) = delete;
+
+  struct AxisInput {
+    int buttonDirection = 0;   // Set by HoldButton, cleared every Update
+    int direction = 0;         // Digital direction in the previous frame
+    std::chrono::steady_clock::time_point heldSince;
+    double velocity = 0.0;     // Last velocity sent
+  };
+
+  static int AxisIndex(const std::string& axis);
+  double ReadStick(SDL_GameControllerAxis axis) const;
+  bool Send(int axisIndex, double velocity);
+
+  Target m_target;
+  SpeedProfile m_profile;
+  bool m_inputEnabled = false;
+  AxisInput m_axes[AXIS_COUNT];
+  SDL_GameController* m_gamepad = nullptr;
+  SDL_JoystickID m_gamepadId = -1;
+};
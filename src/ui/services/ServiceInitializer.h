@@ -10,6 +10,7 @@
 // Manual category
 #include "manual/PIControlService.h"
 #include "manual/GantryService.h"
+#include "manual/HomingService.h"
 #include "manual/IOControlService.h"
 #include "manual/PneumaticService.h"
 
@@ -45,6 +46,7 @@ public:
     // Manual category services
     registry.RegisterService(std::make_shared<PIControlService>());
     registry.RegisterService(std::make_shared<GantryService>());
+    registry.RegisterService(std::make_shared<HomingService>());
     registry.RegisterService(std::make_shared<IOControlService>());
     registry.RegisterService(std::make_shared<PneumaticService>());
 
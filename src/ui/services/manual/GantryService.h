@@ -6,12 +6,18 @@
 #include "utils/Logger.h"
 #include "utils/Unicode.h"
 #include "imgui.h"
+#include "JogPanel.h"
+#include "devices/motions/ACSControllerManagerStandardized.h"
 
 class GantryService : public IUIService {
 public:
   void RenderUI() override {
     auto acs = Services.ACS();
     ImGui::Text(acs ? "🦾 Gantry: ACS Ready" : "🦾 Gantry: ACS Not available");
+    if (acs) {
+      ImGui::Separator();
+      JogPanel::Render(JogInput::Target::Kind::Gantry, acs->GetDeviceNames());
+    }
   }
   std::string GetServiceName() const override { return "gantry_control"; }
   std::string GetDisplayName() const override { return "Gantry Control"; }
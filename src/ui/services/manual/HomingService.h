@@ -0,0 +1,120 @@
+// src/ui/services/manual/HomingService.h
+#pragma once
+
+#include "../UIServiceRegistry.h"
+#include "core/ServiceLocator.h"
+#include "utils/Logger.h"
+#include "imgui.h"
+#include "devices/motions/HomingOrchestrator.h"
+#include <chrono>
+#include <future>
+
+// Machine homing: runs the phased plan from homing.json and shows each step live
+class HomingService : public IUIService {
+public:
+  void RenderUI() override {
+    auto homing = Services.Homing();
+    ImGui::Text(homing ? "🏠 Machine Homing: Plan loaded" : "🏠 Machine Homing: Not available");
+    if (!homing) {
+      return;
+    }
+    ImGui::Separator();
+
+    const bool running = homing->IsRunning();
+    if (running) {
+      ImGui::BeginDisabled();
+    }
+    if (ImGui::Button("🏠 Home Machine", ImVec2(180, 36))) {
+      Logger::Info(L"Machine homing started");
+      m_result = homing->Start();
+    }
+    if (running) {
+      ImGui::EndDisabled();
+    }
+    ImGui::SameLine();
+    if (!running) {
+      ImGui::BeginDisabled();
+    }
+    if (ImGui::Button("⏹️ Abort", ImVec2(120, 36))) {
+      homing->Abort();
+    }
+    if (!running) {
+      ImGui::EndDisabled();
+    }
+
+    RenderOutcome(running);
+    RenderProgress(*homing);
+  }
+
+  std::string GetServiceName() const override { return "machine_homing"; }
+  std::string GetDisplayName() const override { return "Machine Homing"; }
+  std::string GetCategory() const override { return "Manual"; }
+  bool IsAvailable() const override { return true; }
+
+private:
+  void RenderOutcome(bool running) {
+    if (running) {
+      ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.0f, 1.0f), "Homing in progress...");
+      return;
+    }
+    if (!m_result.valid() || m_result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return;
+    }
+    const HomingOrchestrator::Result& result = m_result.get();
+    if (result.success) {
+      ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Homing complete in %.1f s", result.totalSeconds);
+    }
+    else {
+      ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), result.aborted ? "Homing aborted" : "Homing FAILED");
+    }
+  }
+
+  void RenderProgress(const HomingOrchestrator& homing) {
+    const auto& plan = homing.GetPlan();
+    const auto progress = homing.GetProgress();
+    if (progress.empty()) {
+      ImGui::TextDisabled("%zu phases planned", plan.size());
+      return;
+    }
+
+    if (!ImGui::BeginTable("homing_steps", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+      return;
+    }
+    ImGui::TableSetupColumn("Phase");
+    ImGui::TableSetupColumn("Device");
+    ImGui::TableSetupColumn("Step");
+    ImGui::TableSetupColumn("State");
+    ImGui::TableSetupColumn("Time");
+    ImGui::TableHeadersRow();
+
+    for (const auto& step : progress) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      const bool named = step.phase >= 0 && step.phase < static_cast<int>(plan.size());
+      ImGui::TextUnformatted(named ? plan[step.phase].name.c_str() : "?");
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(step.device.c_str());
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(step.description.c_str());
+      ImGui::TableNextColumn();
+      ImGui::TextColored(StateColor(step.state), "%s", HomingOrchestrator::StateName(step.state));
+      if (!step.message.empty() && ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("%s", step.message.c_str());
+      }
+      ImGui::TableNextColumn();
+      ImGui::Text("%.1f s", step.elapsedSeconds);
+    }
+    ImGui::EndTable();
+  }
+
+  static ImVec4 StateColor(HomingOrchestrator::StepState state) {
+    switch (state) {
+    case HomingOrchestrator::StepState::Running: return ImVec4(1.0f, 0.8f, 0.0f, 1.0f);
+    case HomingOrchestrator::StepState::Done: return ImVec4(0.0f, 1.0f, 0.0f, 1.0f);
+    case HomingOrchestrator::StepState::Failed: return ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
+    default: return ImVec4(0.7f, 0.7f, 0.7f, 1.0f);
+    }
+  }
+
+  std::shared_future<HomingOrchestrator::Result> m_result;
+};
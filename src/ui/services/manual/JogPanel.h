@@ -0,0 +1,88 @@
+// src/ui/services/manual/JogPanel.h
+#pragma once
+
+#include "ui/JogInput.h"
+#include "imgui.h"
+#include <string>
+#include <vector>
+
+// Hold-to-move jog controls shared by the gantry and hexapod pages
+class JogPanel {
+public:
+  static void Render(JogInput::Target::Kind kind, const std::vector<std::string>& devices) {
+    auto& jog = JogInput::Instance();
+    ImGui::PushID(static_cast<int>(kind));
+
+    ImGui::Text("Jog:");
+    if (devices.empty()) {
+      ImGui::TextDisabled("No devices configured");
+      ImGui::PopID();
+      return;
+    }
+
+    // Selecting a device makes it the target of the buttons, keyboard and gamepad
+    const JogInput::Target target = jog.GetTarget();
+    const std::string current = target.kind == kind ? target.device : "";
+    if (ImGui::BeginCombo("Device", current.empty() ? "(select)" : current.c_str())) {
+      for (const auto& device : devices) {
+        if (ImGui::Selectable(device.c_str(), device == current)) {
+          jog.SetTarget({ kind, device });
+        }
+      }
+      ImGui::EndCombo();
+    }
+    if (current.empty()) {
+      ImGui::PopID();
+      return;
+    }
+
+    auto profile = jog.GetSpeedProfile();
+    float maxSpeed = static_cast<float>(profile.maxSpeed);
+    if (ImGui::SliderFloat("Max speed", &maxSpeed, 0.1f, 50.0f, "%.1f mm/s", ImGuiSliderFlags_Logarithmic)) {
+      profile.maxSpeed = maxSpeed;
+      jog.SetSpeedProfile(profile);
+    }
+
+    bool inputEnabled = jog.IsInputEnabled();
+    if (ImGui::Checkbox("Keyboard / gamepad", &inputEnabled)) {
+      jog.SetInputEnabled(inputEnabled);
+    }
+    ImGui::SameLine();
+    ImGui::TextDisabled(jog.HasGamepad() ? "(gamepad connected)" : "(no gamepad)");
+
+    // Buttons move while held and stop on release
+    static const char* const kAxes[] = { "X", "Y", "Z", "U", "V", "W" };
+    const int axisCount = kind == JogInput::Target::Kind::Hexapod ? JogInput::AXIS_COUNT : 3;
+    for (int i = 0; i < axisCount; i++) {
+      ImGui::PushID(i);
+      ImGui::Text("%s", kAxes[i]);
+      ImGui::SameLine(40);
+      ImGui::Button("-", ImVec2(60, 36));
+      if (ImGui::IsItemActive()) {
+        jog.HoldButton(kAxes[i], -1);
+      }
+      ImGui::SameLine();
+      ImGui::Button("+", ImVec2(60, 36));
+      if (ImGui::IsItemActive()) {
+        jog.HoldButton(kAxes[i], 1);
+      }
+      ImGui::SameLine();
+      ImGui::Text("%8.3f", jog.GetVelocity(kAxes[i]));
+      double position = 0.0;
+      double uncertainty = 0.0;
+      if (jog.GetEstimatedPosition(kAxes[i], position, uncertainty)) {
+        ImGui::SameLine();
+        ImGui::Text("at %10.4f", position);
+        ImGui::SameLine();
+        ImGui::TextDisabled("+-%.4f", uncertainty);
+      }
+      ImGui::PopID();
+    }
+
+    if (ImGui::Button("Stop jog", ImVec2(128, 30))) {
+      jog.StopAll();
+    }
+
+    ImGui::PopID();
+  }
+};
@@ -6,6 +6,8 @@
 #include "utils/Logger.h"
 #include "utils/Unicode.h"
 #include "imgui.h"
+#include "JogPanel.h"
+#include "devices/motions/PIControllerManagerStandardized.h"
 
 class PIControlService : public IUIService {
 public:
@@ -99,6 +101,11 @@ private:
       SetOrigin();
     }
 
+    // Continuous jog on the selected hexapod
+    ImGui::Spacing();
+    ImGui::Separator();
+    JogPanel::Render(JogInput::Target::Kind::Hexapod, Services.PI()->GetDeviceNames());
+
     // Speed control
     ImGui::Spacing();
     ImGui::Text("Speed Control:");
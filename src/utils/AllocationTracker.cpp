@@ -0,0 +1,251 @@
+// utils/AllocationTracker.cpp
+#include "AllocationTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+  // Everything here is constant-initialized so it is usable from operator new
+  // before main() and never allocates itself.
+  struct ThreadEntry {
+    std::atomic<uint64_t> allocations{ 0 };
+    std::atomic<uint64_t> deallocations{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<bool> used{ false };
+    char name[32] = {};
+  };
+
+  struct ScopeEntry {
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<uint64_t> calls{ 0 };
+    std::atomic<uint64_t> allocations{ 0 };
+    std::atomic<uint64_t> maxAllocations{ 0 };
+  };
+
+  ThreadEntry g_threads[AllocationTracker::MAX_THREADS];
+  ScopeEntry g_scopes[AllocationTracker::MAX_SCOPES];
+  std::atomic<int> g_nextThread{ 0 };
+
+  thread_local int t_threadSlot = -1;
+
+  ThreadEntry& CurrentThread() {
+    if (t_threadSlot < 0) {
+      int slot = g_nextThread.fetch_add(1, std::memory_order_relaxed);
+      // Threads beyond the table share the last entry
+      t_threadSlot = slot < AllocationTracker::MAX_THREADS ? slot : AllocationTracker::MAX_THREADS - 1;
+      g_threads[t_threadSlot].used.store(true, std::memory_order_relaxed);
+    }
+    return g_threads[t_threadSlot];
+  }
+
+  ScopeEntry* FindScope(const char* name) {
+    for (auto& entry : g_scopes) {
+      const char* current = entry.name.load(std::memory_order_acquire);
+      if (current == name) {
+        return &entry;
+      }
+      if (current == nullptr) {
+        const char* expected = nullptr;
+        if (entry.name.compare_exchange_strong(expected, name) || expected == name) {
+          return &entry;
+        }
+      }
+    }
+    return nullptr;
+  }
+}
+
+// ============================================================================
+// COUNTERS
+// ============================================================================
+
+void AllocationTracker::RecordAllocation(uint64_t bytes) {
+  ThreadEntry& entry = CurrentThread();
+  entry.allocations.fetch_add(1, std::memory_order_relaxed);
+  entry.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AllocationTracker::RecordDeallocation() {
+  CurrentThread().deallocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocationTracker::Counters AllocationTracker::GetThreadCounters() {
+  Counters counters;
+  if (!IsEnabled()) {
+    return counters;
+  }
+
+  ThreadEntry& entry = CurrentThread();
+  counters.allocations = entry.allocations.load(std::memory_order_relaxed);
+  counters.deallocations = entry.deallocations.load(std::memory_order_relaxed);
+  counters.bytes = entry.bytes.load(std::memory_order_relaxed);
+  return counters;
+}
+
+AllocationTracker::Counters AllocationTracker::GetTotalCounters() {
+  Counters counters;
+  for (const auto& entry : g_threads) {
+    counters.allocations += entry.allocations.load(std::memory_order_relaxed);
+    counters.deallocations += entry.deallocations.load(std::memory_order_relaxed);
+    counters.bytes += entry.bytes.load(std::memory_order_relaxed);
+  }
+  return counters;
+}
+
+void AllocationTracker::SetThreadName(const char* name) {
+  if (!IsEnabled() || name == nullptr) {
+    return;
+  }
+
+  ThreadEntry& entry = CurrentThread();
+  std::strncpy(entry.name, name, sizeof(entry.name) - 1);
+  entry.name[sizeof(entry.name) - 1] = '\0';
+}
+
+// ============================================================================
+// SCOPES
+// ============================================================================
+
+AllocationTracker::Scope::Scope(const char* name)
+  : m_name(name), m_start(GetThreadCounters()) {
+}
+
+AllocationTracker::Scope::~Scope() {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  uint64_t allocations = Allocations();
+  ScopeEntry* entry = FindScope(m_name);
+  if (entry == nullptr) {
+    return;
+  }
+
+  entry->calls.fetch_add(1, std::memory_order_relaxed);
+  entry->allocations.fetch_add(allocations, std::memory_order_relaxed);
+
+  uint64_t previous = entry->maxAllocations.load(std::memory_order_relaxed);
+  while (allocations > previous &&
+    !entry->maxAllocations.compare_exchange_weak(previous, allocations, std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t AllocationTracker::Scope::Allocations() const {
+  return GetThreadCounters().allocations - m_start.allocations;
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+void AllocationTracker::Report(std::ostream& out) {
+  if (!IsEnabled()) {
+    out << "AllocationTracker: disabled (build with PROJECT4_TRACK_ALLOCATIONS)" << std::endl;
+    return;
+  }
+
+  Counters total = GetTotalCounters();
+  out << "AllocationTracker: " << total.allocations << " allocations, "
+    << total.deallocations << " frees, " << total.bytes << " bytes" << std::endl;
+
+  out << "  Threads:" << std::endl;
+  for (int i = 0; i < MAX_THREADS; i++) {
+    const ThreadEntry& entry = g_threads[i];
+    if (!entry.used.load(std::memory_order_relaxed)) {
+      continue;
+    }
+    out << "    [" << i << "] " << (entry.name[0] ? entry.name : "(unnamed)")
+      << ": " << entry.allocations.load() << " allocs, " << entry.bytes.load() << " bytes" << std::endl;
+  }
+
+  out << "  Scopes:" << std::endl;
+  for (const auto& entry : g_scopes) {
+    const char* name = entry.name.load();
+    if (name == nullptr) {
+      continue;
+    }
+    uint64_t calls = entry.calls.load();
+    uint64_t allocations = entry.allocations.load();
+    out << "    " << name << ": " << calls << " calls, " << allocations << " allocs"
+      << " (max " << entry.maxAllocations.load() << "/call)" << std::endl;
+  }
+}
+
+// ============================================================================
+// GLOBAL OPERATOR NEW/DELETE REPLACEMENT
+// ============================================================================
+#ifdef PROJECT4_TRACK_ALLOCATIONS
+
+namespace {
+  void* TrackedAlloc(std::size_t size) {
+    AllocationTracker::RecordAllocation(size);
+    return std::malloc(size ? size : 1);
+  }
+
+  void* TrackedAlignedAlloc(std::size_t size, std::align_val_t align) {
+    AllocationTracker::RecordAllocation(size);
+    std::size_t alignment = static_cast<std::size_t>(align);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, alignment);
+#else
+    std::size_t rounded = ((size ? size : 1) + alignment - 1) / alignment * alignment;
+    return std::aligned_alloc(alignment, rounded);
+#endif
+  }
+
+  void TrackedFree(void* ptr) {
+    if (ptr) {
+      AllocationTracker::RecordDeallocation();
+      std::free(ptr);
+    }
+  }
+
+  void TrackedAlignedFree(void* ptr) {
+    if (ptr) {
+      AllocationTracker::RecordDeallocation();
+#ifdef _WIN32
+      _aligned_free(ptr);
+#else
+      std::free(ptr);
+#endif
+    }
+  }
+}
+
+void* operator new(std::size_t size) {
+  if (void* ptr = TrackedAlloc(size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  if (void* ptr = TrackedAlloc(size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return TrackedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return TrackedAlloc(size); }
+
+void* operator new(std::size_t size, std::align_val_t align) {
+  if (void* ptr = TrackedAlignedAlloc(size, align)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+  if (void* ptr = TrackedAlignedAlloc(size, align)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { TrackedAlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { TrackedAlignedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { TrackedAlignedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { TrackedAlignedFree(ptr); }
+
+#endif // PROJECT4_TRACK_ALLOCATIONS
@@ -0,0 +1,70 @@
+// utils/AllocationTracker.h
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+/**
+ * AllocationTracker - Per-thread and per-scope heap allocation counters
+ *
+ * Built with PROJECT4_TRACK_ALLOCATIONS (CMake option of the same name), the
+ * global operator new/delete are replaced with counting versions. Without it
+ * every call here compiles to reading zeros, so scopes can stay in hot paths.
+ *
+ * Usage:
+ *   AllocationTracker::SetThreadName("PI comm");
+ *   while (running) {
+ *     AllocationTracker::Scope scope("PIController::CommTick");  // string literal only
+ *     ...
+ *   }
+ *   AllocationTracker::Report(std::cout);
+ *
+ * Steady-state hot paths (comm ticks, move commands, telemetry publication)
+ * are expected to report zero allocations per call after warm-up.
+ */
+class AllocationTracker {
+public:
+  struct Counters {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes = 0;
+  };
+
+  static constexpr bool IsEnabled() {
+#ifdef PROJECT4_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  // Counters for the calling thread / the whole process
+  static Counters GetThreadCounters();
+  static Counters GetTotalCounters();
+
+  // Label the calling thread in reports
+  static void SetThreadName(const char* name);
+
+  // Dump per-thread and per-scope tables
+  static void Report(std::ostream& out);
+
+  // Measures allocations made by the calling thread between construction and destruction
+  class Scope {
+  public:
+    explicit Scope(const char* name);  // Must have static storage (string literal)
+    ~Scope();
+
+    uint64_t Allocations() const;
+
+  private:
+    const char* m_name;
+    Counters m_start;
+  };
+
+  // Called by the replaced operator new/delete
+  static void RecordAllocation(uint64_t bytes);
+  static void RecordDeallocation();
+
+  static constexpr int MAX_THREADS = 64;
+  static constexpr int MAX_SCOPES = 64;
+};
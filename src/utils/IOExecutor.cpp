@@ -0,0 +1,153 @@
+// utils/IOExecutor.cpp
+#include "IOExecutor.h"
+#include "ThreadPolicy.h"
+
+#include <algorithm>
+#include <iostream>
+
+IOExecutor::IOExecutor(const std::string& name, int threadCount)
+  : m_name(name) {
+  threadCount = std::max(1, threadCount);
+  for (int i = 0; i < threadCount; i++) {
+    m_workers.emplace_back(&IOExecutor::WorkerFunc, this, i);
+  }
+  std::cout << "IOExecutor: " << m_name << " started with " << threadCount << " workers" << std::endl;
+}
+
+IOExecutor::~IOExecutor() {
+  {
+    ProfiledLockGuard lock(m_mutex);
+    m_stopping = true;
+    if (!m_tasks.empty()) {
+      std::cout << "IOExecutor: " << m_name << " dropping " << m_tasks.size()
+        << " tasks that were never cancelled" << std::endl;
+    }
+  }
+  m_workCondition.notify_all();
+
+  for (auto& worker : m_workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+IOExecutor::TaskId IOExecutor::Schedule(const std::string& name, Task task,
+  std::chrono::milliseconds initialDelay) {
+  TaskId id;
+  {
+    ProfiledLockGuard lock(m_mutex);
+    id = m_nextId++;
+    TaskState& state = m_tasks[id];
+    state.name = name;
+    state.task = std::move(task);
+    state.due = std::chrono::steady_clock::now() + initialDelay;
+  }
+  m_workCondition.notify_one();
+  return id;
+}
+
+void IOExecutor::Wake(TaskId id) {
+  {
+    ProfiledLockGuard lock(m_mutex);
+    auto it = m_tasks.find(id);
+    if (it == m_tasks.end() || it->second.cancelled) {
+      return;
+    }
+    if (it->second.running) {
+      it->second.wakePending = true;
+      return;
+    }
+    it->second.due = std::chrono::steady_clock::now();
+  }
+  m_workCondition.notify_one();
+}
+
+bool IOExecutor::Cancel(TaskId id, std::chrono::milliseconds timeout) {
+  ProfiledUniqueLock lock(m_mutex);
+  auto it = m_tasks.find(id);
+  if (it == m_tasks.end()) {
+    return true;
+  }
+
+  if (!it->second.running) {
+    m_tasks.erase(it);
+    return true;
+  }
+
+  // The worker erases it when the current run returns
+  it->second.cancelled = true;
+  auto finished = [this, id]() { return m_tasks.find(id) == m_tasks.end(); };
+  if (timeout == kWaitForever) {
+    m_doneCondition.wait(lock, finished);
+    return true;
+  }
+  return m_doneCondition.wait_for(lock, timeout, finished);
+}
+
+size_t IOExecutor::GetTaskCount() const {
+  ProfiledLockGuard lock(m_mutex);
+  return m_tasks.size();
+}
+
+IOExecutor::Stats IOExecutor::GetStats() const {
+  ProfiledLockGuard lock(m_mutex);
+  return m_stats;
+}
+
+void IOExecutor::WorkerFunc(int index) {
+  ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::MotionIO,
+    m_name + " " + std::to_string(index));
+
+  ProfiledUniqueLock lock(m_mutex);
+  while (!m_stopping) {
+    // Earliest due task that is not already on another worker. A cell has a
+    // few dozen tasks, so a scan is cheaper than keeping a heap consistent
+    // with Wake() and Cancel().
+    auto next = m_tasks.end();
+    for (auto it = m_tasks.begin(); it != m_tasks.end(); ++it) {
+      if (it->second.running || it->second.cancelled) {
+        continue;
+      }
+      if (next == m_tasks.end() || it->second.due < next->second.due) {
+        next = it;
+      }
+    }
+
+    if (next == m_tasks.end()) {
+      m_workCondition.wait(lock);
+      continue;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (next->second.due > now) {
+      m_workCondition.wait_until(lock, next->second.due);
+      continue;
+    }
+
+    TaskState& state = next->second;
+    const TaskId id = next->first;
+    const double latenessMs = std::chrono::duration<double, std::milli>(now - state.due).count();
+    state.running = true;
+    state.wakePending = false;
+
+    lock.unlock();
+    const std::chrono::milliseconds delay = state.task();
+    const auto finishedAt = std::chrono::steady_clock::now();
+    lock.lock();
+
+    m_stats.runs++;
+    m_stats.busySeconds += std::chrono::duration<double>(finishedAt - now).count();
+    m_stats.maxLatenessMs = std::max(m_stats.maxLatenessMs, latenessMs);
+
+    state.running = false;
+    if (state.cancelled || delay < std::chrono::milliseconds(0)) {
+      m_tasks.erase(id);
+      m_doneCondition.notify_all();
+      continue;
+    }
+
+    state.due = state.wakePending ? finishedAt : finishedAt + delay;
+    state.wakePending = false;
+  }
+}
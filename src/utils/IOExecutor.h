@@ -0,0 +1,93 @@
+// utils/IOExecutor.h
+#pragma once
+
+#include "ProfiledMutex.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * IOExecutor - Shared worker pool for periodic controller polling
+ *
+ * A controller normally owns a communication thread that polls, sleeps and
+ * polls again. With a few dozen controllers in one process that is a few
+ * dozen mostly-sleeping threads; an IOExecutor runs the same poll ticks on a
+ * handful of workers instead.
+ *
+ * A task returns the delay until its next run, or kStop. It never runs
+ * concurrently with itself, so a tick keeps the single-threaded assumptions
+ * of the loop it replaces. A tick stuck in a vendor call occupies one worker
+ * and the other tasks keep running on the rest.
+ *
+ * Usage:
+ *   IOExecutor executor("Motion IO", 4);
+ *   auto id = executor.Schedule("PI comm", [this]() { return CommunicationTick(); });
+ *   executor.Wake(id);      // Run as soon as a worker is free
+ *   executor.Cancel(id, std::chrono::milliseconds(2000));
+ */
+class IOExecutor {
+public:
+  using TaskId = uint64_t;
+  using Task = std::function<std::chrono::milliseconds()>;
+
+  static constexpr std::chrono::milliseconds kStop{ -1 };
+  static constexpr std::chrono::milliseconds kWaitForever = std::chrono::milliseconds::max();
+
+  struct Stats {
+    uint64_t runs = 0;
+    double busySeconds = 0.0;      // Summed over all workers
+    double maxLatenessMs = 0.0;    // Worst start delay past the due time
+  };
+
+  IOExecutor(const std::string& name, int threadCount);
+  ~IOExecutor();
+
+  IOExecutor(const IOExecutor&) = delete;
+  IOExecutor& operator=(const IOExecutor&) = delete;
+
+  TaskId Schedule(const std::string& name, Task task,
+    std::chrono::milliseconds initialDelay = std::chrono::milliseconds(0));
+
+  // Bring the next run forward to now (after the current run, if one is in progress)
+  void Wake(TaskId id);
+
+  // Remove a task. Returns false if it is still running after the timeout -
+  // it will not be started again, and a later Cancel waits for it again.
+  bool Cancel(TaskId id, std::chrono::milliseconds timeout);
+
+  int GetThreadCount() const { return static_cast<int>(m_workers.size()); }
+  size_t GetTaskCount() const;
+  Stats GetStats() const;
+  const std::string& GetName() const { return m_name; }
+
+private:
+  struct TaskState {
+    std::string name;
+    Task task;
+    std::chrono::steady_clock::time_point due;
+    bool running = false;
+    bool wakePending = false;
+    bool cancelled = false;
+  };
+
+  void WorkerFunc(int index);
+
+  std::string m_name;
+  std::vector<std::thread> m_workers;
+
+  mutable ProfiledMutex m_mutex{ "IOExecutor::m_mutex" };
+  std::condition_variable_any m_workCondition;   // New or earlier due time
+  std::condition_variable_any m_doneCondition;   // A cancelled task finished
+  std::map<TaskId, TaskState> m_tasks;           // Node-based: entries stay put while running
+  TaskId m_nextId = 1;
+  bool m_stopping = false;
+
+  Stats m_stats;
+};
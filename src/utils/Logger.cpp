@@ -26,11 +26,17 @@ void Logger::Success(const std::wstring& message) {
 void Logger::Log(Level level, const std::wstring& message) {
   std::lock_guard<std::mutex> lock(log_mutex);
 
-  std::wstring fullMessage = GetLevelPrefix(level) + message + L"\n";
-  UnicodeUtils::PrintUnicode(fullMessage);
+  // Reuse one buffer instead of concatenating temporaries - after the first
+  // few messages its capacity covers every line and logging stops allocating
+  static std::wstring buffer;
+  buffer.clear();
+  buffer.append(GetLevelPrefix(level));
+  buffer.append(message);
+  buffer.push_back(L'\n');
+  UnicodeUtils::PrintUnicode(buffer);
 }
 
-std::wstring Logger::GetLevelPrefix(Level level) {
+const wchar_t* Logger::GetLevelPrefix(Level level) {
   switch (level) {
   case Level::INFO:    return L"";
   case Level::WARNING: return L"⚠️ ";
@@ -21,5 +21,5 @@ public:
 
 private:
   static std::mutex log_mutex;
-  static std::wstring GetLevelPrefix(Level level);
+  static const wchar_t* GetLevelPrefix(Level level);
 };
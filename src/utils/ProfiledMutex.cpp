@@ -0,0 +1,368 @@
+// utils/ProfiledMutex.cpp
+#include "ProfiledMutex.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+namespace {
+  // Fixed tables of atomics, as in AllocationTracker: recording never allocates
+  // and never takes a lock except for the trace event log.
+  struct LockEntry {
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<uint64_t> acquisitions{ 0 };
+    std::atomic<uint64_t> contentions{ 0 };
+    std::atomic<int64_t> waitNs{ 0 };
+    std::atomic<int64_t> maxWaitNs{ 0 };
+    std::atomic<int64_t> holdNs{ 0 };
+    std::atomic<int64_t> maxHoldNs{ 0 };
+  };
+
+  struct SiteEntry {
+    std::atomic<uint64_t> key{ 0 };        // 0 = free
+    std::atomic<bool> ready{ false };      // Metadata below written
+    int lock = -1;
+    const char* file = nullptr;
+    const char* function = nullptr;
+    uint32_t line = 0;
+    std::atomic<uint64_t> acquisitions{ 0 };
+    std::atomic<uint64_t> contentions{ 0 };
+    std::atomic<int64_t> waitNs{ 0 };
+    std::atomic<int64_t> maxWaitNs{ 0 };
+    std::atomic<int64_t> holdNs{ 0 };
+    std::atomic<int64_t> maxHoldNs{ 0 };
+    std::atomic<int64_t> blockedOthersNs{ 0 };   // Waits spent by other sites while this one held the lock
+  };
+
+  struct TraceEvent {
+    int lock;
+    int site;
+    int holder;       // Site holding the lock during a wait, -1 for hold events
+    int thread;
+    bool wait;
+    int64_t startNs;
+    int64_t durationNs;
+  };
+
+  LockEntry g_locks[LockProfiler::MAX_LOCKS];
+  SiteEntry g_sites[LockProfiler::MAX_SITES];
+
+  std::mutex g_traceMutex;
+  TraceEvent g_trace[LockProfiler::MAX_TRACE_EVENTS];   // Ring buffer - static, so recording never allocates
+  size_t g_traceCount = 0;
+  size_t g_traceNext = 0;
+
+  std::atomic<int> g_nextThread{ 0 };
+  thread_local int t_thread = -1;
+
+  const std::source_location* Unattributed() {
+    static const std::source_location site;
+    return &site;
+  }
+
+  int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  int CurrentThread() {
+    if (t_thread < 0) {
+      t_thread = g_nextThread.fetch_add(1, std::memory_order_relaxed);
+    }
+    return t_thread;
+  }
+
+  void AtomicMax(std::atomic<int64_t>& target, int64_t value) {
+    int64_t previous = target.load(std::memory_order_relaxed);
+    while (value > previous && !target.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  int FindLock(const char* name) {
+    for (int i = 0; i < LockProfiler::MAX_LOCKS; i++) {
+      const char* current = g_locks[i].name.load(std::memory_order_acquire);
+      if (current != nullptr && std::strcmp(current, name) == 0) {
+        return i;
+      }
+      if (current == nullptr) {
+        const char* expected = nullptr;
+        if (g_locks[i].name.compare_exchange_strong(expected, name) || std::strcmp(expected, name) == 0) {
+          return i;
+        }
+      }
+    }
+    return -1;
+  }
+
+  // Open addressing on (lock, file, line); function names are not compared
+  int FindSite(int lock, const std::source_location& site) {
+    uint64_t key = reinterpret_cast<uintptr_t>(site.file_name()) * 0x9E3779B97F4A7C15ull;
+    key ^= (static_cast<uint64_t>(site.line()) << 20) ^ static_cast<uint64_t>(lock);
+    key |= 1;
+
+    for (int probe = 0; probe < LockProfiler::MAX_SITES; probe++) {
+      const int index = static_cast<int>((key + probe) % LockProfiler::MAX_SITES);
+      SiteEntry& entry = g_sites[index];
+      uint64_t current = entry.key.load(std::memory_order_acquire);
+      if (current == 0) {
+        uint64_t expected = 0;
+        if (entry.key.compare_exchange_strong(expected, key)) {
+          entry.lock = lock;
+          entry.file = site.file_name();
+          entry.function = site.function_name();
+          entry.line = site.line();
+          entry.ready.store(true, std::memory_order_release);
+          return index;
+        }
+        current = expected;
+      }
+      if (current == key) {
+        return index;
+      }
+    }
+    return -1;
+  }
+
+  void RecordTrace(const TraceEvent& event) {
+    std::lock_guard<std::mutex> lock(g_traceMutex);
+    g_trace[g_traceNext] = event;
+    g_traceNext = (g_traceNext + 1) % LockProfiler::MAX_TRACE_EVENTS;
+    g_traceCount = std::min<size_t>(g_traceCount + 1, LockProfiler::MAX_TRACE_EVENTS);
+  }
+
+  // "PIController.cpp:1136 WaitForMotionCompletion" - the file already names the class
+  std::string DescribeSite(int index) {
+    if (index < 0 || !g_sites[index].ready.load(std::memory_order_acquire)) {
+      return "unknown";
+    }
+    const SiteEntry& entry = g_sites[index];
+    if (entry.line == 0) {
+      return "unattributed";
+    }
+
+    const char* file = entry.file;
+    for (const char* p = entry.file; *p; p++) {
+      if (*p == '/' || *p == '\\') file = p + 1;
+    }
+
+    // Method name out of the full signature
+    std::string function = entry.function;
+    const size_t paren = function.find('(');
+    if (paren != std::string::npos) function.resize(paren);
+    const size_t scope = function.rfind("::");
+    if (scope != std::string::npos) function.erase(0, scope + 2);
+    const size_t space = function.rfind(' ');
+    if (space != std::string::npos) function.erase(0, space + 1);
+
+    return std::string(file) + ":" + std::to_string(entry.line) + " " + function;
+  }
+
+  double Milliseconds(int64_t ns) {
+    return ns / 1e6;
+  }
+}
+
+// ============================================================================
+// PROFILED MUTEX
+// ============================================================================
+
+ProfiledMutex::ProfiledMutex(const char* name)
+  : m_name(name) {
+  if (LockProfiler::IsEnabled()) {
+    m_slot = FindLock(name);
+  }
+}
+
+void ProfiledMutex::LockProfiled(const std::source_location* site) {
+  const int siteIndex = m_slot >= 0 ? FindSite(m_slot, site ? *site : *Unattributed()) : -1;
+
+  int64_t waitNs = 0;
+  int64_t acquiredAt = 0;
+  if (m_mutex.try_lock()) {
+    acquiredAt = Now();
+  }
+  else {
+    const int holder = m_ownerSite.load(std::memory_order_relaxed);
+    const int64_t start = Now();
+    m_mutex.lock();
+    acquiredAt = Now();
+    waitNs = acquiredAt - start;
+
+    if (m_slot >= 0) {
+      g_locks[m_slot].contentions.fetch_add(1, std::memory_order_relaxed);
+      g_locks[m_slot].waitNs.fetch_add(waitNs, std::memory_order_relaxed);
+      AtomicMax(g_locks[m_slot].maxWaitNs, waitNs);
+    }
+    if (siteIndex >= 0) {
+      g_sites[siteIndex].contentions.fetch_add(1, std::memory_order_relaxed);
+      g_sites[siteIndex].waitNs.fetch_add(waitNs, std::memory_order_relaxed);
+      AtomicMax(g_sites[siteIndex].maxWaitNs, waitNs);
+    }
+    if (holder >= 0) {
+      g_sites[holder].blockedOthersNs.fetch_add(waitNs, std::memory_order_relaxed);
+    }
+    RecordTrace({ m_slot, siteIndex, holder, CurrentThread(), true, start, waitNs });
+  }
+
+  if (m_slot >= 0) {
+    g_locks[m_slot].acquisitions.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (siteIndex >= 0) {
+    g_sites[siteIndex].acquisitions.fetch_add(1, std::memory_order_relaxed);
+  }
+  m_acquiredAt = acquiredAt;
+  m_ownerSite.store(siteIndex, std::memory_order_relaxed);
+}
+
+bool ProfiledMutex::try_lock() {
+  if (!m_mutex.try_lock()) {
+    return false;
+  }
+  if (LockProfiler::IsEnabled()) {
+    m_acquiredAt = Now();
+    m_ownerSite.store(-1, std::memory_order_relaxed);
+    if (m_slot >= 0) {
+      g_locks[m_slot].acquisitions.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  return true;
+}
+
+void ProfiledMutex::RecordHold() {
+  const int64_t holdNs = Now() - m_acquiredAt;
+  const int siteIndex = m_ownerSite.exchange(-1, std::memory_order_relaxed);
+
+  if (m_slot >= 0) {
+    g_locks[m_slot].holdNs.fetch_add(holdNs, std::memory_order_relaxed);
+    AtomicMax(g_locks[m_slot].maxHoldNs, holdNs);
+  }
+  if (siteIndex >= 0) {
+    g_sites[siteIndex].holdNs.fetch_add(holdNs, std::memory_order_relaxed);
+    AtomicMax(g_sites[siteIndex].maxHoldNs, holdNs);
+  }
+  if (holdNs >= LockProfiler::kTraceHoldMicroseconds * 1000) {
+    RecordTrace({ m_slot, siteIndex, -1, CurrentThread(), false, m_acquiredAt, holdNs });
+  }
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+LockProfiler::Totals LockProfiler::GetTotals() {
+  Totals totals;
+  for (const auto& entry : g_locks) {
+    totals.acquisitions += entry.acquisitions.load(std::memory_order_relaxed);
+    totals.contentions += entry.contentions.load(std::memory_order_relaxed);
+    totals.waitSeconds += entry.waitNs.load(std::memory_order_relaxed) / 1e9;
+    totals.holdSeconds += entry.holdNs.load(std::memory_order_relaxed) / 1e9;
+  }
+  return totals;
+}
+
+void LockProfiler::Report(std::ostream& out) {
+  if (!IsEnabled()) {
+    out << "LockProfiler: disabled (build with PROJECT4_PROFILE_LOCKS)" << std::endl;
+    return;
+  }
+
+  std::vector<int> locks;
+  for (int i = 0; i < MAX_LOCKS; i++) {
+    if (g_locks[i].name.load(std::memory_order_acquire) != nullptr &&
+      g_locks[i].acquisitions.load(std::memory_order_relaxed) > 0) {
+      locks.push_back(i);
+    }
+  }
+  std::sort(locks.begin(), locks.end(), [](int a, int b) {
+    return g_locks[a].waitNs.load() > g_locks[b].waitNs.load();
+  });
+
+  const Totals totals = GetTotals();
+  out << "LockProfiler: " << totals.acquisitions << " acquisitions, " << totals.contentions
+    << " contended, " << std::fixed << std::setprecision(1) << totals.waitSeconds * 1000.0 << " ms waiting" << std::endl;
+
+  for (int lock : locks) {
+    const LockEntry& entry = g_locks[lock];
+    const uint64_t acquisitions = entry.acquisitions.load();
+    const uint64_t contentions = entry.contentions.load();
+    out << "\n  " << entry.name.load() << ": " << acquisitions << " acquisitions, " << contentions << " contended ("
+      << std::setprecision(1) << 100.0 * contentions / acquisitions << "%)" << std::setprecision(3)
+      << " | wait " << Milliseconds(entry.waitNs.load()) << " ms (max " << Milliseconds(entry.maxWaitNs.load()) << ")"
+      << " | hold " << Milliseconds(entry.holdNs.load()) << " ms (max " << Milliseconds(entry.maxHoldNs.load()) << ")"
+      << std::endl;
+
+    std::vector<int> sites;
+    for (int i = 0; i < MAX_SITES; i++) {
+      if (g_sites[i].ready.load(std::memory_order_acquire) && g_sites[i].lock == lock) {
+        sites.push_back(i);
+      }
+    }
+    std::sort(sites.begin(), sites.end(), [](int a, int b) {
+      return g_sites[a].waitNs.load() + g_sites[a].blockedOthersNs.load() >
+        g_sites[b].waitNs.load() + g_sites[b].blockedOthersNs.load();
+    });
+
+    out << "    " << std::left << std::setw(64) << "site" << std::right << std::setw(10) << "acquired"
+      << std::setw(10) << "waited" << std::setw(12) << "wait ms" << std::setw(12) << "max wait"
+      << std::setw(12) << "hold ms" << std::setw(12) << "max hold" << std::setw(14) << "blocked ms" << std::endl;
+    for (int site : sites) {
+      const SiteEntry& s = g_sites[site];
+      out << "    " << std::left << std::setw(64) << DescribeSite(site) << std::right
+        << std::setw(10) << s.acquisitions.load() << std::setw(10) << s.contentions.load()
+        << std::setw(12) << Milliseconds(s.waitNs.load()) << std::setw(12) << Milliseconds(s.maxWaitNs.load())
+        << std::setw(12) << Milliseconds(s.holdNs.load()) << std::setw(12) << Milliseconds(s.maxHoldNs.load())
+        << std::setw(14) << Milliseconds(s.blockedOthersNs.load()) << std::endl;
+    }
+  }
+}
+
+bool LockProfiler::ExportTrace(const std::string& path) {
+  if (!IsEnabled()) {
+    return false;
+  }
+
+  std::vector<TraceEvent> events;
+  {
+    std::lock_guard<std::mutex> lock(g_traceMutex);
+    events.assign(g_trace, g_trace + g_traceCount);
+  }
+  if (events.empty()) {
+    return false;
+  }
+
+  int64_t origin = events.front().startNs;
+  for (const auto& event : events) {
+    origin = std::min(origin, event.startNs);
+  }
+
+  nlohmann::json traceEvents = nlohmann::json::array();
+  for (const auto& event : events) {
+    const char* lockName = event.lock >= 0 ? g_locks[event.lock].name.load() : "unregistered";
+    nlohmann::json args = { { "site", DescribeSite(event.site) } };
+    if (event.wait) {
+      args["holder"] = DescribeSite(event.holder);
+    }
+    traceEvents.push_back({
+      { "name", std::string(event.wait ? "wait " : "hold ") + lockName },
+      { "cat", event.wait ? "lock.wait" : "lock.hold" },
+      { "ph", "X" },
+      { "ts", (event.startNs - origin) / 1000.0 },
+      { "dur", event.durationNs / 1000.0 },
+      { "pid", 1 },
+      { "tid", event.thread },
+      { "args", args }
+    });
+  }
+
+  std::ofstream file(path);
+  if (!file) {
+    return false;
+  }
+  file << nlohmann::json{ { "traceEvents", traceEvents }, { "displayTimeUnit", "ms" } }.dump();
+  return file.good();
+}
@@ -0,0 +1,162 @@
+// utils/ProfiledMutex.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <source_location>
+#include <string>
+
+/**
+ * LockProfiler - Wait and hold times per lock and per call site
+ *
+ * Built with PROJECT4_PROFILE_LOCKS (CMake option of the same name), every
+ * ProfiledMutex acquisition records how long the caller waited, how long the
+ * lock was then held, and - when it had to wait - which call site was
+ * holding it. Without it ProfiledMutex forwards straight to std::mutex and
+ * every call here reports zeros.
+ *
+ * Locks are reported by name, so the PIController::m_mutex of all hexapods
+ * add up to one row. Contended waits and long holds also go to a bounded
+ * event log that ExportTrace writes as Chrome trace-event JSON
+ * (chrome://tracing or ui.perfetto.dev).
+ */
+class LockProfiler {
+public:
+  struct Totals {
+    uint64_t acquisitions = 0;
+    uint64_t contentions = 0;
+    double waitSeconds = 0.0;
+    double holdSeconds = 0.0;
+  };
+
+  static constexpr bool IsEnabled() {
+#ifdef PROJECT4_PROFILE_LOCKS
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  static Totals GetTotals();
+
+  // Per lock, then per call site, ordered by total wait
+  static void Report(std::ostream& out);
+
+  // Contended waits and holds over kTraceHoldMicroseconds
+  static bool ExportTrace(const std::string& path);
+
+  static constexpr int MAX_LOCKS = 64;
+  static constexpr int MAX_SITES = 512;
+  static constexpr int MAX_TRACE_EVENTS = 65536;
+  static constexpr int64_t kTraceHoldMicroseconds = 1000;
+};
+
+/**
+ * ProfiledMutex - std::mutex that reports to LockProfiler
+ *
+ * Take it through ProfiledLockGuard / ProfiledUniqueLock so the call site
+ * is recorded; plain lock() still works but is reported as "unattributed".
+ * Condition variables waiting on it must be std::condition_variable_any.
+ *
+ *   mutable ProfiledMutex m_mutex{ "PIController::m_mutex" };  // string literal only
+ *   ProfiledLockGuard lock(m_mutex);
+ */
+class ProfiledMutex {
+public:
+  explicit ProfiledMutex(const char* name);
+  ProfiledMutex(const ProfiledMutex&) = delete;
+  ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+  void Lock(const std::source_location& site) {
+    if constexpr (!LockProfiler::IsEnabled()) {
+      m_mutex.lock();
+      return;
+    }
+    LockProfiled(&site);
+  }
+
+  void unlock() {
+    if constexpr (LockProfiler::IsEnabled()) {
+      RecordHold();
+    }
+    m_mutex.unlock();
+  }
+
+  // BasicLockable / Lockable for std:: lock helpers
+  void lock() {
+    if constexpr (!LockProfiler::IsEnabled()) {
+      m_mutex.lock();
+      return;
+    }
+    LockProfiled(nullptr);
+  }
+
+  bool try_lock();
+
+  const char* GetName() const { return m_name; }
+
+private:
+  void LockProfiled(const std::source_location* site);
+  void RecordHold();
+
+  std::mutex m_mutex;
+  const char* m_name;
+  int m_slot = -1;
+
+  // Written by the owner after acquiring; m_ownerSite is also read by waiters
+  std::atomic<int> m_ownerSite{ -1 };
+  int64_t m_acquiredAt = 0;
+};
+
+// std::lock_guard that records the line it was constructed on
+class ProfiledLockGuard {
+public:
+  explicit ProfiledLockGuard(ProfiledMutex& mutex,
+    const std::source_location& site = std::source_location::current())
+    : m_mutex(mutex) {
+    m_mutex.Lock(site);
+  }
+  ~ProfiledLockGuard() { m_mutex.unlock(); }
+
+  ProfiledLockGuard(const ProfiledLockGuard&) = delete;
+  ProfiledLockGuard& operator=(const ProfiledLockGuard&) = delete;
+
+private:
+  ProfiledMutex& m_mutex;
+};
+
+// std::unique_lock counterpart - condition_variable_any re-locks through it,
+// so wake-ups are attributed to the waiting site
+class ProfiledUniqueLock {
+public:
+  explicit ProfiledUniqueLock(ProfiledMutex& mutex,
+    const std::source_location& site = std::source_location::current())
+    : m_mutex(mutex), m_site(site) {
+    lock();
+  }
+  ~ProfiledUniqueLock() {
+    if (m_owns) {
+      m_mutex.unlock();
+    }
+  }
+
+  ProfiledUniqueLock(const ProfiledUniqueLock&) = delete;
+  ProfiledUniqueLock& operator=(const ProfiledUniqueLock&) = delete;
+
+  void lock() {
+    m_mutex.Lock(m_site);
+    m_owns = true;
+  }
+  void unlock() {
+    m_owns = false;
+    m_mutex.unlock();
+  }
+  bool owns_lock() const { return m_owns; }
+
+private:
+  ProfiledMutex& m_mutex;
+  std::source_location m_site;
+  bool m_owns = false;
+};
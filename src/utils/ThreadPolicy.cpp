@@ -0,0 +1,345 @@
+// utils/ThreadPolicy.cpp
+#include "ThreadPolicy.h"
+#include "AllocationTracker.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "nlohmann/json.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+std::mutex ThreadPolicy::s_mutex;
+ThreadPolicy::ClassSettings ThreadPolicy::s_settings[static_cast<int>(ThreadPolicy::ThreadClass::Count)];
+std::vector<ThreadPolicy::AppliedSettings> ThreadPolicy::s_report;
+
+namespace {
+  const char* kPriorityNames[] = { "lowest", "below_normal", "normal", "above_normal", "highest", "time_critical" };
+
+  int ParsePriority(const nlohmann::json& value) {
+    if (value.is_number_integer()) {
+      return std::clamp(value.get<int>(), -2, 3);
+    }
+    if (value.is_string()) {
+      const std::string name = value.get<std::string>();
+      for (int i = 0; i < 6; i++) {
+        if (name == kPriorityNames[i]) return i - 2;
+      }
+    }
+    return 0;
+  }
+
+  const char* PriorityName(int priority) {
+    return kPriorityNames[std::clamp(priority, -2, 3) + 2];
+  }
+
+  std::string CpuList(const std::vector<int>& cpus) {
+    if (cpus.empty()) return "any";
+    std::ostringstream ss;
+    for (size_t i = 0; i < cpus.size(); i++) {
+      ss << (i ? "," : "") << cpus[i];
+    }
+    return ss.str();
+  }
+}
+
+const char* ThreadPolicy::ClassName(ThreadClass threadClass) {
+  switch (threadClass) {
+  case ThreadClass::MotionIO:   return "MotionIO";
+  case ThreadClass::Vision:     return "Vision";
+  case ThreadClass::Logging:    return "Logging";
+  case ThreadClass::UI:         return "UI";
+  case ThreadClass::Background: return "Background";
+  default:                      return "Unknown";
+  }
+}
+
+int ThreadPolicy::CpuCount() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+bool ThreadPolicy::LoadFromFile(const std::string& path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    std::cout << "ThreadPolicy: " << path << " not found - using default policy" << std::endl;
+    return false;
+  }
+
+  nlohmann::json config;
+  try {
+    file >> config;
+  }
+  catch (const std::exception& e) {
+    std::cout << "ThreadPolicy: Failed to parse " << path << ": " << e.what() << std::endl;
+    return false;
+  }
+
+  if (!config.contains("threadClasses") || !config["threadClasses"].is_object()) {
+    std::cout << "ThreadPolicy: " << path << " has no threadClasses section" << std::endl;
+    return false;
+  }
+
+  const auto& classes = config["threadClasses"];
+  for (int i = 0; i < static_cast<int>(ThreadClass::Count); i++) {
+    const ThreadClass threadClass = static_cast<ThreadClass>(i);
+    if (!classes.contains(ClassName(threadClass))) {
+      continue;
+    }
+
+    const auto& entry = classes[ClassName(threadClass)];
+    ClassSettings settings;
+    settings.priority = ParsePriority(entry.value("priority", nlohmann::json("normal")));
+    settings.isolate = entry.value("isolate", false);
+
+    if (entry.contains("cpus") && entry["cpus"].is_array()) {
+      for (const auto& cpu : entry["cpus"]) {
+        if (cpu.is_number_integer()) settings.cpus.push_back(cpu.get<int>());
+      }
+    }
+
+    if (entry.contains("realtime") && entry["realtime"].is_object()) {
+      settings.realtimePolicy = entry["realtime"].value("policy", "");
+      settings.realtimePriority = std::clamp(entry["realtime"].value("priority", 50), 1, 99);
+    }
+
+    SetClassSettings(threadClass, settings);
+  }
+
+  std::cout << "ThreadPolicy: Loaded " << path << std::endl;
+  return true;
+}
+
+void ThreadPolicy::SetClassSettings(ThreadClass threadClass, const ClassSettings& settings) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  s_settings[static_cast<int>(threadClass)] = settings;
+}
+
+ThreadPolicy::ClassSettings ThreadPolicy::GetClassSettings(ThreadClass threadClass) {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  return s_settings[static_cast<int>(threadClass)];
+}
+
+// Called with s_mutex held
+std::vector<int> ThreadPolicy::ResolveCpus(ThreadClass threadClass) {
+  const int cpuCount = CpuCount();
+  std::vector<int> cpus;
+
+  for (int cpu : s_settings[static_cast<int>(threadClass)].cpus) {
+    if (cpu >= 0 && cpu < cpuCount) cpus.push_back(cpu);
+  }
+  if (!cpus.empty()) {
+    return cpus;
+  }
+
+  // No explicit list: everything not reserved by an isolated class
+  std::vector<bool> reserved(cpuCount, false);
+  bool anyReserved = false;
+  for (int i = 0; i < static_cast<int>(ThreadClass::Count); i++) {
+    if (i == static_cast<int>(threadClass) || !s_settings[i].isolate) continue;
+    for (int cpu : s_settings[i].cpus) {
+      if (cpu >= 0 && cpu < cpuCount) {
+        reserved[cpu] = true;
+        anyReserved = true;
+      }
+    }
+  }
+
+  if (!anyReserved) {
+    return cpus;  // Any CPU
+  }
+
+  for (int cpu = 0; cpu < cpuCount; cpu++) {
+    if (!reserved[cpu]) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+// ============================================================================
+// APPLY
+// ============================================================================
+
+ThreadPolicy::AppliedSettings ThreadPolicy::ApplyToCurrentThread(ThreadClass threadClass, const std::string& name) {
+  ClassSettings settings;
+  std::vector<int> cpus;
+  {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    settings = s_settings[static_cast<int>(threadClass)];
+    cpus = ResolveCpus(threadClass);
+  }
+
+  AppliedSettings applied;
+  applied.threadName = name;
+  applied.threadClass = threadClass;
+  std::ostringstream notes;
+
+  AllocationTracker::SetThreadName(name.c_str());
+
+#ifdef _WIN32
+  // --- Name ---
+  std::wstring wideName(name.begin(), name.end());
+  applied.nameApplied = SUCCEEDED(SetThreadDescription(GetCurrentThread(), wideName.c_str()));
+
+  // --- Priority ---
+  static const int kWindowsPriority[] = {
+    THREAD_PRIORITY_LOWEST, THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL,
+    THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_HIGHEST, THREAD_PRIORITY_TIME_CRITICAL
+  };
+  applied.priorityApplied = SetThreadPriority(GetCurrentThread(), kWindowsPriority[settings.priority + 2]) != 0;
+  if (!applied.priorityApplied) {
+    notes << "SetThreadPriority failed (" << GetLastError() << "); ";
+  }
+  if (!settings.realtimePolicy.empty()) {
+    notes << "realtime policy ignored on Windows; ";
+  }
+
+  int actual = GetThreadPriority(GetCurrentThread());
+  applied.effectivePriority = "normal";
+  for (int i = 0; i < 6; i++) {
+    if (kWindowsPriority[i] == actual) applied.effectivePriority = kPriorityNames[i];
+  }
+
+  // --- Affinity ---
+  if (!cpus.empty()) {
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+      if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) mask |= (static_cast<DWORD_PTR>(1) << cpu);
+    }
+    applied.affinityApplied = SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+    if (!applied.affinityApplied) {
+      notes << "SetThreadAffinityMask failed (" << GetLastError() << "); ";
+    }
+  }
+  applied.effectiveCpus = applied.affinityApplied ? cpus : std::vector<int>();
+#else
+  // --- Name (Linux limits names to 15 characters) ---
+  applied.nameApplied = pthread_setname_np(pthread_self(), name.substr(0, 15).c_str()) == 0;
+
+  // --- Priority ---
+  bool realtimeApplied = false;
+  if (!settings.realtimePolicy.empty()) {
+    int policy = settings.realtimePolicy == "rr" ? SCHED_RR : SCHED_FIFO;
+    sched_param param{};
+    param.sched_priority = settings.realtimePriority;
+    int result = pthread_setschedparam(pthread_self(), policy, &param);
+    realtimeApplied = (result == 0);
+    if (!realtimeApplied) {
+      notes << "SCHED_" << (policy == SCHED_RR ? "RR" : "FIFO") << " unavailable ("
+        << std::strerror(result) << "), using nice; ";
+    }
+  }
+
+  if (realtimeApplied) {
+    applied.priorityApplied = true;
+  }
+  else if (settings.priority != 0) {
+    // Map -2..+3 onto nice 10..-15 for this thread only
+    const int niceValue = -settings.priority * 5;
+    const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+    applied.priorityApplied = setpriority(PRIO_PROCESS, tid, niceValue) == 0;
+    if (!applied.priorityApplied) {
+      notes << "nice " << niceValue << " failed (" << std::strerror(errno) << "); ";
+    }
+  }
+  else {
+    applied.priorityApplied = true;
+  }
+
+  int policy = SCHED_OTHER;
+  sched_param param{};
+  pthread_getschedparam(pthread_self(), &policy, &param);
+  if (policy == SCHED_FIFO || policy == SCHED_RR) {
+    applied.effectivePriority = std::string(policy == SCHED_FIFO ? "SCHED_FIFO " : "SCHED_RR ") +
+      std::to_string(param.sched_priority);
+  }
+  else {
+    const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+    applied.effectivePriority = "SCHED_OTHER nice " + std::to_string(getpriority(PRIO_PROCESS, tid));
+  }
+
+  // --- Affinity ---
+  if (!cpus.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    applied.affinityApplied = (result == 0);
+    if (!applied.affinityApplied) {
+      notes << "affinity failed (" << std::strerror(result) << "); ";
+    }
+  }
+
+  cpu_set_t actualSet;
+  CPU_ZERO(&actualSet);
+  if (!cpus.empty() && pthread_getaffinity_np(pthread_self(), sizeof(actualSet), &actualSet) == 0) {
+    for (int cpu = 0; cpu < CpuCount(); cpu++) {
+      if (CPU_ISSET(cpu, &actualSet)) applied.effectiveCpus.push_back(cpu);
+    }
+  }
+#endif
+
+  applied.notes = notes.str();
+
+  std::cout << "ThreadPolicy: [" << ClassName(threadClass) << "] " << name
+    << " -> priority " << applied.effectivePriority
+    << " (requested " << PriorityName(settings.priority) << ")"
+    << ", cpus " << CpuList(applied.effectiveCpus);
+  if (!applied.notes.empty()) {
+    std::cout << " - " << applied.notes;
+  }
+  std::cout << std::endl;
+
+  // A restarted thread (e.g. after reconnect) replaces its previous entry, so
+  // names must be unique per thread - controllers append their device name
+  {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto it = std::find_if(s_report.begin(), s_report.end(),
+      [&](const AppliedSettings& entry) { return entry.threadName == name; });
+    if (it != s_report.end()) {
+      *it = applied;
+    }
+    else {
+      s_report.push_back(applied);
+    }
+  }
+  return applied;
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+std::vector<ThreadPolicy::AppliedSettings> ThreadPolicy::GetReport() {
+  std::lock_guard<std::mutex> lock(s_mutex);
+  return s_report;
+}
+
+void ThreadPolicy::PrintReport(std::ostream& out) {
+  std::vector<AppliedSettings> report = GetReport();
+
+  out << "ThreadPolicy: " << report.size() << " threads" << std::endl;
+  for (const auto& entry : report) {
+    out << "  [" << ClassName(entry.threadClass) << "] " << entry.threadName
+      << ": priority " << entry.effectivePriority << (entry.priorityApplied ? "" : " (NOT applied)")
+      << ", cpus " << CpuList(entry.effectiveCpus) << (entry.affinityApplied || entry.effectiveCpus.empty() ? "" : " (NOT applied)");
+    if (!entry.notes.empty()) {
+      out << " - " << entry.notes;
+    }
+    out << std::endl;
+  }
+}
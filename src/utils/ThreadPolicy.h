@@ -0,0 +1,81 @@
+// utils/ThreadPolicy.h
+#pragma once
+
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * ThreadPolicy - Names, priorities and CPU affinity per class of thread
+ *
+ * Every thread the application creates calls ApplyToCurrentThread() with its
+ * class as the first thing it does. Settings per class come from
+ * config/thread_policy.json; without a config file every class runs at
+ * normal priority on any CPU and only the thread name is applied.
+ *
+ * Priorities map to SetThreadPriority levels on Windows. On Linux a class
+ * may request SCHED_FIFO / SCHED_RR; when the process lacks permission the
+ * equivalent nice value is used instead and the report says so.
+ *
+ * Classes marked "isolate" keep their CPUs to themselves: classes without
+ * an explicit CPU list are pinned to the remaining CPUs.
+ *
+ * Usage:
+ *   ThreadPolicy::LoadFromFile("config/thread_policy.json");
+ *   ...
+ *   ThreadPolicy::ApplyToCurrentThread(ThreadPolicy::ThreadClass::MotionIO, "PI comm");
+ *   ThreadPolicy::PrintReport(std::cout);
+ */
+class ThreadPolicy {
+public:
+  enum class ThreadClass {
+    MotionIO,    // Controller comm threads, watchdog - must never wait on the others
+    Vision,      // Camera acquisition and processing
+    Logging,     // Log/trace writers, disk flushes
+    UI,          // Render loop
+    Background,  // Connect/recovery workers and other one-off tasks
+    Count
+  };
+
+  struct ClassSettings {
+    int priority = 0;                  // -2 lowest .. 0 normal .. +3 time critical
+    std::string realtimePolicy;        // "", "fifo" or "rr" (Linux only)
+    int realtimePriority = 0;          // 1..99 when realtimePolicy is set
+    std::vector<int> cpus;             // Empty = any CPU (minus isolated ones)
+    bool isolate = false;
+  };
+
+  struct AppliedSettings {
+    std::string threadName;
+    ThreadClass threadClass = ThreadClass::Background;
+    bool nameApplied = false;
+    bool priorityApplied = false;
+    bool affinityApplied = false;
+    std::string effectivePriority;     // What the OS reports back
+    std::vector<int> effectiveCpus;
+    std::string notes;                 // Fallbacks and failures
+  };
+
+  // Configuration
+  static bool LoadFromFile(const std::string& path);
+  static void SetClassSettings(ThreadClass threadClass, const ClassSettings& settings);
+  static ClassSettings GetClassSettings(ThreadClass threadClass);
+
+  // Apply the class policy to the calling thread and record the result
+  static AppliedSettings ApplyToCurrentThread(ThreadClass threadClass, const std::string& name);
+
+  // Effective settings of every thread that applied a policy
+  static std::vector<AppliedSettings> GetReport();
+  static void PrintReport(std::ostream& out);
+
+  static const char* ClassName(ThreadClass threadClass);
+
+private:
+  static std::vector<int> ResolveCpus(ThreadClass threadClass);
+  static int CpuCount();
+
+  static std::mutex s_mutex;
+  static ClassSettings s_settings[static_cast<int>(ThreadClass::Count)];
+  static std::vector<AppliedSettings> s_report;
+};